@@ -0,0 +1,198 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005,2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+
+#ifndef DEFAULT_SIMULATOR_IMPL_H
+#define DEFAULT_SIMULATOR_IMPL_H
+
+#include "simulator-impl.h"
+#include "scheduler.h"
+#include "event-impl.h"
+#include "event-profiler.h"
+#include "system-thread.h"
+#include "ns3/system-mutex.h"
+
+#include "ptr.h"
+
+#include <atomic>
+#include <list>
+#include <string>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * Declaration of class ns3::DefaultSimulatorImpl.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ *
+ * The default single process simulator implementation.
+ *
+ * When the Profile attribute is set, the simulator measures the wall
+ * clock time spent in each event, and writes an EventProfiler report
+ * at the end of each Run.
+ */
+class DefaultSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  DefaultSimulatorImpl ();
+  /** Destructor. */
+  ~DefaultSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const; 
+  virtual uint32_t GetContext (void) const;
+  virtual void RestoreClock (const Time &now);
+
+private:
+  virtual void DoDispose (void);
+
+  /**
+   * Enable or disable the recycling of event objects.
+   *
+   * \param [in] enabled \c true to recycle event objects through the
+   *        EventAllocator free lists.
+   */
+  void SetEventPool (bool enabled);
+  /**
+   * \returns \c true if event objects are recycled.
+   */
+  bool GetEventPool (void) const;
+  /** Write the event profile, if profiling is enabled. */
+  void WriteProfile (void) const;
+
+  /**
+   * Get the timestamp of an event, including the delay added by
+   * RestoreClock to the events scheduled before it.
+   *
+   * \param [in] id The event identifier.
+   * \returns The timestamp of the event.
+   */
+  uint64_t GetEventTs (const EventId &id) const;
+  /** Process the next event. */
+  void ProcessOneEvent (void);
+  /** Move events from a different context into the main event queue. */
+  void ProcessEventsWithContext (void);
+ 
+  /** Wrap an event with its execution context. */
+  struct EventWithContext {
+    /** The event context. */
+    uint32_t context;
+    /** Event timestamp. */
+    uint64_t timestamp;
+    /** The event implementation. */
+    EventImpl *event;
+  };
+  /** Container type for the events from a different context. */
+  typedef std::vector<struct EventWithContext> EventsWithContext;
+  /**
+   * Ring buffer of the events from a different context.
+   *
+   * The size of the ring is a power of two; it is preallocated, and
+   * doubles when a thread pushes an event into a full ring.
+   */
+  EventsWithContext m_eventsWithContext;
+  /** Index of the oldest event in the ring. */
+  uint32_t m_eventsWithContextHead;
+  /** Number of events in the ring. */
+  uint32_t m_eventsWithContextCount;
+  /**
+   * Events copied out of the ring by ProcessEventsWithContext, kept
+   * as a member so that its storage is reused from one batch to the next.
+   */
+  EventsWithContext m_eventsWithContextBatch;
+  /**
+   * Flag \c true if all events with context have been moved to the
+   * primary event queue.  It is read without taking the mutex, so that
+   * the main thread checks for new events with a single atomic load.
+   */
+  std::atomic<bool> m_eventsWithContextEmpty;
+  /** Mutex to control access to the ring of events with context. */
+  SystemMutex m_eventsWithContextMutex;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Flag calling for the end of the simulation. */
+  bool m_stop;
+  /** The event priority queue. */
+  Ptr<Scheduler> m_events;
+
+  /** Next event unique id. */
+  uint32_t m_uid;
+  /** Unique id of the current event. */
+  uint32_t m_currentUid;
+  /** Timestamp of the current event. */
+  uint64_t m_currentTs;
+  /** Execution context of the current event. */
+  uint32_t m_currentContext;
+  /** Time restored by RestoreClock, added to the events scheduled before it. */
+  uint64_t m_restoreTs;
+  /** Unique id of the first event scheduled after RestoreClock. */
+  uint32_t m_restoreUid;
+  /**
+   * Number of events that have been inserted but not yet scheduled,
+   *  not counting the Destroy events; this is used for validation
+   */
+  int m_unscheduledEvents;
+
+  /** Main execution thread. */
+  SystemThread::ThreadId m_main;
+
+  /** Flag \c true to measure the time spent in each event. */
+  bool m_profile;
+  /** File name of the profile report; empty for std::clog. */
+  std::string m_profileReport;
+  /** File name of the folded stacks profile; empty for none. */
+  std::string m_profileFolded;
+  /** The time spent in events, by type and context. */
+  EventProfiler m_profiler;
+};
+
+} // namespace ns3
+
+#endif /* DEFAULT_SIMULATOR_IMPL_H */
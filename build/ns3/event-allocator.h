@@ -0,0 +1,98 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_ALLOCATOR_H
+#define EVENT_ALLOCATOR_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "free-list-allocator.h"
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief Free-list allocator for EventImpl objects.
+ *
+ * Every EventImpl (and hence every event created by MakeEvent and the
+ * Simulator::Schedule family) is allocated through this class, by way
+ * of EventImpl::operator new and EventImpl::operator delete.  The
+ * blocks of up to MAX_SIZE bytes are recycled by a FreeListAllocator,
+ * from 16-byte blocks up, so that events can be created and deleted
+ * from several threads (for example by Simulator::ScheduleWithContext)
+ * without any locking.
+ *
+ * The recycling can be turned off with SetEnabled, which is what the
+ * ns3::DefaultSimulatorImpl::EventPool attribute does.  When disabled,
+ * freed blocks are returned to the system allocator immediately.
+ */
+class EventAllocator
+{
+public:
+  /** Allocation statistics of the calling thread. */
+  typedef FreeListAllocator::Stats Stats;
+
+  /** Largest block size, in bytes, which is recycled. */
+  static const std::size_t MAX_SIZE = 256;
+  /** Maximum number of blocks kept in each free list. */
+  static const uint32_t MAX_FREE = 4096;
+
+  /**
+   * Allocate a block.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns The block.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Release a block obtained from Allocate.
+   *
+   * \param [in] p The block.
+   * \param [in] size The size which was passed to Allocate.
+   */
+  static void Deallocate (void *p, std::size_t size);
+  /**
+   * Enable or disable recycling of freed blocks.
+   *
+   * Disabling the pool also releases the blocks pooled by the
+   * calling thread.
+   *
+   * \param [in] enabled \c true to recycle freed blocks.
+   */
+  static void SetEnabled (bool enabled);
+  /**
+   * \returns \c true if freed blocks are recycled.
+   */
+  static bool IsEnabled (void);
+  /**
+   * \returns The allocation statistics of the calling thread.
+   */
+  static Stats GetStats (void);
+  /** Reset the allocation statistics of the calling thread. */
+  static void ResetStats (void);
+};
+
+} // namespace ns3
+
+#endif /* EVENT_ALLOCATOR_H */
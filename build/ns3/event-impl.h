@@ -0,0 +1,149 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2005,2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef EVENT_IMPL_H
+#define EVENT_IMPL_H
+
+#include <stdint.h>
+#include <cstddef>
+#include "simple-ref-count.h"
+#include "event-allocator.h"
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventImpl declarations.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup events
+ * \brief A simulation event.
+ *
+ * Each subclass of this base class represents a simulation event. The
+ * Invoke() method will be called by the simulation engine
+ * when it reaches the time associated to this event. Most subclasses
+ * are usually created by one of the many Simulator::Schedule
+ * methods.
+ */
+class EventImpl : public SimpleRefCount<EventImpl>
+{
+public:
+  /** Default constructor. */
+  EventImpl ();
+  /** Destructor. */
+  virtual ~EventImpl () = 0;
+  /**
+   * Called by the simulation engine to notify the event that it is time
+   * to execute.
+   */
+  void Invoke (void);
+  /**
+   * Marks the event as 'canceled'. The event is not removed from
+   * the event list but the simulation engine will check its canceled status
+   * before calling Invoke().
+   */
+  void Cancel (void);
+  /**
+   * \returns true if the event has been canceled.
+   *
+   * Checked by the simulation engine before calling Invoke().
+   */
+  bool IsCancelled (void);
+  /**
+   * Prepare the event to run in another thread than the one which
+   * created it.
+   *
+   * The bound arguments which share state with the objects of the
+   * calling thread, such as packets, are replaced by private copies.
+   * Called by the simulator implementations which run events in
+   * several threads, before they hand an event over to another thread.
+   */
+  void Isolate (void);
+  /**
+   * Attach an opaque link to the event, for the use of the Scheduler
+   * which holds it, e.g. to find its entry in Scheduler::Remove
+   * without a lookup.
+   *
+   * \param [in] link The link, or 0 once the event leaves the scheduler.
+   */
+  void SetSchedulerLink (void *link);
+  /**
+   * \returns The link set by SetSchedulerLink, or 0.
+   */
+  void * GetSchedulerLink (void) const;
+
+  /**
+   * Allocate the storage of an event through the EventAllocator.
+   *
+   * \param [in] size The size of the event object.
+   * \returns The storage.
+   */
+  static void * operator new (std::size_t size)
+  {
+    return EventAllocator::Allocate (size);
+  }
+  /**
+   * Release the storage of an event to the EventAllocator.
+   *
+   * \param [in] p The storage.
+   * \param [in] size The size of the event object.
+   */
+  static void operator delete (void *p, std::size_t size)
+  {
+    EventAllocator::Deallocate (p, size);
+  }
+
+protected:
+  /**
+   * Implementation for Invoke().
+   *
+   * This typically calls a method or function pointer with the
+   * arguments bound by a call to one of the MakeEvent() functions.
+   */
+  virtual void Notify (void) = 0;
+  /**
+   * Implementation for Isolate().
+   *
+   * This does nothing by default; the events made by the MakeEvent()
+   * functions call IsolateEventArgument() on each of their arguments.
+   */
+  virtual void DoIsolate (void);
+
+private:
+  bool m_cancel;  /**< Has this event been cancelled. */
+  void *m_link;   /**< The link of the Scheduler holding the event. */
+};
+
+inline void
+EventImpl::SetSchedulerLink (void *link)
+{
+  m_link = link;
+}
+
+inline void *
+EventImpl::GetSchedulerLink (void) const
+{
+  return m_link;
+}
+
+} // namespace ns3
+
+#endif /* EVENT_IMPL_H */
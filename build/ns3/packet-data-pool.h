@@ -0,0 +1,64 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef PACKET_DATA_POOL_H
+#define PACKET_DATA_POOL_H
+
+#include <stdint.h>
+#include "ns3/free-list-allocator.h"
+
+/**
+ * \file
+ * \ingroup packet
+ * ns3::PacketDataPool declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup packet
+ * \brief Free lists for the data blocks of the packets.
+ *
+ * The copy-on-write data of Buffer, PacketMetadata, ByteTagList and
+ * PacketTagList, and the Packet objects themselves, are allocated
+ * through one PacketDataPool each: a FreeListAllocator of blocks from
+ * MIN_SIZE to MAX_SIZE bytes, which keeps up to DEFAULT_MAX_FREE free
+ * blocks per size class, so that packets can be created and destroyed
+ * from several threads (emulated devices, parallel simulator
+ * implementations) without any locking.
+ */
+class PacketDataPool : public FreeListAllocator
+{
+public:
+  /** Smallest block size, in bytes. */
+  static const uint32_t MIN_SIZE = 64;
+  /** Largest block size, in bytes, which is recycled. */
+  static const uint32_t MAX_SIZE = 65536;
+  /** Default maximum number of free blocks per size class and thread. */
+  static const uint32_t DEFAULT_MAX_FREE = 256;
+
+  /** Constructor. */
+  constexpr PacketDataPool ()
+    : FreeListAllocator (MIN_SIZE, MAX_SIZE, DEFAULT_MAX_FREE)
+  {
+  }
+};
+
+} // namespace ns3
+
+#endif /* PACKET_DATA_POOL_H */
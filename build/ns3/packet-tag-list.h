@@ -0,0 +1,331 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2006 INRIA
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * Author: Mathieu Lacage <mathieu.lacage@sophia.inria.fr>
+ */
+#ifndef PACKET_TAG_LIST_H
+#define PACKET_TAG_LIST_H
+
+/**
+\file   packet-tag-list.h
+\brief  Defines a copy-on-write array of Packet tags.
+*/
+
+#include <stdint.h>
+#include <ostream>
+#include "ns3/type-id.h"
+#include "packet-data-pool.h"
+
+namespace ns3 {
+
+class Tag;
+
+/**
+ * \ingroup packet
+ *
+ * \brief List of the packet tags stored in a packet.
+ *
+ * This class is mostly private to the Packet implementation and users
+ * should never have to access it directly.
+ *
+ * \internal
+ *
+ *   - Tags are stored in serialized form, in a single array of TagData
+ *     structures allocated from a PacketDataPool.  The first
+ *     allocation has room for a few tags, which is all most packets
+ *     ever carry, and the array grows when it is full.  The tags are
+ *     kept in the order they were added.
+ *
+ *   - The array is shared by the copies of a PacketTagList and,
+ *     thus, reference-counted.  Each PacketTagList holds the number
+ *     of tags of the array which belong to it, while the array
+ *     records the number of tags written by any of the lists which
+ *     share it (the "dirty" tags, as in the ByteTagList).
+ *
+ *   - Each PacketTagList also holds a mask of the hashes of the
+ *     TypeId's of its tags, so that looking for a tag which is not
+ *     in the list does not look at the array at all.
+ *
+ * \par <b> Copy-on-write </b> is implemented as follows:
+ *
+ *   - Copy constructor (PacketTagList(const PacketTagList & o))
+ *     and assignment (#operator=(const PacketTagList & o))
+ *     simply share the array of \c o, incrementing its count.
+ *
+ *   - #Add writes the new tag after the tags of the list, in place,
+ *     if no other list sharing the array has written there, and
+ *     copies the array otherwise, or when it is full.  This does not
+ *     affect any other PacketTagList, hence this is a \c const function.
+ *
+ *   - #Remove of the last tag added only shortens the list.  Other
+ *     #Remove and #Replace operations are done in place if the array
+ *     is not shared, and on a copy of the array otherwise.
+ *
+ * \par <b> Memory Management: </b>
+ * \n
+ * Packet tags must serialize to a finite maximum size, see TagData
+ *
+ * This documentation entitles the original author to a free beer.
+ */
+class PacketTagList 
+{
+public:
+  /**
+   * A serialized tag, as stored in the array of a PacketTagList.
+   *
+   * See TagData::TagData_e for a discussion of the size limit on
+   * tag serialization.
+   */
+  struct TagData
+  {
+    /**
+     * \brief Packet Tag maximum size
+     *
+     * The maximum size (in bytes) of a Tag is stored
+     * in this constant.
+     *
+     * \internal
+     * ns3:Ipv6PacketInfoTag needs 19 bytes.  The current
+     * implementation allows 21 bytes, which, with the TypeId,
+     * gives TagData a size of 24 bytes on all architectures.
+     */
+    enum TagData_e
+    {
+      MAX_SIZE = 21           /**< Size of serialization buffer #data */
+  };
+
+    uint8_t data[MAX_SIZE];   /**< Serialization buffer */
+    TypeId tid;               /**< Type of the tag serialized into #data */
+  };  /* struct TagData */
+
+  /**
+   * Create a new PacketTagList.
+   */
+  inline PacketTagList ();
+  /**
+   * Copy constructor
+   *
+   * \param [in] o The PacketTagList to copy.
+   *
+   * This makes a light-weight copy, sharing the
+   * \ref TagData array of \pname{o}.
+   */
+  inline PacketTagList (PacketTagList const &o);
+  /**
+   * Assignment
+   *
+   * \param [in] o The PacketTagList to copy.
+   * \returns the copied object
+   *
+   * This makes a light-weight copy by #RemoveAll, then
+   * sharing the \ref TagData array of \pname{o}.
+   */
+  inline PacketTagList &operator = (PacketTagList const &o);
+  /**
+   * Destructor
+   *
+   * #RemoveAll's the tags.
+   */
+  inline ~PacketTagList ();
+
+  /**
+   * Add a tag at the end of the list.
+   *
+   * \param [in] tag The tag to add
+   */
+  void Add (Tag const&tag) const;
+  /**
+   * Remove (the first instance of) tag from the list.
+   *
+   * \param [in,out] tag The tag type to remove.  If found,
+   *          \pname{tag} is set to the value of the tag found.
+   * \returns True if \pname{tag} is found, false otherwise.
+   */
+  bool Remove (Tag &tag);
+  /**
+   * Replace the value of a tag.
+   *
+   * \param [in] tag The tag type to replace.  To get the old
+   *        value of the tag, use #Peek first.
+   * \returns True if \pname{tag} is found, false otherwise.
+   *        If \pname{tag} wasn't found, Add is performed instead (so
+   *        the list is guaranteed to have the new tag value either way).
+   */
+  bool Replace (Tag &tag);
+  /**
+   * Find a tag and return its value.
+   *
+   * \param [in,out] tag The tag type to find.  If found,
+   *          \pname{tag} is set to the value of the tag found.
+   * \returns True if \pname{tag} is found, false otherwise.
+   */
+  bool Peek (Tag &tag) const;
+  /**
+   * Remove all tags from this list.
+   */
+  inline void RemoveAll (void);
+  /**
+   * Give this list its own copy of the tag array it shares with
+   * other lists, e.g. before it is handed over to another thread.
+   */
+  void Detach (void);
+  /**
+   * \returns pointer to the first tag of the list, the oldest one
+   */
+  const struct PacketTagList::TagData *Begin (void) const;
+  /**
+   * \returns pointer past the last tag of the list
+   */
+  const struct PacketTagList::TagData *End (void) const;
+
+  /**
+   * \brief Get the pool which recycles the tag arrays.
+   * \returns the pool of the packet tag storage.
+   */
+  static PacketDataPool & GetDataPool (void);
+
+private:
+  /**
+   * The array of tags, shared by the copies of a PacketTagList.
+   */
+  struct Data
+  {
+    /** Number of PacketTagList's which reference this array. */
+    uint32_t m_count;
+    /** Number of tags which m_tags can hold. */
+    uint32_t m_size;
+    /** Number of tags written by any of the lists which share the array. */
+    uint32_t m_dirty;
+    /** Size of this structure, in bytes, as allocated by the pool. */
+    uint32_t m_capacity;
+    /** The tags, in the order they were added. */
+    struct TagData m_tags[1];
+  };
+
+  /**
+   * Get the bit of the mask of the tags of a type.
+   *
+   * \param [in] tid The type of the tag.
+   * \returns The bit of the hash of \pname{tid}.
+   */
+  static inline uint32_t GetMask (TypeId tid);
+  /**
+   * Find a tag of the list.
+   *
+   * \param [in] tid The type of the tag.
+   * \returns The index of the tag in the array, or #m_used if
+   *          the list has no tag of type \pname{tid}.
+   */
+  uint32_t Find (TypeId tid) const;
+  /**
+   * Copy the tags of the list to a new array, which the list
+   * then references alone.
+   *
+   * \param [in] size The number of tags the new array must hold.
+   */
+  void Unshare (uint32_t size);
+  /**
+   * Allocate an array of tags.
+   *
+   * \param [in] size The number of tags to hold.
+   * \returns The array, with a count of one.
+   */
+  static struct Data *Allocate (uint32_t size);
+  /**
+   * Release a reference to an array of tags, and free it
+   * when this was the last one.
+   *
+   * \param [in] data The array.
+   */
+  static void Deallocate (struct Data *data);
+
+  struct Data *m_data;  //!< The array of tags, or 0 if there are none.
+  uint32_t m_used;      //!< Number of tags of #m_data in this list.
+  uint32_t m_mask;      //!< Union of GetMask() of the tags of this list.
+};
+
+} // namespace ns3
+
+/****************************************************
+ *  Implementation of inline methods for performance
+ ****************************************************/
+
+namespace ns3 {
+
+PacketTagList::PacketTagList ()
+  : m_data (0),
+    m_used (0),
+    m_mask (0)
+{
+}
+
+PacketTagList::PacketTagList (PacketTagList const &o)
+  : m_data (o.m_data),
+    m_used (o.m_used),
+    m_mask (o.m_mask)
+{
+  if (m_data != 0)
+    {
+      m_data->m_count++;
+    }
+}
+
+PacketTagList &
+PacketTagList::operator = (PacketTagList const &o)
+{
+  // self assignment
+  if (this == &o) 
+    {
+      return *this;
+    }
+  if (o.m_data != 0)
+    {
+      o.m_data->m_count++;
+    }
+  RemoveAll ();
+  m_data = o.m_data;
+  m_used = o.m_used;
+  m_mask = o.m_mask;
+  return *this;
+}
+
+PacketTagList::~PacketTagList ()
+{
+  RemoveAll ();
+}
+
+void
+PacketTagList::RemoveAll (void)
+{
+  if (m_data != 0)
+    {
+      Deallocate (m_data);
+      m_data = 0;
+    }
+  m_used = 0;
+  m_mask = 0;
+}
+
+uint32_t
+PacketTagList::GetMask (TypeId tid)
+{
+  return 1U << (tid.GetUid () & 31);
+}
+
+} // namespace ns3
+
+#endif /* PACKET_TAG_LIST_H */
@@ -0,0 +1,168 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TIMING_WHEEL_SCHEDULER_H
+#define TIMING_WHEEL_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::TimingWheelScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a hierarchical timing wheel event scheduler
+ *
+ * This scheduler is designed for simulations with many timers which
+ * are cancelled before they expire, such as transport retransmission
+ * timers, or neighbor cache and routing protocol timers.
+ *
+ * The event list is made of 8 wheels of 256 slots each, one wheel for
+ * each byte of the 64-bit event timestamps.  An event is stored in the
+ * wheel of the most significant byte in which its timestamp differs from
+ * the time of the last event removed, in the slot given by the value of
+ * that byte.  All the events of a slot of the first wheel thus have the
+ * same timestamp, and are kept ordered by uid.  When the first wheel is
+ * empty, the first occupied slot of the next non-empty wheel is
+ * redistributed ("cascaded") to the lower wheels.
+ *
+ * - Insert is constant time;
+ * - RemoveNext is constant time, amortized over the cascades;
+ * - Remove is constant time, and actually removes the event from the
+ *   event list.  This scheduler thus reports IsRemoveFast, so that the
+ *   simulator removes cancelled events right away rather than keeping
+ *   them until they expire.
+ * - PeekNext is constant time, except for the first call after the
+ *   next event was removed while the first wheel is empty, which scans
+ *   the first occupied slot of the upper wheels.
+ *
+ * The event entries are recycled through an internal free list, and
+ * each event links to its entry through EventImpl::SetSchedulerLink, so
+ * that neither Insert nor Remove allocates memory in the steady state.
+ */
+class TimingWheelScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  TimingWheelScheduler ();
+  /** Destructor. */
+  virtual ~TimingWheelScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+  virtual bool IsRemoveFast (void) const;
+
+private:
+  /** Number of timestamp bits handled by each wheel. */
+  static const uint32_t SLOT_BITS = 8;
+  /** Number of slots of each wheel. */
+  static const uint32_t SLOTS = 1 << SLOT_BITS;
+  /** Number of wheels. */
+  static const uint32_t LEVELS = 64 / SLOT_BITS;
+  /** Number of 64-bit words in the occupancy bitmap of a wheel. */
+  static const uint32_t WORDS = SLOTS / 64;
+  /** Number of entries allocated at once. */
+  static const uint32_t CHUNK = 1024;
+
+  /** An entry of the event list. */
+  struct Node
+  {
+    Scheduler::Event ev;  /**< The event. */
+    Node *prev;           /**< Previous entry in the slot. */
+    Node *next;           /**< Next entry in the slot. */
+    uint8_t level;        /**< The wheel of the entry. */
+    uint8_t slot;         /**< The slot of the entry. */
+  };
+  /** A slot: a doubly-linked list of entries. */
+  struct Slot
+  {
+    Node *head;           /**< First entry. */
+    Node *tail;           /**< Last entry. */
+  };
+
+  /**
+   * Add an entry to the slot matching its timestamp.
+   * \param [in] node The entry.
+   */
+  void Link (Node *node);
+  /**
+   * Take an entry out of its slot.
+   * \param [in] node The entry.
+   */
+  void Unlink (Node *node);
+  /**
+   * \returns The first wheel with an entry.
+   */
+  uint32_t FirstLevel (void) const;
+  /**
+   * Find the first occupied slot of a non-empty wheel.
+   * \param [in] level The wheel.
+   * \returns The slot index.
+   */
+  uint32_t FirstSlot (uint32_t level) const;
+  /** Cascade the upper wheels until the first wheel has an entry. */
+  void Cascade (void);
+  /**
+   * Get a free entry.
+   * \returns The entry.
+   */
+  Node * AllocateNode (void);
+  /**
+   * Return an entry to the free list.
+   * \param [in] node The entry.
+   */
+  void FreeNode (Node *node);
+
+  /** The wheels. */
+  Slot m_slots[LEVELS][SLOTS];
+  /** The occupied slots of each wheel, one bit per slot. */
+  uint64_t m_occupied[LEVELS][WORDS];
+  /** The number of entries in each wheel. */
+  uint32_t m_levelCount[LEVELS];
+  /** The time the wheels are relative to: no entry is earlier. */
+  uint64_t m_now;
+  /** The number of entries. */
+  uint32_t m_count;
+  /** The entry of the next event, or 0 if not known yet. */
+  mutable const Node *m_next;
+  /** The blocks of entries allocated so far. */
+  std::vector<Node *> m_chunks;
+  /** The free entries. */
+  Node *m_free;
+};
+
+} // namespace ns3
+
+#endif /* TIMING_WHEEL_SCHEDULER_H */
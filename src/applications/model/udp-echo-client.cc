@@ -299,7 +299,7 @@ UdpEchoClient::Send (void)
       //
       NS_ASSERT_MSG (m_dataSize == m_size, "UdpEchoClient::Send(): m_size and m_dataSize inconsistent");
       NS_ASSERT_MSG (m_data, "UdpEchoClient::Send(): m_dataSize but no m_data");
-      p = Create<Packet> (m_data, m_dataSize);
+      p = Packet::CreatePayload (m_data, m_dataSize);
     }
   else
     {
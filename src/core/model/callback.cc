@@ -20,17 +20,57 @@
 
 #include "callback.h"
 #include "log.h"
+#include <cstring>
+#include <sstream>
 
 /**
  * \file
  * \ingroup callback
- * ns3::CallbackValue implementation.
+ * ns3::CallbackBase and ns3::CallbackValue implementations.
  */
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Callback");
 
+std::string
+CallbackBase::GetIdentity (void) const
+{
+  std::ostringstream oss;
+  if (m_makeImpl == 0)
+    {
+      oss << PeekPointer (m_impl);
+      return oss.str ();
+    }
+  // The padding of the inline data is zeroed when it is stored.
+  uintptr_t words[sizeof (CallbackStorage) / sizeof (uintptr_t)];
+  std::memcpy (words, &m_storage, sizeof (words));
+  oss << std::hex << "0x" << reinterpret_cast<uintptr_t> (m_invoke);
+  for (uint32_t i = 0; i < sizeof (words) / sizeof (words[0]); i++)
+    {
+      oss << ":" << words[i];
+    }
+  return oss.str ();
+}
+
+bool
+CallbackBase::DoIsEqual (const CallbackBase &other) const
+{
+  if (m_makeImpl != 0 && other.m_makeImpl != 0)
+    {
+      // The padding of the inline data is zeroed when it is stored.
+      return m_invoke == other.m_invoke &&
+             std::memcmp (&m_storage, &other.m_storage, sizeof (CallbackStorage)) == 0;
+    }
+  Ptr<CallbackImplBase> impl = GetImpl ();
+  Ptr<CallbackImplBase> otherImpl = other.GetImpl ();
+  if (impl == 0 || otherImpl == 0)
+    {
+      return impl == otherImpl;
+    }
+  return impl->IsEqual (otherImpl);
+}
+
 CallbackValue::CallbackValue ()
   : m_value ()
 {
@@ -61,9 +101,7 @@ std::string
 CallbackValue::SerializeToString (Ptr<const AttributeChecker> checker) const
 {
   NS_LOG_FUNCTION (this << checker);
-  std::ostringstream oss;
-  oss << PeekPointer (m_value.GetImpl ());
-  return oss.str ();
+  return m_value.GetIdentity ();
 }
 bool
 CallbackValue::DeserializeFromString (std::string value, Ptr<const AttributeChecker> checker)
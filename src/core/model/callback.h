@@ -28,7 +28,9 @@
 #include "attribute.h"
 #include "attribute-helper.h"
 #include "simple-ref-count.h"
+#include <new>
 #include <typeinfo>
+#include <type_traits>
 
 /**
  * \file
@@ -183,6 +185,12 @@ protected:
   }
 };
 
+/**
+ * \ingroup callbackimpl
+ * Inline storage of the small callbacks, see CallbackBase.
+ */
+typedef std::aligned_storage<4 * sizeof (void *)>::type CallbackStorage;
+
 /**
  * \ingroup callbackimpl
  * The unqualified CallbackImpl class
@@ -202,6 +210,8 @@ class CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> : pu
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (void) = 0;      //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -221,6 +231,8 @@ class CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> : publi
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1) = 0;        //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -241,6 +253,8 @@ class CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> : public C
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2) = 0;    //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -262,6 +276,8 @@ class CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> : public Call
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2, T3) = 0;  //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2, T3);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -284,6 +300,8 @@ class CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> : public Callbac
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2, T3, T4) = 0;  //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2, T3, T4);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -307,6 +325,8 @@ class CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> : public CallbackIm
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2, T3, T4, T5) = 0;  //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2, T3, T4, T5);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -331,6 +351,8 @@ class CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> : public CallbackImplB
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2, T3, T4, T5, T6) = 0;  //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2, T3, T4, T5, T6);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -356,6 +378,8 @@ class CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,empty,empty> : public CallbackImplBase
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2, T3, T4, T5, T6, T7) = 0;  //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2, T3, T4, T5, T6, T7);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -382,6 +406,8 @@ class CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,empty> : public CallbackImplBase {
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2, T3, T4, T5, T6, T7, T8) = 0;  //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2, T3, T4, T5, T6, T7, T8);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -409,6 +435,8 @@ class CallbackImpl : public CallbackImplBase {
 public:
   virtual ~CallbackImpl () {}
   virtual R operator() (T1, T2, T3, T4, T5, T6, T7, T8, T9) = 0;  //!< Abstract operator
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef R (*Invoker)(const CallbackStorage &, T1, T2, T3, T4, T5, T6, T7, T8, T9);
   virtual std::string GetTypeid (void) const
   {
     return DoGetTypeid ();
@@ -1096,23 +1124,569 @@ private:
   typename TypeTraits<TX3>::ReferencedType m_a3;  //!< third bound argument
 };
 
+/**
+ * \ingroup callbackimpl
+ * Trait class to tell whether a functor can be stored inline in a
+ * Callback: it must be trivially copyable, and fit in CallbackStorage.
+ * By default, only function pointers are stored inline.
+ */
+template <typename T>
+struct CallbackInlineTraits
+{
+  /** \c true if the functor is stored inline. */
+  static const bool IsInline =
+    std::is_pointer<T>::value &&
+    std::is_function<typename std::remove_pointer<T>::type>::value;
+};
+
+/**
+ * \ingroup callbackimpl
+ * Invoke a functor stored inline in a Callback, and rebuild the
+ * equivalent FunctorCallbackImpl on demand.
+ */
+template <typename T, typename R, typename T1, typename T2, typename T3, typename T4,typename T5, typename T6, typename T7, typename T8, typename T9>
+class FunctorCallbackThunk {
+public:
+  /**
+   * Store a functor.
+   * \param [out] s The inline storage
+   * \param [in] functor The functor
+   */
+  static void Store (CallbackStorage &s, T const &functor) {
+    static_assert (sizeof (T) <= sizeof (CallbackStorage) &&
+                   std::alignment_of<T>::value <= std::alignment_of<CallbackStorage>::value &&
+                   std::is_trivially_copyable<T>::value,
+                   "The functor cannot be stored in CallbackStorage");
+    // Zero the padding, so that CallbackBase::GetIdentity is stable.
+    s = CallbackStorage ();
+    new (&s) T (functor);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \return A FunctorCallbackImpl for the stored functor
+   */
+  static Ptr<CallbackImplBase> MakeImpl (const CallbackStorage &s) {
+    return Create<FunctorCallbackImpl<T,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (Get (s));
+  }
+  /**
+   * Functor with varying numbers of arguments
+   * @{
+   */
+  /**
+   * \param [in] s The inline storage
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s) {
+    return Get (s) ();
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1) {
+    return Get (s) (a1);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2) {
+    return Get (s) (a1, a2);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3) {
+    return Get (s) (a1, a2, a3);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4) {
+    return Get (s) (a1, a2, a3, a4);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5) {
+    return Get (s) (a1, a2, a3, a4, a5);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6) {
+    return Get (s) (a1, a2, a3, a4, a5, a6);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7) {
+    return Get (s) (a1, a2, a3, a4, a5, a6, a7);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \param [in] a8 Eighth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8) {
+    return Get (s) (a1, a2, a3, a4, a5, a6, a7, a8);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \param [in] a8 Eighth argument
+   * \param [in] a9 Ninth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8,T9 a9) {
+    return Get (s) (a1, a2, a3, a4, a5, a6, a7, a8, a9);
+  }
+  /**@}*/
+private:
+  /**
+   * \param [in] s The inline storage
+   * \return The stored functor
+   */
+  static T const & Get (const CallbackStorage &s) {
+    return *reinterpret_cast<T const *> (&s);
+  }
+};
+
+/**
+ * \ingroup makecallbackmemptr
+ * Invoke a member function on a raw object pointer stored inline in
+ * a Callback, and rebuild the equivalent MemPtrCallbackImpl on demand.
+ */
+template <typename OBJ_PTR, typename MEM_PTR, typename R, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7, typename T8, typename T9>
+class MemPtrCallbackThunk {
+public:
+  /** The inline data. */
+  struct Data {
+    OBJ_PTR objPtr;                     //!< the object pointer
+    MEM_PTR memPtr;                     //!< the member function pointer
+  };
+  /**
+   * Store an object pointer and member function pointer
+   * \param [out] s The inline storage
+   * \param [in] objPtr The object pointer
+   * \param [in] memPtr The object class member function
+   */
+  static void Store (CallbackStorage &s, OBJ_PTR objPtr, MEM_PTR memPtr) {
+    static_assert (sizeof (Data) <= sizeof (CallbackStorage) &&
+                   std::alignment_of<Data>::value <= std::alignment_of<CallbackStorage>::value &&
+                   std::is_trivially_copyable<Data>::value,
+                   "The pointers cannot be stored in CallbackStorage");
+    // Zero the padding, so that CallbackBase::GetIdentity is stable.
+    s = CallbackStorage ();
+    Data *data = new (&s) Data;
+    data->objPtr = objPtr;
+    data->memPtr = memPtr;
+  }
+  /**
+   * \param [in] s The inline storage
+   * \return A MemPtrCallbackImpl for the stored pointers
+   */
+  static Ptr<CallbackImplBase> MakeImpl (const CallbackStorage &s) {
+    return Create<MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (Get (s).objPtr, Get (s).memPtr);
+  }
+  /**
+   * Functor with varying numbers of arguments
+   * @{
+   */
+  /**
+   * \param [in] s The inline storage
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)();
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2,a3);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2,a3,a4);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2,a3,a4,a5);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2,a3,a4,a5,a6);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2,a3,a4,a5,a6,a7);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \param [in] a8 Eighth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2,a3,a4,a5,a6,a7,a8);
+  }
+  /**
+   * \param [in] s The inline storage
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \param [in] a8 Eighth argument
+   * \param [in] a9 Ninth argument
+   * \return Callback value
+   */
+  static R Invoke (const CallbackStorage &s, T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8,T9 a9) {
+    return ((*Get (s).objPtr).*Get (s).memPtr)(a1,a2,a3,a4,a5,a6,a7,a8,a9);
+  }
+  /**@}*/
+private:
+  /**
+   * \param [in] s The inline storage
+   * \return The stored pointers
+   */
+  static Data const & Get (const CallbackStorage &s) {
+    return *reinterpret_cast<Data const *> (&s);
+  }
+};
+
+/**
+ * \ingroup makeboundcallback
+ * Functor calling a function pointer with its first argument bound,
+ * used by MakeBoundCallback.  When the bound argument is a scalar, the
+ * functor is stored inline in the Callback.
+ */
+template <typename FN, typename TX, typename R, typename T1, typename T2, typename T3, typename T4,typename T5, typename T6, typename T7, typename T8>
+class BoundFunctionCallbackFunctor {
+public:
+  /**
+   * Construct from a function pointer and a bound argument
+   * \param [in] fnPtr The function pointer
+   * \param [in] a The argument to bind
+   */
+  template <typename ARG>
+  BoundFunctionCallbackFunctor (FN fnPtr, ARG a)
+    : m_fnPtr (fnPtr), m_a (a) {}
+  /**
+   * Functor with varying numbers of arguments
+   * @{
+   */
+  /** \return Callback value */
+  R operator() (void) const {
+    return m_fnPtr (m_a);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \return Callback value
+   */
+  R operator() (T1 a1) const {
+    return m_fnPtr (m_a,a1);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \return Callback value
+   */
+  R operator() (T1 a1,T2 a2) const {
+    return m_fnPtr (m_a,a1,a2);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \return Callback value
+   */
+  R operator() (T1 a1,T2 a2,T3 a3) const {
+    return m_fnPtr (m_a,a1,a2,a3);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \return Callback value
+   */
+  R operator() (T1 a1,T2 a2,T3 a3,T4 a4) const {
+    return m_fnPtr (m_a,a1,a2,a3,a4);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \return Callback value
+   */
+  R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5) const {
+    return m_fnPtr (m_a,a1,a2,a3,a4,a5);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \return Callback value
+   */
+  R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6) const {
+    return m_fnPtr (m_a,a1,a2,a3,a4,a5,a6);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \return Callback value
+   */
+  R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7) const {
+    return m_fnPtr (m_a,a1,a2,a3,a4,a5,a6,a7);
+  }
+  /**
+   * \param [in] a1 First argument
+   * \param [in] a2 Second argument
+   * \param [in] a3 Third argument
+   * \param [in] a4 Fourth argument
+   * \param [in] a5 Fifth argument
+   * \param [in] a6 Sixth argument
+   * \param [in] a7 Seventh argument
+   * \param [in] a8 Eighth argument
+   * \return Callback value
+   */
+  R operator() (T1 a1,T2 a2,T3 a3,T4 a4,T5 a5,T6 a6,T7 a7,T8 a8) const {
+    return m_fnPtr (m_a,a1,a2,a3,a4,a5,a6,a7,a8);
+  }
+  /**@}*/
+  /**
+   * Inequality test.
+   *
+   * \param [in] other The other functor
+   * \return \c true if the functors call different functions, or
+   *         bind different arguments
+   */
+  bool operator != (BoundFunctionCallbackFunctor const &other) const {
+    return m_fnPtr != other.m_fnPtr || m_a != other.m_a;
+  }
+private:
+  FN m_fnPtr;                                   //!< the function pointer
+  /** The bound argument; mutable, as it may be passed by reference. */
+  mutable typename TypeTraits<TX>::ReferencedType m_a;
+};
+
+/**
+ * \ingroup makeboundcallback
+ * Specialization of CallbackInlineTraits: a function pointer with
+ * a bound scalar argument is stored inline, unless the argument is
+ * passed by non-const reference: the changes to the argument must
+ * then be seen by all the copies of the callback.
+ */
+template <typename FN, typename TX, typename R, typename T1, typename T2, typename T3, typename T4,typename T5, typename T6, typename T7, typename T8>
+struct CallbackInlineTraits<BoundFunctionCallbackFunctor<FN,TX,R,T1,T2,T3,T4,T5,T6,T7,T8> >
+{
+  /** \c true if the functor is stored inline. */
+  static const bool IsInline =
+    std::is_scalar<typename TypeTraits<TX>::ReferencedType>::value &&
+    !(std::is_reference<TX>::value &&
+      !std::is_const<typename std::remove_reference<TX>::type>::value) &&
+    sizeof (BoundFunctionCallbackFunctor<FN,TX,R,T1,T2,T3,T4,T5,T6,T7,T8>) <= sizeof (CallbackStorage);
+};
+
 /**
  * \ingroup callbackimpl
  * Base class for Callback class.
  * Provides pimpl abstraction.
+ *
+ * The callbacks to a member function of a raw object pointer, to a
+ * function pointer, and to a function pointer with a bound scalar
+ * argument are not allocated: they are kept inline, in m_storage,
+ * and invoked through the m_invoke function pointer, so that copying
+ * them does not touch a reference count, and invoking them does not
+ * go through a virtual call.  GetImpl builds a new equivalent pimpl on
+ * each call for them: use GetIdentity, not the address of that pimpl,
+ * to identify such a callback.  The comparisons between them do not
+ * build any pimpl.
  */
 class CallbackBase {
 public:
-  CallbackBase () : m_impl () {}
-  /** \return The impl pointer */
-  Ptr<CallbackImplBase> GetImpl (void) const { return m_impl; }
+  CallbackBase () : m_impl (), m_invoke (0), m_makeImpl (0), m_getTypeid (0) {}
+  /**
+   * \return The impl pointer.  For the callbacks stored inline, this
+   *         is a new impl equivalent to the callback.
+   */
+  Ptr<CallbackImplBase> GetImpl (void) const {
+    if (m_makeImpl != 0)
+      {
+        return m_makeImpl (m_storage);
+      }
+    return m_impl;
+  }
+  /**
+   * \return A string which identifies the target of the callback, and
+   *         is the same for all its copies: the address of the pimpl,
+   *         or, for the callbacks stored inline, the address of their
+   *         Invoke function followed by the inline data.
+   */
+  std::string GetIdentity (void) const;
 protected:
   /**
    * Construct from a pimpl
    * \param [in] impl The CallbackImplBase Ptr
    */
-  CallbackBase (Ptr<CallbackImplBase> impl) : m_impl (impl) {}
-  Ptr<CallbackImplBase> m_impl;         //!< the pimpl
+  CallbackBase (Ptr<CallbackImplBase> impl) : m_impl (impl), m_invoke (0), m_makeImpl (0), m_getTypeid (0) {}
+  /** Type-erased pointer to the Invoke function of an inline callback. */
+  typedef void (*Invoke)(void);
+  /** Pointer to the MakeImpl function of an inline callback. */
+  typedef Ptr<CallbackImplBase> (*MakeImpl)(const CallbackStorage &);
+  /** Pointer to the CallbackImpl::DoGetTypeid function of an inline callback. */
+  typedef std::string (*GetTypeid)(void);
+
+  /**
+   * Equality test, which builds a pimpl only to compare an inline
+   * callback with a callback which is not.
+   *
+   * \param [in] other Callback
+   * \return \c true if we are equal
+   */
+  bool DoIsEqual (const CallbackBase &other) const;
+  /**
+   * \param [in] other Callback
+   * \return The CallbackImpl::DoGetTypeid function of the signature
+   *         of \p other if it is stored inline, else 0.
+   */
+  static GetTypeid PeekTypeid (const CallbackBase &other) {
+    return other.m_getTypeid;
+  }
+  /**
+   * \param [in] other Callback
+   * \return The pimpl of \p other, which is 0 if it is stored inline.
+   */
+  static Ptr<CallbackImplBase> PeekImpl (const CallbackBase &other) {
+    return other.m_impl;
+  }
+
+  Ptr<CallbackImplBase> m_impl;         //!< the pimpl, if not inline
+  CallbackStorage m_storage;            //!< the inline callback
+  Invoke m_invoke;                      //!< invoke the inline callback
+  MakeImpl m_makeImpl;                  //!< build a pimpl for the inline callback
+  GetTypeid m_getTypeid;                //!< get the signature of the inline callback
 };
 
 /**
@@ -1188,8 +1762,9 @@ public:
    */
   template <typename FUNCTOR>
   Callback (FUNCTOR const &functor, bool, bool) 
-    : CallbackBase (Create<FunctorCallbackImpl<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (functor))
-  {}
+  {
+    DoSetFunctor (functor, std::integral_constant<bool, CallbackInlineTraits<FUNCTOR>::IsInline> ());
+  }
 
   /**
    * Construct a member function pointer call back.
@@ -1199,8 +1774,9 @@ public:
    */
   template <typename OBJ_PTR, typename MEM_PTR>
   Callback (OBJ_PTR const &objPtr, MEM_PTR memPtr)
-    : CallbackBase (Create<MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (objPtr, memPtr))
-  {}
+  {
+    DoSetMemPtr (objPtr, memPtr, std::is_pointer<OBJ_PTR> ());
+  }
 
   /**
    * Construct from a CallbackImpl pointer
@@ -1268,11 +1844,14 @@ public:
    * \return \c true if I don't have an implementation
    */
   bool IsNull (void) const {
-    return (DoPeekImpl () == 0) ? true : false;
+    return (m_invoke == 0 && DoPeekImpl () == 0) ? true : false;
   }
   /** Discard the implementation, set it to null */
   void Nullify (void) {
     m_impl = 0;
+    m_invoke = 0;
+    m_makeImpl = 0;
+    m_getTypeid = 0;
   }
 
   /**
@@ -1281,6 +1860,10 @@ public:
    */
   /** \return Callback value */
   R operator() (void) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage);
+      }
     return (*(DoPeekImpl ()))();
   }
   /**
@@ -1288,6 +1871,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1);
+      }
     return (*(DoPeekImpl ()))(a1);
   }
   /**
@@ -1296,6 +1883,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2);
+      }
     return (*(DoPeekImpl ()))(a1,a2);
   }
   /**
@@ -1305,6 +1896,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2, T3 a3) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2,a3);
+      }
     return (*(DoPeekImpl ()))(a1,a2,a3);
   }
   /**
@@ -1315,6 +1910,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2,a3,a4);
+      }
     return (*(DoPeekImpl ()))(a1,a2,a3,a4);
   }
   /**
@@ -1326,6 +1925,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2,a3,a4,a5);
+      }
     return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5);
   }
   /**
@@ -1338,6 +1941,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2,a3,a4,a5,a6);
+      }
     return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6);
   }
   /**
@@ -1351,6 +1958,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2,a3,a4,a5,a6,a7);
+      }
     return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7);
   }
   /**
@@ -1365,6 +1976,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7,T8 a8) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2,a3,a4,a5,a6,a7,a8);
+      }
     return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7,a8);
   }
   /**
@@ -1380,6 +1995,10 @@ public:
    * \return Callback value
    */
   R operator() (T1 a1, T2 a2, T3 a3, T4 a4,T5 a5,T6 a6,T7 a7,T8 a8, T9 a9) const {
+    if (m_invoke != 0)
+      {
+        return reinterpret_cast<Invoker> (m_invoke)(m_storage,a1,a2,a3,a4,a5,a6,a7,a8,a9);
+      }
     return (*(DoPeekImpl ()))(a1,a2,a3,a4,a5,a6,a7,a8,a9);
   }
   /**@}*/
@@ -1391,7 +2010,7 @@ public:
    * \return \c true if we are equal
    */
   bool IsEqual (const CallbackBase &other) const {
-    return m_impl->IsEqual (other.GetImpl ());
+    return DoIsEqual (other);
   }
 
   /**
@@ -1401,7 +2020,12 @@ public:
    * \return \c true if other can be dynamic_cast to my type
    */
   bool CheckType (const CallbackBase & other) const {
-    return DoCheckType (other.GetImpl ());
+    GetTypeid getTypeid = PeekTypeid (other);
+    if (getTypeid != 0)
+      {
+        return DoCheckType (getTypeid);
+      }
+    return DoCheckType (PeekImpl (other));
   }
   /**
    * Adopt the other's implementation, if type compatible
@@ -1410,9 +2034,70 @@ public:
    * \returns \c true if \p other was type-compatible and could be adopted.
    */
   bool Assign (const CallbackBase &other) {
-    return DoAssign (other.GetImpl ());
+    GetTypeid getTypeid = PeekTypeid (other);
+    if (getTypeid != 0 && !DoCheckType (getTypeid))
+      {
+        std::string othTid = getTypeid ();
+        std::string myTid = CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>::DoGetTypeid ();
+        NS_FATAL_ERROR_CONT ("Incompatible types. (feed to \"c++filt -t\" if needed)" << std::endl <<
+                        "got=" << othTid << std::endl <<
+                        "expected=" << myTid);
+        return false;
+      }
+    if (getTypeid == 0 && !DoAssign (PeekImpl (other)))
+      {
+        return false;
+      }
+    // Keep the inline representation of other, if any.
+    CallbackBase::operator = (other);
+    return true;
   }
 private:
+  /** Signature of the Invoke functions of the callbacks stored inline. */
+  typedef typename CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>::Invoker Invoker;
+
+  /**
+   * Store a functor inline.
+   * \param [in] functor The functor
+   */
+  template <typename FUNCTOR>
+  void DoSetFunctor (FUNCTOR const &functor, std::true_type) {
+    typedef FunctorCallbackThunk<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> Thunk;
+    Thunk::Store (m_storage, functor);
+    m_invoke = reinterpret_cast<Invoke> (static_cast<Invoker> (&Thunk::Invoke));
+    m_makeImpl = &Thunk::MakeImpl;
+    m_getTypeid = &CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>::DoGetTypeid;
+  }
+  /**
+   * Allocate a pimpl for a functor which cannot be stored inline.
+   * \param [in] functor The functor
+   */
+  template <typename FUNCTOR>
+  void DoSetFunctor (FUNCTOR const &functor, std::false_type) {
+    m_impl = Create<FunctorCallbackImpl<FUNCTOR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (functor);
+  }
+  /**
+   * Store a raw object pointer and a member function pointer inline.
+   * \param [in] objPtr Pointer to the object
+   * \param [in] memPtr Pointer to the member function
+   */
+  template <typename OBJ_PTR, typename MEM_PTR>
+  void DoSetMemPtr (OBJ_PTR const &objPtr, MEM_PTR memPtr, std::true_type) {
+    typedef MemPtrCallbackThunk<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> Thunk;
+    Thunk::Store (m_storage, objPtr, memPtr);
+    m_invoke = reinterpret_cast<Invoke> (static_cast<Invoker> (&Thunk::Invoke));
+    m_makeImpl = &Thunk::MakeImpl;
+    m_getTypeid = &CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>::DoGetTypeid;
+  }
+  /**
+   * Allocate a pimpl for a smart object pointer and a member function pointer.
+   * \param [in] objPtr Pointer to the object
+   * \param [in] memPtr Pointer to the member function
+   */
+  template <typename OBJ_PTR, typename MEM_PTR>
+  void DoSetMemPtr (OBJ_PTR const &objPtr, MEM_PTR memPtr, std::false_type) {
+    m_impl = Create<MemPtrCallbackImpl<OBJ_PTR,MEM_PTR,R,T1,T2,T3,T4,T5,T6,T7,T8,T9> > (objPtr, memPtr);
+  }
   /** \return The pimpl pointer */
   CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *DoPeekImpl (void) const {
     return static_cast<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> *> (PeekPointer (m_impl));
@@ -1438,6 +2123,18 @@ private:
         return false;
       }
   }
+  /**
+   * Check for compatible types with an inline callback
+   *
+   * \param [in] getTypeid The CallbackImpl::DoGetTypeid function of
+   *             the signature of the other callback
+   * \return \c true if the other callback has my signature
+   */
+  bool DoCheckType (GetTypeid getTypeid) const {
+    GetTypeid mine = &CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,T9>::DoGetTypeid;
+    // The same signature may have several copies of the function.
+    return getTypeid == mine || getTypeid () == mine ();
+  }
   /** \copydoc Assign */
   bool DoAssign (Ptr<const CallbackImplBase> other) {
     if (!DoCheckType (other))
@@ -1684,65 +2381,56 @@ Callback<R,T1,T2,T3,T4,T5,T6,T7,T8,T9> MakeNullCallback (void) {
  */   
 template <typename R, typename TX, typename ARG>
 Callback<R> MakeBoundCallback (R (*fnPtr)(TX), ARG a1) {
-  Ptr<CallbackImpl<R,empty,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX),R,TX,empty,empty,empty,empty,empty,empty,empty,empty> >(fnPtr, a1);
-  return Callback<R> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX),TX,R,empty,empty,empty,empty,empty,empty,empty,empty> functor (fnPtr, a1);
+  return Callback<R> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG, 
           typename T1>
 Callback<R,T1> MakeBoundCallback (R (*fnPtr)(TX,T1), ARG a1) {
-  Ptr<CallbackImpl<R,T1,empty,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1),R,TX,T1,empty,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1),TX,R,T1,empty,empty,empty,empty,empty,empty,empty> functor (fnPtr, a1);
+  return Callback<R,T1> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG, 
           typename T1, typename T2>
 Callback<R,T1,T2> MakeBoundCallback (R (*fnPtr)(TX,T1,T2), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,empty,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2),R,TX,T1,T2,empty,empty,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1,T2),TX,R,T1,T2,empty,empty,empty,empty,empty,empty> functor (fnPtr, a1);
+  return Callback<R,T1,T2> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3>
 Callback<R,T1,T2,T3> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,empty,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3),R,TX,T1,T2,T3,empty,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1,T2,T3),TX,R,T1,T2,T3,empty,empty,empty,empty,empty> functor (fnPtr, a1);
+  return Callback<R,T1,T2,T3> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4>
 Callback<R,T1,T2,T3,T4> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,empty,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4),R,TX,T1,T2,T3,T4,empty,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1,T2,T3,T4),TX,R,T1,T2,T3,T4,empty,empty,empty,empty> functor (fnPtr, a1);
+  return Callback<R,T1,T2,T3,T4> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5>
 Callback<R,T1,T2,T3,T4,T5> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,empty,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5),R,TX,T1,T2,T3,T4,T5,empty,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1,T2,T3,T4,T5),TX,R,T1,T2,T3,T4,T5,empty,empty,empty> functor (fnPtr, a1);
+  return Callback<R,T1,T2,T3,T4,T5> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6>
 Callback<R,T1,T2,T3,T4,T5,T6> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,empty,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6),R,TX,T1,T2,T3,T4,T5,T6,empty,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5,T6> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1,T2,T3,T4,T5,T6),TX,R,T1,T2,T3,T4,T5,T6,empty,empty> functor (fnPtr, a1);
+  return Callback<R,T1,T2,T3,T4,T5,T6> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7>
 Callback<R,T1,T2,T3,T4,T5,T6,T7> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6,T7), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,empty,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7),R,TX,T1,T2,T3,T4,T5,T6,T7,empty> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5,T6,T7> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1,T2,T3,T4,T5,T6,T7),TX,R,T1,T2,T3,T4,T5,T6,T7,empty> functor (fnPtr, a1);
+  return Callback<R,T1,T2,T3,T4,T5,T6,T7> (functor, true, true);
 }
 template <typename R, typename TX, typename ARG,
           typename T1, typename T2,typename T3,typename T4,typename T5, typename T6, typename T7, typename T8>
 Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> MakeBoundCallback (R (*fnPtr)(TX,T1,T2,T3,T4,T5,T6,T7,T8), ARG a1) {
-  Ptr<CallbackImpl<R,T1,T2,T3,T4,T5,T6,T7,T8,empty> > impl =
-    Create<BoundFunctorCallbackImpl<R (*)(TX,T1,T2,T3,T4,T5,T6,T7,T8),R,TX,T1,T2,T3,T4,T5,T6,T7,T8> > (fnPtr, a1);
-  return Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> (impl);
+  BoundFunctionCallbackFunctor<R (*)(TX,T1,T2,T3,T4,T5,T6,T7,T8),TX,R,T1,T2,T3,T4,T5,T6,T7,T8> functor (fnPtr, a1);
+  return Callback<R,T1,T2,T3,T4,T5,T6,T7,T8> (functor, true, true);
 }
 /**@}*/
 
@@ -0,0 +1,556 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "checkpoint.h"
+#include "simulator.h"
+#include "simulator-impl.h"
+#include "make-event.h"
+#include "system-mutex.h"
+#include "random-variable-stream.h"
+#include "rng-stream.h"
+#include "rng-seed-manager.h"
+#include "type-id.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "string.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("Checkpoint");
+
+namespace {
+
+/** The start of a checkpoint file. */
+const char MAGIC[8] = { 'n', 's', '3', 'c', 'k', 'p', 't', '\0' };
+/** The version of the checkpoint file format. */
+const uint32_t VERSION = 1;
+
+/**
+ * \ingroup simulator
+ * An event scheduled with Checkpoint::Schedule, not yet expired.
+ */
+struct PendingEvent
+{
+  std::string name;   //!< The name of the event.
+  uint32_t context;   //!< The context of the event.
+  Time time;          //!< The expiration time of the event.
+  Ptr<EventImpl> impl; //!< The event, to check if it was cancelled.
+};
+
+/** The smallest number of pending events which triggers a purge. */
+const std::size_t MIN_PURGE_SIZE = 64;
+
+/**
+ * \ingroup simulator
+ * The registrations of the Checkpoint.
+ */
+struct Registry
+{
+  Registry () : nextKey (0), purgeSize (MIN_PURGE_SIZE), clearScheduled (false) {}
+  /** The Objects whose attributes are saved, by name. */
+  std::map<std::string, Ptr<Object> > objects;
+  /** The callbacks of the events scheduled by name. */
+  std::map<std::string, Callback<void> > callbacks;
+  /** The events scheduled by name, by key. */
+  std::map<uint64_t, PendingEvent> pending;
+  /** The next key of the pending events. */
+  uint64_t nextKey;
+  /** The number of pending events above which the cancelled ones are purged. */
+  std::size_t purgeSize;
+  /** Is Checkpoint::Clear scheduled at Simulator::Destroy ? */
+  bool clearScheduled;
+};
+
+/**
+ * \ingroup simulator
+ * Get the registrations of the Checkpoint.
+ * \returns The registrations.
+ */
+Registry &
+GetRegistry (void)
+{
+  static Registry registry;
+  return registry;
+}
+
+/**
+ * \ingroup simulator
+ * Drop the pending events which were cancelled, or removed, and will
+ * thus never fire.
+ * \param [in,out] registry The registrations.
+ */
+void
+PurgeCancelled (Registry &registry)
+{
+  std::map<uint64_t, PendingEvent>::iterator i = registry.pending.begin ();
+  while (i != registry.pending.end ())
+    {
+      if (i->second.impl->IsCancelled ())
+        {
+          registry.pending.erase (i++);
+        }
+      else
+        {
+          ++i;
+        }
+    }
+  // Purge again when the number of events has doubled, so that the
+  // cost of the purges is constant per scheduled event.
+  registry.purgeSize = std::max (MIN_PURGE_SIZE, 2 * registry.pending.size ());
+}
+
+/**
+ * \ingroup simulator
+ * Write the binary checkpoint file.
+ */
+class Writer
+{
+public:
+  /**
+   * Open the file.
+   * \param [in] filename The file name.
+   */
+  Writer (std::string filename)
+    : m_os (filename.c_str (), std::ios::binary)
+  {
+    NS_ABORT_MSG_UNLESS (m_os, "Can not open checkpoint file \"" << filename << "\"");
+    m_os.write (MAGIC, sizeof (MAGIC));
+    U32 (VERSION);
+  }
+  /** \param [in] v The value to write. */
+  void U32 (uint32_t v)
+  {
+    U64 (v, 4);
+  }
+  /**
+   * \param [in] v The value to write, in little endian order.
+   * \param [in] bytes The number of bytes to write.
+   */
+  void U64 (uint64_t v, int bytes = 8)
+  {
+    for (int i = 0; i < bytes; i++)
+      {
+        m_os.put (static_cast<char> ((v >> (8 * i)) & 0xff));
+      }
+  }
+  /** \param [in] v The value to write. */
+  void Double (double v)
+  {
+    uint64_t bits;
+    std::memcpy (&bits, &v, sizeof (bits));
+    U64 (bits);
+  }
+  /** \param [in] s The string to write, after its length. */
+  void String (const std::string &s)
+  {
+    U32 (s.size ());
+    m_os.write (s.data (), s.size ());
+  }
+  /** \returns \c true if all the writes succeeded. */
+  bool Good (void)
+  {
+    m_os.flush ();
+    return m_os.good ();
+  }
+private:
+  std::ofstream m_os;  //!< The file.
+};
+
+/**
+ * \ingroup simulator
+ * Read the binary checkpoint file.
+ */
+class Reader
+{
+public:
+  /**
+   * Open the file, and check its header.
+   * \param [in] filename The file name.
+   */
+  Reader (std::string filename)
+    : m_is (filename.c_str (), std::ios::binary),
+      m_filename (filename)
+  {
+    NS_ABORT_MSG_UNLESS (m_is, "Can not open checkpoint file \"" << filename << "\"");
+    char magic[sizeof (MAGIC)];
+    m_is.read (magic, sizeof (magic));
+    NS_ABORT_MSG_UNLESS (m_is && std::memcmp (magic, MAGIC, sizeof (MAGIC)) == 0,
+                         "\"" << filename << "\" is not a checkpoint file");
+    uint32_t version = U32 ();
+    NS_ABORT_MSG_UNLESS (version == VERSION,
+                         "Unsupported version " << version <<
+                         " of checkpoint file \"" << filename << "\"");
+  }
+  /** \returns The value read. */
+  uint32_t U32 (void)
+  {
+    return static_cast<uint32_t> (U64 (4));
+  }
+  /**
+   * \param [in] bytes The number of bytes to read.
+   * \returns The value read, in little endian order.
+   */
+  uint64_t U64 (int bytes = 8)
+  {
+    uint64_t v = 0;
+    for (int i = 0; i < bytes; i++)
+      {
+        int c = m_is.get ();
+        Check ();
+        v |= static_cast<uint64_t> (c & 0xff) << (8 * i);
+      }
+    return v;
+  }
+  /** \returns The value read. */
+  double Double (void)
+  {
+    uint64_t bits = U64 ();
+    double v;
+    std::memcpy (&v, &bits, sizeof (v));
+    return v;
+  }
+  /** \returns The string read. */
+  std::string String (void)
+  {
+    uint32_t size = U32 ();
+    std::string s (size, '\0');
+    m_is.read (&s[0], size);
+    Check ();
+    return s;
+  }
+private:
+  /** Abort if the file is truncated. */
+  void Check (void)
+  {
+    NS_ABORT_MSG_UNLESS (m_is, "Truncated checkpoint file \"" << m_filename << "\"");
+  }
+  std::ifstream m_is;        //!< The file.
+  std::string m_filename;    //!< The file name, for the error messages.
+};
+
+} // unnamed namespace
+
+void
+Checkpoint::Register (std::string name, Ptr<Object> object)
+{
+  NS_LOG_FUNCTION (name << object);
+  ScheduleClear ();
+  GetRegistry ().objects[name] = object;
+}
+
+void
+Checkpoint::RegisterEvent (std::string name, Callback<void> callback)
+{
+  NS_LOG_FUNCTION (name);
+  ScheduleClear ();
+  GetRegistry ().callbacks[name] = callback;
+}
+
+EventId
+Checkpoint::Schedule (const Time &delay, std::string name)
+{
+  NS_LOG_FUNCTION (delay << name);
+  Registry &registry = GetRegistry ();
+  NS_ABORT_MSG_UNLESS (registry.callbacks.find (name) != registry.callbacks.end (),
+                       "Checkpoint event \"" << name << "\" is not registered");
+  ScheduleClear ();
+  // Cancelled events never fire, so they are dropped from time to time.
+  if (registry.pending.size () >= registry.purgeSize)
+    {
+      PurgeCancelled (registry);
+    }
+  uint64_t key = registry.nextKey++;
+  PendingEvent event;
+  event.name = name;
+  event.context = Simulator::GetContext ();
+  event.time = Simulator::Now () + delay;
+  EventId id = Simulator::Schedule (delay, &Checkpoint::Fire, key);
+  event.impl = id.PeekEventImpl ();
+  registry.pending[key] = event;
+  return id;
+}
+
+void
+Checkpoint::Fire (uint64_t key)
+{
+  NS_LOG_FUNCTION (key);
+  Registry &registry = GetRegistry ();
+  std::map<uint64_t, PendingEvent>::iterator i = registry.pending.find (key);
+  NS_ASSERT (i != registry.pending.end ());
+  Callback<void> callback = registry.callbacks[i->second.name];
+  registry.pending.erase (i);
+  callback ();
+}
+
+void
+Checkpoint::Save (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  Registry &registry = GetRegistry ();
+  Writer writer (filename);
+
+  // The clock
+  writer.U32 (Time::GetResolution ());
+  writer.U64 (Simulator::Now ().GetTimeStep ());
+
+  // The random number generators
+  writer.U32 (RngSeedManager::GetSeed ());
+  writer.U64 (RngSeedManager::GetRun ());
+  writer.U64 (RngSeedManager::PeekNextStreamIndex ());
+
+  // The attributes of the registered objects
+  writer.U64 (registry.objects.size ());
+  for (std::map<std::string, Ptr<Object> >::const_iterator i = registry.objects.begin ();
+       i != registry.objects.end (); ++i)
+    {
+      std::vector<std::pair<std::string, std::string> > attributes;
+      for (TypeId tid = i->second->GetInstanceTypeId (); ; tid = tid.GetParent ())
+        {
+          for (uint32_t j = 0; j < tid.GetAttributeN (); j++)
+            {
+              struct TypeId::AttributeInformation info = tid.GetAttribute (j);
+              if (!(info.flags & TypeId::ATTR_GET) || !(info.flags & TypeId::ATTR_SET)
+                  || !info.accessor->HasGetter () || !info.accessor->HasSetter ())
+                {
+                  continue;
+                }
+              Ptr<AttributeValue> value = info.checker->Create ();
+              if (!i->second->GetAttributeFailSafe (info.name, *value))
+                {
+                  continue;
+                }
+              // Keep only the values which survive the round trip
+              // through a string.
+              std::string serialized = value->SerializeToString (info.checker);
+              Ptr<AttributeValue> check = info.checker->Create ();
+              if (!check->DeserializeFromString (serialized, info.checker))
+                {
+                  NS_LOG_LOGIC ("not saving attribute " << info.name << " of " << i->first);
+                  continue;
+                }
+              attributes.push_back (std::make_pair (info.name, serialized));
+            }
+          if (tid == tid.GetParent ())
+            {
+              break;
+            }
+        }
+      writer.String (i->first);
+      writer.U64 (attributes.size ());
+      for (std::vector<std::pair<std::string, std::string> >::const_iterator j = attributes.begin ();
+           j != attributes.end (); ++j)
+        {
+          writer.String (j->first);
+          writer.String (j->second);
+        }
+    }
+
+  // The states of the random streams, after the attributes: restoring
+  // the "Stream" attribute of a random variable resets its stream.
+  std::vector<RandomVariableStream *> streams = GetStreams ();
+  writer.U64 (streams.size ());
+  for (std::vector<RandomVariableStream *>::const_iterator i = streams.begin (); i != streams.end (); ++i)
+    {
+      double state[6];
+      (*i)->m_rng->GetState (state);
+      writer.U64 ((*i)->m_index);
+      for (int j = 0; j < 6; j++)
+        {
+          writer.Double (state[j]);
+        }
+    }
+
+  // The pending events scheduled by name
+  PurgeCancelled (registry);
+  writer.U64 (registry.pending.size ());
+  for (std::map<uint64_t, PendingEvent>::const_iterator i = registry.pending.begin ();
+       i != registry.pending.end (); ++i)
+    {
+      writer.String (i->second.name);
+      writer.U32 (i->second.context);
+      writer.U64 (i->second.time.GetTimeStep ());
+    }
+
+  NS_ABORT_MSG_UNLESS (writer.Good (), "Can not write checkpoint file \"" << filename << "\"");
+}
+
+void
+Checkpoint::Restore (std::string filename)
+{
+  NS_LOG_FUNCTION (filename);
+  Registry &registry = GetRegistry ();
+  Reader reader (filename);
+
+  // The clock
+  uint32_t resolution = reader.U32 ();
+  NS_ABORT_MSG_UNLESS (resolution == static_cast<uint32_t> (Time::GetResolution ()),
+                       "The checkpoint \"" << filename << "\" was saved with another Time resolution");
+  Time now = TimeStep (reader.U64 ());
+  if (now.IsStrictlyPositive ())
+    {
+      Simulator::GetImplementation ()->RestoreClock (now);
+    }
+
+  // The random number generators
+  RngSeedManager::SetSeed (reader.U32 ());
+  RngSeedManager::SetRun (reader.U64 ());
+  RngSeedManager::SetNextStreamIndex (reader.U64 ());
+  // The attributes of the registered objects
+  uint64_t nObjects = reader.U64 ();
+  for (uint64_t i = 0; i < nObjects; i++)
+    {
+      std::string name = reader.String ();
+      std::map<std::string, Ptr<Object> >::const_iterator object = registry.objects.find (name);
+      NS_ABORT_MSG_IF (object == registry.objects.end (),
+                       "Checkpoint object \"" << name << "\" is not registered");
+      uint64_t nAttributes = reader.U64 ();
+      for (uint64_t j = 0; j < nAttributes; j++)
+        {
+          std::string attribute = reader.String ();
+          std::string value = reader.String ();
+          struct TypeId::AttributeInformation info;
+          if (!object->second->GetInstanceTypeId ().LookupAttributeByName (attribute, &info))
+            {
+              NS_FATAL_ERROR ("Checkpoint object \"" << name << "\" has no attribute " << attribute);
+            }
+          // Setting some attributes has side effects, as the "Stream"
+          // attribute of the random variables: leave the unchanged
+          // values alone.
+          Ptr<AttributeValue> current = info.checker->Create ();
+          if (object->second->GetAttributeFailSafe (attribute, *current)
+              && current->SerializeToString (info.checker) == value)
+            {
+              continue;
+            }
+          Ptr<AttributeValue> v = info.checker->CreateValidValue (StringValue (value));
+          NS_ABORT_MSG_IF (v == 0, "Invalid value " << value << " for attribute " << attribute <<
+                           " of checkpoint object \"" << name << "\"");
+          object->second->SetAttribute (attribute, *v);
+        }
+    }
+
+  // The states of the random streams
+  std::vector<RandomVariableStream *> streams = GetStreams ();
+  std::vector<RandomVariableStream *>::const_iterator stream = streams.begin ();
+  uint64_t nStreams = reader.U64 ();
+  for (uint64_t i = 0; i < nStreams; i++)
+    {
+      uint64_t index = reader.U64 ();
+      double state[6];
+      for (int j = 0; j < 6; j++)
+        {
+          state[j] = reader.Double ();
+        }
+      // Both lists are sorted by stream index: skip the streams
+      // which are not in the checkpoint.
+      while (stream != streams.end () && (*stream)->m_index < index)
+        {
+          NS_LOG_WARN ("stream " << (*stream)->m_index << " not in the checkpoint");
+          ++stream;
+        }
+      if (stream == streams.end () || (*stream)->m_index != index)
+        {
+          NS_LOG_WARN ("no random variable for stream " << index);
+          continue;
+        }
+      (*stream)->m_rng->SetState (state);
+      ++stream;
+    }
+
+  // The pending events scheduled by name
+  uint64_t nEvents = reader.U64 ();
+  for (uint64_t i = 0; i < nEvents; i++)
+    {
+      PendingEvent event;
+      event.name = reader.String ();
+      event.context = reader.U32 ();
+      event.time = TimeStep (reader.U64 ());
+      NS_ABORT_MSG_UNLESS (registry.callbacks.find (event.name) != registry.callbacks.end (),
+                           "Checkpoint event \"" << event.name << "\" is not registered");
+      uint64_t key = registry.nextKey++;
+      EventImpl *impl = MakeEvent (&Checkpoint::Fire, key);
+      event.impl = impl;
+      registry.pending[key] = event;
+      Simulator::ScheduleWithContext (event.context, event.time - Simulator::Now (), impl);
+    }
+  ScheduleClear ();
+}
+
+std::vector<RandomVariableStream *>
+Checkpoint::GetStreams (void)
+{
+  CriticalSection cs (RandomVariableStream::GetInstancesMutex ());
+  std::set<RandomVariableStream *> &instances = RandomVariableStream::GetInstances ();
+  std::vector<RandomVariableStream *> streams;
+  for (std::set<RandomVariableStream *>::const_iterator i = instances.begin (); i != instances.end (); ++i)
+    {
+      if ((*i)->m_rng != 0)
+        {
+          streams.push_back (*i);
+        }
+    }
+  std::sort (streams.begin (), streams.end (), &Checkpoint::StreamLess);
+  return streams;
+}
+
+bool
+Checkpoint::StreamLess (const RandomVariableStream *a, const RandomVariableStream *b)
+{
+  if (a->m_index != b->m_index)
+    {
+      return a->m_index < b->m_index;
+    }
+  return a->m_serial < b->m_serial;
+}
+
+void
+Checkpoint::Clear (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  Registry &registry = GetRegistry ();
+  registry.objects.clear ();
+  registry.callbacks.clear ();
+  registry.pending.clear ();
+  registry.purgeSize = MIN_PURGE_SIZE;
+  registry.clearScheduled = false;
+}
+
+void
+Checkpoint::ScheduleClear (void)
+{
+  Registry &registry = GetRegistry ();
+  if (!registry.clearScheduled)
+    {
+      Simulator::ScheduleDestroy (&Checkpoint::Clear);
+      registry.clearScheduled = true;
+    }
+}
+
+} // namespace ns3
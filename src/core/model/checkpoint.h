@@ -0,0 +1,156 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <string>
+#include <vector>
+#include "callback.h"
+#include "event-id.h"
+#include "nstime.h"
+#include "object.h"
+#include "ptr.h"
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::Checkpoint declaration.
+ */
+
+namespace ns3 {
+
+class RandomVariableStream;
+
+/**
+ * \ingroup simulator
+ * \brief Save the state of a simulation to a binary file, and restore it.
+ *
+ * A checkpoint holds:
+ *   - the simulation clock;
+ *   - the random number generator seed, run number and next automatic
+ *     stream index, and the state of the stream of every live
+ *     RandomVariableStream;
+ *   - the attributes of the Objects registered with Register();
+ *   - the pending events scheduled with Schedule().
+ *
+ * The events scheduled directly through the Simulator are bound to
+ * arbitrary functions and arguments, and can not be saved: only the
+ * events scheduled by name, with Schedule(), are part of a checkpoint.
+ * The name refers to a callback registered with RegisterEvent(), by
+ * the program which saves the checkpoint as well as by the program
+ * which restores it.
+ *
+ * To skip the warm-up of a simulation, save a checkpoint from an
+ * event scheduled at the end of the warm-up:
+ * \code
+ *   Simulator::Schedule (Seconds (3600), &Checkpoint::Save, "warm.ckpt");
+ * \endcode
+ * then, in each run of the parameter sweep, build the same scenario,
+ * register the same objects and event names, restore the checkpoint,
+ * and run:
+ * \code
+ *   Checkpoint::Restore ("warm.ckpt");
+ *   Simulator::Run ();
+ * \endcode
+ *
+ * The random variables are matched by stream index, so the scenario
+ * must create its random variables in the same order, or with the
+ * same fixed stream numbers.  The values a random variable caches
+ * between two draws (such as the second value of a normal variable)
+ * are not saved.
+ *
+ * The clock is restored before Simulator::Run: the events pending at
+ * that point, such as the initialization of the nodes, are delayed by
+ * the restored time, and their EventIds follow them.  Only the
+ * simulator implementations which support SimulatorImpl::RestoreClock,
+ * such as DefaultSimulatorImpl, can restore a checkpoint.
+ *
+ * All the registrations are dropped by Simulator::Destroy.
+ */
+class Checkpoint
+{
+public:
+  /**
+   * Register an Object whose attributes are part of the checkpoints.
+   *
+   * Only the attributes which can be read, written, and converted to
+   * and from a string are saved; for example, the attributes holding
+   * pointers to other Objects are not.
+   *
+   * \param [in] name The name of the Object in the checkpoints.
+   * \param [in] object The Object.
+   */
+  static void Register (std::string name, Ptr<Object> object);
+  /**
+   * Register the callback of the events scheduled by name.
+   *
+   * \param [in] name The name of the event.
+   * \param [in] callback The callback invoked when the event expires.
+   */
+  static void RegisterEvent (std::string name, Callback<void> callback);
+  /**
+   * Schedule an event which is part of the checkpoints.
+   *
+   * The event is scheduled with the current context.
+   *
+   * \param [in] delay The delay before the event expires.
+   * \param [in] name The name of the event, registered with RegisterEvent().
+   * \returns The id of the event.
+   */
+  static EventId Schedule (const Time &delay, std::string name);
+  /**
+   * Save the state of the simulation.
+   *
+   * \param [in] filename The checkpoint file.
+   */
+  static void Save (std::string filename);
+  /**
+   * Restore the state of the simulation, before Simulator::Run.
+   *
+   * \param [in] filename The checkpoint file.
+   */
+  static void Restore (std::string filename);
+
+private:
+  /**
+   * Invoke an event scheduled by name.
+   * \param [in] key The key of the event in the pending events.
+   */
+  static void Fire (uint64_t key);
+  /** Drop all the registrations, at Simulator::Destroy. */
+  static void Clear (void);
+  /** Make sure that Clear() is called by Simulator::Destroy. */
+  static void ScheduleClear (void);
+  /**
+   * Get the live RandomVariableStreams which have a stream.
+   * \returns The streams, sorted by stream index, then creation order.
+   */
+  static std::vector<RandomVariableStream *> GetStreams (void);
+  /**
+   * Compare the RandomVariableStreams by stream index, then creation order.
+   * \param [in] a The first RandomVariableStream.
+   * \param [in] b The second RandomVariableStream.
+   * \returns \c true if \p a comes before \p b.
+   */
+  static bool StreamLess (const RandomVariableStream *a, const RandomVariableStream *b);
+};
+
+} // namespace ns3
+
+#endif /* CHECKPOINT_H */
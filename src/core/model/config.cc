@@ -24,8 +24,11 @@
 #include "object-ptr-container.h"
 #include "names.h"
 #include "pointer.h"
+#include "trace-source-accessor.h"
+#include "simple-ref-count.h"
 #include "log.h"
 
+#include <map>
 #include <sstream>
 
 /**
@@ -156,6 +159,9 @@ public:
   /**
    * Construct from a Config path specification.
    *
+   * The specification is parsed once here, rather than for
+   * each index matched against it.
+   *
    * \param [in] element The Config path specification.
    */
   ArrayMatcher (std::string element);
@@ -166,7 +172,21 @@ public:
    * \returns \c true if the index matches the Config Path.
    */
   bool Matches (uint32_t i) const;
+  /**
+   * Test if the Config path specification matches a single index.
+   *
+   * \param [out] i The index, if there is a single one.
+   * \returns \c true if the specification matches only \p i.
+   */
+  bool GetSingleIndex (uint32_t *i) const;
 private:
+  /**
+   * Parse one of the alternatives, separated by '|', of the
+   * Config path specification.
+   *
+   * \param [in] element The alternative.
+   */
+  void Parse (std::string element);
   /**
    * Convert a string to an \c uint32_t.
    *
@@ -177,77 +197,92 @@ private:
   bool StringToUint32 (std::string str, uint32_t *value) const;
   /** The Config path element. */
   std::string m_element;
+  /** The Config path element matches all the indices. */
+  bool m_all;
+  /** The ranges of indices matched, bounds included. */
+  std::vector<std::pair<uint32_t, uint32_t> > m_ranges;
 };
 
 
 ArrayMatcher::ArrayMatcher (std::string element)
-  : m_element (element)
+  : m_element (element),
+    m_all (false)
 {
   NS_LOG_FUNCTION (this << element);
-}
-bool
-ArrayMatcher::Matches (uint32_t i) const
-{
-  NS_LOG_FUNCTION (this << i);
-  if (m_element == "*")
+  std::string::size_type cur = 0;
+  std::string::size_type next;
+  do
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches *");
-      return true;
+      next = element.find ("|", cur);
+      Parse (element.substr (cur, next - cur));
+      cur = next + 1;
     }
-  std::string::size_type tmp;
-  tmp = m_element.find ("|");
-  if (tmp != std::string::npos)
+  while (next != std::string::npos);
+}
+void
+ArrayMatcher::Parse (std::string element)
+{
+  NS_LOG_FUNCTION (this << element);
+  if (element == "*")
     {
-      std::string left = m_element.substr (0, tmp-0);
-      std::string right = m_element.substr (tmp+1, m_element.size () - (tmp + 1));
-      ArrayMatcher matcher = ArrayMatcher (left);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<left);
-          return true;
-        }
-      matcher = ArrayMatcher (right);
-      if (matcher.Matches (i))
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<right);
-          return true;
-        }
-      NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
-      return false;
+      m_all = true;
+      return;
     }
-  std::string::size_type leftBracket = m_element.find ("[");
-  std::string::size_type rightBracket = m_element.find ("]");
-  std::string::size_type dash = m_element.find ("-");
-  if (leftBracket == 0 && rightBracket == m_element.size () - 1 &&
+  std::string::size_type leftBracket = element.find ("[");
+  std::string::size_type rightBracket = element.find ("]");
+  std::string::size_type dash = element.find ("-");
+  if (leftBracket == 0 && rightBracket == element.size () - 1 &&
       dash > leftBracket && dash < rightBracket)
     {
-      std::string lowerBound = m_element.substr (leftBracket + 1, dash - (leftBracket + 1));
-      std::string upperBound = m_element.substr (dash + 1, rightBracket - (dash + 1));
+      std::string lowerBound = element.substr (leftBracket + 1, dash - (leftBracket + 1));
+      std::string upperBound = element.substr (dash + 1, rightBracket - (dash + 1));
       uint32_t min;
       uint32_t max;
       if (StringToUint32 (lowerBound, &min) && 
-          StringToUint32 (upperBound, &max) &&
-          i >= min && i <= max)
-        {
-          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
-          return true;
-        }
-      else
+          StringToUint32 (upperBound, &max))
         {
-          NS_LOG_DEBUG ("Array "<<i<<" does not "<<m_element);
-          return false;
+          m_ranges.push_back (std::make_pair (min, max));
         }
+      return;
     }
   uint32_t value;
-  if (StringToUint32 (m_element, &value) &&
-      i == value)
+  if (StringToUint32 (element, &value))
     {
-      NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+      m_ranges.push_back (std::make_pair (value, value));
+    }
+}
+bool
+ArrayMatcher::Matches (uint32_t i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all)
+    {
+      NS_LOG_DEBUG ("Array "<<i<<" matches *");
       return true;
     }
+  for (std::vector<std::pair<uint32_t, uint32_t> >::const_iterator j = m_ranges.begin ();
+       j != m_ranges.end (); ++j)
+    {
+      if (i >= j->first && i <= j->second)
+        {
+          NS_LOG_DEBUG ("Array "<<i<<" matches "<<m_element);
+          return true;
+        }
+    }
   NS_LOG_DEBUG ("Array "<<i<<" does not match "<<m_element);
   return false;
 }
+bool
+ArrayMatcher::GetSingleIndex (uint32_t *i) const
+{
+  NS_LOG_FUNCTION (this << i);
+  if (m_all || m_ranges.size () != 1 || m_ranges[0].first != m_ranges[0].second)
+    {
+      return false;
+    }
+  *i = m_ranges[0].first;
+  return true;
+}
 
 bool
 ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
@@ -259,8 +294,240 @@ ArrayMatcher::StringToUint32 (std::string str, uint32_t *value) const
   return !iss.bad () && !iss.fail ();
 }
 
+/**
+ * Index, per TypeId, of the attributes and trace sources used by the
+ * Config paths.
+ *
+ * Resolving a path element used to scan every attribute of the TypeId
+ * of each object, and of its parents, and to test the checker of each
+ * of them.  This index is built the first time a TypeId is met, and
+ * keeps only the attributes which lead to other objects.  It is rebuilt
+ * when the TypeId generation changes, i.e. when a TypeId gains a parent,
+ * an attribute or a trace source.
+ */
+class ConfigTypeIndex
+{
+public:
+  /** An attribute which holds objects. */
+  struct Attribute
+  {
+    std::string name;                       //!< The attribute name.
+    Ptr<const AttributeAccessor> accessor;  //!< The accessor, or 0 if not gettable.
+    bool container;                         //!< The attribute holds an ObjectPtrContainerValue,
+                                            //!< rather than a PointerValue.
+  };
+  /** The attributes of a TypeId which hold objects. */
+  typedef std::vector<Attribute> Attributes;
+  /** The index of a TypeId. */
+  struct Entry : public SimpleRefCount<Entry>
+  {
+    /**
+     * The attributes holding objects of the TypeId and of its parents,
+     * in the order of TypeId::GetAttribute, starting with the TypeId
+     * and then its parents.
+     */
+    Attributes attributes;
+    /** The trace sources, by name. */
+    std::map<std::string, Ptr<const TraceSourceAccessor> > traceSources;
+    /** The TypeId generation the entry was built at. */
+    uint32_t generation;
+  };
+
+  /**
+   * Get the index of a TypeId, building it if needed.
+   *
+   * The entry is kept alive by the returned pointer, even if it is
+   * rebuilt meanwhile, e.g. because a TypeId is first registered while
+   * a path is being resolved.
+   *
+   * \param [in] tid The TypeId.
+   * \returns The index.
+   */
+  Ptr<const Entry> GetEntry (TypeId tid);
+  /**
+   * Find a trace source of a TypeId or of its parents.
+   *
+   * \param [in] tid The TypeId.
+   * \param [in] name The trace source name.
+   * \returns The trace source accessor, or 0 if not found.
+   */
+  Ptr<const TraceSourceAccessor> GetTraceSource (TypeId tid, std::string name);
+  /**
+   * Get the value of an attribute holding objects.
+   *
+   * \param [in] object The object.
+   * \param [in] attribute The attribute.
+   * \param [out] value The value.
+   */
+  static void GetValue (Ptr<Object> object, const Attribute &attribute, AttributeValue &value);
+
+private:
+  /** The indices, by TypeId uid. */
+  std::map<uint16_t, Ptr<Entry> > m_entries;
+};
+
+Ptr<const ConfigTypeIndex::Entry>
+ConfigTypeIndex::GetEntry (TypeId tid)
+{
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t generation = TypeId::GetGeneration ();
+  Ptr<Entry> &slot = m_entries[tid.GetUid ()];
+  if (slot != 0 && slot->generation == generation)
+    {
+      return slot;
+    }
+  Ptr<Entry> entry = Create<Entry> ();
+  entry->generation = generation;
+  TypeId nextTid = tid;
+  do
+    {
+      tid = nextTid;
+      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+        {
+          struct TypeId::AttributeInformation info = tid.GetAttribute (i);
+          Attribute attribute;
+          if (dynamic_cast<const PointerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.container = false;
+            }
+          else if (dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker)) != 0)
+            {
+              attribute.container = true;
+            }
+          else
+            {
+              continue;
+            }
+          attribute.name = info.name;
+          if ((info.flags & TypeId::ATTR_GET) && info.accessor->HasGetter ())
+            {
+              attribute.accessor = info.accessor;
+            }
+          entry->attributes.push_back (attribute);
+        }
+      for (uint32_t i = 0; i < tid.GetTraceSourceN (); i++)
+        {
+          struct TypeId::TraceSourceInformation info = tid.GetTraceSource (i);
+          // as TypeId::LookupTraceSourceByName, the sources of
+          // a TypeId hide the ones of its parents.
+          entry->traceSources.insert (std::make_pair (info.name, info.accessor));
+        }
+      nextTid = tid.GetParent ();
+    }
+  while (nextTid != tid);
+  slot = entry;
+  return entry;
+}
+
+Ptr<const TraceSourceAccessor>
+ConfigTypeIndex::GetTraceSource (TypeId tid, std::string name)
+{
+  NS_LOG_FUNCTION (this << tid << name);
+  Ptr<const Entry> entry = GetEntry (tid);
+  std::map<std::string, Ptr<const TraceSourceAccessor> >::const_iterator i =
+    entry->traceSources.find (name);
+  if (i == entry->traceSources.end ())
+    {
+      return 0;
+    }
+  return i->second;
+}
+
+void
+ConfigTypeIndex::GetValue (Ptr<Object> object, const Attribute &attribute, AttributeValue &value)
+{
+  NS_LOG_FUNCTION (object << attribute.name << &value);
+  if (attribute.accessor == 0 || !attribute.accessor->Get (PeekPointer (object), value))
+    {
+      // Let ObjectBase::GetAttribute report the error.
+      object->GetAttribute (attribute.name, value);
+    }
+}
+
+/** A Config path, split into its elements. */
+struct ConfigPath : public SimpleRefCount<ConfigPath>
+{
+  std::vector<std::string> items;      //!< The path elements.
+  std::vector<ArrayMatcher> matchers;  //!< The path elements, as array indices.
+};
+
+/**
+ * Cache of the Config paths split into their elements, by path.
+ *
+ * The programs which set attributes or connect trace sources on many
+ * objects resolve the same paths again and again: each is split only
+ * once.
+ */
+class ConfigPathCache
+{
+public:
+  /**
+   * Get a Config path split into its elements, splitting it if needed.
+   *
+   * \param [in] path The Config path.
+   * \returns The path elements.
+   */
+  Ptr<const ConfigPath> Get (std::string path);
+
+private:
+  /** The number of paths above which the cache is emptied. */
+  static const std::size_t MAX_PATHS = 4096;
+  /** The paths, by path string. */
+  std::map<std::string, Ptr<const ConfigPath> > m_paths;
+};
+
+Ptr<const ConfigPath>
+ConfigPathCache::Get (std::string path)
+{
+  NS_LOG_FUNCTION (this << path);
+  std::map<std::string, Ptr<const ConfigPath> >::const_iterator found = m_paths.find (path);
+  if (found != m_paths.end ())
+    {
+      return found->second;
+    }
+  std::string key = path;
+
+  // ensure that we start and end with a '/'
+  std::string::size_type tmp = path.find ("/");
+  if (tmp != 0)
+    {
+      // no slash at start
+      path = "/" + path;
+    }
+  tmp = path.find_last_of ("/");
+  if (tmp != (path.size () - 1))
+    {
+      // no slash at end
+      path = path + "/";
+    }
+
+  Ptr<ConfigPath> compiled = Create<ConfigPath> ();
+  std::string::size_type cur = 1;
+  std::string::size_type next;
+  while ((next = path.find ("/", cur)) != std::string::npos)
+    {
+      std::string item = path.substr (cur, next - cur);
+      compiled->items.push_back (item);
+      compiled->matchers.push_back (ArrayMatcher (item));
+      cur = next + 1;
+    }
+  // The paths built from node or device indices may be all different:
+  // bound the cache.  The resolvers hold on to the paths they use.
+  if (m_paths.size () >= MAX_PATHS)
+    {
+      m_paths.clear ();
+    }
+  m_paths[key] = compiled;
+  return compiled;
+}
+
 /**
  * Abstract class to parse Config paths into object references.
+ *
+ * The paths are split into their elements once, through a ConfigPathCache.
+ * Several paths can be resolved together, in a single traversal of the
+ * object graph: the paths which go through the same objects are
+ * resolved together, up to the objects where they diverge.
  */
 class Resolver
 {
@@ -269,13 +536,23 @@ public:
    * Construct from a base Config path.
    *
    * \param [in] path The Config path.
+   * \param [in] cache The cache of the split Config paths.
+   * \param [in] index The index of the attributes holding objects.
+   */
+  Resolver (std::string path, ConfigPathCache &cache, ConfigTypeIndex &index);
+  /**
+   * Construct from several base Config paths.
+   *
+   * \param [in] paths The Config paths.
+   * \param [in] cache The cache of the split Config paths.
+   * \param [in] index The index of the attributes holding objects.
    */
-  Resolver (std::string path);
+  Resolver (const std::vector<std::string> &paths, ConfigPathCache &cache, ConfigTypeIndex &index);
   /** Destructor. */
   virtual ~Resolver ();
 
   /**
-   * Parse the stored Config path into an object reference,
+   * Parse the stored Config paths into object references,
    * beginning at the indicated root object.
    *
    * \param [in] root The object corresponding to the current position in
@@ -284,29 +561,43 @@ public:
   void Resolve (Ptr<Object> root);
   
 private:
-  /** Ensure the Config path starts and ends with a '/'. */
-  void Canonicalize (void);
+  /** A list of Config paths, as indices in m_paths. */
+  typedef std::vector<uint32_t> PathList;
+
   /**
-   * Parse the next element in the Config path.
+   * Parse the next element of several Config paths.
    *
-   * \param [in] path The remaining portion of the Config path.
+   * \param [in] depth The number of elements already parsed.
    * \param [in] root The object corresponding to the current positon
-   *                  in the Config path.
+   *                  in the Config paths.
+   * \param [in] paths The Config paths.
+   */
+  void DoResolve (uint32_t depth, Ptr<Object> root, const PathList &paths);
+  /**
+   * Parse the next element of Config paths sharing this element.
+   *
+   * \param [in] depth The number of elements already parsed.
+   * \param [in] root The object corresponding to the current positon
+   *                  in the Config paths.
+   * \param [in] item The next element.
+   * \param [in] paths The Config paths.
    */
-  void DoResolve (std::string path, Ptr<Object> root);
+  void DoResolveItem (uint32_t depth, Ptr<Object> root, std::string item, const PathList &paths);
   /**
-   * Parse an index on the Config path.
+   * Parse an index on the Config paths.
    *
-   * \param [in] path The remaining Config path.
-   * \param [in,out] vector The resulting list of matching objects.
+   * \param [in] depth The number of elements already parsed.
+   * \param [in] container The list of objects to match.
+   * \param [in] paths The Config paths.
    */
-  void DoArrayResolve (std::string path, const ObjectPtrContainerValue &vector);
+  void DoArrayResolve (uint32_t depth, const ObjectPtrContainerValue &container, const PathList &paths);
   /**
    * Handle one object found on the path.
    *
    * \param [in] object The current object on the Config path.
+   * \param [in] path The index of the Config path.
    */
-  void DoResolveOne (Ptr<Object> object);
+  void DoResolveOne (Ptr<Object> object, uint32_t path);
   /**
    * Get the current Config path.
    *
@@ -318,43 +609,41 @@ private:
    *
    * \param [in] object The found object.
    * \param [in] path The matching Config path context.
+   * \param [in] i The index of the Config path in the paths
+   *               given to the constructor.
    */
-  virtual void DoOne (Ptr<Object> object, std::string path) = 0;
+  virtual void DoOne (Ptr<Object> object, std::string path, uint32_t i) = 0;
 
   /** Current list of path tokens. */
   std::vector<std::string> m_workStack;
-  /** The Config path. */
-  std::string m_path;
+  /** The Config paths. */
+  std::vector<Ptr<const ConfigPath> > m_paths;
+  /** All the Config paths. */
+  PathList m_all;
+  /** The index of the attributes holding objects. */
+  ConfigTypeIndex &m_index;
 };
 
-Resolver::Resolver (std::string path)
-  : m_path (path)
+Resolver::Resolver (std::string path, ConfigPathCache &cache, ConfigTypeIndex &index)
+  : m_index (index)
 {
-  NS_LOG_FUNCTION (this << path);
-  Canonicalize ();
+  NS_LOG_FUNCTION (this << path << &cache << &index);
+  m_all.push_back (0);
+  m_paths.push_back (cache.Get (path));
 }
-Resolver::~Resolver ()
+Resolver::Resolver (const std::vector<std::string> &paths, ConfigPathCache &cache, ConfigTypeIndex &index)
+  : m_index (index)
 {
-  NS_LOG_FUNCTION (this);
+  NS_LOG_FUNCTION (this << paths.size () << &cache << &index);
+  for (std::vector<std::string>::const_iterator i = paths.begin (); i != paths.end (); ++i)
+    {
+      m_all.push_back (m_paths.size ());
+      m_paths.push_back (cache.Get (*i));
+    }
 }
-void
-Resolver::Canonicalize (void)
+Resolver::~Resolver ()
 {
   NS_LOG_FUNCTION (this);
-
-  // ensure that we start and end with a '/'
-  std::string::size_type tmp = m_path.find ("/");
-  if (tmp != 0)
-    {
-      // no slash at start
-      m_path = "/" + m_path;
-    }
-  tmp = m_path.find_last_of ("/");
-  if (tmp != (m_path.size () - 1))
-    {
-      // no slash at end
-      m_path = m_path + "/";
-    }
 }
 
 void 
@@ -362,7 +651,7 @@ Resolver::Resolve (Ptr<Object> root)
 {
   NS_LOG_FUNCTION (this << root);
 
-  DoResolve (m_path, root);
+  DoResolve (0, root, m_all);
 }
 
 std::string
@@ -379,23 +668,29 @@ Resolver::GetResolvedPath (void) const
 }
 
 void 
-Resolver::DoResolveOne (Ptr<Object> object)
+Resolver::DoResolveOne (Ptr<Object> object, uint32_t path)
 {
-  NS_LOG_FUNCTION (this << object);
+  NS_LOG_FUNCTION (this << object << path);
 
   NS_LOG_DEBUG ("resolved="<<GetResolvedPath ());
-  DoOne (object, GetResolvedPath ());
+  DoOne (object, GetResolvedPath (), path);
 }
 
 void
-Resolver::DoResolve (std::string path, Ptr<Object> root)
+Resolver::DoResolve (uint32_t depth, Ptr<Object> root, const PathList &paths)
 {
-  NS_LOG_FUNCTION (this << path << root);
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
+  NS_LOG_FUNCTION (this << depth << root << paths.size ());
 
-  if (next == std::string::npos)
+  // Group the paths which do not end here by their next element.
+  std::map<std::string, PathList> items;
+  for (PathList::const_iterator i = paths.begin (); i != paths.end (); ++i)
     {
+      const ConfigPath &path = *m_paths[*i];
+      if (depth < path.items.size ())
+        {
+          items[path.items[depth]].push_back (*i);
+          continue;
+        }
       //
       // If root is zero, we're beginning to see if we can use the object name 
       // service to resolve this path.  It is impossible to have a object name 
@@ -406,12 +701,19 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
       // 
       if (root)
         {
-          DoResolveOne (root);
+          DoResolveOne (root, *i);
         }
-      return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
+  for (std::map<std::string, PathList>::const_iterator i = items.begin (); i != items.end (); ++i)
+    {
+      DoResolveItem (depth, root, i->first, i->second);
+    }
+}
+
+void
+Resolver::DoResolveItem (uint32_t depth, Ptr<Object> root, std::string item, const PathList &paths)
+{
+  NS_LOG_FUNCTION (this << depth << root << item << paths.size ());
 
   //
   // If root is zero, we're beginning to see if we can use the object name 
@@ -422,11 +724,11 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
   //
   if (root == 0)
     {
-      std::string::size_type offset = path.find ("/Names");
+      std::string::size_type offset = item.find ("Names");
       if (offset == 0)
         {
           m_workStack.push_back (item);
-          DoResolve (pathLeft, root);
+          DoResolve (depth + 1, root, paths);
           m_workStack.pop_back ();
           return;
         }
@@ -443,7 +745,7 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
     {
       NS_LOG_DEBUG ("Name system resolved item = " << item << " to " << namedObject);
       m_workStack.push_back (item);
-      DoResolve (pathLeft, namedObject);
+      DoResolve (depth + 1, namedObject, paths);
       m_workStack.pop_back ();
       return;
     }
@@ -473,67 +775,52 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
           return;
         }
       m_workStack.push_back (item);
-      DoResolve (pathLeft, object);
+      DoResolve (depth + 1, object, paths);
       m_workStack.pop_back ();
     }
   else 
     {
       // this is a normal attribute.
-      TypeId tid;
-      TypeId nextTid = root->GetInstanceTypeId ();
+      Ptr<const ConfigTypeIndex::Entry> entry = m_index.GetEntry (root->GetInstanceTypeId ());
+      const ConfigTypeIndex::Attributes &attributes = entry->attributes;
       bool foundMatch = false;
       
-      do
+      for (ConfigTypeIndex::Attributes::const_iterator i = attributes.begin ();
+           i != attributes.end (); ++i)
         {
-          tid = nextTid;
-          
-          for (uint32_t i = 0; i < tid.GetAttributeN(); i++)
+          if (i->name != item && item != "*")
+            {
+              continue;
+            }
+          if (!i->container)
             {
-              struct TypeId::AttributeInformation info;
-              info = tid.GetAttribute(i);
-              if (info.name != item && item != "*")
+              NS_LOG_DEBUG ("GetAttribute(ptr)="<<i->name<<" on path="<<GetResolvedPath ());
+              PointerValue ptr;
+              ConfigTypeIndex::GetValue (root, *i, ptr);
+              Ptr<Object> object = ptr.Get<Object> ();
+              if (object == 0)
                 {
+                  NS_LOG_ERROR ("Requested object name=\""<<item<<
+                                "\" exists on path=\""<<GetResolvedPath ()<<"\""
+                                " but is null.");
                   continue;
                 }
-              // attempt to cast to a pointer checker.
-              const PointerChecker *ptr = dynamic_cast<const PointerChecker *> (PeekPointer (info.checker));
-              if (ptr != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(ptr)="<<info.name<<" on path="<<GetResolvedPath ());
-                  PointerValue ptr;
-                  root->GetAttribute (info.name, ptr);
-                  Ptr<Object> object = ptr.Get<Object> ();
-                  if (object == 0)
-                    {
-                      NS_LOG_ERROR ("Requested object name=\""<<item<<
-                                    "\" exists on path=\""<<GetResolvedPath ()<<"\""
-                                    " but is null.");
-                      continue;
-                    }
-                  foundMatch = true;
-                  m_workStack.push_back (info.name);
-                  DoResolve (pathLeft, object);
-                  m_workStack.pop_back ();
-                }
-              // attempt to cast to an object vector.
-              const ObjectPtrContainerChecker *vectorChecker = 
-                dynamic_cast<const ObjectPtrContainerChecker *> (PeekPointer (info.checker));
-              if (vectorChecker != 0)
-                {
-                  NS_LOG_DEBUG ("GetAttribute(vector)="<<info.name<<" on path="<<GetResolvedPath () << pathLeft);
-                  foundMatch = true;
-                  ObjectPtrContainerValue vector;
-                  root->GetAttribute (info.name, vector);
-                  m_workStack.push_back (info.name);
-                  DoArrayResolve (pathLeft, vector);
-                  m_workStack.pop_back ();
-                }
-              // this could be anything else and we don't know what to do with it.
-              // So, we just ignore it.
+              foundMatch = true;
+              m_workStack.push_back (i->name);
+              DoResolve (depth + 1, object, paths);
+              m_workStack.pop_back ();
             }
-
-          nextTid = tid.GetParent ();
-        } while (nextTid != tid);
+          else
+            {
+              NS_LOG_DEBUG ("GetAttribute(vector)="<<i->name<<" on path="<<GetResolvedPath ());
+              foundMatch = true;
+              ObjectPtrContainerValue vector;
+              ConfigTypeIndex::GetValue (root, *i, vector);
+              m_workStack.push_back (i->name);
+              DoArrayResolve (depth + 1, vector, paths);
+              m_workStack.pop_back ();
+            }
+        }
       
       if (!foundMatch)
         {
@@ -544,29 +831,59 @@ Resolver::DoResolve (std::string path, Ptr<Object> root)
 }
 
 void 
-Resolver::DoArrayResolve (std::string path, const ObjectPtrContainerValue &container)
+Resolver::DoArrayResolve (uint32_t depth, const ObjectPtrContainerValue &container, const PathList &paths)
 {
-  NS_LOG_FUNCTION(this << path << &container);
-  NS_ASSERT (path != "");
-  NS_ASSERT ((path.find ("/")) == 0);
-  std::string::size_type next = path.find ("/", 1);
-  if (next == std::string::npos)
+  NS_LOG_FUNCTION(this << depth << &container << paths.size ());
+
+  // The paths naming a single index, the common case when many paths
+  // are resolved together, are found directly from the index; the
+  // others are matched against each index.
+  std::map<uint32_t, PathList> single;
+  PathList others;
+  for (PathList::const_iterator i = paths.begin (); i != paths.end (); ++i)
+    {
+      const ConfigPath &path = *m_paths[*i];
+      if (depth >= path.items.size ())
+        {
+          continue;
+        }
+      uint32_t index;
+      if (path.matchers[depth].GetSingleIndex (&index))
+        {
+          single[index].push_back (*i);
+        }
+      else
+        {
+          others.push_back (*i);
+        }
+    }
+  if (single.empty () && others.empty ())
     {
       return;
     }
-  std::string item = path.substr (1, next-1);
-  std::string pathLeft = path.substr (next, path.size ()-next);
 
-  ArrayMatcher matcher = ArrayMatcher (item);
   ObjectPtrContainerValue::Iterator it;
   for (it = container.Begin (); it != container.End (); ++it)
     {
-      if (matcher.Matches ((*it).first))
+      PathList matched;
+      std::map<uint32_t, PathList>::const_iterator s = single.find ((*it).first);
+      if (s != single.end ())
+        {
+          matched = s->second;
+        }
+      for (PathList::const_iterator i = others.begin (); i != others.end (); ++i)
+        {
+          if (m_paths[*i]->matchers[depth].Matches ((*it).first))
+            {
+              matched.push_back (*i);
+            }
+        }
+      if (!matched.empty ())
         {
           std::ostringstream oss;
           oss << (*it).first;
           m_workStack.push_back (oss.str ());
-          DoResolve (pathLeft, (*it).second);
+          DoResolve (depth + 1, (*it).second, matched);
           m_workStack.pop_back ();
         }
     }
@@ -582,6 +899,8 @@ public:
   void ConnectWithoutContext (std::string path, const CallbackBase &cb);
   /** \copydoc Config::Connect() */
   void Connect (std::string path, const CallbackBase &cb);
+  /** \copydoc Config::ConnectBatch() */
+  void ConnectBatch (const std::vector<std::pair<std::string, CallbackBase> > &connections);
   /** \copydoc Config::DisconnectWithoutContext() */
   void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
   /** \copydoc Config::Disconnect() */
@@ -608,12 +927,22 @@ private:
    * \param [in,out] leaf The trailing part of the \p path.
    */
   void ParsePath (std::string path, std::string *root, std::string *leaf) const;
+  /**
+   * Resolve Config paths from all the roots, and from the
+   * root of the "/Names" namespace.
+   * \param [in,out] resolver The resolver of the Config paths.
+   */
+  void ResolveAll (Resolver &resolver);
 
   /** Container type to hold the root Config path tokens. */
   typedef std::vector<Ptr<Object> > Roots;
 
   /** The list of Config path roots. */
   Roots m_roots;
+  /** The Config paths already split into their elements. */
+  ConfigPathCache m_paths;
+  /** The index of the attributes and trace sources used by the Config paths. */
+  ConfigTypeIndex m_index;
 };
 
 void 
@@ -661,10 +990,54 @@ ConfigImpl::Connect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (this << path << &cb);
 
-  std::string root, leaf;
-  ParsePath (path, &root, &leaf);
-  Config::MatchContainer container = LookupMatches (root);
-  container.Connect (leaf, cb);
+  std::vector<std::pair<std::string, CallbackBase> > connections;
+  connections.push_back (std::make_pair (path, cb));
+  ConnectBatch (connections);
+}
+void 
+ConfigImpl::ConnectBatch (const std::vector<std::pair<std::string, CallbackBase> > &connections)
+{
+  NS_LOG_FUNCTION (this << connections.size ());
+  class ConnectResolver : public Resolver 
+  {
+  public:
+    ConnectResolver (const std::vector<std::string> &roots,
+                     const std::vector<std::string> &leaves,
+                     const std::vector<std::pair<std::string, CallbackBase> > &connections,
+                     ConfigPathCache &cache,
+                     ConfigTypeIndex &index)
+      : Resolver (roots, cache, index),
+        m_leaves (leaves),
+        m_connections (connections),
+        m_index (index)
+    {}
+    virtual void DoOne (Ptr<Object> object, std::string path, uint32_t i) {
+      // As MatchContainer::Connect, but with the trace sources
+      // found from the index.
+      Ptr<const TraceSourceAccessor> accessor =
+        m_index.GetTraceSource (object->GetInstanceTypeId (), m_leaves[i]);
+      if (accessor != 0)
+        {
+          accessor->Connect (PeekPointer (object), path + m_leaves[i], m_connections[i].second);
+        }
+    }
+    const std::vector<std::string> &m_leaves;
+    const std::vector<std::pair<std::string, CallbackBase> > &m_connections;
+    ConfigTypeIndex &m_index;
+  };
+
+  std::vector<std::string> roots;
+  std::vector<std::string> leaves;
+  for (std::vector<std::pair<std::string, CallbackBase> >::const_iterator i = connections.begin ();
+       i != connections.end (); ++i)
+    {
+      std::string root, leaf;
+      ParsePath (i->first, &root, &leaf);
+      roots.push_back (root);
+      leaves.push_back (leaf);
+    }
+  ConnectResolver resolver (roots, leaves, connections, m_paths, m_index);
+  ResolveAll (resolver);
 }
 void 
 ConfigImpl::Disconnect (std::string path, const CallbackBase &cb)
@@ -684,16 +1057,25 @@ ConfigImpl::LookupMatches (std::string path)
   class LookupMatchesResolver : public Resolver 
   {
   public:
-    LookupMatchesResolver (std::string path)
-      : Resolver (path)
+    LookupMatchesResolver (std::string path, ConfigPathCache &cache, ConfigTypeIndex &index)
+      : Resolver (path, cache, index)
     {}
-    virtual void DoOne (Ptr<Object> object, std::string path) {
+    virtual void DoOne (Ptr<Object> object, std::string path, uint32_t i) {
       m_objects.push_back (object);
       m_contexts.push_back (path);
     }
     std::vector<Ptr<Object> > m_objects;
     std::vector<std::string> m_contexts;
-  } resolver = LookupMatchesResolver (path);
+  } resolver = LookupMatchesResolver (path, m_paths, m_index);
+  ResolveAll (resolver);
+
+  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
+}
+
+void
+ConfigImpl::ResolveAll (Resolver &resolver)
+{
+  NS_LOG_FUNCTION (this << &resolver);
   for (Roots::const_iterator i = m_roots.begin (); i != m_roots.end (); i++)
     {
       resolver.Resolve (*i);
@@ -705,8 +1087,6 @@ ConfigImpl::LookupMatches (std::string path)
   // looking at the root of the "/Names" namespace during this go.
   //
   resolver.Resolve (0);
-
-  return Config::MatchContainer (resolver.m_objects, resolver.m_contexts, path);
 }
 
 void 
@@ -838,6 +1218,12 @@ Connect (std::string path, const CallbackBase &cb)
   ConfigImpl::Get ()->Connect (path, cb);
 }
 void 
+ConnectBatch (const std::vector<std::pair<std::string, CallbackBase> > &connections)
+{
+  NS_LOG_FUNCTION (connections.size ());
+  ConfigImpl::Get ()->ConnectBatch (connections);
+}
+void 
 Disconnect (std::string path, const CallbackBase &cb)
 {
   NS_LOG_FUNCTION (path << &cb);
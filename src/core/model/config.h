@@ -22,6 +22,7 @@
 
 #include "ptr.h"
 #include <string>
+#include <utility>
 #include <vector>
 
 /**
@@ -131,6 +132,20 @@ void DisconnectWithoutContext (std::string path, const CallbackBase &cb);
  * context string upon trace event notification.
  */
 void Connect (std::string path, const CallbackBase &cb);
+/**
+ * \ingroup config
+ * \param [in] connections The paths to match trace sources, each with
+ *            the callback to connect to the matching trace sources.
+ *
+ * This function is equivalent to a call to Config::Connect for each
+ * of the \p connections, but the objects are found in a single
+ * traversal of the object graph: the paths which share a prefix, as
+ * "/NodeList/x/DeviceList/y/Mac/MacTx" and
+ * "/NodeList/x/DeviceList/y/Phy/PhyTxBegin", or which differ only by
+ * an index, as "/NodeList/3/..." and "/NodeList/5/...", are resolved
+ * together.  Use it to connect many trace sources in large topologies.
+ */
+void ConnectBatch (const std::vector<std::pair<std::string, CallbackBase> > &connections);
 /**
  * \ingroup config
  * \param [in] path A path to match trace sources.
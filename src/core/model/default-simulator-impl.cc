@@ -25,10 +25,18 @@
 
 #include "ptr.h"
 #include "pointer.h"
+#include "boolean.h"
+#include "string.h"
+#include "event-allocator.h"
 #include "assert.h"
 #include "log.h"
 
+#include <algorithm>
+#include <chrono>
 #include <cmath>
+#include <fstream>
+#include <iostream>
+#include <vector>
 
 
 /**
@@ -46,6 +54,12 @@ NS_LOG_COMPONENT_DEFINE ("DefaultSimulatorImpl");
 
 NS_OBJECT_ENSURE_REGISTERED (DefaultSimulatorImpl);
 
+/**
+ * Initial size of the ring of events scheduled from other threads.
+ * Must be a power of two.
+ */
+static const uint32_t EVENTS_WITH_CONTEXT_SIZE = 1024;
+
 TypeId
 DefaultSimulatorImpl::GetTypeId (void)
 {
@@ -53,6 +67,33 @@ DefaultSimulatorImpl::GetTypeId (void)
     .SetParent<SimulatorImpl> ()
     .SetGroupName ("Core")
     .AddConstructor<DefaultSimulatorImpl> ()
+    .AddAttribute ("EventPool",
+                   "Recycle the memory of executed and removed events "
+                   "through per-thread free lists, rather than returning "
+                   "it to the system allocator.",
+                   BooleanValue (true),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::SetEventPool,
+                                        &DefaultSimulatorImpl::GetEventPool),
+                   MakeBooleanChecker ())
+    .AddAttribute ("Profile",
+                   "Measure the wall clock time spent in each event, "
+                   "and write the time per event type and per context "
+                   "at the end of each Run.",
+                   BooleanValue (false),
+                   MakeBooleanAccessor (&DefaultSimulatorImpl::m_profile),
+                   MakeBooleanChecker ())
+    .AddAttribute ("ProfileReport",
+                   "The file to write the profile report to.  "
+                   "If empty, the report is written to std::clog.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileReport),
+                   MakeStringChecker ())
+    .AddAttribute ("ProfileFolded",
+                   "The file to write the profile to, in the folded stacks "
+                   "format of flame graph tools.  If empty, it is not written.",
+                   StringValue (""),
+                   MakeStringAccessor (&DefaultSimulatorImpl::m_profileFolded),
+                   MakeStringChecker ())
   ;
   return tid;
 }
@@ -70,9 +111,16 @@ DefaultSimulatorImpl::DefaultSimulatorImpl ()
   m_currentUid = 0;
   m_currentTs = 0;
   m_currentContext = Simulator::NO_CONTEXT;
+  m_restoreTs = 0;
+  m_restoreUid = 0;
   m_unscheduledEvents = 0;
   m_eventsWithContextEmpty = true;
+  m_eventsWithContext.resize (EVENTS_WITH_CONTEXT_SIZE);
+  m_eventsWithContextHead = 0;
+  m_eventsWithContextCount = 0;
+  m_eventsWithContextBatch.reserve (EVENTS_WITH_CONTEXT_SIZE);
   m_main = SystemThread::Self();
+  m_profile = false;
 }
 
 DefaultSimulatorImpl::~DefaultSimulatorImpl ()
@@ -92,8 +140,66 @@ DefaultSimulatorImpl::DoDispose (void)
       next.impl->Unref ();
     }
   m_events = 0;
+
+  EventAllocator::Stats stats = EventAllocator::GetStats ();
+  NS_LOG_INFO ("event allocations " << stats.allocations <<
+               ", pool hits " << stats.hits <<
+               ", pool misses " << stats.misses);
   SimulatorImpl::DoDispose ();
 }
+
+void
+DefaultSimulatorImpl::SetEventPool (bool enabled)
+{
+  NS_LOG_FUNCTION (this << enabled);
+  EventAllocator::SetEnabled (enabled);
+}
+
+bool
+DefaultSimulatorImpl::GetEventPool (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return EventAllocator::IsEnabled ();
+}
+
+void
+DefaultSimulatorImpl::WriteProfile (void) const
+{
+  NS_LOG_FUNCTION (this);
+  if (!m_profile)
+    {
+      return;
+    }
+  if (m_profileReport.empty ())
+    {
+      m_profiler.WriteReport (std::clog);
+    }
+  else
+    {
+      std::ofstream os (m_profileReport.c_str ());
+      if (!os.is_open ())
+        {
+          NS_LOG_WARN ("cannot open profile report file " << m_profileReport);
+        }
+      else
+        {
+          m_profiler.WriteReport (os);
+        }
+    }
+  if (!m_profileFolded.empty ())
+    {
+      std::ofstream os (m_profileFolded.c_str ());
+      if (!os.is_open ())
+        {
+          NS_LOG_WARN ("cannot open folded profile file " << m_profileFolded);
+        }
+      else
+        {
+          m_profiler.WriteFolded (os);
+        }
+    }
+}
+
 void
 DefaultSimulatorImpl::Destroy ()
 {
@@ -127,6 +233,41 @@ DefaultSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
   m_events = scheduler;
 }
 
+void
+DefaultSimulatorImpl::RestoreClock (const Time &now)
+{
+  NS_LOG_FUNCTION (this << now);
+  NS_ASSERT_MSG (m_currentUid == 0 && m_currentTs == 0,
+                 "The clock can only be restored before Simulator::Run");
+  NS_ASSERT (now.IsPositive ());
+  uint64_t ts = now.GetTimeStep ();
+  std::vector<Scheduler::Event> events;
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event next = m_events->RemoveNext ();
+      next.key.m_ts += ts;
+      events.push_back (next);
+    }
+  m_currentTs = ts;
+  // The EventIds of the pending events keep their old timestamp.
+  m_restoreTs = ts;
+  m_restoreUid = m_uid;
+  for (std::vector<Scheduler::Event>::const_iterator i = events.begin (); i != events.end (); ++i)
+    {
+      m_events->Insert (*i);
+    }
+}
+
+uint64_t
+DefaultSimulatorImpl::GetEventTs (const EventId &id) const
+{
+  if (id.GetUid () < m_restoreUid)
+    {
+      return id.GetTs () + m_restoreTs;
+    }
+  return id.GetTs ();
+}
+
 // System ID for non-distributed simulation is always zero
 uint32_t 
 DefaultSimulatorImpl::GetSystemId (void) const
@@ -146,7 +287,18 @@ DefaultSimulatorImpl::ProcessOneEvent (void)
   m_currentTs = next.key.m_ts;
   m_currentContext = next.key.m_context;
   m_currentUid = next.key.m_uid;
-  next.impl->Invoke ();
+  if (m_profile)
+    {
+      std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now ();
+      next.impl->Invoke ();
+      std::chrono::steady_clock::duration elapsed = std::chrono::steady_clock::now () - start;
+      m_profiler.Record (typeid (*next.impl), next.key.m_context,
+                         std::chrono::duration_cast<std::chrono::nanoseconds> (elapsed).count ());
+    }
+  else
+    {
+      next.impl->Invoke ();
+    }
   next.impl->Unref ();
 
   ProcessEventsWithContext ();
@@ -161,31 +313,40 @@ DefaultSimulatorImpl::IsFinished (void) const
 void
 DefaultSimulatorImpl::ProcessEventsWithContext (void)
 {
-  if (m_eventsWithContextEmpty)
+  if (m_eventsWithContextEmpty.load (std::memory_order_acquire))
     {
       return;
     }
 
-  // swap queues
-  EventsWithContext eventsWithContext;
+  // copy the whole ring out in one batch, to hold the lock
+  // as briefly as possible.
   {
     CriticalSection cs (m_eventsWithContextMutex);
-    m_eventsWithContext.swap(eventsWithContext);
-    m_eventsWithContextEmpty = true;
+    EventsWithContext::const_iterator ring = m_eventsWithContext.begin ();
+    uint32_t size = m_eventsWithContext.size ();
+    uint32_t first = std::min (m_eventsWithContextCount, size - m_eventsWithContextHead);
+    m_eventsWithContextBatch.insert (m_eventsWithContextBatch.end (),
+                                     ring + m_eventsWithContextHead,
+                                     ring + m_eventsWithContextHead + first);
+    m_eventsWithContextBatch.insert (m_eventsWithContextBatch.end (),
+                                     ring, ring + (m_eventsWithContextCount - first));
+    m_eventsWithContextHead = (m_eventsWithContextHead + m_eventsWithContextCount) & (size - 1);
+    m_eventsWithContextCount = 0;
+    m_eventsWithContextEmpty.store (true, std::memory_order_relaxed);
   }
-  while (!eventsWithContext.empty ())
+  for (EventsWithContext::const_iterator i = m_eventsWithContextBatch.begin ();
+       i != m_eventsWithContextBatch.end (); ++i)
     {
-       EventWithContext event = eventsWithContext.front ();
-       eventsWithContext.pop_front ();
        Scheduler::Event ev;
-       ev.impl = event.event;
-       ev.key.m_ts = m_currentTs + event.timestamp;
-       ev.key.m_context = event.context;
+       ev.impl = i->event;
+       ev.key.m_ts = m_currentTs + i->timestamp;
+       ev.key.m_context = i->context;
        ev.key.m_uid = m_uid;
        m_uid++;
        m_unscheduledEvents++;
        m_events->Insert (ev);
     }
+  m_eventsWithContextBatch.clear ();
 }
 
 void
@@ -205,6 +366,8 @@ DefaultSimulatorImpl::Run (void)
   // If the simulator stopped naturally by lack of events, make a
   // consistency test to check that we didn't lose any events along the way.
   NS_ASSERT (!m_events->IsEmpty () || m_unscheduledEvents == 0);
+
+  WriteProfile ();
 }
 
 void 
@@ -271,8 +434,21 @@ DefaultSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
       ev.event = event;
       {
         CriticalSection cs (m_eventsWithContextMutex);
-        m_eventsWithContext.push_back(ev);
-        m_eventsWithContextEmpty = false;
+        uint32_t size = m_eventsWithContext.size ();
+        if (m_eventsWithContextCount == size)
+          {
+            // The ring is full: double it, moving the wrapped part of
+            // the ring to the new upper half.
+            m_eventsWithContext.resize (2 * size);
+            std::copy (m_eventsWithContext.begin (),
+                       m_eventsWithContext.begin () + m_eventsWithContextHead,
+                       m_eventsWithContext.begin () + size);
+            size *= 2;
+          }
+        uint32_t tail = (m_eventsWithContextHead + m_eventsWithContextCount) & (size - 1);
+        m_eventsWithContext[tail] = ev;
+        m_eventsWithContextCount++;
+        m_eventsWithContextEmpty.store (false, std::memory_order_release);
       }
     }
 }
@@ -320,7 +496,7 @@ DefaultSimulatorImpl::GetDelayLeft (const EventId &id) const
     }
   else
     {
-      return TimeStep (id.GetTs () - m_currentTs);
+      return TimeStep (GetEventTs (id) - m_currentTs);
     }
 }
 
@@ -346,7 +522,7 @@ DefaultSimulatorImpl::Remove (const EventId &id)
     }
   Scheduler::Event event;
   event.impl = id.PeekEventImpl ();
-  event.key.m_ts = id.GetTs ();
+  event.key.m_ts = GetEventTs (id);
   event.key.m_context = id.GetContext ();
   event.key.m_uid = id.GetUid ();
   m_events->Remove (event);
@@ -362,7 +538,16 @@ DefaultSimulatorImpl::Cancel (const EventId &id)
 {
   if (!IsExpired (id))
     {
-      id.PeekEventImpl ()->Cancel ();
+      if (id.GetUid () != 2 && m_events->IsRemoveFast ())
+        {
+          // Do not leave the cancelled event in the event list
+          // until it expires.
+          Remove (id);
+        }
+      else
+        {
+          id.PeekEventImpl ()->Cancel ();
+        }
     }
 }
 
@@ -386,9 +571,10 @@ DefaultSimulatorImpl::IsExpired (const EventId &id) const
         }
       return true;
     }
+  uint64_t ts = GetEventTs (id);
   if (id.PeekEventImpl () == 0 ||
-      id.GetTs () < m_currentTs ||
-      (id.GetTs () == m_currentTs &&
+      ts < m_currentTs ||
+      (ts == m_currentTs &&
        id.GetUid () <= m_currentUid) ||
       id.PeekEventImpl ()->IsCancelled ()) 
     {
@@ -24,12 +24,16 @@
 #include "simulator-impl.h"
 #include "scheduler.h"
 #include "event-impl.h"
+#include "event-profiler.h"
 #include "system-thread.h"
 #include "ns3/system-mutex.h"
 
 #include "ptr.h"
 
+#include <atomic>
 #include <list>
+#include <string>
+#include <vector>
 
 /**
  * \file
@@ -43,6 +47,10 @@ namespace ns3 {
  * \ingroup simulator
  *
  * The default single process simulator implementation.
+ *
+ * When the Profile attribute is set, the simulator measures the wall
+ * clock time spent in each event, and writes an EventProfiler report
+ * at the end of each Run.
  */
 class DefaultSimulatorImpl : public SimulatorImpl
 {
@@ -77,10 +85,33 @@ public:
   virtual void SetScheduler (ObjectFactory schedulerFactory);
   virtual uint32_t GetSystemId (void) const; 
   virtual uint32_t GetContext (void) const;
+  virtual void RestoreClock (const Time &now);
 
 private:
   virtual void DoDispose (void);
 
+  /**
+   * Enable or disable the recycling of event objects.
+   *
+   * \param [in] enabled \c true to recycle event objects through the
+   *        EventAllocator free lists.
+   */
+  void SetEventPool (bool enabled);
+  /**
+   * \returns \c true if event objects are recycled.
+   */
+  bool GetEventPool (void) const;
+  /** Write the event profile, if profiling is enabled. */
+  void WriteProfile (void) const;
+
+  /**
+   * Get the timestamp of an event, including the delay added by
+   * RestoreClock to the events scheduled before it.
+   *
+   * \param [in] id The event identifier.
+   * \returns The timestamp of the event.
+   */
+  uint64_t GetEventTs (const EventId &id) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
   /** Move events from a different context into the main event queue. */
@@ -96,15 +127,30 @@ private:
     EventImpl *event;
   };
   /** Container type for the events from a different context. */
-  typedef std::list<struct EventWithContext> EventsWithContext;
-  /** The container of events from a different context. */
+  typedef std::vector<struct EventWithContext> EventsWithContext;
+  /**
+   * Ring buffer of the events from a different context.
+   *
+   * The size of the ring is a power of two; it is preallocated, and
+   * doubles when a thread pushes an event into a full ring.
+   */
   EventsWithContext m_eventsWithContext;
+  /** Index of the oldest event in the ring. */
+  uint32_t m_eventsWithContextHead;
+  /** Number of events in the ring. */
+  uint32_t m_eventsWithContextCount;
+  /**
+   * Events copied out of the ring by ProcessEventsWithContext, kept
+   * as a member so that its storage is reused from one batch to the next.
+   */
+  EventsWithContext m_eventsWithContextBatch;
   /**
    * Flag \c true if all events with context have been moved to the
-   * primary event queue.
+   * primary event queue.  It is read without taking the mutex, so that
+   * the main thread checks for new events with a single atomic load.
    */
-  bool m_eventsWithContextEmpty;
-  /** Mutex to control access to the list of events with context. */
+  std::atomic<bool> m_eventsWithContextEmpty;
+  /** Mutex to control access to the ring of events with context. */
   SystemMutex m_eventsWithContextMutex;
 
   /** Container type for the events to run at Simulator::Destroy() */
@@ -124,6 +170,10 @@ private:
   uint64_t m_currentTs;
   /** Execution context of the current event. */
   uint32_t m_currentContext;
+  /** Time restored by RestoreClock, added to the events scheduled before it. */
+  uint64_t m_restoreTs;
+  /** Unique id of the first event scheduled after RestoreClock. */
+  uint32_t m_restoreUid;
   /**
    * Number of events that have been inserted but not yet scheduled,
    *  not counting the Destroy events; this is used for validation
@@ -132,6 +182,15 @@ private:
 
   /** Main execution thread. */
   SystemThread::ThreadId m_main;
+
+  /** Flag \c true to measure the time spent in each event. */
+  bool m_profile;
+  /** File name of the profile report; empty for std::clog. */
+  std::string m_profileReport;
+  /** File name of the folded stacks profile; empty for none. */
+  std::string m_profileFolded;
+  /** The time spent in events, by type and context. */
+  EventProfiler m_profiler;
 };
 
 } // namespace ns3
@@ -0,0 +1,76 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-allocator.h"
+
+/**
+ * \file
+ * \ingroup events
+ * ns3::EventAllocator implementation.
+ */
+
+namespace ns3 {
+
+namespace {
+
+/** Smallest block size, in bytes. */
+const uint32_t MIN_SIZE = 16;
+
+/** The free lists of the events. */
+FreeListAllocator g_allocator (MIN_SIZE, EventAllocator::MAX_SIZE, EventAllocator::MAX_FREE);
+
+} // unnamed namespace
+
+void *
+EventAllocator::Allocate (std::size_t size)
+{
+  uint32_t capacity;
+  return g_allocator.Allocate (size, &capacity);
+}
+
+void
+EventAllocator::Deallocate (void *p, std::size_t size)
+{
+  g_allocator.Deallocate (p, g_allocator.GetCapacity (size));
+}
+
+void
+EventAllocator::SetEnabled (bool enabled)
+{
+  g_allocator.SetMaxFree (enabled ? MAX_FREE : 0);
+}
+
+bool
+EventAllocator::IsEnabled (void)
+{
+  return g_allocator.GetMaxFree () != 0;
+}
+
+EventAllocator::Stats
+EventAllocator::GetStats (void)
+{
+  return g_allocator.GetStats ();
+}
+
+void
+EventAllocator::ResetStats (void)
+{
+  g_allocator.ResetStats ();
+}
+
+} // namespace ns3
@@ -37,7 +37,8 @@ EventImpl::~EventImpl ()
 }
 
 EventImpl::EventImpl ()
-  : m_cancel (false)
+  : m_cancel (false),
+    m_link (0)
 {
   NS_LOG_FUNCTION (this);
 }
@@ -52,6 +53,18 @@ EventImpl::Invoke (void)
     }
 }
 
+void
+EventImpl::Isolate (void)
+{
+  NS_LOG_FUNCTION (this);
+  DoIsolate ();
+}
+
+void
+EventImpl::DoIsolate (void)
+{
+}
+
 void
 EventImpl::Cancel (void)
 {
@@ -21,7 +21,9 @@
 #define EVENT_IMPL_H
 
 #include <stdint.h>
+#include <cstddef>
 #include "simple-ref-count.h"
+#include "event-allocator.h"
 
 /**
  * \file
@@ -65,6 +67,49 @@ public:
    * Checked by the simulation engine before calling Invoke().
    */
   bool IsCancelled (void);
+  /**
+   * Prepare the event to run in another thread than the one which
+   * created it.
+   *
+   * The bound arguments which share state with the objects of the
+   * calling thread, such as packets, are replaced by private copies.
+   * Called by the simulator implementations which run events in
+   * several threads, before they hand an event over to another thread.
+   */
+  void Isolate (void);
+  /**
+   * Attach an opaque link to the event, for the use of the Scheduler
+   * which holds it, e.g. to find its entry in Scheduler::Remove
+   * without a lookup.
+   *
+   * \param [in] link The link, or 0 once the event leaves the scheduler.
+   */
+  void SetSchedulerLink (void *link);
+  /**
+   * \returns The link set by SetSchedulerLink, or 0.
+   */
+  void * GetSchedulerLink (void) const;
+
+  /**
+   * Allocate the storage of an event through the EventAllocator.
+   *
+   * \param [in] size The size of the event object.
+   * \returns The storage.
+   */
+  static void * operator new (std::size_t size)
+  {
+    return EventAllocator::Allocate (size);
+  }
+  /**
+   * Release the storage of an event to the EventAllocator.
+   *
+   * \param [in] p The storage.
+   * \param [in] size The size of the event object.
+   */
+  static void operator delete (void *p, std::size_t size)
+  {
+    EventAllocator::Deallocate (p, size);
+  }
 
 protected:
   /**
@@ -74,11 +119,31 @@ protected:
    * arguments bound by a call to one of the MakeEvent() functions.
    */
   virtual void Notify (void) = 0;
+  /**
+   * Implementation for Isolate().
+   *
+   * This does nothing by default; the events made by the MakeEvent()
+   * functions call IsolateEventArgument() on each of their arguments.
+   */
+  virtual void DoIsolate (void);
 
 private:
   bool m_cancel;  /**< Has this event been cancelled. */
+  void *m_link;   /**< The link of the Scheduler holding the event. */
 };
 
+inline void
+EventImpl::SetSchedulerLink (void *link)
+{
+  m_link = link;
+}
+
+inline void *
+EventImpl::GetSchedulerLink (void) const
+{
+  return m_link;
+}
+
 } // namespace ns3
 
 #endif /* EVENT_IMPL_H */
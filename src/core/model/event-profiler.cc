@@ -0,0 +1,314 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "event-profiler.h"
+#include "simulator.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+#if (__GNUC__ >= 3)
+#include <cxxabi.h>
+#endif
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler implementation.
+ */
+
+// Note: no logging in this file, as Record sits on the hot path
+// of every event when profiling is enabled.
+
+namespace ns3 {
+
+EventProfiler::EventProfiler ()
+{
+}
+
+void
+EventProfiler::Record (const std::type_info &type, uint32_t context, uint64_t ns)
+{
+  Key key;
+  key.type = &type;
+  key.context = context;
+  Stats &stats = m_stats[key];
+  stats.count++;
+  stats.totalNs += ns;
+  if (ns > stats.maxNs)
+    {
+      stats.maxNs = ns;
+    }
+}
+
+void
+EventProfiler::Clear (void)
+{
+  m_stats.clear ();
+}
+
+std::string
+EventProfiler::GetTypeName (const std::type_info &type)
+{
+  std::string name = type.name ();
+#if (__GNUC__ >= 3)
+  int status;
+  char *demangled = abi::__cxa_demangle (name.c_str (), NULL, NULL, &status);
+  if (status == 0 && demangled != 0)
+    {
+      name = demangled;
+    }
+  std::free (demangled);
+#endif
+
+  // The events made by MakeEvent are local classes of the MakeEvent
+  // function templates, such as
+  //   ns3::MakeEvent<MEM, OBJ, T1> (MEM, OBJ, T1)::EventMemberImpl1
+  // The first argument of MakeEvent is the function the event calls.
+  const std::string prefix = "ns3::MakeEvent";
+  if (name.compare (0, prefix.size (), prefix) != 0)
+    {
+      return name;
+    }
+  std::string::size_type i = prefix.size ();
+  // skip the template arguments, if any, then find the function arguments.
+  int depth = 0;
+  for (; i < name.size (); i++)
+    {
+      char c = name[i];
+      if (c == '<')
+        {
+          depth++;
+        }
+      else if (c == '>')
+        {
+          depth--;
+        }
+      else if (c == '(' && depth == 0)
+        {
+          break;
+        }
+    }
+  std::string::size_type start = i + 1;
+  depth = 0;
+  for (i = start; i < name.size (); i++)
+    {
+      char c = name[i];
+      if (c == '<' || c == '(')
+        {
+          depth++;
+        }
+      else if (c == '>' || c == ')')
+        {
+          if (depth == 0)
+            {
+              break;
+            }
+          depth--;
+        }
+      else if (c == ',' && depth == 0)
+        {
+          break;
+        }
+    }
+  if (i >= name.size ())
+    {
+      return name;
+    }
+  return name.substr (start, i - start);
+}
+
+std::string
+EventProfiler::GetContextName (uint32_t context)
+{
+  if (context == Simulator::NO_CONTEXT)
+    {
+      return "no context";
+    }
+  std::ostringstream oss;
+  oss << "node " << context;
+  return oss.str ();
+}
+
+/**
+ * Compare two profile entries by decreasing total time.
+ * \param [in] a The first entry.
+ * \param [in] b The second entry.
+ * \returns \c true if \p a must be listed before \p b.
+ */
+static bool
+EntryGreater (const EventProfiler::Entry &a, const EventProfiler::Entry &b)
+{
+  if (a.totalNs != b.totalNs)
+    {
+      return a.totalNs > b.totalNs;
+    }
+  return a.name < b.name;
+}
+
+void
+EventProfiler::Sort (std::vector<Entry> &entries)
+{
+  std::sort (entries.begin (), entries.end (), &EntryGreater);
+}
+
+std::vector<EventProfiler::Entry>
+EventProfiler::GetByType (void) const
+{
+  // Merge by name rather than by type_info, as the same type may have
+  // several type_info objects when it is used from several libraries.
+  std::map<std::string, Entry> byName;
+  std::map<const std::type_info *, std::string> names;
+  for (std::unordered_map<Key, Stats, KeyHash>::const_iterator i = m_stats.begin ();
+       i != m_stats.end (); ++i)
+    {
+      std::map<const std::type_info *, std::string>::iterator n = names.find (i->first.type);
+      if (n == names.end ())
+        {
+          n = names.insert (std::make_pair (i->first.type, GetTypeName (*i->first.type))).first;
+        }
+      Entry &entry = byName[n->second];
+      entry.name = n->second;
+      entry.count += i->second.count;
+      entry.totalNs += i->second.totalNs;
+      entry.maxNs = std::max (entry.maxNs, i->second.maxNs);
+    }
+  std::vector<Entry> entries;
+  for (std::map<std::string, Entry>::const_iterator i = byName.begin (); i != byName.end (); ++i)
+    {
+      entries.push_back (i->second);
+    }
+  Sort (entries);
+  return entries;
+}
+
+std::vector<EventProfiler::Entry>
+EventProfiler::GetByContext (void) const
+{
+  std::map<uint32_t, Entry> byContext;
+  for (std::unordered_map<Key, Stats, KeyHash>::const_iterator i = m_stats.begin ();
+       i != m_stats.end (); ++i)
+    {
+      Entry &entry = byContext[i->first.context];
+      entry.count += i->second.count;
+      entry.totalNs += i->second.totalNs;
+      entry.maxNs = std::max (entry.maxNs, i->second.maxNs);
+    }
+  std::vector<Entry> entries;
+  for (std::map<uint32_t, Entry>::iterator i = byContext.begin (); i != byContext.end (); ++i)
+    {
+      i->second.name = GetContextName (i->first);
+      entries.push_back (i->second);
+    }
+  Sort (entries);
+  return entries;
+}
+
+/**
+ * Write one table of the profile report.
+ * \param [in,out] os The output stream.
+ * \param [in] title The title of the name column.
+ * \param [in] entries The entries, sorted.
+ * \param [in] maxLines The maximum number of entries to write.
+ */
+static void
+WriteTable (std::ostream &os, const std::string &title,
+            const std::vector<EventProfiler::Entry> &entries, uint32_t maxLines)
+{
+  uint64_t total = 0;
+  for (std::vector<EventProfiler::Entry>::const_iterator i = entries.begin ();
+       i != entries.end (); ++i)
+    {
+      total += i->totalNs;
+    }
+  std::ios_base::fmtflags flags = os.flags ();
+  std::streamsize precision = os.precision ();
+  os << std::left
+     << std::setw (12) << "Total (s)"
+     << std::setw (8) << "%"
+     << std::setw (12) << "Count"
+     << std::setw (12) << "Mean (us)"
+     << std::setw (12) << "Max (us)"
+     << title << std::endl;
+  uint32_t lines = 0;
+  for (std::vector<EventProfiler::Entry>::const_iterator i = entries.begin ();
+       i != entries.end () && lines < maxLines; ++i, ++lines)
+    {
+      os << std::left << std::fixed
+         << std::setw (12) << std::setprecision (6) << i->totalNs / 1e9
+         << std::setw (8) << std::setprecision (2) << (total ? 100.0 * i->totalNs / total : 0.0)
+         << std::setw (12) << i->count
+         << std::setw (12) << std::setprecision (3) << (i->count ? i->totalNs / 1e3 / i->count : 0.0)
+         << std::setw (12) << std::setprecision (3) << i->maxNs / 1e3
+         << i->name << std::endl;
+    }
+  if (lines < entries.size ())
+    {
+      os << "... " << entries.size () - lines << " more" << std::endl;
+    }
+  os.flags (flags);
+  os.precision (precision);
+}
+
+void
+EventProfiler::WriteReport (std::ostream &os, uint32_t maxLines) const
+{
+  std::vector<Entry> byType = GetByType ();
+  uint64_t count = 0;
+  uint64_t total = 0;
+  for (std::vector<Entry>::const_iterator i = byType.begin (); i != byType.end (); ++i)
+    {
+      count += i->count;
+      total += i->totalNs;
+    }
+  os << "Event profile: " << count << " events, "
+     << total / 1e9 << " s in event handlers" << std::endl
+     << std::endl;
+  WriteTable (os, "Event type", byType, maxLines);
+  os << std::endl;
+  WriteTable (os, "Context", GetByContext (), maxLines);
+}
+
+void
+EventProfiler::WriteFolded (std::ostream &os) const
+{
+  std::map<std::string, uint64_t> lines;
+  std::map<const std::type_info *, std::string> names;
+  for (std::unordered_map<Key, Stats, KeyHash>::const_iterator i = m_stats.begin ();
+       i != m_stats.end (); ++i)
+    {
+      std::map<const std::type_info *, std::string>::iterator n = names.find (i->first.type);
+      if (n == names.end ())
+        {
+          std::string name = GetTypeName (*i->first.type);
+          // ';' separates the frames of a folded stack.
+          std::replace (name.begin (), name.end (), ';', ',');
+          n = names.insert (std::make_pair (i->first.type, name)).first;
+        }
+      lines[GetContextName (i->first.context) + ";" + n->second] += i->second.totalNs;
+    }
+  for (std::map<std::string, uint64_t>::const_iterator i = lines.begin (); i != lines.end (); ++i)
+    {
+      os << i->first << " " << (i->second + 500) / 1000 << std::endl;
+    }
+}
+
+} // namespace ns3
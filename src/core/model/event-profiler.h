@@ -0,0 +1,170 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EVENT_PROFILER_H
+#define EVENT_PROFILER_H
+
+#include <stdint.h>
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <typeinfo>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup simulator
+ * ns3::EventProfiler declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup simulator
+ * \brief Attribute the wall clock time spent running events to event
+ * types and node contexts.
+ *
+ * When the ns3::DefaultSimulatorImpl::Profile attribute is set, the
+ * simulator measures the wall clock time taken by each event it runs,
+ * and records it here, keyed by the dynamic type of the event and by
+ * the context (node id) the event ran in.  The dynamic type of the
+ * events created by Simulator::Schedule and MakeEvent identifies the
+ * function or method they call, by its signature.
+ *
+ * At the end of Simulator::Run, the simulator writes the profile as
+ *  - a report, sorted by decreasing total time, of the event types and
+ *    of the contexts (see WriteReport);
+ *  - optionally, a "folded stacks" file (see WriteFolded), with one
+ *    line per (context, event type) pair, which can be turned into a
+ *    flame graph by flamegraph.pl or similar tools.
+ */
+class EventProfiler
+{
+public:
+  /** Time spent in a group of events. */
+  struct Entry
+  {
+    std::string name;     /**< The event type or the context. */
+    uint64_t count;       /**< Number of events. */
+    uint64_t totalNs;     /**< Total wall clock time, in nanoseconds. */
+    uint64_t maxNs;       /**< Longest event, in nanoseconds. */
+  };
+
+  EventProfiler ();
+
+  /**
+   * Record the execution of an event.
+   *
+   * \param [in] type The dynamic type of the event.
+   * \param [in] context The context of the event.
+   * \param [in] ns The wall clock time taken by the event, in nanoseconds.
+   */
+  void Record (const std::type_info &type, uint32_t context, uint64_t ns);
+  /** Forget all the recorded events. */
+  void Clear (void);
+
+  /**
+   * \returns The time spent per event type, by decreasing total time.
+   */
+  std::vector<Entry> GetByType (void) const;
+  /**
+   * \returns The time spent per context, by decreasing total time.
+   */
+  std::vector<Entry> GetByContext (void) const;
+
+  /**
+   * Write the time spent per event type and per context, by
+   * decreasing total time.
+   *
+   * \param [in,out] os The output stream.
+   * \param [in] maxLines The maximum number of lines of each table.
+   */
+  void WriteReport (std::ostream &os, uint32_t maxLines = 50) const;
+  /**
+   * Write the profile in the "folded stacks" format: one line per
+   * (context, event type) pair, with the two frames separated by
+   * a semicolon, followed by the total time in microseconds.
+   *
+   * \param [in,out] os The output stream.
+   */
+  void WriteFolded (std::ostream &os) const;
+
+  /**
+   * Get a short, readable, name for an event type.
+   *
+   * For the events made by MakeEvent, this is the signature of the
+   * function they call; otherwise it is the demangled type name.
+   *
+   * \param [in] type The event type.
+   * \returns The name.
+   */
+  static std::string GetTypeName (const std::type_info &type);
+
+private:
+  /** The key of the profile: an event type in a context. */
+  struct Key
+  {
+    const std::type_info *type;  /**< The event type. */
+    uint32_t context;            /**< The context. */
+    /**
+     * \param [in] o The other key.
+     * \returns \c true if the keys are equal.
+     */
+    bool operator == (const Key &o) const
+    {
+      return type == o.type && context == o.context;
+    }
+  };
+  /** Hash function for Key. */
+  struct KeyHash
+  {
+    /**
+     * \param [in] k The key.
+     * \returns The hash.
+     */
+    std::size_t operator () (const Key &k) const
+    {
+      return reinterpret_cast<std::size_t> (k.type) ^ (static_cast<std::size_t> (k.context) * 2654435761u);
+    }
+  };
+  /** The accumulated time of a key. */
+  struct Stats
+  {
+    uint64_t count;    /**< Number of events. */
+    uint64_t totalNs;  /**< Total time. */
+    uint64_t maxNs;    /**< Longest event. */
+  };
+  /**
+   * Sort entries by decreasing total time.
+   * \param [in,out] entries The entries.
+   */
+  static void Sort (std::vector<Entry> &entries);
+  /**
+   * \param [in] context A context.
+   * \returns A name for the context.
+   */
+  static std::string GetContextName (uint32_t context);
+
+  /** The profile. */
+  std::unordered_map<Key, Stats, KeyHash> m_stats;
+};
+
+} // namespace ns3
+
+#endif /* EVENT_PROFILER_H */
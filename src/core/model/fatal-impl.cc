@@ -147,6 +147,9 @@ void
 FlushStreams (void)
 {
   NS_LOG_FUNCTION_NOARGS ();
+  /* Write out the asynchronous log messages, if any. */
+  LogFlush ();
+
   std::list<std::ostream*> **pl = PeekStreamList ();
   if (*pl == 0)
     {
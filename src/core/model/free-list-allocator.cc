@@ -0,0 +1,373 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "free-list-allocator.h"
+#include <mutex>
+#include <new>
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::FreeListAllocator implementation.
+ */
+
+// Note: no logging in this file, as it sits on the hot path of
+// every event and packet creation.
+
+namespace ns3 {
+
+namespace {
+
+/**
+ * \ingroup system
+ * The free lists and statistics of one allocator in one thread.
+ */
+class Cache
+{
+public:
+  Cache ();
+  ~Cache ();
+  /**
+   * Return the free blocks to the system allocator, keeping at most
+   * \p maxFree blocks in each size class.
+   *
+   * \param [in] maxFree The number of blocks to keep per size class.
+   */
+  void Trim (uint32_t maxFree);
+
+  /** A free block: the first word links to the next free block. */
+  struct Block
+  {
+    Block *next;  /**< Next free block of the same size class. */
+  };
+  /** The free list heads, one per size class. */
+  Block *m_free[FreeListAllocator::MAX_CLASSES];
+  /** The length of each free list. */
+  uint32_t m_count[FreeListAllocator::MAX_CLASSES];
+  /** Allocations served from a free list. */
+  uint64_t m_hits;
+  /** Allocations served by the system allocator. */
+  uint64_t m_misses;
+  /** Blocks added to a free list. */
+  uint64_t m_recycled;
+  /** Blocks returned to the system allocator. */
+  uint64_t m_released;
+  /** Blocks currently held in the free lists. */
+  uint64_t m_pooled;
+  /** Largest value of m_pooled. */
+  uint64_t m_peak;
+};
+
+Cache::Cache ()
+{
+  for (uint32_t i = 0; i < FreeListAllocator::MAX_CLASSES; i++)
+    {
+      m_free[i] = 0;
+      m_count[i] = 0;
+    }
+  m_hits = 0;
+  m_misses = 0;
+  m_recycled = 0;
+  m_released = 0;
+  m_pooled = 0;
+  m_peak = 0;
+}
+
+Cache::~Cache ()
+{
+  Trim (0);
+}
+
+void
+Cache::Trim (uint32_t maxFree)
+{
+  for (uint32_t i = 0; i < FreeListAllocator::MAX_CLASSES; i++)
+    {
+      while (m_count[i] > maxFree)
+        {
+          Block *block = m_free[i];
+          m_free[i] = block->next;
+          m_count[i]--;
+          ::operator delete (block);
+          m_released++;
+          m_pooled--;
+        }
+    }
+}
+
+/** The number of allocators which have been given an index. */
+uint32_t g_allocators = 0;
+/**
+ * Serialize the allocation of the indexes, so that an index is only
+ * used up by the allocator which gets it.
+ */
+std::mutex g_allocatorsMutex;
+
+/**
+ * The caches of the calling thread, one per allocator, created on
+ * first use.
+ *
+ * Plain pointers, rather than Cache objects, so that the accesses to
+ * these thread-local variables need no initialization check.
+ */
+thread_local Cache *g_caches[FreeListAllocator::MAX_ALLOCATORS];
+/** Set once the caches of the calling thread have been destroyed. */
+thread_local bool g_cachesDestroyed;
+
+/**
+ * \ingroup system
+ * Destroy the caches of a thread when the thread exits.
+ */
+struct CacheOwner
+{
+  ~CacheOwner ()
+  {
+    for (uint32_t i = 0; i < FreeListAllocator::MAX_ALLOCATORS; i++)
+      {
+        delete g_caches[i];
+        g_caches[i] = 0;
+      }
+    // Blocks freed after this point, e.g. by static destructors,
+    // go straight back to the system allocator.
+    g_cachesDestroyed = true;
+  }
+};
+/** The owner of the caches of the calling thread. */
+thread_local CacheOwner g_cacheOwner;
+
+/**
+ * \ingroup system
+ * Get the cache of an allocator for the calling thread, if it exists.
+ *
+ * \param [in] id The index of the allocator, plus one, or 0.
+ * \returns The cache, or 0.
+ */
+inline Cache *
+FindCache (uint32_t id)
+{
+  return (id == 0 || id > FreeListAllocator::MAX_ALLOCATORS) ? 0 : g_caches[id - 1];
+}
+
+/**
+ * \ingroup system
+ * Create the cache of an allocator for the calling thread, giving
+ * the allocator an index first if needed.
+ *
+ * \param [in,out] id The index of the allocator, plus one, or 0.
+ * \returns The cache, or 0 if the caches of the calling thread have
+ *          already been destroyed, or if there are too many allocators.
+ */
+Cache *
+CreateCache (std::atomic<uint32_t> &id)
+{
+  if (g_cachesDestroyed)
+    {
+      return 0;
+    }
+  uint32_t index = id.load (std::memory_order_acquire);
+  if (index == 0)
+    {
+      std::lock_guard<std::mutex> lock (g_allocatorsMutex);
+      // Another thread may have given the allocator its index first.
+      index = id.load (std::memory_order_relaxed);
+      if (index == 0)
+        {
+          index = ++g_allocators;
+          id.store (index, std::memory_order_release);
+        }
+    }
+  if (index > FreeListAllocator::MAX_ALLOCATORS)
+    {
+      return 0;
+    }
+  // Touch the owner, so that it is destroyed when the thread exits.
+  (void) &g_cacheOwner;
+  g_caches[index - 1] = new Cache ();
+  return g_caches[index - 1];
+}
+
+/**
+ * \ingroup system
+ * Get the cache of an allocator for the calling thread.
+ *
+ * \param [in,out] id The index of the allocator, plus one, or 0.
+ * \returns The cache, or 0 if the caches of the calling thread have
+ *          already been destroyed, or if there are too many allocators.
+ */
+inline Cache *
+GetCache (std::atomic<uint32_t> &id)
+{
+  Cache *cache = FindCache (id.load (std::memory_order_relaxed));
+  if (cache == 0)
+    {
+      cache = CreateCache (id);
+    }
+  return cache;
+}
+
+} // unnamed namespace
+
+inline uint32_t
+FreeListAllocator::GetClass (uint32_t size) const
+{
+  if (size <= m_minSize)
+    {
+      return 0;
+    }
+  // The number of bits of size - 1, less those of m_minSize - 1.
+  return __builtin_clz (m_minSize - 1) - __builtin_clz (size - 1);
+}
+
+void *
+FreeListAllocator::Allocate (uint32_t size, uint32_t *capacity)
+{
+  Cache *cache = GetCache (m_id);
+  if (size > m_maxSize || cache == 0)
+    {
+      if (cache != 0)
+        {
+          cache->m_misses++;
+        }
+      // The full size class, as GetCapacity reports it.
+      *capacity = GetCapacity (size);
+      return ::operator new (*capacity);
+    }
+  uint32_t cls = GetClass (size);
+  *capacity = m_minSize << cls;
+  Cache::Block *block = cache->m_free[cls];
+  if (block != 0)
+    {
+      cache->m_free[cls] = block->next;
+      cache->m_count[cls]--;
+      cache->m_pooled--;
+      cache->m_hits++;
+      return block;
+    }
+  cache->m_misses++;
+  // Always allocate the full size class, so that the block can be
+  // recycled for any request of the same class.
+  return ::operator new (*capacity);
+}
+
+uint32_t
+FreeListAllocator::GetCapacity (uint32_t size) const
+{
+  if (size > m_maxSize)
+    {
+      return size;
+    }
+  return m_minSize << GetClass (size);
+}
+
+void
+FreeListAllocator::Deallocate (void *p, uint32_t capacity)
+{
+  if (p == 0)
+    {
+      return;
+    }
+  Cache *cache = GetCache (m_id);
+  if (cache == 0)
+    {
+      ::operator delete (p);
+      return;
+    }
+  // Only the blocks of exactly one size class can be recycled.
+  if (capacity >= m_minSize && capacity <= m_maxSize
+      && (capacity & (capacity - 1)) == 0)
+    {
+      uint32_t cls = GetClass (capacity);
+      if (cache->m_count[cls] < m_maxFree.load (std::memory_order_relaxed))
+        {
+          Cache::Block *block = static_cast<Cache::Block *> (p);
+          block->next = cache->m_free[cls];
+          cache->m_free[cls] = block;
+          cache->m_count[cls]++;
+          cache->m_recycled++;
+          cache->m_pooled++;
+          if (cache->m_pooled > cache->m_peak)
+            {
+              cache->m_peak = cache->m_pooled;
+            }
+          return;
+        }
+    }
+  cache->m_released++;
+  ::operator delete (p);
+}
+
+void
+FreeListAllocator::SetMaxFree (uint32_t maxFree)
+{
+  m_maxFree.store (maxFree, std::memory_order_relaxed);
+  Cache *cache = FindCache (m_id.load (std::memory_order_relaxed));
+  if (cache != 0)
+    {
+      cache->Trim (maxFree);
+    }
+}
+
+uint32_t
+FreeListAllocator::GetMaxFree (void) const
+{
+  return m_maxFree.load (std::memory_order_relaxed);
+}
+
+void
+FreeListAllocator::Release (void)
+{
+  Cache *cache = FindCache (m_id.load (std::memory_order_relaxed));
+  if (cache != 0)
+    {
+      cache->Trim (0);
+    }
+}
+
+struct FreeListAllocator::Stats
+FreeListAllocator::GetStats (void) const
+{
+  FreeListAllocator::Stats stats = { 0, 0, 0, 0, 0, 0, 0 };
+  Cache *cache = FindCache (m_id.load (std::memory_order_relaxed));
+  if (cache != 0)
+    {
+      stats.allocations = cache->m_hits + cache->m_misses;
+      stats.deallocations = cache->m_recycled + cache->m_released;
+      stats.hits = cache->m_hits;
+      stats.misses = cache->m_misses;
+      stats.released = cache->m_released;
+      stats.pooled = cache->m_pooled;
+      stats.peak = cache->m_peak;
+    }
+  return stats;
+}
+
+void
+FreeListAllocator::ResetStats (void)
+{
+  Cache *cache = FindCache (m_id.load (std::memory_order_relaxed));
+  if (cache != 0)
+    {
+      cache->m_hits = 0;
+      cache->m_misses = 0;
+      cache->m_recycled = 0;
+      cache->m_released = 0;
+      cache->m_peak = cache->m_pooled;
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,159 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FREE_LIST_ALLOCATOR_H
+#define FREE_LIST_ALLOCATOR_H
+
+#include <stdint.h>
+#include <atomic>
+
+/**
+ * \file
+ * \ingroup system
+ * ns3::FreeListAllocator declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup system
+ * \brief Per-thread, size-classed free lists of memory blocks.
+ *
+ * Requested sizes are rounded up to a power of two, between the
+ * smallest and the largest block size of the allocator.  The freed
+ * blocks are kept on one free list per size class, up to a
+ * configurable number of blocks, and reused by the next allocations
+ * of their class.  Blocks larger than the largest size go straight
+ * to the system allocator.
+ *
+ * Each thread has its own free lists and statistics, created on
+ * first use, so that blocks can be allocated and freed from several
+ * threads without any locking.  A block freed by a thread other than
+ * the one which allocated it simply joins the free lists of the
+ * freeing thread.  When a thread exits, its free blocks are returned
+ * to the system allocator, and the blocks it frees afterwards (e.g.
+ * from static destructors) go straight to the system allocator.
+ *
+ * The allocators are constant-initialized, so that they can be used
+ * from static constructors and destructors.  At most MAX_ALLOCATORS
+ * allocators use free lists; any further allocator simply forwards
+ * to the system allocator.
+ */
+class FreeListAllocator
+{
+public:
+  /** Allocation statistics of an allocator in the calling thread. */
+  struct Stats
+  {
+    uint64_t allocations;   /**< Number of calls to Allocate. */
+    uint64_t deallocations; /**< Number of calls to Deallocate. */
+    uint64_t hits;          /**< Allocations served from a free list. */
+    uint64_t misses;        /**< Allocations served by the system allocator. */
+    uint64_t released;      /**< Blocks returned to the system allocator. */
+    uint64_t pooled;        /**< Blocks currently held in the free lists. */
+    uint64_t peak;          /**< Largest number of blocks held in the free lists. */
+  };
+
+  /** Maximum number of allocators with free lists in a process. */
+  static const uint32_t MAX_ALLOCATORS = 16;
+  /** Maximum number of size classes of an allocator. */
+  static const uint32_t MAX_CLASSES = 16;
+
+  /**
+   * Constructor.
+   *
+   * \param [in] minSize The smallest block size, in bytes: a power
+   *             of two, at least the size of a pointer.
+   * \param [in] maxSize The largest block size, in bytes, which is
+   *             recycled: a power of two, at most
+   *             <tt>minSize << (MAX_CLASSES - 1)</tt>.
+   * \param [in] maxFree The initial maximum number of free blocks per
+   *             size class and thread.
+   */
+  constexpr FreeListAllocator (uint32_t minSize, uint32_t maxSize, uint32_t maxFree)
+    : m_minSize (minSize),
+      m_maxSize (maxSize),
+      m_maxFree (maxFree),
+      m_id (0)
+  {
+  }
+
+  /**
+   * Allocate a block.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \param [out] capacity The actual size of the block, in bytes, at
+   *              least \p size.
+   * \returns The block.
+   */
+  void * Allocate (uint32_t size, uint32_t *capacity);
+  /**
+   * Release a block obtained from Allocate.
+   *
+   * \param [in] p The block, or 0.
+   * \param [in] capacity The capacity returned by Allocate.
+   */
+  void Deallocate (void *p, uint32_t capacity);
+  /**
+   * Get the capacity of the blocks allocated for a size.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns The capacity which Allocate returns for \p size.
+   */
+  uint32_t GetCapacity (uint32_t size) const;
+  /**
+   * Set the maximum number of free blocks kept in each size class by
+   * each thread.  Zero disables the recycling.
+   *
+   * Lowering the limit also trims the free lists of the calling thread.
+   *
+   * \param [in] maxFree The maximum number of free blocks.
+   */
+  void SetMaxFree (uint32_t maxFree);
+  /**
+   * \returns The maximum number of free blocks kept in each size class
+   *          by each thread.
+   */
+  uint32_t GetMaxFree (void) const;
+  /** Return the free blocks of the calling thread to the system allocator. */
+  void Release (void);
+  /**
+   * \returns The allocation statistics of the calling thread.
+   */
+  struct Stats GetStats (void) const;
+  /** Reset the allocation statistics of the calling thread. */
+  void ResetStats (void);
+
+private:
+  /**
+   * Get the size class of a block.
+   *
+   * \param [in] size The block size, in bytes, at most m_maxSize.
+   * \returns The index of the smallest size class which holds \p size bytes.
+   */
+  uint32_t GetClass (uint32_t size) const;
+
+  uint32_t m_minSize;               //!< The smallest block size.
+  uint32_t m_maxSize;               //!< The largest recycled block size.
+  std::atomic<uint32_t> m_maxFree;  //!< Maximum number of free blocks per size class.
+  std::atomic<uint32_t> m_id;       //!< Index of the free lists, plus one, or 0.
+};
+
+} // namespace ns3
+
+#endif /* FREE_LIST_ALLOCATOR_H */
@@ -35,182 +35,85 @@ namespace ns3 {
 // of causing recursions leading to stack overflow
 NS_LOG_COMPONENT_DEFINE ("int64x64-128");
 
-/**
- * \ingroup highprec
- * Compute the sign of the result of multiplying or dividing
- * Q64.64 fixed precision operands.
- *
- * \param [in]  sa The signed value of the first operand.
- * \param [in]  sb The signed value of the second operand.
- * \param [out] ua The unsigned magnitude of the first operand.
- * \param [out] ub The unsigned magnitude of the second operand.
- * \returns \c true if the result will be negative.
- */
-static inline  
-bool
-output_sign (const int128_t sa,
-             const int128_t sb,
-             uint128_t & ua,
-             uint128_t & ub)
-{
-  bool negA = sa < 0;
-  bool negB = sb < 0;
-  ua = negA ? -sa : sa;
-  ub = negB ? -sb : sb;
-  return (negA && !negB) || (!negA && negB);
-}
-
 void
-int64x64_t::Mul (const int64x64_t & o)
-{
-  uint128_t a, b;
-  bool negative = output_sign (_v, o._v, a, b);
-  uint128_t result = Umul (a, b);
-  _v = negative ? -result : result;
-}
-
-uint128_t
-int64x64_t::Umul (const uint128_t a, const uint128_t b)
+int64x64_t::MulOverflow (void)
 {
-  uint128_t aL = a & HP_MASK_LO;
-  uint128_t bL = b & HP_MASK_LO;
-  uint128_t aH = (a >> 64) & HP_MASK_LO;
-  uint128_t bH = (b >> 64) & HP_MASK_LO;
-
-  uint128_t result;
-  uint128_t hiPart, loPart, midPart;
-  uint128_t res1, res2;
-
-  // Multiplying (a.h 2^64 + a.l) x (b.h 2^64 + b.l) =
-  //			2^128 a.h b.h + 2^64*(a.h b.l+b.h a.l) + a.l b.l
-  // get the low part a.l b.l
-  // multiply the fractional part
-  loPart = aL * bL;
-  // compute the middle part 2^64*(a.h b.l+b.h a.l)
-  midPart = aL * bH + aH * bL;
-  // compute the high part 2^128 a.h b.h
-  hiPart = aH * bH;
-  // if the high part is not zero, put a warning
-  NS_ABORT_MSG_IF ((hiPart & HP_MASK_HI) != 0,
-                   "High precision 128 bits multiplication error: multiplication overflow.");
-  
-  // Adding 64-bit terms to get 128-bit results, with carries
-  res1 = loPart >> 64;
-  res2 = midPart & HP_MASK_LO;
-  result = res1 + res2;
-
-  res1 = midPart >> 64;
-  res2 = hiPart & HP_MASK_LO;
-  res1 += res2;
-  res1 <<= 64;
-
-  result += res1;
-
-  return result;
+  NS_ABORT_MSG ("High precision 128 bits multiplication error: multiplication overflow.");
 }
 
-void
-int64x64_t::Div (const int64x64_t & o)
-{
-  uint128_t a, b;
-  bool negative = output_sign (_v, o._v, a, b);
-  int128_t result = Udiv (a, b);
-  _v = negative ? -result : result;
-}
-
-uint128_t
-int64x64_t::Udiv (const uint128_t a, const uint128_t b)
+/**
+ * \ingroup highprec
+ * Divide a three digit number by a normalized two digit number,
+ * in base \f$2^{64}\f$, when the quotient fits in one digit
+ * (Knuth, TAOCP vol. 2, 4.3.1, algorithm D).
+ *
+ * \param [in] u2 The high digit of the numerator, not greater than \pname{v1}.
+ * \param [in] u1 The middle digit of the numerator.
+ * \param [in] u0 The low digit of the numerator.
+ * \param [in] v The denominator, with its most significant bit set.
+ * \param [out] rem The remainder.
+ * \returns The quotient.
+ */
+static inline
+uint64_t
+Div3By2 (const uint64_t u2, const uint64_t u1, const uint64_t u0,
+         const uint128_t v, uint128_t & rem)
 {
-  
-  uint128_t rem = a;
-  uint128_t den = b;
-  uint128_t quo = rem / den;
-  rem = rem % den;
-  uint128_t result = quo;
-
-  // Now, manage the remainder
-  const uint64_t DIGITS = 64;  // Number of fraction digits (bits) we need
-  const uint128_t ZERO = 0;
-  
-  NS_ASSERT_MSG (rem < den,
-                 "Remainder not less than divisor");
-  
-  uint64_t digis = 0;          // Number of digits we have already
-  uint64_t shift = 0;          // Number we are going to get this round
-  
-    // Skip trailing zeros in divisor
-  while ( (shift < DIGITS) && !(den & 0x1))
+  const uint64_t v1 = v >> 64;
+  const uint64_t v0 = v;
+  uint128_t top = ((uint128_t)u2 << 64) | u1;
+  uint128_t qhat, rhat;
+  if (u2 >= v1)
     {
-      ++shift;
-      den >>= 1;
+      qhat = 0xffffffffffffffffULL;
+      rhat = top - qhat * v1;
     }
-  
-  while ( (digis < DIGITS) && (rem != ZERO) )
+  else
     {
-      // Skip leading zeros in remainder
-      while ( (digis + shift < DIGITS) &&
-              !(rem & HP128_MASK_HI_BIT))
-        {      
-          ++shift;
-          rem <<= 1;
-        }
-
-      // Cast off denominator bits if:
-      //   Need more digits and
-      //     LSB is zero or 
-      //     rem < den
-      while ( (digis + shift < DIGITS) &&
-              ( !(den & 0x1) || (rem < den) ) )
-        {
-          ++shift;
-          den >>= 1;
-        }
-
-      // Do the division
-      quo = rem / den;
-      rem = rem % den;
-
-      // Add in the quotient as shift bits of the fraction
-      result <<= shift;
-      result += quo;
-
-      digis += shift;
-      shift = 0;
+      qhat = top / v1;
+      rhat = top % v1;
     }
-  // Did we run out of remainder?
-  if (digis < DIGITS)
+  // With a two digit divisor this test makes qhat exact.
+  while ( ((rhat >> 64) == 0)
+          && (qhat * v0 > ((rhat << 64) | u0)) )
     {
-      shift = DIGITS - digis;
-      result <<= shift;
+      --qhat;
+      rhat += v1;
     }
-  
-  return result;
+  // The remainder is less than v, so the high digit can be ignored.
+  rem = (((uint128_t)u1 << 64) | u0) - qhat * v;
+  return qhat;
 }
 
-void 
-int64x64_t::MulByInvert (const int64x64_t & o)
+uint128_t
+int64x64_t::UdivLong (const uint128_t a, const uint128_t b)
 {
-  bool negResult = _v < 0;
-  uint128_t a = negResult ? -_v : _v;
-  uint128_t result = UmulByInvert (a, o._v);
+  const uint64_t aH = a >> 64;
+  const uint64_t aL = a;
+  uint128_t rem;
 
-  _v = negResult ? -result : result;
-}
+  if ((b >> 64) == 0)
+    {
+      // Less than one: long division of (a << 64) by a single digit.
+      // The quotient of the high digit, aH / b, is shifted out: like
+      // the multiplication, the result overflows if a / b >= 2^63.
+      rem = aH % b;
+      uint128_t mid = (rem << 64) | aL;
+      uint128_t quo = mid / b;
+      rem = mid % b;
+      return (quo << 64) + (rem << 64) / b;
+    }
 
-uint128_t
-int64x64_t::UmulByInvert (const uint128_t a, const uint128_t b)
-{
-  uint128_t result, ah, bh, al, bl;
-  uint128_t hi, mid;
-  ah = a >> 64;
-  bh = b >> 64;
-  al = a & HP_MASK_LO;
-  bl = b & HP_MASK_LO;
-  hi = ah * bh;
-  mid = ah * bl + al * bh;
-  mid >>= 64;
-  result = hi + mid;
-  return result;
+  // Normalize, so the most significant bit of the divisor is set,
+  // then divide (a << 64) in two steps of one digit each.
+  const int shift = __builtin_clzll (b >> 64);
+  const uint128_t v = b << shift;
+  const uint64_t u3 = shift ? aH >> (64 - shift) : 0;
+  const uint64_t u2 = (aH << shift) | (shift ? aL >> (64 - shift) : 0);
+  const uint64_t u1 = aL << shift;
+  uint128_t hi = Div3By2 (u3, u2, u1, v, rem);
+  uint128_t lo = Div3By2 (rem >> 64, rem, 0, v, rem);
+  return (hi << 64) | lo;
 }
 
 int64x64_t 
@@ -61,9 +61,10 @@ class int64x64_t
    * We could make this a static and initialize in int64x64-128.cc or
    * int64x64.cc, but this requires handling static initialization order
    * when most of the implementation is inline.  Instead, we resort to
-   * this define.
+   * this define, with the value written out, so that it is not
+   * computed at each use in unoptimized builds.
    */
-#define HP_MAX_64    (std::pow (2.0L, 64))
+#define HP_MAX_64    (18446744073709551616.0L)
 
 public:
   /**
@@ -93,8 +94,30 @@ public:
   /**@{*/
   inline int64x64_t (const double value)
   {
-    const int64x64_t tmp ((long double)value);
-    _v = tmp._v;
+    // The same value as the long double conversion below,
+    // value * 2^64 rounded half up, but computed exactly from
+    // the 53-bit mantissa: value = m * 2^(exp - 53).
+    const bool negative = value < 0;
+    const double v = negative ? -value : value;
+    int exp;
+    const double mant = std::frexp (v, &exp);
+    const uint64_t m = static_cast<uint64_t> (mant * 9007199254740992.0);  // 2^53
+    const int shift = exp + 11;  // exp - 53 + 64
+    uint128_t result;
+    if (shift >= 0)
+      {
+        result = static_cast<uint128_t> (m) << shift;
+      }
+    else if (shift > -64)
+      {
+        result = (m + (1ULL << (-shift - 1))) >> -shift;
+      }
+    else
+      {
+        result = 0;
+      }
+    _v = result;
+    _v = negative ? -_v : _v;
   }
   inline int64x64_t (const long double value)
   {
@@ -204,8 +227,10 @@ public:
   {
     const bool negative = _v < 0;
     const uint128_t value = negative ? -_v : _v;
-    const long double fhi = value >> 64;
-    const long double flo = (value & HP_MASK_LO) / HP_MAX_64;
+    // Convert from 64-bit integers, which is much faster than from
+    // 128-bit integers, and exact.
+    const long double fhi = static_cast<uint64_t> (value >> 64);
+    const long double flo = static_cast<uint64_t> (value & HP_MASK_LO) / HP_MAX_64;
     long double retval = fhi;
     retval += flo;
     retval = negative ? -retval : retval;
@@ -240,7 +265,7 @@ public:
    *
    * \see Invert()
    */
-  void MulByInvert (const int64x64_t & o);
+  inline void MulByInvert (const int64x64_t & o);
 
   /**
    * Compute the inverse of an integer value.
@@ -272,18 +297,32 @@ private:
   friend int64x64_t   operator -  (const int64x64_t & lhs);
   friend int64x64_t   operator !  (const int64x64_t & lhs);
 
+  /**
+   * Compute the sign of the result of multiplying or dividing
+   * Q64.64 fixed precision operands.
+   *
+   * \param [in]  sa The signed value of the first operand.
+   * \param [in]  sb The signed value of the second operand.
+   * \param [out] ua The unsigned magnitude of the first operand.
+   * \param [out] ub The unsigned magnitude of the second operand.
+   * \returns \c true if the result will be negative.
+   */
+  static inline bool output_sign (const int128_t sa,
+                                  const int128_t sb,
+                                  uint128_t & ua,
+                                  uint128_t & ub);
   /**
    * Implement `*=`.
    *
    * \param [in] o The other factor.
    */   
-  void Mul (const int64x64_t & o);
+  inline void Mul (const int64x64_t & o);
   /**
    * Implement `/=`.
    *
    * \param [in] o The divisor.
    */
-  void Div (const int64x64_t & o);
+  inline void Div (const int64x64_t & o);
   /**
    * Unsigned multiplication of Q64.64 values.
    *
@@ -308,15 +347,33 @@ private:
    * high and low 64 bits.  To achieve this, we carry out the multiplication
    * explicitly with 64-bit operands and 128-bit intermediate results.
    */
-  static uint128_t Umul         (const uint128_t a, const uint128_t b);
+  static inline uint128_t Umul (const uint128_t a, const uint128_t b);
+  /** Abort on an overflow of Umul(). */
+  static void MulOverflow (void);
   /**
    * Unsigned division of Q64.64 values.
    *
+   * The result is the Q64.64 value `(a << 64) / b`, truncated.
+   * When \pname{a} is less than one, or \pname{b} is an integer,
+   * this is a single native 128-bit division; otherwise it is
+   * computed by UdivLong().
+   *
    * \param [in] a Numerator.
    * \param [in] b Denominator.
    * \return The Q64.64 representation of `a / b`.
    */
-  static uint128_t Udiv         (const uint128_t a, const uint128_t b);
+  static inline uint128_t Udiv (const uint128_t a, const uint128_t b);
+  /**
+   * Unsigned division of Q64.64 values, for any operands.
+   *
+   * This is a schoolbook long division in base \f$2^{64}\f$, with
+   * one native 128-bit division per digit of the quotient.
+   *
+   * \param [in] a Numerator.
+   * \param [in] b Denominator.
+   * \return The Q64.64 representation of `a / b`.
+   */
+  static uint128_t UdivLong     (const uint128_t a, const uint128_t b);
   /**
    * Unsigned multiplication of Q64.64 and Q0.128 values.
    *
@@ -326,7 +383,7 @@ private:
    *
    * \see Invert()
    */
-  static uint128_t UmulByInvert (const uint128_t a, const uint128_t b);
+  static inline uint128_t UmulByInvert (const uint128_t a, const uint128_t b);
 
   /**
    * Construct from an integral type.
@@ -341,6 +398,99 @@ private:
 };  // class int64x64_t
 
 
+inline bool
+int64x64_t::output_sign (const int128_t sa,
+                         const int128_t sb,
+                         uint128_t & ua,
+                         uint128_t & ub)
+{
+  bool negA = sa < 0;
+  bool negB = sb < 0;
+  ua = negA ? -sa : sa;
+  ub = negB ? -sb : sb;
+  return negA != negB;
+}
+
+inline void
+int64x64_t::Mul (const int64x64_t & o)
+{
+  uint128_t a, b;
+  bool negative = output_sign (_v, o._v, a, b);
+  uint128_t result = Umul (a, b);
+  _v = negative ? -result : result;
+}
+
+inline uint128_t
+int64x64_t::Umul (const uint128_t a, const uint128_t b)
+{
+  uint128_t aL = a & HP_MASK_LO;
+  uint128_t bL = b & HP_MASK_LO;
+  uint128_t aH = (a >> 64) & HP_MASK_LO;
+  uint128_t bH = (b >> 64) & HP_MASK_LO;
+
+  // Multiplying (a.h 2^64 + a.l) x (b.h 2^64 + b.l) =
+  //			2^128 a.h b.h + 2^64*(a.h b.l+b.h a.l) + a.l b.l
+  // We keep the middle 128 bits: the high 64 bits of a.l b.l,
+  // a.h b.l + b.h a.l, and the low 64 bits of a.h b.h.
+  uint128_t loPart = aL * bL;
+  uint128_t midPart = aL * bH + aH * bL;
+  uint128_t hiPart = aH * bH;
+  if ((hiPart & HP_MASK_HI) != 0)
+    {
+      MulOverflow ();
+    }
+  return (loPart >> 64) + midPart + (hiPart << 64);
+}
+
+inline void
+int64x64_t::Div (const int64x64_t & o)
+{
+  uint128_t a, b;
+  bool negative = output_sign (_v, o._v, a, b);
+  int128_t result = Udiv (a, b);
+  _v = negative ? -result : result;
+}
+
+inline uint128_t
+int64x64_t::Udiv (const uint128_t a, const uint128_t b)
+{
+  if ((a >> 64) == 0)
+    {
+      // a << 64 fits in 128 bits.
+      return (a << 64) / b;
+    }
+  if ((b & HP_MASK_LO) == 0)
+    {
+      // (a << 64) / (b.h << 64)
+      return a / (b >> 64);
+    }
+  return UdivLong (a, b);
+}
+
+inline void
+int64x64_t::MulByInvert (const int64x64_t & o)
+{
+  bool negResult = _v < 0;
+  uint128_t a = negResult ? -_v : _v;
+  uint128_t result = UmulByInvert (a, o._v);
+
+  _v = negResult ? -result : result;
+}
+
+inline uint128_t
+int64x64_t::UmulByInvert (const uint128_t a, const uint128_t b)
+{
+  uint128_t ah = a >> 64;
+  uint128_t bh = b >> 64;
+  uint128_t al = a & HP_MASK_LO;
+  uint128_t bl = b & HP_MASK_LO;
+  uint128_t hi = ah * bh;
+  uint128_t mid = ah * bl + al * bh;
+  mid >>= 64;
+  return hi + mid;
+}
+
+
 /**
  * \ingroup highprec
  * Equality operator.
@@ -0,0 +1,237 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "log-async.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogAsyncBuffer implementation.
+ */
+
+// Note: no logging in this file, as it implements the logging output.
+
+namespace ns3 {
+
+/**
+ * \ingroup logging
+ * The next LogAsyncBuffer::m_id.
+ */
+static std::atomic<uint64_t> g_logAsyncNextId (1);
+
+const std::size_t LogAsyncBuffer::RING_SIZE;
+
+LogAsyncBuffer::Ring::Ring ()
+  : m_head (0),
+    m_tail (0)
+{
+}
+
+bool
+LogAsyncBuffer::Ring::Put (const char *s, std::size_t n)
+{
+  std::size_t head = m_head.load (std::memory_order_relaxed);
+  std::size_t tail = m_tail.load (std::memory_order_acquire);
+  if (n > RING_SIZE - (head - tail))
+    {
+      return false;
+    }
+  std::size_t start = head & (RING_SIZE - 1);
+  std::size_t first = std::min (n, RING_SIZE - start);
+  std::memcpy (m_data + start, s, first);
+  std::memcpy (m_data, s + first, n - first);
+  m_head.store (head + n, std::memory_order_release);
+  return true;
+}
+
+bool
+LogAsyncBuffer::Ring::Get (std::streambuf *sink)
+{
+  std::size_t tail = m_tail.load (std::memory_order_relaxed);
+  std::size_t head = m_head.load (std::memory_order_acquire);
+  if (head == tail)
+    {
+      return false;
+    }
+  std::size_t n = head - tail;
+  std::size_t start = tail & (RING_SIZE - 1);
+  std::size_t first = std::min (n, RING_SIZE - start);
+  sink->sputn (m_data + start, first);
+  sink->sputn (m_data, n - first);
+  m_tail.store (head, std::memory_order_release);
+  return true;
+}
+
+
+LogAsyncBuffer::LogAsyncBuffer (std::streambuf *sink)
+  : m_sink (sink),
+    m_id (g_logAsyncNextId++),
+    m_stop (false)
+{
+  m_thread = std::thread (&LogAsyncBuffer::Run, this);
+}
+
+LogAsyncBuffer::~LogAsyncBuffer ()
+{
+  {
+    std::lock_guard<std::mutex> lock (m_wakeMutex);
+    m_stop = true;
+  }
+  m_wake.notify_one ();
+  m_thread.join ();
+  Flush ();
+  for (std::vector<Ring *>::iterator i = m_rings.begin (); i != m_rings.end (); ++i)
+    {
+      delete *i;
+    }
+}
+
+std::streambuf *
+LogAsyncBuffer::GetSink (void) const
+{
+  return m_sink;
+}
+
+void
+LogAsyncBuffer::Flush (void)
+{
+  std::lock_guard<std::mutex> lock (m_drainMutex);
+  Drain ();
+}
+
+LogAsyncBuffer::ThreadState &
+LogAsyncBuffer::GetThreadState (void)
+{
+  static thread_local ThreadState state = { 0, 0, std::string () };
+  if (state.id != m_id)
+    {
+      // First write of this thread to this buffer.  The ring buffers
+      // are owned by the LogAsyncBuffer, and outlive the threads.
+      state.id = m_id;
+      state.ring = new Ring ();
+      state.line.clear ();
+      std::lock_guard<std::mutex> lock (m_ringsMutex);
+      m_rings.push_back (state.ring);
+    }
+  return state;
+}
+
+void
+LogAsyncBuffer::Commit (ThreadState &state)
+{
+  std::string::size_type end = state.line.rfind ('\n');
+  if (end == std::string::npos)
+    {
+      return;
+    }
+  const char *s = state.line.data ();
+  std::size_t n = end + 1;
+  while (n > 0)
+    {
+      // Only the lines longer than the ring buffer are split.
+      std::size_t chunk = std::min (n, RING_SIZE);
+      if (!state.ring->Put (s, chunk))
+        {
+          // The ring buffer is full: rather than waiting for the
+          // background thread, drain the ring buffers ourselves.
+          Flush ();
+          continue;
+        }
+      s += chunk;
+      n -= chunk;
+    }
+  state.line.erase (0, end + 1);
+
+  std::size_t used = state.ring->m_head.load (std::memory_order_relaxed)
+    - state.ring->m_tail.load (std::memory_order_relaxed);
+  if (used > RING_SIZE / 2)
+    {
+      m_wake.notify_one ();
+    }
+}
+
+void
+LogAsyncBuffer::Drain (void)
+{
+  bool written = false;
+  {
+    std::lock_guard<std::mutex> lock (m_ringsMutex);
+    for (std::vector<Ring *>::iterator i = m_rings.begin (); i != m_rings.end (); ++i)
+      {
+        written |= (*i)->Get (m_sink);
+      }
+  }
+  if (written)
+    {
+      m_sink->pubsync ();
+    }
+}
+
+void
+LogAsyncBuffer::Run (void)
+{
+  std::unique_lock<std::mutex> lock (m_wakeMutex);
+  while (!m_stop)
+    {
+      m_wake.wait_for (lock, std::chrono::milliseconds (10));
+      lock.unlock ();
+      Flush ();
+      lock.lock ();
+    }
+}
+
+LogAsyncBuffer::int_type
+LogAsyncBuffer::overflow (int_type c)
+{
+  if (traits_type::eq_int_type (c, traits_type::eof ()))
+    {
+      return traits_type::not_eof (c);
+    }
+  ThreadState &state = GetThreadState ();
+  char ch = traits_type::to_char_type (c);
+  state.line.push_back (ch);
+  if (ch == '\n')
+    {
+      Commit (state);
+    }
+  return c;
+}
+
+std::streamsize
+LogAsyncBuffer::xsputn (const char *s, std::streamsize n)
+{
+  ThreadState &state = GetThreadState ();
+  state.line.append (s, n);
+  if (std::memchr (s, '\n', n) != 0)
+    {
+      Commit (state);
+    }
+  return n;
+}
+
+int
+LogAsyncBuffer::sync (void)
+{
+  return 0;
+}
+
+} // namespace ns3
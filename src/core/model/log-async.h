@@ -0,0 +1,165 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef NS3_LOG_ASYNC_H
+#define NS3_LOG_ASYNC_H
+
+#include <stdint.h>
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <streambuf>
+#include <string>
+#include <thread>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup logging
+ * ns3::LogAsyncBuffer declaration.
+ *
+ * This is private to the logging implementation.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup logging
+ * A stream buffer which writes the lines it receives to another stream
+ * buffer, the sink, from a background thread.
+ *
+ * Each thread writing to this buffer accumulates its current line in a
+ * thread local string.  When the line is complete, it is copied into a
+ * single producer, single consumer, ring buffer owned by the thread.
+ * The background thread, or any thread calling Flush, drains the ring
+ * buffers into the sink.  A thread whose ring buffer is full drains the
+ * ring buffers itself.
+ *
+ * \internal
+ * The implementation uses the standard library threads rather than
+ * ns3::SystemThread and ns3::SystemMutex, which themselves log.
+ */
+class LogAsyncBuffer : public std::streambuf
+{
+public:
+  /**
+   * Constructor: start the background thread.
+   * \param [in] sink The stream buffer to write the lines to.
+   */
+  LogAsyncBuffer (std::streambuf *sink);
+  /**
+   * Destructor: stop the background thread and write out the
+   * pending lines.  No other thread may write to this buffer
+   * during or after its destruction.
+   */
+  virtual ~LogAsyncBuffer ();
+
+  /** \returns The stream buffer the lines are written to. */
+  std::streambuf *GetSink (void) const;
+  /** Write out all the complete lines pending in the ring buffers. */
+  void Flush (void);
+
+protected:
+  /**
+   * Append a character to the line of the calling thread.
+   * \param [in] c The character.
+   * \returns \p c, or not \c EOF if \p c is \c EOF.
+   */
+  virtual int_type overflow (int_type c);
+  /**
+   * Append characters to the line of the calling thread.
+   * \param [in] s The characters.
+   * \param [in] n The number of characters.
+   * \returns \p n.
+   */
+  virtual std::streamsize xsputn (const char *s, std::streamsize n);
+  /**
+   * Do nothing: std::clog is unit buffered, and syncs after each
+   * insertion, but incomplete lines must not be written out.
+   * \returns 0.
+   */
+  virtual int sync (void);
+
+private:
+  /** The size of the ring buffer of each thread. */
+  static const std::size_t RING_SIZE = 1 << 16;
+
+  /** A single producer, single consumer ring buffer of characters. */
+  struct Ring
+  {
+    Ring ();
+    /**
+     * Copy characters into the ring buffer, if they fit.  Called by
+     * the thread which owns the ring buffer.
+     * \param [in] s The characters.
+     * \param [in] n The number of characters.
+     * \returns \c false if there is not enough room for \p n characters.
+     */
+    bool Put (const char *s, std::size_t n);
+    /**
+     * Write the content of the ring buffer to a stream buffer.
+     * Called with LogAsyncBuffer::m_drainMutex held.
+     * \param [in] sink The stream buffer.
+     * \returns \c true if some characters were written.
+     */
+    bool Get (std::streambuf *sink);
+
+    std::atomic<std::size_t> m_head;  //!< Write index, updated by the owner.
+    std::atomic<std::size_t> m_tail;  //!< Read index, updated by the drainer.
+    char m_data[RING_SIZE];           //!< The characters.
+  };
+
+  /** The state of a thread writing to a LogAsyncBuffer. */
+  struct ThreadState
+  {
+    uint64_t id;       //!< The LogAsyncBuffer::m_id the state belongs to.
+    Ring *ring;        //!< The ring buffer of the thread.
+    std::string line;  //!< The line being written by the thread.
+  };
+
+  /**
+   * Get the state of the calling thread, creating its ring buffer
+   * if needed.
+   * \returns The state.
+   */
+  ThreadState &GetThreadState (void);
+  /**
+   * Copy the complete lines at the start of the current line of the
+   * calling thread into its ring buffer.
+   * \param [in,out] state The state of the calling thread.
+   */
+  void Commit (ThreadState &state);
+  /** Drain all the ring buffers into the sink, with m_drainMutex held. */
+  void Drain (void);
+  /** The body of the background thread. */
+  void Run (void);
+
+  std::streambuf *m_sink;            //!< The stream buffer to write to.
+  uint64_t m_id;                     //!< Unique id, for the thread local state.
+  std::vector<Ring *> m_rings;       //!< The ring buffers of all the threads.
+  std::mutex m_ringsMutex;           //!< Protects m_rings.
+  std::mutex m_drainMutex;           //!< Serializes the drains.
+  std::mutex m_wakeMutex;            //!< Protects m_stop, for m_wake.
+  std::condition_variable m_wake;    //!< Wakes the background thread up.
+  bool m_stop;                       //!< Stop the background thread.
+  std::thread m_thread;              //!< The background thread.
+};
+
+} // namespace ns3
+
+#endif /* NS3_LOG_ASYNC_H */
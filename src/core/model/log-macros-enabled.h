@@ -30,6 +30,54 @@
 #ifdef NS3_LOG_ENABLE
 
 
+/**
+ * \ingroup logging
+ * Tell the compiler that a log level check is expected to fail,
+ * so that it keeps the disabled logging statements out of the
+ * straight-line code.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ *
+ * \param [in] cond The log level check.
+ */
+#if defined (__GNUC__)
+#define NS_LOG_UNLIKELY(cond) __builtin_expect (!!(cond), 0)
+#else
+#define NS_LOG_UNLIKELY(cond) (cond)
+#endif
+
+#ifndef NS_LOG_STATIC_LEVEL
+/**
+ * \ingroup logging
+ * The log levels which the NS_LOG macros of a compilation unit can
+ * print, fixed at compile time.
+ *
+ * By default, every level can be enabled at run time.  Define this
+ * macro, on the compiler command line or before including log.h, to
+ * a mask of ns3::LogLevel values to remove the logging statements of
+ * the other levels from the code altogether:
+ * \code
+ *   #define NS_LOG_STATIC_LEVEL ns3::LOG_LEVEL_WARN
+ *   #include "ns3/log.h"
+ * \endcode
+ * The levels of the mask are still enabled and disabled at run time.
+ */
+#define NS_LOG_STATIC_LEVEL ns3::LOG_ALL
+#endif
+
+/**
+ * \ingroup logging
+ * Check a log level, first against NS_LOG_STATIC_LEVEL, which the
+ * compiler resolves for the constant levels, then against the levels
+ * enabled in the log component.
+ * \internal
+ * Logging implementation macro; should not be called directly.
+ *
+ * \param [in] level The log level.
+ */
+#define NS_LOG_IS_ENABLED(level)                                        \
+  NS_LOG_UNLIKELY (((level) & (NS_LOG_STATIC_LEVEL)) != 0 && g_log.IsEnabled (level))
+
 /**
  * \ingroup logging
  * Append the simulation time to a log message.
@@ -153,7 +201,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (level))                              \
+      if (NS_LOG_IS_ENABLED (level))                            \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -177,7 +225,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_IS_ENABLED (ns3::LOG_FUNCTION))                \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -214,7 +262,7 @@
   NS_LOG_CONDITION                                              \
   do                                                            \
     {                                                           \
-      if (g_log.IsEnabled (ns3::LOG_FUNCTION))                  \
+      if (NS_LOG_IS_ENABLED (ns3::LOG_FUNCTION))                \
         {                                                       \
           NS_LOG_APPEND_TIME_PREFIX;                            \
           NS_LOG_APPEND_NODE_PREFIX;                            \
@@ -34,6 +34,10 @@
 #include <cstdlib>
 #endif
 
+#ifdef HAVE_PTHREAD_H
+#include "log-async.h"
+#endif
+
 /**
  * \file
  * \ingroup logging
@@ -55,6 +59,30 @@ static LogTimePrinter g_logTimePrinter = 0;
  */
 static LogNodePrinter g_logNodePrinter = 0;
 
+#ifdef HAVE_PTHREAD_H
+/**
+ * \ingroup logging
+ * The stream buffer of std::clog, when the log messages
+ * are written asynchronously.
+ */
+static LogAsyncBuffer *g_logAsyncBuffer = 0;
+
+/**
+ * \ingroup logging
+ * Write out the asynchronous log messages at exit.
+ * This is private to the logging implementation.
+ */
+static class LogAsyncCleanup
+{
+public:
+  /** Destructor: stop writing asynchronously. */
+  ~LogAsyncCleanup ()
+  {
+    LogSetAsync (false);
+  }
+} g_logAsyncCleanup;  //!< Write out the log messages at exit.
+#endif /* HAVE_PTHREAD_H */
+
 /**
  * \ingroup logging
  * Handler for \c print-list token in NS_LOG
@@ -268,19 +296,6 @@ LogComponent::EnvVarCheck (void)
 }
 
 
-bool 
-LogComponent::IsEnabled (const enum LogLevel level) const
-{
-  //  LogComponentEnableEnvVar ();
-  return (level & m_levels) ? 1 : 0;
-}
-
-bool
-LogComponent::IsNoneEnabled (void) const
-{
-  return m_levels == 0;
-}
-
 void
 LogComponent::SetMask (const enum LogLevel level)
 {
@@ -538,7 +553,11 @@ static void CheckEnvironmentVariables (void)
         {
           // ie no '=' characters found 
           component = tmp;
-          if (ComponentExists(component) || component == "*" || component == "***")
+          if (component == "async")
+            {
+              LogSetAsync (true);
+            }
+          else if (ComponentExists(component) || component == "*" || component == "***")
             {
               return;
             }
@@ -631,6 +650,40 @@ LogNodePrinter LogGetNodePrinter (void)
   return g_logNodePrinter;
 }
 
+void LogSetAsync (bool async)
+{
+#ifdef HAVE_PTHREAD_H
+  if (async && g_logAsyncBuffer == 0)
+    {
+      g_logAsyncBuffer = new LogAsyncBuffer (std::clog.rdbuf ());
+      std::clog.rdbuf (g_logAsyncBuffer);
+    }
+  else if (!async && g_logAsyncBuffer != 0)
+    {
+      std::clog.rdbuf (g_logAsyncBuffer->GetSink ());
+      delete g_logAsyncBuffer;
+      g_logAsyncBuffer = 0;
+    }
+#endif
+}
+bool LogIsAsync (void)
+{
+#ifdef HAVE_PTHREAD_H
+  return g_logAsyncBuffer != 0;
+#else
+  return false;
+#endif
+}
+void LogFlush (void)
+{
+#ifdef HAVE_PTHREAD_H
+  if (g_logAsyncBuffer != 0)
+    {
+      g_logAsyncBuffer->Flush ();
+    }
+#endif
+}
+
 
 ParameterLogger::ParameterLogger (std::ostream &os)
   : m_first (true),
@@ -78,6 +78,18 @@
  *   NS_LOG_FUNCTION (this << arg1 << args);
  * \endcode
  * Use NS_LOG_FUNCTION_NOARGS() only in static functions with no arguments.
+ *
+ * The levels which a file can log can also be limited at compile time,
+ * to remove the other logging statements from optimized code, see
+ * NS_LOG_STATIC_LEVEL.
+ *
+ * By default each log message is written to \c std::clog by the thread
+ * which logs it, before the logging statement returns.  For long runs
+ * with many enabled components, the messages can instead be written
+ * asynchronously, see ns3::LogSetAsync, or the \c async token of NS_LOG:
+ * \code
+ *   $ NS_LOG='async:Component1=info' ./waf --run ...
+ * \endcode
  */
 /** @{ */
 
@@ -303,6 +315,42 @@ void LogSetNodePrinter (LogNodePrinter np);
  */
 LogNodePrinter LogGetNodePrinter (void);
 
+/**
+ * Write the log messages to \c std::clog asynchronously.
+ *
+ * When enabled, the output of \c std::clog, and therefore of all the
+ * NS_LOG macros, is collected line by line into a lock-free ring
+ * buffer owned by the logging thread, and written to the original
+ * \c std::clog buffer by a background thread.  The messages are still
+ * formatted by the thread which logs them, but they no longer wait
+ * for the output.  The lines logged by one thread stay in order, but
+ * the lines of different threads may be reordered.  When a ring buffer
+ * is full, the logging thread writes out the pending lines itself, so
+ * no message is lost.
+ *
+ * Same as running your program with the NS_LOG environment
+ * variable containing the \c async token.
+ *
+ * This function must not be called while other threads are logging.
+ * It has no effect when ns-3 is built without threading support.
+ *
+ * \param [in] async \c true to write asynchronously, \c false to
+ *            write synchronously again.
+ */
+void LogSetAsync (bool async);
+/**
+ * Check whether the log messages are written asynchronously.
+ * \returns \c true if the log messages are written asynchronously.
+ */
+bool LogIsAsync (void);
+/**
+ * Write out all the complete lines pending in the asynchronous
+ * log buffers.  This is called by Simulator::Destroy and before
+ * aborting on a fatal error.  Does nothing when the log messages
+ * are written synchronously.
+ */
+void LogFlush (void);
+
 
 /**
  * A single log component configuration.
@@ -409,6 +457,23 @@ private:
 
 };  // class LogComponent
 
+/*
+ * These checks sit in front of every logging statement, so they are
+ * inlined: with logging disabled a log statement costs a load of
+ * m_levels and a branch.
+ */
+inline bool
+LogComponent::IsEnabled (const enum LogLevel level) const
+{
+  return (level & m_levels) != 0;
+}
+
+inline bool
+LogComponent::IsNoneEnabled (void) const
+{
+  return m_levels == 0;
+}
+
   
 /**
  * Insert `, ` when streaming function arguments.
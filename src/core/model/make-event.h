@@ -266,6 +266,22 @@ EventImpl * MakeEvent (void (*f)(U1,U2,U3,U4,U5), T1 a1, T2 a2, T3 a3, T4 a4, T5
 
 namespace ns3 {
 
+/**
+ * \ingroup events
+ * Give an argument bound to an event its own copy of the state it
+ * shares with the objects of the calling thread, before the event is
+ * handed over to another thread (see EventImpl::Isolate).
+ *
+ * This generic version does nothing: the types which need it, such
+ * as Ptr<Packet>, provide an overload.
+ *
+ * \tparam T \deduced The argument type.
+ */
+template <typename T>
+void IsolateEventArgument (T &)
+{
+}
+
 /**
  * \ingroup makeeventmemptr
  * Helper for the MakeEvent functions which take a class method.
@@ -348,6 +364,10 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1);
@@ -379,6 +399,11 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2);
@@ -412,6 +437,12 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+      IsolateEventArgument (m_a3);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3);
@@ -447,6 +478,13 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+      IsolateEventArgument (m_a3);
+      IsolateEventArgument (m_a4);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4);
@@ -485,6 +523,14 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+      IsolateEventArgument (m_a3);
+      IsolateEventArgument (m_a4);
+      IsolateEventArgument (m_a5);
+    }
     virtual void Notify (void)
     {
       (EventMemberImplObjTraits<OBJ>::GetReference (m_obj).*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
@@ -519,6 +565,10 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1);
@@ -549,6 +599,11 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2);
@@ -582,6 +637,12 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+      IsolateEventArgument (m_a3);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2, m_a3);
@@ -617,6 +678,13 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+      IsolateEventArgument (m_a3);
+      IsolateEventArgument (m_a4);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4);
@@ -654,6 +722,14 @@ protected:
     {
     }
 private:
+    virtual void DoIsolate (void)
+    {
+      IsolateEventArgument (m_a1);
+      IsolateEventArgument (m_a2);
+      IsolateEventArgument (m_a3);
+      IsolateEventArgument (m_a4);
+      IsolateEventArgument (m_a5);
+    }
     virtual void Notify (void)
     {
       (*m_function)(m_a1, m_a2, m_a3, m_a4, m_a5);
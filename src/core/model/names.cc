@@ -16,7 +16,7 @@
  * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
  */
 
-#include <map>
+#include <unordered_map>
 #include "object.h"
 #include "log.h"
 #include "assert.h"
@@ -44,69 +44,35 @@ class NameNode
 public:
   /** Default constructor. */
   NameNode ();
-  /**
-   * Copy constructor.
-   *
-   * \param [in] nameNode The NameNode to copy from.
-   */
-  NameNode (const NameNode &nameNode);
   /**
    * Constructor.
    *
    * \param [in] parent The parent NameNode.
-   * \param [in] name The name of this NameNode
+   * \param [in] name The interned name of this NameNode
    * \param [in] object The object corresponding to this NameNode.
    */
-  NameNode (NameNode *parent, std::string name, Ptr<Object> object);
-  /**
-   * Assignment operator.
-   *
-   * \param [in] rhs The NameNode to copy from.
-   * \returns The lhs NameNode.
-   */
-  NameNode &operator = (const NameNode &rhs);
+  NameNode (NameNode *parent, const std::string *name, Ptr<Object> object);
 
   /** Destructor. */
   ~NameNode ();
 
   /** The parent NameNode. */
   NameNode *m_parent;
-  /** The name of this NameNode. */
-  std::string m_name;
+  /** The name of this NameNode, interned by NamesPriv. */
+  const std::string *m_name;
   /** The object corresponding to this NameNode. */
   Ptr<Object> m_object;
-
-  /** Children of this NameNode. */
-  std::map<std::string, NameNode *> m_nameMap;
 };
 
 NameNode::NameNode ()
-  : m_parent (0), m_name (""), m_object (0)
+  : m_parent (0), m_name (0), m_object (0)
 {
 }
 
-NameNode::NameNode (const NameNode &nameNode)
-{
-  m_parent = nameNode.m_parent;
-  m_name = nameNode.m_name;
-  m_object = nameNode.m_object;
-  m_nameMap = nameNode.m_nameMap;
-}
-
-NameNode &
-NameNode::operator = (const NameNode &rhs)
-{
-  m_parent = rhs.m_parent;
-  m_name = rhs.m_name;
-  m_object = rhs.m_object;
-  m_nameMap = rhs.m_nameMap;
-  return *this;
-}
-
-NameNode::NameNode (NameNode *parent, std::string name, Ptr<Object> object)
+NameNode::NameNode (NameNode *parent, const std::string *name, Ptr<Object> object)
   : m_parent (parent), m_name (name), m_object (object)
 {
-  NS_LOG_FUNCTION (this << parent << name << object);
+  NS_LOG_FUNCTION (this << parent << *name << object);
 }
 
 NameNode::~NameNode ()
@@ -117,6 +83,13 @@ NameNode::~NameNode ()
 /**
  * \ingroup config
  * The singleton root Names object.
+ *
+ * The names are interned: each distinct name is stored once, and the
+ * NameNodes point to it.  The children of all the NameNodes are in a
+ * single hash table, indexed by the parent NameNode and the interned
+ * name, so that a name which is not interned can not be the name of
+ * any child.  The NameNodes found from a path are cached by path, until
+ * a NameNode is renamed.
  */
 class NamesPriv : public Singleton<NamesPriv>
 {
@@ -176,6 +149,42 @@ public:
 private:
   friend class Names;
 
+  /** The key of a child NameNode: its parent, and its interned name. */
+  struct ChildKey
+  {
+    const NameNode *parent;    //!< The parent NameNode.
+    const std::string *name;   //!< The interned name.
+    /**
+     * \param [in] other The other key.
+     * \returns \c true if the keys are equal.
+     */
+    bool operator == (const ChildKey &other) const
+    {
+      return parent == other.parent && name == other.name;
+    }
+  };
+  /** Hash a ChildKey. */
+  struct ChildKeyHash
+  {
+    /**
+     * \param [in] key The key.
+     * \returns The hash of the key.
+     */
+    std::size_t operator () (const ChildKey &key) const
+    {
+      std::size_t h = reinterpret_cast<std::size_t> (key.parent);
+      return h ^ (reinterpret_cast<std::size_t> (key.name) + 0x9e3779b9 + (h << 6) + (h >> 2));
+    }
+  };
+  /** Interned name strings, with the number of NameNodes using them. */
+  typedef std::unordered_map<std::string, uint32_t> StringPool;
+  /** The children of all the NameNodes. */
+  typedef std::unordered_map<ChildKey, NameNode *, ChildKeyHash> ChildMap;
+  /** Map from object pointers to their NameNodes. */
+  typedef std::unordered_map<Object *, NameNode *> ObjectMap;
+  /** Cache of the NameNodes found from a path, without the "/Names/" prefix. */
+  typedef std::unordered_map<std::string, NameNode *> PathCache;
+
   /**
    * Check if an object has a name.
    *
@@ -191,20 +200,50 @@ private:
    * \returns \c true if \c name already exists as a child of \c node.
    */
   bool IsDuplicateName (NameNode *node, std::string name);
+  /**
+   * Find a child of a NameNode.
+   *
+   * \param [in] node The parent NameNode.
+   * \param [in] name The name of the child.
+   * \returns The child NameNode, or 0 if it does not exist.
+   */
+  NameNode *FindChild (const NameNode *node, const std::string &name) const;
+  /**
+   * Intern a name, for one more NameNode.
+   *
+   * \param [in] name The name.
+   * \returns The interned name.
+   */
+  const std::string *Intern (const std::string &name);
+  /**
+   * Release an interned name, used by one less NameNode.
+   *
+   * \param [in] name The interned name.
+   */
+  void Release (const std::string *name);
 
+  /** The name of the root NameNode. */
+  const std::string m_rootName;
   /** The root NameNode. */
   NameNode m_root;
 
+  /** The interned names. */
+  StringPool m_strings;
+  /** The children of all the NameNodes. */
+  ChildMap m_children;
   /** Map from object pointers to their NameNodes. */
-  std::map<Ptr<Object>, NameNode *> m_objectMap;
+  ObjectMap m_objectMap;
+  /** The NameNodes found from a path. */
+  PathCache m_pathCache;
 };
 
 NamesPriv::NamesPriv ()
+  : m_rootName ("Names")
 {
   NS_LOG_FUNCTION (this);
 
   m_root.m_parent = 0;
-  m_root.m_name = "Names";
+  m_root.m_name = &m_rootName;
   m_root.m_object = 0;
 }
 
@@ -212,7 +251,6 @@ NamesPriv::~NamesPriv ()
 {
   NS_LOG_FUNCTION (this);
   Clear ();
-  m_root.m_name = "";
 }
 
 void
@@ -223,18 +261,20 @@ NamesPriv::Clear (void)
   // Every name is associated with an object in the object map, so freeing the
   // NameNodes in this map will free all of the memory allocated for the NameNodes
   //
-  for (std::map<Ptr<Object>, NameNode *>::iterator i = m_objectMap.begin (); i != m_objectMap.end (); ++i)
+  for (ObjectMap::iterator i = m_objectMap.begin (); i != m_objectMap.end (); ++i)
     {
       delete i->second;
       i->second = 0;
     }
 
   m_objectMap.clear ();
+  m_children.clear ();
+  m_strings.clear ();
+  m_pathCache.clear ();
 
   m_root.m_parent = 0;
-  m_root.m_name = "Names";
+  m_root.m_name = &m_rootName;
   m_root.m_object = 0;
-  m_root.m_nameMap.clear ();
 }
 
 bool
@@ -338,9 +378,10 @@ NamesPriv::Add (Ptr<Object> context, std::string name, Ptr<Object> object)
       return false;
     }
 
-  NameNode *newNode = new NameNode (node, name, object);
-  node->m_nameMap[name] = newNode;
-  m_objectMap[object] = newNode;
+  NameNode *newNode = new NameNode (node, Intern (name), object);
+  ChildKey key = { node, newNode->m_name };
+  m_children[key] = newNode;
+  m_objectMap[PeekPointer (object)] = newNode;
 
   return true;
 }
@@ -442,8 +483,8 @@ NamesPriv::Rename (Ptr<Object> context, std::string oldname, std::string newname
       return false;
     }
 
-  std::map<std::string, NameNode *>::iterator i = node->m_nameMap.find (oldname);
-  if (i == node->m_nameMap.end ())
+  NameNode *changeNode = FindChild (node, oldname);
+  if (changeNode == 0)
     {
       NS_LOG_LOGIC ("Old name does not exist in name map");
       return false;
@@ -454,15 +495,18 @@ NamesPriv::Rename (Ptr<Object> context, std::string oldname, std::string newname
 
       //
       // The rename process consists of:
-      // 1.  Geting the pointer to the name node from the map and remembering it;
-      // 2.  Removing the map entry corresponding to oldname from the map;
-      // 3.  Changing the name string in the name node;
-      // 4.  Adding the name node back in the map under the newname.
+      // 1.  Removing the entry corresponding to oldname from the children;
+      // 2.  Changing the name in the name node;
+      // 3.  Adding the name node back in the children under the newname;
+      // 4.  Forgetting the cached paths, some of which went through oldname.
       //
-      NameNode *changeNode = i->second;
-      node->m_nameMap.erase (i);
-      changeNode->m_name = newname;
-      node->m_nameMap[newname] = changeNode;
+      ChildKey key = { node, changeNode->m_name };
+      m_children.erase (key);
+      Release (changeNode->m_name);
+      changeNode->m_name = Intern (newname);
+      key.name = changeNode->m_name;
+      m_children[key] = changeNode;
+      m_pathCache.clear ();
       return true;
     }
 }
@@ -472,7 +516,7 @@ NamesPriv::FindName (Ptr<Object> object)
 {
   NS_LOG_FUNCTION (this << object);
 
-  std::map<Ptr<Object>, NameNode *>::iterator i = m_objectMap.find (object);
+  ObjectMap::iterator i = m_objectMap.find (PeekPointer (object));
   if (i == m_objectMap.end ())
     {
       NS_LOG_LOGIC ("Object does not exist in object map");
@@ -481,7 +525,7 @@ NamesPriv::FindName (Ptr<Object> object)
   else
     {
       NS_LOG_LOGIC ("Object exists in object map");
-      return i->second->m_name;
+      return *i->second->m_name;
     }
 }
 
@@ -490,7 +534,7 @@ NamesPriv::FindPath (Ptr<Object> object)
 {
   NS_LOG_FUNCTION (this << object);
 
-  std::map<Ptr<Object>, NameNode *>::iterator i = m_objectMap.find (object);
+  ObjectMap::iterator i = m_objectMap.find (PeekPointer (object));
   if (i == m_objectMap.end ())
     {
       NS_LOG_LOGIC ("Object does not exist in object map");
@@ -504,7 +548,7 @@ NamesPriv::FindPath (Ptr<Object> object)
 
   do
     {
-      path = "/" + p->m_name + path;
+      path = "/" + *p->m_name + path;
       NS_LOG_LOGIC ("path is " << path);
     }
   while ((p = p->m_parent) != 0);
@@ -535,8 +579,7 @@ NamesPriv::Find (std::string path)
   std::string namespaceName = "/Names/";
   std::string remaining;
 
-  std::string::size_type offset = path.find (namespaceName);
-  if (offset == 0)
+  if (path.compare (0, namespaceName.size (), namespaceName) == 0)
     {
       NS_LOG_LOGIC (path << " is a fully qualified name");
       remaining = path.substr (namespaceName.size ());
@@ -544,10 +587,15 @@ NamesPriv::Find (std::string path)
   else
     {
       NS_LOG_LOGIC (path << " begins with a relative name");
-      remaining = path;
+      remaining.swap (path);
     }
 
-  NameNode *node = &m_root;
+  PathCache::const_iterator cached = m_pathCache.find (remaining);
+  if (cached != m_pathCache.end ())
+    {
+      NS_LOG_LOGIC ("Path found in the cache");
+      return cached->second->m_object;
+    }
 
   //
   // The string <remaining> is now composed entirely of path segments in
@@ -555,56 +603,31 @@ NamesPriv::Find (std::string path)
   // remaining = "ClientNode/eth0"
   //
   // The start of the search is always at the root of the name space.
+  // Each segment is looked up in turn, until the last one.
   //
+  NameNode *node = &m_root;
+  std::string segment;
+  std::string::size_type start = 0;
   for (;;)
     {
-      NS_LOG_LOGIC ("Looking for the object of name " << remaining);
-      offset = remaining.find ("/");
-      if (offset == std::string::npos)
+      std::string::size_type offset = remaining.find ('/', start);
+      segment.assign (remaining, start,
+                      offset == std::string::npos ? std::string::npos : offset - start);
+      node = FindChild (node, segment);
+      if (node == 0)
         {
-          //
-          // There are no remaining slashes so this is the last segment of the 
-          // specified name.  We're done when we find it
-          //
-          std::map<std::string, NameNode *>::iterator i = node->m_nameMap.find (remaining);
-          if (i == node->m_nameMap.end ())
-            {
-              NS_LOG_LOGIC ("Name does not exist in name map");
-              return 0;
-            }
-          else
-            {
-              NS_LOG_LOGIC ("Name parsed, found object");
-              return i->second->m_object;
-            }
+          NS_LOG_LOGIC ("Name does not exist in name map");
+          return 0;
         }
-      else
+      if (offset == std::string::npos)
         {
-          //
-          // There are more slashes so this is an intermediate segment of the 
-          // specified name.  We need to "recurse" when we find this segment.
-          //
-          offset = remaining.find ("/");
-          std::string segment = remaining.substr (0, offset);
-
-          std::map<std::string, NameNode *>::iterator i = node->m_nameMap.find (segment);
-          if (i == node->m_nameMap.end ())
-            {
-              NS_LOG_LOGIC ("Name does not exist in name map");
-              return 0;
-            }
-          else
-            {
-              node = i->second;
-              remaining = remaining.substr (offset + 1);
-              NS_LOG_LOGIC ("Intermediate segment parsed");
-              continue;
-            }
+          NS_LOG_LOGIC ("Name parsed, found object");
+          m_pathCache[remaining] = node;
+          return node->m_object;
         }
+      NS_LOG_LOGIC ("Intermediate segment parsed");
+      start = offset + 1;
     }
-
-  NS_ASSERT_MSG (node, "NamesPriv::Find(): Internal error:  this can't happen");
-  return 0;
 }
 
 Ptr<Object>
@@ -641,8 +664,8 @@ NamesPriv::Find (Ptr<Object> context, std::string name)
         }
     }
 
-  std::map<std::string, NameNode *>::iterator i = node->m_nameMap.find (name);
-  if (i == node->m_nameMap.end ())
+  NameNode *child = FindChild (node, name);
+  if (child == 0)
     {
       NS_LOG_LOGIC ("Name does not exist in name map");
       return 0;
@@ -650,7 +673,7 @@ NamesPriv::Find (Ptr<Object> context, std::string name)
   else
     {
       NS_LOG_LOGIC ("Name exists in name map");
-      return i->second->m_object;
+      return child->m_object;
     }
 }
 
@@ -659,7 +682,7 @@ NamesPriv::IsNamed (Ptr<Object> object)
 {
   NS_LOG_FUNCTION (this << object);
 
-  std::map<Ptr<Object>, NameNode *>::iterator i = m_objectMap.find (object);
+  ObjectMap::iterator i = m_objectMap.find (PeekPointer (object));
   if (i == m_objectMap.end ())
     {
       NS_LOG_LOGIC ("Object does not exist in object map, returning NameNode 0");
@@ -667,7 +690,7 @@ NamesPriv::IsNamed (Ptr<Object> object)
     }
   else
     {
-      NS_LOG_LOGIC ("Object exists in object map, returning NameNode " << &i->second);
+      NS_LOG_LOGIC ("Object exists in object map, returning NameNode " << i->second);
       return i->second;
     }
 }
@@ -677,8 +700,7 @@ NamesPriv::IsDuplicateName (NameNode *node, std::string name)
 {
   NS_LOG_FUNCTION (this << node << name);
 
-  std::map<std::string, NameNode *>::iterator i = node->m_nameMap.find (name);
-  if (i == node->m_nameMap.end ())
+  if (FindChild (node, name) == 0)
     {
       NS_LOG_LOGIC ("Name does not exist in name map");
       return false;
@@ -690,6 +712,43 @@ NamesPriv::IsDuplicateName (NameNode *node, std::string name)
     }
 }
 
+NameNode *
+NamesPriv::FindChild (const NameNode *node, const std::string &name) const
+{
+  StringPool::const_iterator s = m_strings.find (name);
+  if (s == m_strings.end ())
+    {
+      // No NameNode has this name.
+      return 0;
+    }
+  ChildKey key = { node, &s->first };
+  ChildMap::const_iterator i = m_children.find (key);
+  if (i == m_children.end ())
+    {
+      return 0;
+    }
+  return i->second;
+}
+
+const std::string *
+NamesPriv::Intern (const std::string &name)
+{
+  StringPool::iterator s = m_strings.insert (std::make_pair (name, 0)).first;
+  s->second++;
+  return &s->first;
+}
+
+void
+NamesPriv::Release (const std::string *name)
+{
+  StringPool::iterator s = m_strings.find (*name);
+  NS_ASSERT (s != m_strings.end () && s->second > 0);
+  if (--s->second == 0)
+    {
+      m_strings.erase (s);
+    }
+}
+
 void
 Names::Add (std::string name, Ptr<Object> object)
 {
@@ -0,0 +1,240 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "object-arena.h"
+#include <atomic>
+#include <cstdlib>
+#include <mutex>
+#include <new>
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::ObjectArena implementation.
+ */
+
+// Note: no logging in this file, as it allocates the Objects.
+
+namespace ns3 {
+
+namespace {
+
+/** Size class granularity, in bytes. */
+const std::size_t GRANULARITY = 16;
+/** Number of size classes. */
+const std::size_t N_CLASSES = ObjectArena::MAX_SIZE / GRANULARITY;
+/**
+ * Size of the header at the start of each chunk, which keeps the
+ * alignment of the system allocator for the blocks.
+ */
+const std::size_t HEADER_SIZE = 16;
+/**
+ * Number of slots of the chunk table: twice the maximum number of
+ * chunks, so that the lookups stay short.
+ */
+const uint32_t TABLE_SIZE = 2 * ObjectArena::MAX_CHUNKS;
+
+/**
+ * \ingroup object
+ * A block on a free list: the first word links to the next free
+ * block of the same size class.
+ */
+struct Block
+{
+  Block *next;  /**< Next free block of the same size class. */
+};
+
+/**
+ * \ingroup object
+ * The header of a chunk.  All the blocks of a chunk have the same
+ * size class.
+ */
+struct Chunk
+{
+  uint32_t cls;  /**< The size class of the blocks. */
+};
+
+/**
+ * \ingroup object
+ * The arena of one thread.
+ *
+ * This is a POD, zero initialized, so that it is never destroyed:
+ * the Objects in its chunks may outlive the thread.
+ */
+struct Arena
+{
+  bool enabled;                 /**< In arena mode ? */
+  char *next[N_CLASSES];        /**< The next block to carve out, per class. */
+  char *end[N_CLASSES];         /**< The end of the current chunk, per class. */
+  Block *free[N_CLASSES];       /**< The free list heads, per class. */
+  ObjectArena::Stats stats;     /**< Statistics. */
+};
+
+/** The arena of the calling thread. */
+thread_local Arena g_arena;
+
+/**
+ * The addresses of all the chunks, in an open-addressing hash table
+ * with linear probing; 0 marks an empty slot.  The chunks are never
+ * removed, so the lookups need no lock.
+ */
+std::atomic<uintptr_t> g_chunks[TABLE_SIZE];
+/** The number of chunks in g_chunks. */
+std::atomic<uint32_t> g_chunkCount;
+/** Serializes the insertions in g_chunks. */
+std::mutex g_chunksMutex;
+
+/**
+ * \ingroup object
+ * Get the first slot of a chunk in the chunk table.
+ *
+ * \param [in] chunk The chunk address.
+ * \returns The slot index.
+ */
+inline uint32_t
+GetSlot (uintptr_t chunk)
+{
+  return static_cast<uint32_t> ((chunk / ObjectArena::CHUNK_SIZE) * 2654435761U)
+    & (TABLE_SIZE - 1);
+}
+
+/**
+ * \ingroup object
+ * Allocate and register a new chunk.
+ *
+ * \param [in] cls The size class of the blocks of the chunk.
+ * \returns The chunk, or 0 if the table is full.
+ */
+Chunk *
+NewChunk (uint32_t cls)
+{
+  std::lock_guard<std::mutex> lock (g_chunksMutex);
+  if (g_chunkCount.load (std::memory_order_relaxed) >= ObjectArena::MAX_CHUNKS)
+    {
+      return 0;
+    }
+  void *p;
+  if (posix_memalign (&p, ObjectArena::CHUNK_SIZE, ObjectArena::CHUNK_SIZE) != 0)
+    {
+      throw std::bad_alloc ();
+    }
+  uintptr_t address = reinterpret_cast<uintptr_t> (p);
+  uint32_t i = GetSlot (address);
+  while (g_chunks[i].load (std::memory_order_relaxed) != 0)
+    {
+      i = (i + 1) & (TABLE_SIZE - 1);
+    }
+  g_chunks[i].store (address, std::memory_order_release);
+  g_chunkCount.fetch_add (1, std::memory_order_release);
+  Chunk *chunk = static_cast<Chunk *> (p);
+  chunk->cls = cls;
+  return chunk;
+}
+
+} // unnamed namespace
+
+void *
+ObjectArena::Allocate (std::size_t size)
+{
+  Arena &arena = g_arena;
+  if (!arena.enabled || size > MAX_SIZE)
+    {
+      return ::operator new (size);
+    }
+  arena.stats.allocations++;
+  std::size_t cls = (size + GRANULARITY - 1) / GRANULARITY - 1;
+  Block *block = arena.free[cls];
+  if (block != 0)
+    {
+      arena.free[cls] = block->next;
+      arena.stats.recycled++;
+      return block;
+    }
+  std::size_t blockSize = (cls + 1) * GRANULARITY;
+  if (arena.next[cls] == arena.end[cls])
+    {
+      Chunk *chunk = NewChunk (cls);
+      if (chunk == 0)
+        {
+          return ::operator new (size);
+        }
+      std::size_t blocks = (CHUNK_SIZE - HEADER_SIZE) / blockSize;
+      arena.next[cls] = reinterpret_cast<char *> (chunk) + HEADER_SIZE;
+      arena.end[cls] = arena.next[cls] + blocks * blockSize;
+      arena.stats.chunks++;
+      arena.stats.reserved += CHUNK_SIZE;
+    }
+  char *p = arena.next[cls];
+  arena.next[cls] += blockSize;
+  arena.stats.arena++;
+  return p;
+}
+
+bool
+ObjectArena::Contains (const void *p)
+{
+  if (g_chunkCount.load (std::memory_order_acquire) == 0)
+    {
+      return false;
+    }
+  uintptr_t chunk = reinterpret_cast<uintptr_t> (p) & ~static_cast<uintptr_t> (CHUNK_SIZE - 1);
+  for (uint32_t i = GetSlot (chunk); ; i = (i + 1) & (TABLE_SIZE - 1))
+    {
+      uintptr_t address = g_chunks[i].load (std::memory_order_acquire);
+      if (address == chunk)
+        {
+          return true;
+        }
+      if (address == 0)
+        {
+          return false;
+        }
+    }
+}
+
+void
+ObjectArena::Deallocate (void *p)
+{
+  Arena &arena = g_arena;
+  arena.stats.deallocations++;
+  uintptr_t address = reinterpret_cast<uintptr_t> (p) & ~static_cast<uintptr_t> (CHUNK_SIZE - 1);
+  uint32_t cls = reinterpret_cast<Chunk *> (address)->cls;
+  Block *block = static_cast<Block *> (p);
+  block->next = arena.free[cls];
+  arena.free[cls] = block;
+}
+
+void
+ObjectArena::SetEnabled (bool enabled)
+{
+  g_arena.enabled = enabled;
+}
+
+bool
+ObjectArena::IsEnabled (void)
+{
+  return g_arena.enabled;
+}
+
+struct ObjectArena::Stats
+ObjectArena::GetStats (void)
+{
+  return g_arena.stats;
+}
+
+} // namespace ns3
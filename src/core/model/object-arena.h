@@ -0,0 +1,126 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef OBJECT_ARENA_H
+#define OBJECT_ARENA_H
+
+#include <stdint.h>
+#include <cstddef>
+
+/**
+ * \file
+ * \ingroup object
+ * ns3::ObjectArena declaration.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup object
+ * \brief Slab allocator for Object instances.
+ *
+ * CreateObject and ObjectFactory::Create allocate the Objects through
+ * this class, and Object::DoDelete releases them.
+ *
+ * By default, Allocate simply calls the system allocator.  In arena
+ * mode, turned on by ObjectFactory::SetArenaEnabled, the Objects are
+ * instead carved out of large chunks, one series of chunks per size
+ * class.  The Objects of a type all have the same size, so the Objects
+ * created in a loop, for example by the topology helpers, end up in
+ * contiguous blocks, with a single system allocation for many Objects.
+ *
+ * Requested sizes are rounded up to a multiple of 16 bytes.  Objects
+ * larger than MAX_SIZE bytes always go to the system allocator.  The
+ * chunks are aligned on their size and registered in a process-wide
+ * table, so that Contains tells an arena block from any other storage
+ * by its address alone, without a header in front of the Objects.  When
+ * an arena Object is deleted, its block is kept on a free list of its
+ * size class, and reused by the next allocation of that class in arena
+ * mode.  The chunks themselves are never returned to the system.
+ *
+ * The arena mode, the free lists and the statistics are kept per
+ * thread, without any locking; only the registration of a new chunk
+ * takes a lock.  A block freed by a thread other than the one which
+ * allocated it simply joins the free list of the freeing thread.
+ */
+class ObjectArena
+{
+public:
+  /** Allocation statistics of the calling thread. */
+  struct Stats
+  {
+    uint64_t allocations;   /**< Number of calls to Allocate in arena mode. */
+    uint64_t deallocations; /**< Number of arena blocks released. */
+    uint64_t arena;         /**< Allocations carved out of a chunk. */
+    uint64_t recycled;      /**< Allocations served from a free list. */
+    uint64_t chunks;        /**< Number of chunks allocated. */
+    uint64_t reserved;      /**< Bytes allocated for the chunks. */
+  };
+
+  /** Largest Object size, in bytes, allocated from the chunks. */
+  static const std::size_t MAX_SIZE = 4096;
+  /** Size, and alignment, of the chunks, in bytes. */
+  static const std::size_t CHUNK_SIZE = 256 * 1024;
+  /**
+   * Maximum number of chunks in the process; the allocations beyond
+   * go to the system allocator.
+   */
+  static const uint32_t MAX_CHUNKS = 8192;
+
+  /**
+   * Allocate the storage of an Object.
+   *
+   * Out of arena mode, this is the same as <tt>::operator new</tt>.
+   *
+   * \param [in] size The requested size, in bytes.
+   * \returns The storage.
+   */
+  static void * Allocate (std::size_t size);
+  /**
+   * Check whether some storage was carved out of a chunk.
+   *
+   * \param [in] p The storage.
+   * \returns \c true if \p p must be released with Deallocate, rather
+   *          than by the system allocator.
+   */
+  static bool Contains (const void *p);
+  /**
+   * Release storage carved out of a chunk.
+   *
+   * \param [in] p The storage, for which Contains returns \c true.
+   */
+  static void Deallocate (void *p);
+  /**
+   * Turn the arena mode on or off, for the calling thread.
+   *
+   * \param [in] enabled \c true to allocate the Objects from the chunks.
+   */
+  static void SetEnabled (bool enabled);
+  /**
+   * \returns \c true if the calling thread is in arena mode.
+   */
+  static bool IsEnabled (void);
+  /**
+   * \returns The allocation statistics of the calling thread.
+   */
+  static struct Stats GetStats (void);
+};
+
+} // namespace ns3
+
+#endif /* OBJECT_ARENA_H */
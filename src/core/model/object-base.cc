@@ -26,6 +26,7 @@
 #ifdef HAVE_STDLIB_H
 #include <cstdlib>
 #endif
+#include <vector>
 
 /**
  * \file
@@ -76,20 +77,65 @@ ObjectBase::NotifyConstructionCompleted (void)
   NS_LOG_FUNCTION (this);
 }
 
+/**
+ * \ingroup object
+ * The attribute values in the \c NS_ATTRIBUTE_DEFAULT environment
+ * variable, as (full attribute name, value) pairs, parsed once.
+ *
+ * \relates ns3::ObjectBase
+ *
+ * \returns The attribute values, in the order of the variable.
+ */
+static const std::vector<std::pair<std::string, std::string> > &
+GetEnvironmentDefaults (void)
+{
+  static std::vector<std::pair<std::string, std::string> > defaults;
+  static bool parsed = false;
+  if (parsed)
+    {
+      return defaults;
+    }
+  parsed = true;
+#ifdef HAVE_GETENV
+  char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
+  if (envVar != 0)
+    {
+      std::string env = std::string (envVar);
+      std::string::size_type cur = 0;
+      std::string::size_type next = 0;
+      while (next != std::string::npos)
+        {
+          next = env.find (";", cur);
+          std::string tmp = std::string (env, cur, next-cur);
+          std::string::size_type equal = tmp.find ("=");
+          if (equal != std::string::npos)
+            {
+              std::string name = tmp.substr (0, equal);
+              std::string value = tmp.substr (equal+1, tmp.size () - equal - 1);
+              defaults.push_back (std::make_pair (name, value));
+            }
+          cur = next + 1;
+        }
+    }
+#endif /* HAVE_GETENV */
+  return defaults;
+}
+
 void
 ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
 {
   // loop over the inheritance tree back to the Object base class.
   NS_LOG_FUNCTION (this << &attributes);
+  const std::vector<std::pair<std::string, std::string> > &env = GetEnvironmentDefaults ();
   TypeId tid = GetInstanceTypeId ();
   do {
       // loop over all attributes in object type
       NS_LOG_DEBUG ("construct tid="<<tid.GetName ()<<", params="<<tid.GetAttributeN ());
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
+      Ptr<const TypeId::AttributeDefaults> defaults = tid.GetAttributeDefaults ();
+      for (uint32_t i = 0; i < defaults->attributes.size (); i++)
         {
-          struct TypeId::AttributeInformation info = tid.GetAttribute(i);
-          NS_LOG_DEBUG ("try to construct \""<< tid.GetName ()<<"::"<<
-                        info.name <<"\"");
+          const struct TypeId::AttributeDefault &info = defaults->attributes[i];
+          NS_LOG_DEBUG ("try to construct \""<< tid.GetAttributeFullName (i) <<"\"");
           // is this attribute stored in this AttributeConstructionList instance ?
           Ptr<AttributeValue> value = attributes.Find(info.checker);
           // See if this attribute should not be set here in the
@@ -109,7 +155,7 @@ ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
                   // This is an error because this attribute is not
                   // settable in its constructor but is present in
                   // the AttributeConstructionList.
-                  NS_FATAL_ERROR ("Attribute name="<<info.name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
+                  NS_FATAL_ERROR ("Attribute name="<<tid.GetAttribute (i).name<<" tid="<<tid.GetName () << ": initial value cannot be set using attributes");
                 }
             }
           bool found = false;
@@ -118,53 +164,42 @@ ObjectBase::ConstructSelf (const AttributeConstructionList &attributes)
               // We have a matching attribute value.
               if (DoSet (info.accessor, info.checker, *value))
                 {
-                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                info.name<<"\"");
+                  NS_LOG_DEBUG ("construct \""<< tid.GetAttributeFullName (i) <<"\"");
                   found = true;
                   continue;
                 }
             }              
-          if (!found)
+          if (!found && !env.empty ())
             {
               // No matching attribute value so we try to look at the env var.
-#ifdef HAVE_GETENV
-              char *envVar = getenv ("NS_ATTRIBUTE_DEFAULT");
-              if (envVar != 0)
+              std::string fullName = tid.GetAttributeFullName (i);
+              for (std::vector<std::pair<std::string, std::string> >::const_iterator j = env.begin ();
+                   j != env.end (); ++j)
                 {
-                  std::string env = std::string (envVar);
-                  std::string::size_type cur = 0;
-                  std::string::size_type next = 0;
-                  while (next != std::string::npos)
+                  if (j->first == fullName
+                      && DoSet (info.accessor, info.checker, StringValue (j->second)))
                     {
-                      next = env.find (";", cur);
-                      std::string tmp = std::string (env, cur, next-cur);
-                      std::string::size_type equal = tmp.find ("=");
-                      if (equal != std::string::npos)
-                        {
-                          std::string name = tmp.substr (0, equal);
-                          std::string value = tmp.substr (equal+1, tmp.size () - equal - 1);
-                          if (name == tid.GetAttributeFullName (i))
-                            {
-                              if (DoSet (info.accessor, info.checker, StringValue (value)))
-                                {
-                                  NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                                                info.name <<"\" from env var");
-                                  found = true;
-                                  break;
-                                }
-                            }
-                        }
-                      cur = next + 1;
+                      NS_LOG_DEBUG ("construct \""<< fullName <<"\" from env var");
+                      found = true;
+                      break;
                     }
                 }
-#endif /* HAVE_GETENV */
             }
           if (!found)
             {
               // No matching attribute value so we try to set the default value.
-              DoSet (info.accessor, info.checker, *info.initialValue);
-              NS_LOG_DEBUG ("construct \""<< tid.GetName ()<<"::"<<
-                            info.name <<"\" from initial value.");
+              // The valid initial values are shared by all the objects, and
+              // set as is; the others, such as the strings to convert to
+              // Ptr<RandomVariableStream>, are converted for each object.
+              if (info.valid)
+                {
+                  info.accessor->Set (this, *info.initialValue);
+                }
+              else
+                {
+                  DoSet (info.accessor, info.checker, *info.initialValue);
+                }
+              NS_LOG_DEBUG ("construct \""<< tid.GetAttributeFullName (i) <<"\" from initial value.");
             }
         }
       tid = tid.GetParent ();
@@ -178,6 +213,11 @@ ObjectBase::DoSet (Ptr<const AttributeAccessor> accessor,
                    const AttributeValue &value)
 {
   NS_LOG_FUNCTION (this << accessor << checker << &value);
+  if (checker->Check (value))
+    {
+      // A valid value is set as is: the accessor copies what it needs.
+      return accessor->Set (this, value);
+    }
   Ptr<AttributeValue> v = checker->CreateValidValue (value);
   if (v == 0)
     {
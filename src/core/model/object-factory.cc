@@ -105,6 +105,20 @@ ObjectFactory::Create (void) const
   return object;
 }
 
+void
+ObjectFactory::SetArenaEnabled (bool enabled)
+{
+  NS_LOG_FUNCTION (enabled);
+  ObjectArena::SetEnabled (enabled);
+}
+
+bool
+ObjectFactory::IsArenaEnabled (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return ObjectArena::IsEnabled ();
+}
+
 std::ostream & operator << (std::ostream &os, const ObjectFactory &factory)
 {
   os << factory.m_tid.GetName () << "[";
@@ -97,11 +97,11 @@ Object::Object ()
   : m_tid (Object::GetTypeId ()),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   NS_LOG_FUNCTION (this);
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 Object::~Object () 
@@ -120,6 +120,8 @@ Object::~Object ()
           m_aggregates->n--;
         }
     }
+  // the cached lookups may return this object
+  ClearCache (m_aggregates);
   // finally, if all objects have been removed from the list,
   // delete the aggregate list
   if (m_aggregates->n == 0)
@@ -132,10 +134,10 @@ Object::Object (const Object &o)
   : m_tid (o.m_tid),
     m_disposed (false),
     m_initialized (false),
-    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates))),
-    m_getObjectCount (0)
+    m_aggregates ((struct Aggregates *) std::malloc (sizeof (struct Aggregates)))
 {
   m_aggregates->n = 1;
+  m_aggregates->cache = 0;
   m_aggregates->buffer[0] = this;
 }
 void
@@ -145,12 +147,28 @@ Object::Construct (const AttributeConstructionList &attributes)
   ConstructSelf (attributes);
 }
 
-Ptr<Object>
+Object *
 Object::DoGetObject (TypeId tid) const
 {
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (CheckLoose ());
 
+  // The lookups are cached, per aggregate, rather than reordering
+  // the aggregate array: a lookup already done does not write anything.
+  struct AggregateCache *cache = m_aggregates->cache;
+  if (cache == 0)
+    {
+      cache = (struct AggregateCache *) std::calloc (1, sizeof (struct AggregateCache));
+      m_aggregates->cache = cache;
+    }
+  uint16_t uid = tid.GetUid ();
+  AggregateCache::Entry &entry = cache->entries[uid & (AggregateCache::SIZE - 1)];
+  if (entry.uid == uid)
+    {
+      return entry.object;
+    }
+
+  Object *found = 0;
   uint32_t n = m_aggregates->n;
   TypeId objectTid = Object::GetTypeId ();
   for (uint32_t i = 0; i < n; i++)
@@ -163,21 +181,20 @@ Object::DoGetObject (TypeId tid) const
         }
       if (cur == tid)
         {
-          // This is an attempt to 'cache' the result of this lookup.
-          // the idea is that if we perform a lookup for a TypeId on this object,
-          // we are likely to perform the same lookup later so, we make sure
-          // that the aggregate array is sorted by the number of accesses
-          // to each object.
-
-          // first, increment the access count
-          current->m_getObjectCount++;
-          // then, update the sort
-          UpdateSortedArray (m_aggregates, i);
-          // finally, return the match
-          return const_cast<Object *> (current);
+          found = current;
+          break;
         }
     }
-  return 0;
+  entry.uid = uid;
+  entry.object = found;
+  return found;
+}
+void
+Object::ClearCache (struct Aggregates *aggregates)
+{
+  NS_LOG_FUNCTION (aggregates);
+  std::free (aggregates->cache);
+  aggregates->cache = 0;
 }
 void
 Object::Initialize (void)
@@ -235,19 +252,6 @@ restart:
         }
     }
 }
-void
-Object::UpdateSortedArray (struct Aggregates *aggregates, uint32_t j) const
-{
-  NS_LOG_FUNCTION (this << aggregates << j);
-  while (j > 0 && 
-         aggregates->buffer[j]->m_getObjectCount > aggregates->buffer[j-1]->m_getObjectCount)
-    {
-      Object *tmp = aggregates->buffer[j-1];
-      aggregates->buffer[j-1] = aggregates->buffer[j];
-      aggregates->buffer[j] = tmp;
-      j--;
-    }
-}
 void 
 Object::AggregateObject (Ptr<Object> o)
 {
@@ -263,6 +267,7 @@ Object::AggregateObject (Ptr<Object> o)
   struct Aggregates *aggregates = 
     (struct Aggregates *)std::malloc (sizeof(struct Aggregates)+(total-1)*sizeof(Object*));
   aggregates->n = total;
+  aggregates->cache = 0;
 
   // copy our buffer to the new buffer
   std::memcpy (&aggregates->buffer[0], 
@@ -281,7 +286,6 @@ Object::AggregateObject (Ptr<Object> o)
                           other->GetInstanceTypeId () <<
                           " on objects of type " << typeId);
         }
-      UpdateSortedArray (aggregates, m_aggregates->n + i);
     }
 
   // keep track of the old aggregate buffers for the iteration
@@ -314,6 +318,8 @@ Object::AggregateObject (Ptr<Object> o)
     }
 
   // Now that we are done with them, we can free our old aggregate buffers
+  ClearCache (a);
+  ClearCache (b);
   std::free (a);
   std::free (b);
 }
@@ -340,6 +346,7 @@ Object::SetTypeId (TypeId tid)
   NS_LOG_FUNCTION (this << tid);
   NS_ASSERT (Check ());
   m_tid = tid;
+  ClearCache (m_aggregates);
 }
 
 void
@@ -421,7 +428,18 @@ Object::DoDelete (void)
       // in the destructor so, the index of the next element to 
       // lookup is always zero
       Object *current = aggregates->buffer[0];
-      delete current;
+      if (ObjectArena::Contains (current))
+        {
+          // Carved out of a chunk by CreateObject or ObjectFactory
+          // in arena mode.
+          void *storage = dynamic_cast<void *> (current);
+          current->~Object ();
+          ObjectArena::Deallocate (storage);
+        }
+      else
+        {
+          delete current;
+        }
     }
 }
 } // namespace ns3
@@ -24,11 +24,14 @@
 #include <stdint.h>
 #include <string>
 #include <vector>
+#include <new>
+#include <atomic>
 #include "ptr.h"
 #include "attribute.h"
 #include "object-base.h"
 #include "attribute-construction-list.h"
 #include "simple-ref-count.h"
+#include "object-arena.h"
 
 /**
  * \file
@@ -83,8 +86,12 @@ struct ObjectDeleter
  * all its aggregates. The DoDispose() method is always automatically
  * invoked from the Unref() method before destroying the Object,
  * even if the user did not call Dispose() directly.
+ *
+ * The reference count is atomic: the nodes of a simulation run by
+ * MultithreadedSimulatorImpl reference the devices, channels and
+ * nodes of the other threads.
  */
-class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter>
+class Object : public SimpleRefCount<Object, ObjectBase, ObjectDeleter, std::atomic<uint32_t> >
 {
 public:
   /**
@@ -323,6 +330,22 @@ private:
   friend class AggregateIterator;
   friend struct ObjectDeleter;
 
+  /**
+   * The results of the lookups in an aggregate, indexed by the
+   * TypeId uid, including the TypeIds which are not found.
+   * When two TypeIds map to the same entry, the last lookup wins.
+   */
+  struct AggregateCache {
+    /** The number of entries: a power of two. */
+    static const uint32_t SIZE = 32;
+    /** A lookup result. */
+    struct Entry {
+      uint16_t uid;    //!< The TypeId uid looked up, 0 if the entry is unused.
+      Object *object;  //!< The Object found, or 0.
+    };
+    Entry entries[SIZE];  //!< The lookup results.
+  };
+
   /**
    * The list of Objects aggregated to this one.
    *
@@ -338,9 +361,20 @@ private:
   struct Aggregates {
     /** The number of entries in \c buffer. */
     uint32_t n;
+    /**
+     * The results of the lookups in \c buffer, allocated by the first
+     * lookup.  Aggregating Objects creates a new Aggregates, so
+     * the results are never stale.
+     */
+    struct AggregateCache *cache;
     /** The array of Objects. */
     Object *buffer[1];
   };
+  /**
+   * Free the lookup results of an aggregate.
+   * \param [in,out] aggregates The aggregate.
+   */
+  static void ClearCache (struct Aggregates *aggregates);
 
   /**
    * Find an Object of TypeId tid in the aggregates of this Object.
@@ -348,7 +382,7 @@ private:
    * \param [in] tid The TypeId we're looking for
    * \return The matching Object, if it is found
    */
-  Ptr<Object> DoGetObject (TypeId tid) const;
+  Object *DoGetObject (TypeId tid) const;
   /**
    * Verify that this Object is still live, by checking it's reference count.
    * \return \c true if the reference count is non zero.
@@ -389,13 +423,6 @@ private:
   */
   void Construct (const AttributeConstructionList &attributes);
 
-  /**
-   * Keep the list of aggregates in most-recently-used order
-   *
-   * \param [in,out] aggregates The list of aggregated Objects.
-   * \param [in] i The most recently used entry in the list.
-   */
-  void UpdateSortedArray (struct Aggregates *aggregates, uint32_t i) const;
   /**
    * Attempt to delete this Object.
    *
@@ -427,14 +454,6 @@ private:
    * so the size of the array is indirectly a reference count.
    */
   struct Aggregates * m_aggregates;
-  /**
-   * The number of times the Object was accessed with a
-   * call to GetObject().
-   *
-   * This integer is used to implement a heuristic to sort
-   * the array of aggregates in most-frequently accessed order.
-   */
-  uint32_t m_getObjectCount;
 };
 
 template <typename T>
@@ -461,18 +480,10 @@ template <typename T>
 Ptr<T> 
 Object::GetObject () const
 {
-  // This is an optimization: if the cast works (which is likely),
-  // things will be pretty fast.
-  T *result = dynamic_cast<T *> (m_aggregates->buffer[0]);
-  if (result != 0)
-    {
-      return Ptr<T> (result);
-    }
-  // if the cast does not work, we try to do a full type check.
-  Ptr<Object> found = DoGetObject (T::GetTypeId ());
+  Object *found = DoGetObject (T::GetTypeId ());
   if (found != 0)
     {
-      return Ptr<T> (static_cast<T *> (PeekPointer (found)));
+      return Ptr<T> (static_cast<T *> (found));
     }
   return 0;
 }
@@ -481,10 +492,10 @@ template <typename T>
 Ptr<T> 
 Object::GetObject (TypeId tid) const
 {
-  Ptr<Object> found = DoGetObject (tid);
+  Object *found = DoGetObject (tid);
   if (found != 0)
     {
-      return Ptr<T> (static_cast<T *> (PeekPointer (found)));
+      return Ptr<T> (static_cast<T *> (found));
     }
   return 0;
 }
@@ -524,13 +535,16 @@ Ptr<T> CompleteConstruct (T *object)
 /**
  * Create an object by type, with varying number of constructor parameters.
  *
+ * The object is allocated through the ObjectArena, and released by
+ * Object::DoDelete.
+ *
  * \tparam T \explicit The type of the derived object to construct.
  * \return The derived object.
  */
 template <typename T>
 Ptr<T> CreateObject (void)
 {
-  return CompleteConstruct (new T ());
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T ());
 }
 /**
  * \copybrief CreateObject()
@@ -542,7 +556,7 @@ Ptr<T> CreateObject (void)
 template <typename T, typename T1>
 Ptr<T> CreateObject (T1 a1)
 {
-  return CompleteConstruct (new T (a1));
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T (a1));
 }
 
 /**
@@ -557,7 +571,7 @@ Ptr<T> CreateObject (T1 a1)
 template <typename T, typename T1, typename T2>
 Ptr<T> CreateObject (T1 a1, T2 a2)
 {
-  return CompleteConstruct (new T (a1,a2));
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T (a1,a2));
 }
 
 /**
@@ -574,7 +588,7 @@ Ptr<T> CreateObject (T1 a1, T2 a2)
 template <typename T, typename T1, typename T2, typename T3>
 Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3)
 {
-  return CompleteConstruct (new T (a1,a2,a3));
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T (a1,a2,a3));
 }
 
 /**
@@ -593,7 +607,7 @@ Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3)
 template <typename T, typename T1, typename T2, typename T3, typename T4>
 Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3, T4 a4)
 {
-  return CompleteConstruct (new T (a1,a2,a3,a4));
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T (a1,a2,a3,a4));
 }
 
 /**
@@ -614,7 +628,7 @@ Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3, T4 a4)
 template <typename T, typename T1, typename T2, typename T3, typename T4, typename T5>
 Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
 {
-  return CompleteConstruct (new T (a1,a2,a3,a4,a5));
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T (a1,a2,a3,a4,a5));
 }
 
 /**
@@ -637,7 +651,7 @@ Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5)
 template <typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6>
 Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6)
 {
-  return CompleteConstruct (new T (a1,a2,a3,a4,a5,a6));
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T (a1,a2,a3,a4,a5,a6));
 }
 
 /**
@@ -662,7 +676,7 @@ Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6)
 template <typename T, typename T1, typename T2, typename T3, typename T4, typename T5, typename T6, typename T7>
 Ptr<T> CreateObject (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7)
 {
-  return CompleteConstruct (new T (a1,a2,a3,a4,a5,a6,a7));
+  return CompleteConstruct (::new (ObjectArena::Allocate (sizeof (T))) T (a1,a2,a3,a4,a5,a6,a7));
 }
 /**@}*/
 
@@ -0,0 +1,190 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quad-heap-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::QuadHeapScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("QuadHeapScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (QuadHeapScheduler);
+
+TypeId
+QuadHeapScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::QuadHeapScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<QuadHeapScheduler> ()
+  ;
+  return tid;
+}
+
+QuadHeapScheduler::QuadHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+QuadHeapScheduler::~QuadHeapScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+QuadHeapScheduler::BottomUp (uint32_t index, const EventKey &key, EventImpl *impl)
+{
+  while (index > 0)
+    {
+      uint32_t parent = (index - 1) / 4;
+      if (!(key < m_keys[parent]))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[parent];
+      m_impls[index] = m_impls[parent];
+      index = parent;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+void
+QuadHeapScheduler::TopDown (uint32_t index, const EventKey &key, EventImpl *impl)
+{
+  uint32_t size = m_keys.size ();
+  while (true)
+    {
+      uint32_t first = index * 4 + 1;
+      if (first >= size)
+        {
+          break;
+        }
+      uint32_t last = first + 4;
+      if (last > size)
+        {
+          last = size;
+        }
+      uint32_t smallest = first;
+      for (uint32_t child = first + 1; child < last; child++)
+        {
+          if (m_keys[child] < m_keys[smallest])
+            {
+              smallest = child;
+            }
+        }
+      if (!(m_keys[smallest] < key))
+        {
+          break;
+        }
+      m_keys[index] = m_keys[smallest];
+      m_impls[index] = m_impls[smallest];
+      index = smallest;
+    }
+  m_keys[index] = key;
+  m_impls[index] = impl;
+}
+
+void
+QuadHeapScheduler::RemoveAt (uint32_t index)
+{
+  NS_ASSERT (index < m_keys.size ());
+  EventKey key = m_keys.back ();
+  EventImpl *impl = m_impls.back ();
+  m_keys.pop_back ();
+  m_impls.pop_back ();
+  if (index == m_keys.size ())
+    {
+      // we removed the last entry: nothing to re-order.
+      return;
+    }
+  if (index > 0 && key < m_keys[(index - 1) / 4])
+    {
+      BottomUp (index, key, impl);
+    }
+  else
+    {
+      TopDown (index, key, impl);
+    }
+}
+
+void
+QuadHeapScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  m_keys.push_back (ev.key);
+  m_impls.push_back (ev.impl);
+  BottomUp (m_keys.size () - 1, ev.key, ev.impl);
+}
+
+bool
+QuadHeapScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_keys.empty ();
+}
+
+Scheduler::Event
+QuadHeapScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next;
+  next.impl = m_impls[0];
+  next.key = m_keys[0];
+  return next;
+}
+
+Scheduler::Event
+QuadHeapScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Event next;
+  next.impl = m_impls[0];
+  next.key = m_keys[0];
+  RemoveAt (0);
+  return next;
+}
+
+void
+QuadHeapScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  uint32_t uid = ev.key.m_uid;
+  for (uint32_t i = 0; i < m_keys.size (); i++)
+    {
+      if (uid == m_keys[i].m_uid)
+        {
+          NS_ASSERT (m_impls[i] == ev.impl);
+          RemoveAt (i);
+          return;
+        }
+    }
+  NS_ASSERT (false);
+}
+
+} // namespace ns3
@@ -0,0 +1,108 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUAD_HEAP_SCHEDULER_H
+#define QUAD_HEAP_SCHEDULER_H
+
+#include "scheduler.h"
+#include <stdint.h>
+#include <vector>
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Declaration of ns3::QuadHeapScheduler class.
+ */
+
+namespace ns3 {
+
+/**
+ * \ingroup scheduler
+ * \brief a cache-friendly 4-ary heap event scheduler
+ *
+ * This scheduler keeps the event list as an implicit 4-ary heap.
+ * Compared to the binary HeapScheduler:
+ *  - the heap is half as deep, so an Insert or a RemoveNext touches
+ *    half as many levels;
+ *  - the Scheduler::EventKey of each entry is stored in its own
+ *    contiguous array, separate from the EventImpl pointers, so that
+ *    all the comparisons made while percolating only read keys.  The
+ *    four children of a node are adjacent in memory and, at 16 bytes
+ *    per key, share a single cache line most of the time;
+ *  - entries are moved into a "hole" rather than swapped pairwise,
+ *    which halves the number of writes done while percolating.
+ *
+ * The root of the heap is at index 0, and the children of the entry at
+ * index \c i are at indexes <tt>4i+1</tt> to <tt>4i+4</tt>.
+ *
+ * Like HeapScheduler, Remove is linear in the number of pending events.
+ */
+class QuadHeapScheduler : public Scheduler
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  QuadHeapScheduler ();
+  /** Destructor. */
+  virtual ~QuadHeapScheduler ();
+
+  // Inherited
+  virtual void Insert (const Scheduler::Event &ev);
+  virtual bool IsEmpty (void) const;
+  virtual Scheduler::Event PeekNext (void) const;
+  virtual Scheduler::Event RemoveNext (void);
+  virtual void Remove (const Scheduler::Event &ev);
+
+private:
+  /**
+   * Move an entry towards the root until the heap property holds.
+   *
+   * \param [in] index The index of the hole to start from.
+   * \param [in] key The key of the entry to place.
+   * \param [in] impl The implementation of the entry to place.
+   */
+  void BottomUp (uint32_t index, const Scheduler::EventKey &key, EventImpl *impl);
+  /**
+   * Move an entry towards the leaves until the heap property holds.
+   *
+   * \param [in] index The index of the hole to start from.
+   * \param [in] key The key of the entry to place.
+   * \param [in] impl The implementation of the entry to place.
+   */
+  void TopDown (uint32_t index, const Scheduler::EventKey &key, EventImpl *impl);
+  /**
+   * Remove the entry at a given index, and restore the heap property.
+   *
+   * \param [in] index The index of the entry to remove.
+   */
+  void RemoveAt (uint32_t index);
+
+  /** The event keys, managed as a 4-ary heap. */
+  std::vector<Scheduler::EventKey> m_keys;
+  /** The event implementations, at the same index as their key. */
+  std::vector<EventImpl *> m_impls;
+};
+
+} // namespace ns3
+
+#endif /* QUAD_HEAP_SCHEDULER_H */
@@ -33,6 +33,9 @@
 #include "log.h"
 #include "rng-stream.h"
 #include "rng-seed-manager.h"
+#include "system-mutex.h"
+#include <algorithm>
+#include <atomic>
 #include <cmath>
 #include <iostream>
 
@@ -72,16 +75,42 @@ RandomVariableStream::GetTypeId (void)
 }
 
 RandomVariableStream::RandomVariableStream()
-  : m_rng (0)
+  : m_rng (0),
+    m_index (0)
 {
   NS_LOG_FUNCTION (this);
+  static std::atomic<uint64_t> serial (0);
+  m_serial = serial.fetch_add (1, std::memory_order_relaxed);
+  CriticalSection cs (GetInstancesMutex ());
+  GetInstances ().insert (this);
 }
 RandomVariableStream::~RandomVariableStream()
 {
   NS_LOG_FUNCTION (this);
+  {
+    CriticalSection cs (GetInstancesMutex ());
+    GetInstances ().erase (this);
+  }
   delete m_rng;
 }
 
+std::set<RandomVariableStream *> &
+RandomVariableStream::GetInstances (void)
+{
+  // Never destroyed, as streams held by static objects may be
+  // destroyed after it.
+  static std::set<RandomVariableStream *> *instances = new std::set<RandomVariableStream *> ();
+  return *instances;
+}
+
+SystemMutex &
+RandomVariableStream::GetInstancesMutex (void)
+{
+  // Never destroyed, like the set it protects.
+  static SystemMutex *mutex = new SystemMutex ();
+  return *mutex;
+}
+
 void
 RandomVariableStream::SetAntithetic(bool isAntithetic)
 {
@@ -110,6 +139,7 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              nextStream,
                              RngSeedManager::GetRun ());
+      m_index = nextStream;
     }
   else
     {
@@ -120,6 +150,7 @@ RandomVariableStream::SetStream (int64_t stream)
       m_rng = new RngStream (RngSeedManager::GetSeed (),
                              target,
                              RngSeedManager::GetRun ());
+      m_index = target;
     }
   m_stream = stream;
 }
@@ -137,6 +168,16 @@ RandomVariableStream::Peek(void) const
   return m_rng;
 }
 
+void
+RandomVariableStream::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  for (std::size_t i = 0; i < n; i++)
+    {
+      values[i] = GetValue ();
+    }
+}
+
 NS_OBJECT_ENSURE_REGISTERED(UniformRandomVariable);
 
 TypeId 
@@ -207,6 +248,22 @@ UniformRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_min, m_max + 1);
 }
+void
+UniformRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  Peek ()->RandU01 (values, n);
+  bool antithetic = IsAntithetic ();
+  for (std::size_t i = 0; i < n; i++)
+    {
+      double v = m_min + values[i] * (m_max - m_min);
+      if (antithetic)
+        {
+          v = m_min + (m_max - v);
+        }
+      values[i] = v;
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(ConstantRandomVariable);
 
@@ -262,6 +319,12 @@ ConstantRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_constant);
 }
+void
+ConstantRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  std::fill (values, values + n, m_constant);
+}
 
 NS_OBJECT_ENSURE_REGISTERED(SequentialRandomVariable);
 
@@ -444,6 +507,34 @@ ExponentialRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_bound);
 }
+void
+ExponentialRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  bool antithetic = IsAntithetic ();
+  std::size_t done = 0;
+  while (done < n)
+    {
+      // Each value needs at least one uniform variable: draw one for
+      // each value left, then draw again for the rejected values.
+      std::size_t todo = n - done;
+      Peek ()->RandU01 (values + done, todo);
+      std::size_t end = done + todo;
+      for (std::size_t i = done; i < end; i++)
+        {
+          double v = values[i];
+          if (antithetic)
+            {
+              v = (1 - v);
+            }
+          double r = -m_mean*std::log (v);
+          if (m_bound == 0 || r <= m_bound)
+            {
+              values[done++] = r;
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(ParetoRandomVariable);
 
@@ -540,6 +631,35 @@ ParetoRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_shape, m_bound);
 }
+void
+ParetoRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  double scale = m_mean * (m_shape - 1.0) / m_shape;
+  bool antithetic = IsAntithetic ();
+  std::size_t done = 0;
+  while (done < n)
+    {
+      // Draw one uniform variable for each value left, as in
+      // ExponentialRandomVariable::GetValues.
+      std::size_t todo = n - done;
+      Peek ()->RandU01 (values + done, todo);
+      std::size_t end = done + todo;
+      for (std::size_t i = done; i < end; i++)
+        {
+          double v = values[i];
+          if (antithetic)
+            {
+              v = (1 - v);
+            }
+          double r = (scale * ( 1.0 / std::pow (v, 1.0 / m_shape)));
+          if (m_bound == 0 || r <= m_bound)
+            {
+              values[done++] = r;
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(WeibullRandomVariable);
 
@@ -634,6 +754,35 @@ WeibullRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_scale, m_shape, m_bound);
 }
+void
+WeibullRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  double exponent = 1.0 / m_shape;
+  bool antithetic = IsAntithetic ();
+  std::size_t done = 0;
+  while (done < n)
+    {
+      // Draw one uniform variable for each value left, as in
+      // ExponentialRandomVariable::GetValues.
+      std::size_t todo = n - done;
+      Peek ()->RandU01 (values + done, todo);
+      std::size_t end = done + todo;
+      for (std::size_t i = done; i < end; i++)
+        {
+          double v = values[i];
+          if (antithetic)
+            {
+              v = (1 - v);
+            }
+          double r = m_scale * std::pow ( -std::log (v), exponent);
+          if (m_bound == 0 || r <= m_bound)
+            {
+              values[done++] = r;
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(NormalRandomVariable);
 
@@ -754,6 +903,64 @@ NormalRandomVariable::GetInteger (void)
   NS_LOG_FUNCTION (this);
   return (uint32_t)GetValue (m_mean, m_variance, m_bound);
 }
+void
+NormalRandomVariable::GetValues (double *values, std::size_t n)
+{
+  NS_LOG_FUNCTION (this << values << n);
+  bool antithetic = IsAntithetic ();
+  double sigma = std::sqrt (m_variance);
+  std::size_t done = 0;
+  if (n > 0 && m_nextValid)
+    { // use previously generated
+      m_nextValid = false;
+      values[done++] = m_next;
+    }
+  // Each pair of uniform variables gives at most two values: draw
+  // one pair for every two values left, so that no uniform variable
+  // is drawn which the same sequence of GetValue calls would not draw.
+  double u[2 * 64];
+  while (done < n)
+    {
+      std::size_t pairs = std::min<std::size_t> ((n - done + 1) / 2, 64);
+      Peek ()->RandU01 (u, 2 * pairs);
+      for (std::size_t i = 0; i < pairs && done < n; i++)
+        {
+          double u1 = u[2 * i];
+          double u2 = u[2 * i + 1];
+          if (antithetic)
+            {
+              u1 = (1 - u1);
+              u2 = (1 - u2);
+            }
+          double v1 = 2 * u1 - 1;
+          double v2 = 2 * u2 - 1;
+          double w = v1 * v1 + v2 * v2;
+          if (w <= 1.0)
+            { // Got good pair
+              double y = std::sqrt ((-2 * std::log (w)) / w);
+              double x1 = m_mean + v1 * y * sigma;
+              double x2 = m_mean + v2 * y * sigma;
+              bool x2Valid = std::fabs (x2 - m_mean) <= m_bound;
+              if (std::fabs (x1 - m_mean) <= m_bound)
+                {
+                  values[done++] = x1;
+                }
+              if (x2Valid)
+                {
+                  if (done < n)
+                    {
+                      values[done++] = x2;
+                    }
+                  else
+                    {
+                      m_next = x2;
+                      m_nextValid = true;
+                    }
+                }
+            }
+        }
+    }
+}
 
 NS_OBJECT_ENSURE_REGISTERED(LogNormalRandomVariable);
 
@@ -29,7 +29,9 @@
 #include "type-id.h"
 #include "object.h"
 #include "attribute-helper.h"
+#include <cstddef>
 #include <stdint.h>
+#include <set>
 
 /**
  * \file
@@ -70,6 +72,7 @@ namespace ns3 {
  */
   
 class RngStream;
+class SystemMutex;
 
 /**
  * \ingroup randomvariable
@@ -149,6 +152,19 @@ public:
    */
   virtual uint32_t GetInteger (void) = 0;
 
+  /**
+   * \brief Get the next \p n random values drawn from the distribution.
+   *
+   * The values are exactly those \p n calls to GetValue(void) would
+   * return.  The default implementation does just that; the
+   * subclasses whose values are computed from independent uniform
+   * variables draw the uniform variables in a batch instead.
+   *
+   * \param [out] values The array to store the random values in.
+   * \param [in] n The number of random values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
 protected:
   /**
    * \brief Get the pointer to the underlying RNG stream.
@@ -186,6 +202,27 @@ private:
   /** The stream number for this RNG stream. */
   int64_t m_stream;
 
+  friend class Checkpoint;
+  friend class ReplicationRunner;
+  /**
+   * Get the live RandomVariableStreams, whose RNG stream states are
+   * saved by Checkpoint.  Must be used with GetInstancesMutex held,
+   * as streams may be created and destroyed by several threads.
+   * \returns The live RandomVariableStreams.
+   */
+  static std::set<RandomVariableStream *> & GetInstances (void);
+  /**
+   * Get the mutex which protects GetInstances.
+   * \returns The mutex.
+   */
+  static SystemMutex & GetInstancesMutex (void);
+
+  /** The index of the underlying RNG stream, among all the RNG streams. */
+  uint64_t m_index;
+
+  /** The creation order of this RandomVariableStream. */
+  uint64_t m_serial;
+
 };  // class RandomVariableStream
 
   
@@ -293,6 +330,13 @@ public:
    * \note The upper limit is included in the output range.
    */
   virtual uint32_t GetInteger (void);
+  /**
+   * \brief Get the next \p n random values drawn from the distribution.
+   * \param [out] values The array to store the random values in.
+   * \param [in] n The number of random values.
+   * \note The upper limit is excluded from the output range.
+   */
+  virtual void GetValues (double *values, std::size_t n);
   
 private:
   /** The lower bound on values that can be returned by this RNG stream. */
@@ -352,6 +396,8 @@ public:
   virtual double GetValue (void);
   /* \note This RNG always returns the same value. */
   virtual uint32_t GetInteger (void);
+  /* \note This RNG always returns the same value. */
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The constant value returned by this RNG stream. */
@@ -585,6 +631,7 @@ public:
   // Inherited from RandomVariableStream
   virtual double GetValue (void);
   virtual uint32_t GetInteger (void);
+  virtual void GetValues (double *values, std::size_t n);
 
 private:
   /** The mean value of the unbounded exponential distribution. */
@@ -804,6 +851,13 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \brief Get the next \p n random values drawn from the distribution.
+   * \param [out] values The array to store the random values in.
+   * \param [in] n The number of random values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
 private:
   /** The mean parameter for the Pareto distribution returned by this RNG stream. */
   double m_mean;
@@ -1010,6 +1064,13 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \brief Get the next \p n random values drawn from the distribution.
+   * \param [out] values The array to store the random values in.
+   * \param [in] n The number of random values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
 private:
   /** The scale parameter for the Weibull distribution returned by this RNG stream. */
   double m_scale;
@@ -1243,6 +1304,13 @@ public:
    */
   virtual uint32_t GetInteger (void);
 
+  /**
+   * \brief Get the next \p n random values drawn from the distribution.
+   * \param [out] values The array to store the random values in.
+   * \param [in] n The number of random values.
+   */
+  virtual void GetValues (double *values, std::size_t n);
+
 private:
   /** The mean value for the normal distribution returned by this RNG stream. */
   double m_mean;
@@ -80,6 +80,8 @@ RealtimeSimulatorImpl::RealtimeSimulatorImpl ()
 
   m_stop = false;
   m_running = false;
+  m_inbox = 0;
+  m_inboxFree = 0;
   // uids are allocated from 4.
   // uid 0 is "invalid" events
   // uid 1 is "now" events
@@ -107,6 +109,21 @@ void
 RealtimeSimulatorImpl::DoDispose (void)
 {
   NS_LOG_FUNCTION (this);
+  InboxEvent *ie = m_inbox.exchange (0, std::memory_order_acquire);
+  while (ie != 0)
+    {
+      InboxEvent *next = ie->next;
+      ie->impl->Unref ();
+      delete ie;
+      ie = next;
+    }
+  ie = m_inboxFree.exchange (0, std::memory_order_acquire);
+  while (ie != 0)
+    {
+      InboxEvent *next = ie->next;
+      delete ie;
+      ie = next;
+    }
   while (!m_events->IsEmpty ())
     {
       Scheduler::Event next = m_events->RemoveNext ();
@@ -209,6 +226,12 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
       { 
         CriticalSection cs (m_mutex);
         //
+        // Reset the synchronizer condition first, so that any event pushed
+        // into the inbox after we drain it below interrupts the wait.
+        //
+        m_synchronizer->SetCondition (false);
+        DrainInbox ();
+        //
         // Since we are in realtime mode, the time to delay has got to be the 
         // difference between the current realtime and the timestamp of the next 
         // event.  Since m_currentTs is actually the timestamp of the last event we 
@@ -253,10 +276,10 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
         // We've figured out how long we need to delay in order to pace the 
         // simulation time with the real time.  We're going to sleep, but need
         // to work with the synchronizer to make sure we're awakened if something 
-        // external happens (like a packet is received).  This next line resets
-        // the synchronizer so that any future event will cause it to interrupt.
+        // external happens (like a packet is received).  The condition reset
+        // at the top of this critical section ensures that any future event
+        // will cause it to interrupt.
         //
-        m_synchronizer->SetCondition (false);
       }
 
       //
@@ -326,6 +349,7 @@ RealtimeSimulatorImpl::ProcessOneEvent (void)
     // event we're working on won't be on the list and so subsequent operations won't
     // mess with us.
     //
+    DrainInbox ();
     NS_ASSERT_MSG (m_events->IsEmpty () == false, 
                    "RealtimeSimulatorImpl::ProcessOneEvent(): event queue is empty");
     next = m_events->RemoveNext ();
@@ -399,7 +423,8 @@ RealtimeSimulatorImpl::IsFinished (void) const
   bool rc;
   {
     CriticalSection cs (m_mutex);
-    rc = m_events->IsEmpty () || m_stop;
+    rc = (m_events->IsEmpty () && m_inbox.load (std::memory_order_acquire) == 0)
+      || m_stop;
   }
 
   return rc;
@@ -429,8 +454,10 @@ RealtimeSimulatorImpl::Run (void)
   m_main = SystemThread::Self();
 
   m_stop = false;
-  m_running = true;
+  // Set the origin before other threads can see m_running and read the
+  // realtime clock.
   m_synchronizer->SetOrigin (m_currentTs);
+  m_running = true;
 
   // Sleep until signalled
   uint64_t tsNow;
@@ -442,6 +469,8 @@ RealtimeSimulatorImpl::Run (void)
       {
         CriticalSection cs (m_mutex);
 
+        m_synchronizer->SetCondition (false);
+        DrainInbox ();
         if (!m_events->IsEmpty ())
           {
             process = true;
@@ -472,6 +501,7 @@ RealtimeSimulatorImpl::Run (void)
   {
     CriticalSection cs (m_mutex);
 
+    DrainInbox ();
     NS_ASSERT_MSG (m_events->IsEmpty () == false || m_unscheduledEvents == 0,
                    "RealtimeSimulatorImpl::Run(): Empty queue and unprocessed events");
   }
@@ -543,23 +573,27 @@ RealtimeSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay,
 {
   NS_LOG_FUNCTION (this << context << delay << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      //
+      // If the simulator is running, we're pacing and have a meaningful 
+      // realtime clock.  If we're not, then the event is relative to
+      // m_currentTs, where we stopped, which is resolved by the main thread.
+      // 
+      if (m_running)
+        {
+          PushInbox (context, m_synchronizer->GetCurrentRealtime () + delay.GetTimeStep (), false, impl);
+        }
+      else
+        {
+          PushInbox (context, delay.GetTimeStep (), true, impl);
+        }
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
-    uint64_t ts;
-
-    if (SystemThread::Equals (m_main))
-      {
-        ts = m_currentTs + delay.GetTimeStep ();
-      }
-    else
-      {
-        //
-        // If the simulator is running, we're pacing and have a meaningful 
-        // realtime clock.  If we're not, then m_currentTs is where we stopped.
-        // 
-        ts = m_running ? m_synchronizer->GetCurrentRealtime () : m_currentTs;
-        ts += delay.GetTimeStep ();
-      }
+    uint64_t ts = m_currentTs + delay.GetTimeStep ();
 
     NS_ASSERT_MSG (ts >= m_currentTs, "RealtimeSimulatorImpl::ScheduleRealtime(): schedule for time < m_currentTs");
     Scheduler::Event ev;
@@ -595,6 +629,113 @@ RealtimeSimulatorImpl::ScheduleNow (EventImpl *impl)
   return EventId (impl, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
 }
 
+RealtimeSimulatorImpl::InboxEvent *
+RealtimeSimulatorImpl::AllocateInboxEvent (void)
+{
+  // The entries kept by the calling thread, deleted when it exits.
+  struct Cache
+  {
+    ~Cache ()
+    {
+      while (head != 0)
+        {
+          InboxEvent *next = head->next;
+          delete head;
+          head = next;
+        }
+    }
+    InboxEvent *head;
+  };
+  static thread_local Cache cache = { 0 };
+
+  if (cache.head == 0)
+    {
+      cache.head = m_inboxFree.exchange (0, std::memory_order_acquire);
+      if (cache.head == 0)
+        {
+          return new InboxEvent;
+        }
+    }
+  InboxEvent *ie = cache.head;
+  cache.head = ie->next;
+  return ie;
+}
+
+void
+RealtimeSimulatorImpl::PushInbox (uint32_t context, uint64_t ts, bool relative, EventImpl *impl)
+{
+  InboxEvent *ie = AllocateInboxEvent ();
+  ie->ts = ts;
+  ie->context = context;
+  ie->relative = relative;
+  ie->impl = impl;
+  ie->next = m_inbox.load (std::memory_order_relaxed);
+  while (!m_inbox.compare_exchange_weak (ie->next, ie,
+                                         std::memory_order_release,
+                                         std::memory_order_relaxed))
+    {
+      // ie->next has been reloaded with the current head: retry.
+    }
+  //
+  // If the inbox was not empty, the producer which filled it first has
+  // already signalled the main thread, which has not drained it yet.
+  //
+  if (ie->next == 0)
+    {
+      m_synchronizer->Signal ();
+    }
+}
+
+void
+RealtimeSimulatorImpl::DrainInbox (void)
+{
+  InboxEvent *ie = m_inbox.exchange (0, std::memory_order_acquire);
+  if (ie == 0)
+    {
+      return;
+    }
+  // The inbox is a stack: reverse it to insert the events in arrival order.
+  // Its first entry becomes the last one, to which the entries are
+  // released below.
+  InboxEvent *tail = ie;
+  InboxEvent *head = 0;
+  while (ie != 0)
+    {
+      InboxEvent *next = ie->next;
+      ie->next = head;
+      head = ie;
+      ie = next;
+    }
+  for (ie = head; ie != 0; ie = ie->next)
+    {
+      Scheduler::Event ev;
+      ev.impl = ie->impl;
+      ev.key.m_ts = ie->relative ? m_currentTs + ie->ts : ie->ts;
+      //
+      // The realtime clock was read by the sending thread without holding
+      // the mutex, so it may be a little behind the last event we ran.
+      // Such an event is simply late: run it now.
+      //
+      if (ev.key.m_ts < m_currentTs)
+        {
+          ev.key.m_ts = m_currentTs;
+        }
+      ev.key.m_context = ie->context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_unscheduledEvents++;
+      m_events->Insert (ev);
+    }
+  // Release the entries, still linked in arrival order, all at once.
+  tail->next = m_inboxFree.load (std::memory_order_relaxed);
+  while (!m_inboxFree.compare_exchange_weak (tail->next, head,
+                                             std::memory_order_release,
+                                             std::memory_order_relaxed))
+    {
+      // tail->next has been reloaded with the current head: retry.
+    }
+}
+
 Time
 RealtimeSimulatorImpl::Now (void) const
 {
@@ -609,6 +750,12 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
 {
   NS_LOG_FUNCTION (this << context << time << impl);
 
+  if (!SystemThread::Equals (m_main))
+    {
+      PushInbox (context, m_synchronizer->GetCurrentRealtime () + time.GetTimeStep (), false, impl);
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
 
@@ -617,6 +764,7 @@ RealtimeSimulatorImpl::ScheduleRealtimeWithContext (uint32_t context, Time const
     Scheduler::Event ev;
     ev.impl = impl;
     ev.key.m_ts = ts;
+    ev.key.m_context = context;
     ev.key.m_uid = m_uid;
     m_uid++;
     m_unscheduledEvents++;
@@ -636,6 +784,20 @@ void
 RealtimeSimulatorImpl::ScheduleRealtimeNowWithContext (uint32_t context, EventImpl *impl)
 {
   NS_LOG_FUNCTION (this << context << impl);
+
+  if (!SystemThread::Equals (m_main))
+    {
+      if (m_running)
+        {
+          PushInbox (context, m_synchronizer->GetCurrentRealtime (), false, impl);
+        }
+      else
+        {
+          PushInbox (context, 0, true, impl);
+        }
+      return;
+    }
+
   {
     CriticalSection cs (m_mutex);
 
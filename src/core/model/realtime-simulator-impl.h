@@ -31,6 +31,7 @@
 #include "log.h"
 #include "system-mutex.h"
 
+#include <atomic>
 #include <list>
 
 /**
@@ -52,6 +53,14 @@ namespace ns3 {
  * \ingroup realtime
  *
  * Realtime version of SimulatorImpl.
+ *
+ * Events scheduled from threads other than the main simulation thread
+ * (for example by the FdReader threads of FdNetDevice and TapBridge,
+ * through Simulator::ScheduleWithContext or the ScheduleRealtime methods)
+ * do not take the simulator mutex: they are pushed into a lock-free
+ * inbox, which the main thread drains into the event list each time it
+ * looks for the next event to run.  Events from a given thread keep the
+ * order in which they were scheduled.
  */
 class RealtimeSimulatorImpl : public SimulatorImpl
 {
@@ -172,6 +181,45 @@ private:
   uint64_t NextTs (void) const;
   /** Process the next event. */
   void ProcessOneEvent (void);
+
+  /**
+   * An event scheduled by a thread other than the main simulation thread,
+   * waiting in #m_inbox to be inserted into the event list.
+   */
+  struct InboxEvent
+  {
+    uint64_t ts;          /**< Absolute timestamp, or delay if \c relative. */
+    uint32_t context;     /**< Event context. */
+    bool relative;        /**< \c ts is relative to #m_currentTs. */
+    EventImpl *impl;      /**< The event implementation. */
+    InboxEvent *next;     /**< Next event in the inbox. */
+  };
+  /**
+   * Get an entry for the inbox.
+   *
+   * Each producer thread takes the whole list of entries released by
+   * the main thread at once, which is immune to the ABA problem of
+   * popping a single entry, and keeps them for its next pushes.
+   *
+   * \returns The entry.
+   */
+  InboxEvent * AllocateInboxEvent (void);
+  /**
+   * Push an event into the inbox, without locking, and wake up
+   * the main simulation thread if the inbox was empty.
+   *
+   * \param [in] context The event context.
+   * \param [in] ts The absolute timestamp, or the delay if \p relative.
+   * \param [in] relative \c true if \p ts is relative to the simulation
+   *             time at which the event is inserted in the event list.
+   * \param [in] impl The event implementation.
+   */
+  void PushInbox (uint32_t context, uint64_t ts, bool relative, EventImpl *impl);
+  /**
+   * Move the content of the inbox to the event list, in the order
+   * the events were pushed.  Must be called with #m_mutex held.
+   */
+  void DrainInbox (void);
   /** Destructor implementation. */
   virtual void DoDispose (void);
 
@@ -182,7 +230,20 @@ private:
   /** Has the stopping condition been reached? */
   bool m_stop;
   /** Is the simulator currently running. */
-  bool m_running;
+  std::atomic<bool> m_running;
+  /**
+   * Events scheduled by other threads, in reverse order of arrival.
+   * This is a lock-free multiple producer, single consumer list:
+   * producers push with a compare-and-swap, and the main thread
+   * takes the whole list at once.
+   */
+  std::atomic<InboxEvent *> m_inbox;
+  /**
+   * Inbox entries released by the main thread, for reuse by the
+   * producers.  The main thread pushes with a compare-and-swap, and
+   * producers take the whole list at once.
+   */
+  std::atomic<InboxEvent *> m_inboxFree;
 
   /**
    * \name Mutex-protected variables.
@@ -0,0 +1,216 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "replication-runner.h"
+#include "command-line.h"
+#include "random-variable-stream.h"
+#include "rng-seed-manager.h"
+#include "rng-stream.h"
+#include "simulator.h"
+#include "system-path.h"
+#include "system-mutex.h"
+#include "fatal-error.h"
+#include "log.h"
+#include "ns3/core-config.h"
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <vector>
+
+#if defined (HAVE_UNISTD_H) && defined (HAVE_SYS_WAIT_H)
+/** Do we have fork and waitpid ? */
+#define HAVE_FORK
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+/**
+ * \file
+ * \ingroup randomvariable
+ * ns3::ReplicationRunner implementation.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("ReplicationRunner");
+
+ReplicationRunner::ReplicationRunner ()
+  : m_replications (1),
+    m_jobs (0),
+    m_output ("")
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+ReplicationRunner::AddCommandLineArgs (CommandLine &cmd)
+{
+  NS_LOG_FUNCTION (this);
+  cmd.AddValue ("replications", "number of replications, from the current RngRun", m_replications);
+  cmd.AddValue ("jobs", "number of parallel replications (0: one per processor)", m_jobs);
+  cmd.AddValue ("output", "file collecting the output of the replications", m_output);
+}
+
+void
+ReplicationRunner::SetReplications (uint32_t replications)
+{
+  NS_LOG_FUNCTION (this << replications);
+  m_replications = replications;
+}
+
+void
+ReplicationRunner::SetJobs (uint32_t jobs)
+{
+  NS_LOG_FUNCTION (this << jobs);
+  m_jobs = jobs;
+}
+
+void
+ReplicationRunner::SetOutput (std::string filename)
+{
+  NS_LOG_FUNCTION (this << filename);
+  m_output = filename;
+}
+
+void
+ReplicationRunner::RunReplication (Callback<void> replication, uint64_t run, std::string filename)
+{
+  NS_LOG_FUNCTION (this << run << filename);
+  RngSeedManager::SetRun (run);
+  // Restart the streams created during the setup with the new run
+  // number, at the same stream index.
+  {
+    CriticalSection cs (RandomVariableStream::GetInstancesMutex ());
+    std::set<RandomVariableStream *> &instances = RandomVariableStream::GetInstances ();
+    for (std::set<RandomVariableStream *>::const_iterator i = instances.begin (); i != instances.end (); ++i)
+      {
+        if ((*i)->m_rng != 0)
+          {
+            delete (*i)->m_rng;
+            (*i)->m_rng = new RngStream (RngSeedManager::GetSeed (), (*i)->m_index, run);
+          }
+      }
+  }
+
+  std::ofstream os (filename.c_str ());
+  NS_ABORT_MSG_UNLESS (os, "Can not open replication output file \"" << filename << "\"");
+  std::streambuf *buf = std::cout.rdbuf (os.rdbuf ());
+  replication ();
+  Simulator::Destroy ();
+  std::cout.flush ();
+  std::cout.rdbuf (buf);
+}
+
+uint32_t
+ReplicationRunner::Run (Callback<void> replication)
+{
+  NS_LOG_FUNCTION (this);
+#ifdef HAVE_FORK
+  uint32_t jobs = m_jobs;
+  if (jobs == 0)
+    {
+      long processors = sysconf (_SC_NPROCESSORS_ONLN);
+      jobs = processors > 0 ? processors : 1;
+    }
+  uint64_t first = RngSeedManager::GetRun ();
+  std::string dir = SystemPath::MakeTemporaryDirectoryName ();
+  SystemPath::MakeDirectories (dir);
+  std::vector<std::string> filenames;
+  for (uint32_t i = 0; i < m_replications; i++)
+    {
+      std::ostringstream oss;
+      oss << "run-" << first + i;
+      filenames.push_back (SystemPath::Append (dir, oss.str ()));
+    }
+
+  // What is buffered now must not be written by each replication.
+  std::cout.flush ();
+  std::cerr.flush ();
+  std::clog.flush ();
+
+  std::map<pid_t, uint64_t> running;
+  uint32_t next = 0;
+  uint32_t failed = 0;
+  while (next < m_replications || !running.empty ())
+    {
+      if (next < m_replications && running.size () < jobs)
+        {
+          pid_t pid = fork ();
+          NS_ABORT_MSG_IF (pid < 0, "Can not fork replication " << first + next);
+          if (pid == 0)
+            {
+              RunReplication (replication, first + next, filenames[next]);
+              // Skip the destructors of the static objects, which
+              // belong to the parent process.
+              _exit (0);
+            }
+          NS_LOG_LOGIC ("replication " << first + next << " is process " << pid);
+          running[pid] = first + next;
+          next++;
+          continue;
+        }
+      int status;
+      pid_t pid = waitpid (-1, &status, 0);
+      if (pid < 0)
+        {
+          NS_FATAL_ERROR ("Lost the replications");
+        }
+      std::map<pid_t, uint64_t>::iterator i = running.find (pid);
+      if (i == running.end ())
+        {
+          continue;
+        }
+      if (!WIFEXITED (status) || WEXITSTATUS (status) != 0)
+        {
+          NS_LOG_WARN ("replication " << i->second << " failed");
+          failed++;
+        }
+      running.erase (i);
+    }
+
+  std::ofstream file;
+  if (!m_output.empty ())
+    {
+      file.open (m_output.c_str ());
+      NS_ABORT_MSG_UNLESS (file, "Can not open output file \"" << m_output << "\"");
+    }
+  std::ostream &os = m_output.empty () ? std::cout : file;
+  for (std::vector<std::string>::const_iterator i = filenames.begin (); i != filenames.end (); ++i)
+    {
+      std::ifstream is (i->c_str ());
+      if (is && is.peek () != std::ifstream::traits_type::eof ())
+        {
+          os << is.rdbuf ();
+        }
+      is.close ();
+      std::remove (i->c_str ());
+    }
+  os.flush ();
+  rmdir (dir.c_str ());
+  return failed;
+#else /* HAVE_FORK */
+  NS_FATAL_ERROR ("ReplicationRunner needs fork (), which this platform lacks");
+  return m_replications;
+#endif /* HAVE_FORK */
+}
+
+} // namespace ns3
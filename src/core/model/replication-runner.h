@@ -0,0 +1,128 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef REPLICATION_RUNNER_H
+#define REPLICATION_RUNNER_H
+
+#include <string>
+#include "callback.h"
+
+/**
+ * \file
+ * \ingroup randomvariable
+ * ns3::ReplicationRunner declaration.
+ */
+
+namespace ns3 {
+
+class CommandLine;
+
+/**
+ * \ingroup randomvariable
+ * \brief Run independent replications of a simulation, in parallel,
+ * after a common setup.
+ *
+ * The program builds its scenario once, then hands the rest of the
+ * simulation to Run(), which forks one process per replication.  Each
+ * replication starts from a copy of the scenario, shared with the
+ * other replications until they write to it: the topology, the
+ * routing tables and any other data built during the setup are not
+ * rebuilt nor duplicated.
+ *
+ * The replications use consecutive run numbers, starting with the
+ * current RngRun: before running the callback, each replication sets
+ * its run number and restarts the streams of the random variables
+ * created during the setup, as if they had been created with that run
+ * number.
+ *
+ * What the replications write to \c std::cout is collected in a single
+ * output file, in run order.
+ *
+ * \code
+ *   int main (int argc, char *argv[])
+ *   {
+ *     ReplicationRunner runner;
+ *     CommandLine cmd;
+ *     runner.AddCommandLineArgs (cmd);
+ *     cmd.Parse (argc, argv);
+ *
+ *     BuildTopology ();
+ *     runner.Run (MakeCallback (&RunAndReport));
+ *     Simulator::Destroy ();
+ *     return 0;
+ *   }
+ * \endcode
+ *
+ * where \c RunAndReport calls Simulator::Run, then prints its results.
+ *
+ * The Simulator is a process-wide singleton, so the replications are
+ * processes rather than threads.  Only the thread calling Run() is
+ * copied to the replications: asynchronous logging and
+ * MultithreadedSimulatorImpl workers must not be started during the
+ * setup.
+ */
+class ReplicationRunner
+{
+public:
+  ReplicationRunner ();
+
+  /**
+   * Add the \c --replications, \c --jobs and \c --output arguments.
+   * \param [in,out] cmd The command line.
+   */
+  void AddCommandLineArgs (CommandLine &cmd);
+  /** \param [in] replications The number of replications. */
+  void SetReplications (uint32_t replications);
+  /**
+   * \param [in] jobs The maximum number of replications running at the
+   * same time; 0, the default, is the number of processors.
+   */
+  void SetJobs (uint32_t jobs);
+  /**
+   * \param [in] filename The file collecting the output of the
+   * replications; the default, an empty name, is \c std::cout.
+   */
+  void SetOutput (std::string filename);
+
+  /**
+   * Run the replications, and wait for them to finish.
+   *
+   * \param [in] replication The callback run by each replication, after
+   * setting its run number.  Simulator::Destroy is called after it.
+   * \returns The number of replications which failed: those which
+   * crashed, or called \c exit with a non zero status.
+   */
+  uint32_t Run (Callback<void> replication);
+
+private:
+  /**
+   * Run one replication, in the forked process.
+   * \param [in] replication The callback.
+   * \param [in] run The run number.
+   * \param [in] filename The file collecting its output.
+   */
+  void RunReplication (Callback<void> replication, uint64_t run, std::string filename);
+
+  uint32_t m_replications;  //!< The number of replications.
+  uint32_t m_jobs;          //!< The maximum number of parallel replications.
+  std::string m_output;     //!< The output file name.
+};
+
+} // namespace ns3
+
+#endif /* REPLICATION_RUNNER_H */
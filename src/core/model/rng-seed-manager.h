@@ -104,6 +104,18 @@ public:
    * \returns The next stream index.
    */
   static uint64_t GetNextStreamIndex(void);
+  /**
+   * Get the next automatically assigned stream index, without
+   * assigning it.
+   * \returns The next stream index.
+   */
+  static uint64_t PeekNextStreamIndex (void);
+  /**
+   * Set the next automatically assigned stream index, to restore
+   * a Checkpoint.
+   * \param [in] next The next stream index.
+   */
+  static void SetNextStreamIndex (uint64_t next);
 
 };
 
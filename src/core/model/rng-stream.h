@@ -20,6 +20,7 @@
 #ifndef RNGSTREAM_H
 #define RNGSTREAM_H
 #include <string>
+#include <cstddef>
 #include <stdint.h>
 
 /**
@@ -70,6 +71,30 @@ public:
    * \returns The next random.
    */
   double RandU01 (void);
+  /**
+   * Generate the next \p n random numbers for this stream.
+   * Uniformly distributed between 0 and 1.
+   *
+   * This produces exactly the same numbers as \p n calls to
+   * RandU01(void), but keeps the state in registers for the
+   * whole batch.
+   *
+   * \param [out] values The array to store the random numbers in.
+   * \param [in] n The number of random numbers.
+   */
+  void RandU01 (double *values, std::size_t n);
+  /**
+   * Get the state of this stream, to save it.
+   *
+   * \param [out] state The state vector.
+   */
+  void GetState (double state[6]) const;
+  /**
+   * Set the state of this stream, to restore a saved state.
+   *
+   * \param [in] state The state vector.
+   */
+  void SetState (const double state[6]);
 
 private:
   /**
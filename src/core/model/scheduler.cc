@@ -49,4 +49,10 @@ Scheduler::GetTypeId (void)
   return tid;
 }
 
+bool
+Scheduler::IsRemoveFast (void) const
+{
+  return false;
+}
+
 } // namespace ns3
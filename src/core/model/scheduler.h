@@ -135,6 +135,18 @@ public:
    * \param [in] ev The event to remove
    */
   virtual void Remove (const Event &ev) = 0;
+  /**
+   * Is Remove cheap enough to be used for every cancelled event?
+   *
+   * Simulator implementations may then take a cancelled event out of
+   * the event list immediately, rather than leaving it in the list
+   * until it reaches the front.
+   *
+   * The default implementation returns \c false.
+   *
+   * \returns \c true if Remove runs in constant time.
+   */
+  virtual bool IsRemoveFast (void) const;
 };
 
 /**
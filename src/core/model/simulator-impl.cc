@@ -42,4 +42,12 @@ SimulatorImpl::GetTypeId (void)
   return tid;
 }
 
+void
+SimulatorImpl::RestoreClock (const Time &now)
+{
+  NS_LOG_FUNCTION (this << now);
+  NS_FATAL_ERROR ("The simulator implementation " << GetInstanceTypeId () <<
+                  " can not restore its clock");
+}
+
 } // namespace ns3
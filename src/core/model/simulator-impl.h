@@ -99,6 +99,17 @@ public:
   virtual uint32_t GetSystemId () const = 0; 
   /** \copydoc Simulator::GetContext */
   virtual uint32_t GetContext (void) const = 0;
+  /**
+   * Move the clock to a time restored from a Checkpoint, before Run.
+   *
+   * The events already scheduled keep their delay from the clock,
+   * so they are delayed by \p now; their EventIds stay valid.  The
+   * default implementation
+   * does not support restoring the clock, and aborts.
+   *
+   * \param [in] now The restored time.
+   */
+  virtual void RestoreClock (const Time &now);
 };
 
 } // namespace ns3
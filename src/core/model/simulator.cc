@@ -181,6 +181,7 @@ Simulator::Destroy (void)
   (*pimpl)->Destroy ();
   (*pimpl)->Unref ();
   *pimpl = 0;
+  LogFlush ();
 }
 
 void
@@ -370,6 +371,13 @@ Simulator::GetSystemId (void)
     }
 }
 
+EventAllocator::Stats
+Simulator::GetEventAllocatorStats (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return EventAllocator::GetStats ();
+}
+
 void
 Simulator::SetImplementation (Ptr<SimulatorImpl> impl)
 {
@@ -23,6 +23,7 @@
 
 #include "event-id.h"
 #include "event-impl.h"
+#include "event-allocator.h"
 #include "make-event.h"
 #include "nstime.h"
 
@@ -1182,6 +1183,18 @@ public:
    * @return The system id for this simulator.
    */
   static uint32_t GetSystemId (void);
+
+  /**
+   * Get the event allocation statistics of the calling thread.
+   *
+   * Every event is allocated through the EventAllocator; this reports
+   * how many of those allocations were served by its free lists.
+   * The recycling itself can be turned off with the
+   * ns3::DefaultSimulatorImpl::EventPool attribute.
+   *
+   * @return The event allocation statistics.
+   */
+  static EventAllocator::Stats GetEventAllocatorStats (void);
   
 private:
   /** Default constructor. */
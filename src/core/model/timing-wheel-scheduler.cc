@@ -0,0 +1,326 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "timing-wheel-scheduler.h"
+#include "event-impl.h"
+#include "assert.h"
+#include "log.h"
+
+/**
+ * \file
+ * \ingroup scheduler
+ * Implementation of ns3::TimingWheelScheduler class.
+ */
+
+namespace ns3 {
+
+NS_LOG_COMPONENT_DEFINE ("TimingWheelScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED (TimingWheelScheduler);
+
+TypeId
+TimingWheelScheduler::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::TimingWheelScheduler")
+    .SetParent<Scheduler> ()
+    .SetGroupName ("Core")
+    .AddConstructor<TimingWheelScheduler> ()
+  ;
+  return tid;
+}
+
+TimingWheelScheduler::TimingWheelScheduler ()
+  : m_now (0),
+    m_count (0),
+    m_next (0),
+    m_free (0)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t level = 0; level < LEVELS; level++)
+    {
+      for (uint32_t slot = 0; slot < SLOTS; slot++)
+        {
+          m_slots[level][slot].head = 0;
+          m_slots[level][slot].tail = 0;
+        }
+      for (uint32_t word = 0; word < WORDS; word++)
+        {
+          m_occupied[level][word] = 0;
+        }
+      m_levelCount[level] = 0;
+    }
+}
+
+TimingWheelScheduler::~TimingWheelScheduler ()
+{
+  NS_LOG_FUNCTION (this);
+  for (std::vector<Node *>::iterator i = m_chunks.begin (); i != m_chunks.end (); ++i)
+    {
+      delete [] *i;
+    }
+}
+
+TimingWheelScheduler::Node *
+TimingWheelScheduler::AllocateNode (void)
+{
+  if (m_free == 0)
+    {
+      Node *chunk = new Node [CHUNK];
+      m_chunks.push_back (chunk);
+      for (uint32_t i = 0; i < CHUNK; i++)
+        {
+          chunk[i].next = m_free;
+          m_free = &chunk[i];
+        }
+    }
+  Node *node = m_free;
+  m_free = node->next;
+  return node;
+}
+
+void
+TimingWheelScheduler::FreeNode (Node *node)
+{
+  node->next = m_free;
+  m_free = node;
+}
+
+void
+TimingWheelScheduler::Link (Node *node)
+{
+  uint64_t ts = node->ev.key.m_ts;
+  NS_ASSERT (ts >= m_now);
+  uint64_t diff = ts ^ m_now;
+  uint32_t level = 0;
+  if (diff != 0)
+    {
+      level = (63 - __builtin_clzll (diff)) / SLOT_BITS;
+    }
+  uint32_t slot = (ts >> (level * SLOT_BITS)) & (SLOTS - 1);
+  node->level = level;
+  node->slot = slot;
+
+  Slot &s = m_slots[level][slot];
+  // The entries of a slot of the first wheel all have the same
+  // timestamp, and must come out in uid order.  The uids are
+  // allocated in increasing order, so the new entry goes last,
+  // unless it was cascaded from an upper wheel.
+  Node *prev = s.tail;
+  if (level == 0)
+    {
+      while (prev != 0 && node->ev.key.m_uid < prev->ev.key.m_uid)
+        {
+          prev = prev->prev;
+        }
+    }
+  node->prev = prev;
+  node->next = (prev == 0) ? s.head : prev->next;
+  if (node->prev == 0)
+    {
+      s.head = node;
+    }
+  else
+    {
+      node->prev->next = node;
+    }
+  if (node->next == 0)
+    {
+      s.tail = node;
+    }
+  else
+    {
+      node->next->prev = node;
+    }
+  m_occupied[level][slot / 64] |= (uint64_t)1 << (slot % 64);
+  m_levelCount[level]++;
+}
+
+void
+TimingWheelScheduler::Unlink (Node *node)
+{
+  Slot &s = m_slots[node->level][node->slot];
+  if (node->prev == 0)
+    {
+      s.head = node->next;
+    }
+  else
+    {
+      node->prev->next = node->next;
+    }
+  if (node->next == 0)
+    {
+      s.tail = node->prev;
+    }
+  else
+    {
+      node->next->prev = node->prev;
+    }
+  if (s.head == 0)
+    {
+      m_occupied[node->level][node->slot / 64] &= ~((uint64_t)1 << (node->slot % 64));
+    }
+  m_levelCount[node->level]--;
+}
+
+uint32_t
+TimingWheelScheduler::FirstLevel (void) const
+{
+  NS_ASSERT (m_count > 0);
+  uint32_t level = 0;
+  while (m_levelCount[level] == 0)
+    {
+      level++;
+    }
+  return level;
+}
+
+uint32_t
+TimingWheelScheduler::FirstSlot (uint32_t level) const
+{
+  // No slot of a wheel is ever occupied below the slot of m_now, so
+  // the first occupied slot holds the earliest entries of the wheel.
+  for (uint32_t word = 0; word < WORDS; word++)
+    {
+      uint64_t bits = m_occupied[level][word];
+      if (bits != 0)
+        {
+          return word * 64 + __builtin_ctzll (bits);
+        }
+    }
+  NS_ASSERT (false);
+  return 0;
+}
+
+void
+TimingWheelScheduler::Cascade (void)
+{
+  while (m_levelCount[0] == 0)
+    {
+      uint32_t level = FirstLevel ();
+      uint32_t slot = FirstSlot (level);
+      // Move the wheel time to the start of the slot: this is not later
+      // than any entry of the slot, and the lower wheels are empty.
+      uint32_t shift = level * SLOT_BITS;
+      uint64_t high = 0;
+      if (level + 1 < LEVELS)
+        {
+          high = (m_now >> (shift + SLOT_BITS)) << (shift + SLOT_BITS);
+        }
+      m_now = high | ((uint64_t)slot << shift);
+      NS_LOG_LOGIC ("cascade wheel " << level << " slot " << slot);
+      Node *node = m_slots[level][slot].head;
+      while (node != 0)
+        {
+          Node *next = node->next;
+          Unlink (node);
+          Link (node);
+          node = next;
+        }
+    }
+}
+
+void
+TimingWheelScheduler::Insert (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  NS_ASSERT_MSG (ev.impl->GetSchedulerLink () == 0, "Event already in an event list");
+  Node *node = AllocateNode ();
+  node->ev = ev;
+  Link (node);
+  ev.impl->SetSchedulerLink (node);
+  if (m_count == 0 || (m_next != 0 && ev.key < m_next->ev.key))
+    {
+      m_next = node;
+    }
+  m_count++;
+}
+
+bool
+TimingWheelScheduler::IsEmpty (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return m_count == 0;
+}
+
+Scheduler::Event
+TimingWheelScheduler::PeekNext (void) const
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  if (m_next != 0)
+    {
+      return m_next->ev;
+    }
+  uint32_t level = FirstLevel ();
+  const Node *node = m_slots[level][FirstSlot (level)].head;
+  // The slots of the upper wheels are not sorted.
+  const Node *next = node;
+  if (level != 0)
+    {
+      for (node = node->next; node != 0; node = node->next)
+        {
+          if (node->ev.key < next->ev.key)
+            {
+              next = node;
+            }
+        }
+    }
+  m_next = next;
+  return next->ev;
+}
+
+Scheduler::Event
+TimingWheelScheduler::RemoveNext (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (!IsEmpty ());
+  Cascade ();
+  Node *node = m_slots[0][FirstSlot (0)].head;
+  Unlink (node);
+  m_now = node->ev.key.m_ts;
+  node->ev.impl->SetSchedulerLink (0);
+  m_next = 0;
+  m_count--;
+  Event ev = node->ev;
+  FreeNode (node);
+  return ev;
+}
+
+void
+TimingWheelScheduler::Remove (const Event &ev)
+{
+  NS_LOG_FUNCTION (this << &ev);
+  Node *node = static_cast<Node *> (ev.impl->GetSchedulerLink ());
+  NS_ASSERT (node != 0 && node->ev.impl == ev.impl);
+  ev.impl->SetSchedulerLink (0);
+  if (node == m_next)
+    {
+      m_next = 0;
+    }
+  Unlink (node);
+  m_count--;
+  FreeNode (node);
+}
+
+bool
+TimingWheelScheduler::IsRemoveFast (void) const
+{
+  return true;
+}
+
+} // namespace ns3
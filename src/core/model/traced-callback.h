@@ -22,6 +22,7 @@
 #define TRACED_CALLBACK_H
 
 #include <list>
+#include <vector>
 #include "callback.h"
 
 /**
@@ -46,6 +47,11 @@ namespace ns3 {
  * calling one of the \c operator() forms with the appropriate
  * number of arguments.
  *
+ * The first Callback of the chain is stored inline, and the others
+ * in a contiguous vector, so that a TracedCallback with no or one
+ * Callback connected does not allocate memory, and firing a
+ * TracedCallback with no Callback connected costs a single test.
+ *
  * \tparam T1 \explicit Type of the first argument to the functor.
  * \tparam T2 \explicit Type of the second argument to the functor.
  * \tparam T3 \explicit Type of the third argument to the functor.
@@ -101,6 +107,13 @@ public:
    * which fires the Callback.
    */
   /**@{*/
+  /**
+   * Check whether any Callback is connected, to skip the preparation
+   * of the arguments of a trace when nothing listens to it.
+   *
+   * \return \c true if no Callback is connected.
+   */
+  bool IsEmpty (void) const;
   /** Functor which invokes the chain of Callbacks. */
   void operator() (void) const;
   /**
@@ -234,8 +247,12 @@ private:
    * \tparam T7 \deduced Type of the seventh argument to the functor.
    * \tparam T8 \deduced Type of the eighth argument to the functor.
    */
-  typedef std::list<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
-  /** The chain of Callbacks. */
+  typedef std::vector<Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> > CallbackList;
+  /**
+   * The first Callback of the chain; null if the chain is empty.
+   */
+  Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> m_firstCallback;
+  /** The rest of the chain of Callbacks. */
   CallbackList m_callbackList;
 };
 
@@ -253,7 +270,8 @@ template<typename T1, typename T2,
          typename T5, typename T6,
          typename T7, typename T8>
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::TracedCallback ()
-  : m_callbackList () 
+  : m_firstCallback (),
+    m_callbackList () 
 {
 }
 template<typename T1, typename T2,
@@ -266,7 +284,14 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::ConnectWithoutContext (const CallbackBa
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> cb;
   if (!cb.Assign (callback))
     NS_FATAL_ERROR_NO_MSG();
-  m_callbackList.push_back (cb);
+  if (m_firstCallback.IsNull ())
+    {
+      m_firstCallback = cb;
+    }
+  else
+    {
+      m_callbackList.push_back (cb);
+    }
 }
 template<typename T1, typename T2,
          typename T3, typename T4,
@@ -279,7 +304,14 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Connect (const CallbackBase & callback,
   if (!cb.Assign (callback))
     NS_FATAL_ERROR ("when connecting to " << path);
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
-  m_callbackList.push_back (realCb);
+  if (m_firstCallback.IsNull ())
+    {
+      m_firstCallback = realCb;
+    }
+  else
+    {
+      m_callbackList.push_back (realCb);
+    }
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -300,6 +332,18 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::DisconnectWithoutContext (const Callbac
           i++;
         }
     }
+  if (!m_firstCallback.IsNull () && m_firstCallback.IsEqual (callback))
+    {
+      if (m_callbackList.empty ())
+        {
+          m_firstCallback.Nullify ();
+        }
+      else
+        {
+          m_firstCallback = m_callbackList.front ();
+          m_callbackList.erase (m_callbackList.begin ());
+        }
+    }
 }
 template<typename T1, typename T2, 
          typename T3, typename T4,
@@ -314,6 +358,15 @@ TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::Disconnect (const CallbackBase & callba
   Callback<void,T1,T2,T3,T4,T5,T6,T7,T8> realCb = cb.Bind (path);
   DisconnectWithoutContext (realCb);
 }
+template<typename T1, typename T2, 
+         typename T3, typename T4,
+         typename T5, typename T6,
+         typename T7, typename T8>
+bool
+TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::IsEmpty (void) const
+{
+  return m_firstCallback.IsNull ();
+}
 template<typename T1, typename T2, 
          typename T3, typename T4,
          typename T5, typename T6,
@@ -321,10 +374,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (void) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
+    {
+      return;
+    }
+  m_firstCallback ();
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)();
+      m_callbackList[i] ();
     }
 }
 template<typename T1, typename T2, 
@@ -334,10 +393,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
     {
-      (*i)(a1);
+      return;
+    }
+  m_firstCallback (a1);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
+    {
+      m_callbackList[i] (a1);
     }
 }
 template<typename T1, typename T2, 
@@ -347,10 +412,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
     {
-      (*i)(a1, a2);
+      return;
+    }
+  m_firstCallback (a1, a2);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
+    {
+      m_callbackList[i] (a1, a2);
     }
 }
 template<typename T1, typename T2, 
@@ -360,10 +431,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
+    {
+      return;
+    }
+  m_firstCallback (a1, a2, a3);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3);
+      m_callbackList[i] (a1, a2, a3);
     }
 }
 template<typename T1, typename T2, 
@@ -373,10 +450,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
+    {
+      return;
+    }
+  m_firstCallback (a1, a2, a3, a4);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4);
+      m_callbackList[i] (a1, a2, a3, a4);
     }
 }
 template<typename T1, typename T2, 
@@ -386,10 +469,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
     {
-      (*i)(a1, a2, a3, a4, a5);
+      return;
+    }
+  m_firstCallback (a1, a2, a3, a4, a5);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
+    {
+      m_callbackList[i] (a1, a2, a3, a4, a5);
     }
 }
 template<typename T1, typename T2, 
@@ -399,10 +488,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
     {
-      (*i)(a1, a2, a3, a4, a5, a6);
+      return;
+    }
+  m_firstCallback (a1, a2, a3, a4, a5, a6);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
+    {
+      m_callbackList[i] (a1, a2, a3, a4, a5, a6);
     }
 }
 template<typename T1, typename T2, 
@@ -412,10 +507,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
+    {
+      return;
+    }
+  m_firstCallback (a1, a2, a3, a4, a5, a6, a7);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7);
+      m_callbackList[i] (a1, a2, a3, a4, a5, a6, a7);
     }
 }
 template<typename T1, typename T2, 
@@ -425,10 +526,16 @@ template<typename T1, typename T2,
 void 
 TracedCallback<T1,T2,T3,T4,T5,T6,T7,T8>::operator() (T1 a1, T2 a2, T3 a3, T4 a4, T5 a5, T6 a6, T7 a7, T8 a8) const
 {
-  for (typename CallbackList::const_iterator i = m_callbackList.begin ();
-       i != m_callbackList.end (); i++)
+  if (m_firstCallback.IsNull ())
+    {
+      return;
+    }
+  m_firstCallback (a1, a2, a3, a4, a5, a6, a7, a8);
+  // Index rather than iterate, so that a Callback may connect
+  // another one to this TracedCallback.
+  for (std::size_t i = 0; i < m_callbackList.size (); i++)
     {
-      (*i)(a1, a2, a3, a4, a5, a6, a7, a8);
+      m_callbackList[i] (a1, a2, a3, a4, a5, a6, a7, a8);
     }
 }
 
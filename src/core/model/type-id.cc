@@ -24,6 +24,7 @@
 #include "trace-source-accessor.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 #include <sstream>
 #include <iomanip>
@@ -74,10 +75,23 @@ NS_LOG_COMPONENT_DEFINE ("TypeId");
  * the high order bit of the hash value, and assert on higher level
  * collisions.  The three-fold collision probability should be an
  * acceptablly small error rate.
+ *
+ * <b>Attribute and TraceSource Indices</b>
+ *
+ * Attributes and trace sources are looked up by name each time an
+ * attribute is set or a trace sink is connected, for every object
+ * created.  Rather than scanning the attribute and trace source
+ * vectors of the type and each of its parents, each type has
+ * a flattened by-name index of all its attributes and trace
+ * sources, including the inherited ones.  The indices are built
+ * lazily, on the first lookup, and rebuilt if a type gained a
+ * parent, an attribute or a trace source since.
  */
 class IidManager : public Singleton<IidManager>
 {
 public:
+  /** Constructor. */
+  IidManager ();
   /**
    * Create a new unique type id.
    * \param [in] name The name of this type id.
@@ -182,6 +196,11 @@ public:
    * \returns The type id.
    */
   uint16_t GetRegistered (uint32_t i) const;
+  /**
+   * Get the generation of the type ids.
+   * \returns The generation.
+   */
+  uint32_t GetGeneration (void) const;
   /**
    * Record a new attribute in a type id.
    * \param [in] uid The id.
@@ -229,6 +248,12 @@ public:
    * \returns The information associated to attribute whose index is \p i.
    */
   struct TypeId::AttributeInformation GetAttribute(uint16_t uid, uint32_t i) const;
+  /**
+   * Get the default values of the Attributes, building them if needed.
+   * \param [in] uid The id.
+   * \returns The default values of the Attributes.
+   */
+  Ptr<const TypeId::AttributeDefaults> GetAttributeDefaults (uint16_t uid) const;
   /**
    * Record a new TraceSource.
    * \param [in] uid The id.
@@ -264,6 +289,26 @@ public:
    * \returns Detailed information about the requested trace source.
    */
   struct TypeId::TraceSourceInformation GetTraceSource(uint16_t uid, uint32_t i) const;
+  /**
+   * Find an Attribute by name, in a type id or its parents.
+   * \param [in] uid The id.
+   * \param [in] name The Attribute name.
+   * \returns The information about the attribute, or 0 if not found.
+   *           The pointer is only valid until the next attribute
+   *           is added.
+   */
+  const struct TypeId::AttributeInformation *
+  FindAttribute (uint16_t uid, const std::string &name) const;
+  /**
+   * Find a TraceSource by name, in a type id or its parents.
+   * \param [in] uid The id.
+   * \param [in] name The TraceSource name.
+   * \returns The information about the trace source, or 0 if not found.
+   *           The pointer is only valid until the next trace source
+   *           is added.
+   */
+  const struct TypeId::TraceSourceInformation *
+  FindTraceSource (uint16_t uid, const std::string &name) const;
   /**
    * Check if this TypeId should not be listed in documentation.
    * \param [in] uid The id.
@@ -293,6 +338,12 @@ private:
    */
   static TypeId::hash_t Hasher (const std::string name);
 
+  /**
+   * Type of the Attribute and TraceSource indices: the position,
+   * as the type id and the index in its vector, by name.
+   */
+  typedef std::unordered_map<std::string, std::pair<uint16_t, uint32_t> > nameindex_t;
+
   /** The information record about a single type id. */
   struct IidInformation {
     /** The type id name. */
@@ -319,6 +370,14 @@ private:
     TypeId::SupportLevel supportLevel;
     /** Support message. */
     std::string supportMsg;
+    /** The flattened index of the attributes, including the inherited ones. */
+    nameindex_t attributeIndex;
+    /** The flattened index of the trace sources, including the inherited ones. */
+    nameindex_t traceSourceIndex;
+    /** The m_generation the indices were built at, 0 if never built. */
+    uint32_t indexGeneration;
+    /** The default values of the Attributes, 0 if out of date. */
+    Ptr<TypeId::AttributeDefaults> attributeDefaults;
   };
   /** Iterator type. */
   typedef std::vector<struct IidInformation>::const_iterator Iterator;
@@ -329,6 +388,13 @@ private:
    * \returns The information record.
    */
   struct IidManager::IidInformation *LookupInformation (uint16_t uid) const;
+  /**
+   * Build the attribute and trace source indices of a type,
+   * if they are out of date.
+   * \param [in] uid The id.
+   * \returns The information record of the type.
+   */
+  struct IidInformation *UpdateIndex (uint16_t uid) const;
 
   /** The container of all type id records. */
   std::vector<struct IidInformation> m_information;
@@ -343,6 +409,12 @@ private:
   /** The by-hash index. */
   hashmap_t m_hashmap;
 
+  /**
+   * Incremented each time a type id gains a parent, an attribute
+   * or a trace source, to invalidate the attribute and trace
+   * source indices.
+   */
+  uint32_t m_generation;
 
   /** IidManager constants. */
   enum {
@@ -357,6 +429,11 @@ private:
 };
 
 
+IidManager::IidManager ()
+  : m_generation (1)
+{
+}
+
 //static
 TypeId::hash_t
 IidManager::Hasher (const std::string name)
@@ -429,6 +506,7 @@ IidManager::AllocateUid (std::string name)
   information.size = (std::size_t)(-1);
   information.hasConstructor = false;
   information.mustHideFromDocumentation = false;
+  information.indexGeneration = 0;
   m_information.push_back (information);
   uint32_t uid = m_information.size ();
   NS_ASSERT (uid <= 0xffff);
@@ -456,6 +534,7 @@ IidManager::SetParent (uint16_t uid, uint16_t parent)
   NS_ASSERT (parent <= m_information.size ());
   struct IidInformation *information = LookupInformation (uid);
   information->parent = parent;
+  m_generation++;
 }
 void 
 IidManager::SetGroupName (uint16_t uid, std::string groupName)
@@ -590,6 +669,12 @@ IidManager::GetRegisteredN (void) const
   NS_LOG_FUNCTION (IID << m_information.size ());
   return m_information.size ();
 }
+uint32_t
+IidManager::GetGeneration (void) const
+{
+  NS_LOG_FUNCTION (IID << m_generation);
+  return m_generation;
+}
 uint16_t 
 IidManager::GetRegistered (uint32_t i) const
 {
@@ -665,6 +750,8 @@ IidManager::AddAttribute (uint16_t uid,
   info.supportLevel = supportLevel;
   info.supportMsg = supportMsg;
   information->attributes.push_back (info);
+  information->attributeDefaults = 0;
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->attributes.size () - 1);
 }
 void 
@@ -676,6 +763,7 @@ IidManager::SetAttributeInitialValue(uint16_t uid,
   struct IidInformation *information = LookupInformation (uid);
   NS_ASSERT (i < information->attributes.size ());
   information->attributes[i].initialValue = initialValue;
+  information->attributeDefaults = 0;
 }
 
 
@@ -698,6 +786,29 @@ IidManager::GetAttribute(uint16_t uid, uint32_t i) const
   NS_LOG_LOGIC (IIDL << information->name);
   return information->attributes[i];
 }
+Ptr<const TypeId::AttributeDefaults>
+IidManager::GetAttributeDefaults (uint16_t uid) const
+{
+  NS_LOG_FUNCTION (IID << uid);
+  struct IidInformation *information = LookupInformation (uid);
+  if (information->attributeDefaults == 0)
+    {
+      Ptr<TypeId::AttributeDefaults> defaults = Create<TypeId::AttributeDefaults> ();
+      for (std::vector<struct TypeId::AttributeInformation>::const_iterator i = information->attributes.begin ();
+           i != information->attributes.end (); ++i)
+        {
+          struct TypeId::AttributeDefault attribute;
+          attribute.flags = i->flags;
+          attribute.initialValue = i->initialValue;
+          attribute.accessor = i->accessor;
+          attribute.checker = i->checker;
+          attribute.valid = i->checker->Check (*i->initialValue);
+          defaults->attributes.push_back (attribute);
+        }
+      information->attributeDefaults = defaults;
+    }
+  return information->attributeDefaults;
+}
 
 bool
 IidManager::HasTraceSource (uint16_t uid,
@@ -756,6 +867,7 @@ IidManager::AddTraceSource (uint16_t uid,
   source.supportLevel = supportLevel;
   source.supportMsg = supportMsg;
   information->traceSources.push_back (source);
+  m_generation++;
   NS_LOG_LOGIC (IIDL << information->traceSources.size () - 1);
 }
 uint32_t 
@@ -776,6 +888,72 @@ IidManager::GetTraceSource(uint16_t uid, uint32_t i) const
   NS_LOG_LOGIC (IIDL << information->name);
   return information->traceSources[i];
 }
+
+struct IidManager::IidInformation *
+IidManager::UpdateIndex (uint16_t uid) const
+{
+  NS_LOG_FUNCTION (IID << uid);
+  struct IidInformation *information = LookupInformation (uid);
+  if (information->indexGeneration == m_generation)
+    {
+      return information;
+    }
+  NS_LOG_LOGIC (IIDL << "building the indices of " << information->name);
+  information->attributeIndex.clear ();
+  information->traceSourceIndex.clear ();
+  // Walk up from the type to the root: insert does not replace the
+  // existing entries, so the attributes and trace sources of a type
+  // hide those of its parents with the same name.
+  while (uid != 0)
+    {
+      struct IidInformation *current = LookupInformation (uid);
+      for (uint32_t i = 0; i < current->attributes.size (); i++)
+        {
+          information->attributeIndex.insert
+            (std::make_pair (current->attributes[i].name, std::make_pair (uid, i)));
+        }
+      for (uint32_t i = 0; i < current->traceSources.size (); i++)
+        {
+          information->traceSourceIndex.insert
+            (std::make_pair (current->traceSources[i].name, std::make_pair (uid, i)));
+        }
+      if (current->parent == uid)
+        {
+          // top of inheritance tree
+          break;
+        }
+      uid = current->parent;
+    }
+  information->indexGeneration = m_generation;
+  return information;
+}
+
+const struct TypeId::AttributeInformation *
+IidManager::FindAttribute (uint16_t uid, const std::string &name) const
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = UpdateIndex (uid);
+  nameindex_t::const_iterator it = information->attributeIndex.find (name);
+  if (it == information->attributeIndex.end ())
+    {
+      return 0;
+    }
+  return &LookupInformation (it->second.first)->attributes[it->second.second];
+}
+
+const struct TypeId::TraceSourceInformation *
+IidManager::FindTraceSource (uint16_t uid, const std::string &name) const
+{
+  NS_LOG_FUNCTION (IID << uid << name);
+  struct IidInformation *information = UpdateIndex (uid);
+  nameindex_t::const_iterator it = information->traceSourceIndex.find (name);
+  if (it == information->traceSourceIndex.end ())
+    {
+      return 0;
+    }
+  return &LookupInformation (it->second.first)->traceSources[it->second.second];
+}
+
 bool 
 IidManager::MustHideFromDocumentation (uint16_t uid) const
 {
@@ -855,6 +1033,12 @@ TypeId::GetRegisteredN (void)
   NS_LOG_FUNCTION_NOARGS ();
   return IidManager::Get ()->GetRegisteredN ();
 }
+uint32_t
+TypeId::GetGeneration (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  return IidManager::Get ()->GetGeneration ();
+}
 TypeId 
 TypeId::GetRegistered (uint32_t i)
 {
@@ -866,38 +1050,25 @@ bool
 TypeId::LookupAttributeByName (std::string name, struct TypeId::AttributeInformation *info) const
 {
   NS_LOG_FUNCTION (this << name << info);
-  TypeId tid;
-  TypeId nextTid = *this;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetAttributeN (); i++)
-        {
-          struct TypeId::AttributeInformation tmp = tid.GetAttribute(i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "Attribute '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return true;
-                }
-              else if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("Attribute '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return false;
+  const struct TypeId::AttributeInformation *tmp =
+    IidManager::Get ()->FindAttribute (m_tid, name);
+  if (tmp == 0)
+    {
+      return false;
+    }
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "Attribute '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("Attribute '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
+  *info = *tmp;
+  return true;
 }
 
 TypeId 
@@ -1067,6 +1238,12 @@ TypeId::GetAttribute(uint32_t i) const
   NS_LOG_FUNCTION (this << i);
   return IidManager::Get ()->GetAttribute(m_tid, i);
 }
+Ptr<const TypeId::AttributeDefaults>
+TypeId::GetAttributeDefaults (void) const
+{
+  NS_LOG_FUNCTION (this);
+  return IidManager::Get ()->GetAttributeDefaults (m_tid);
+}
 std::string 
 TypeId::GetAttributeFullName (uint32_t i) const
 {
@@ -1126,39 +1303,25 @@ TypeId::LookupTraceSourceByName (std::string name,
                                  struct TraceSourceInformation *info) const
 {
   NS_LOG_FUNCTION (this << name);
-  TypeId tid;
-  TypeId nextTid = *this;
-  struct TypeId::TraceSourceInformation tmp;
-  do {
-      tid = nextTid;
-      for (uint32_t i = 0; i < tid.GetTraceSourceN (); i++)
-        {
-          tmp = tid.GetTraceSource (i);
-          if (tmp.name == name)
-            {
-              if (tmp.supportLevel == TypeId::SUPPORTED)
-                {
-                  *info = tmp;
-                   return tmp.accessor;
-                }
-              else if (tmp.supportLevel == TypeId::DEPRECATED)
-                {
-                  std::cerr << "TraceSource '" << name << "' is deprecated: "
-                                 << tmp.supportMsg << std::endl;
-                  *info = tmp;
-                  return tmp.accessor;
-                }
-              else  if (tmp.supportLevel == TypeId::OBSOLETE)
-                {
-                  NS_FATAL_ERROR ("TraceSource '" << name
-                                  << "' is obsolete, with no fallback: "
-                                  << tmp.supportMsg);
-                }
-            }
-        }
-      nextTid = tid.GetParent ();
-    } while (nextTid != tid);
-  return 0;
+  const struct TypeId::TraceSourceInformation *tmp =
+    IidManager::Get ()->FindTraceSource (m_tid, name);
+  if (tmp == 0)
+    {
+      return 0;
+    }
+  if (tmp->supportLevel == TypeId::DEPRECATED)
+    {
+      std::cerr << "TraceSource '" << name << "' is deprecated: "
+                << tmp->supportMsg << std::endl;
+    }
+  else if (tmp->supportLevel == TypeId::OBSOLETE)
+    {
+      NS_FATAL_ERROR ("TraceSource '" << name
+                      << "' is obsolete, with no fallback: "
+                      << tmp->supportMsg);
+    }
+  *info = *tmp;
+  return tmp->accessor;
 }
 
 Ptr<const TraceSourceAccessor> 
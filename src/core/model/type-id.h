@@ -27,7 +27,12 @@
 #include "callback.h"
 #include "deprecated.h"
 #include "hash.h"
+#include "simple-ref-count.h"
+#include "object-arena.h"
+#include <new>
 #include <string>
+#include <type_traits>
+#include <vector>
 #include <stdint.h>
 
 /**
@@ -39,6 +44,7 @@
 namespace ns3 {
 
 class ObjectBase;
+class Object;
 
 /**
  * \ingroup object
@@ -108,6 +114,37 @@ public:
     /** Support message. */
     std::string supportMsg;
   };
+  /**
+   * The default value of an Attribute, as applied to the new objects
+   * by ObjectBase::ConstructSelf: the part of the AttributeInformation
+   * needed to construct an object, without the strings.
+   */
+  struct AttributeDefault {
+    /** AttributeFlags value. */
+    uint32_t flags;
+    /** Configured initial value. */
+    Ptr<const AttributeValue> initialValue;
+    /** Accessor object. */
+    Ptr<const AttributeAccessor> accessor;
+    /** Checker object. */
+    Ptr<const AttributeChecker> checker;
+    /**
+     * \c true if the initial value is valid for the checker, and can be
+     * set as is, rather than converted for each object.
+     */
+    bool valid;
+  };
+  /**
+   * The default values of the Attributes of a TypeId, without those of
+   * its parents, in the order of GetAttribute().  They are built once,
+   * and shared by the objects of the TypeId until an Attribute is added
+   * or an initial value changes.
+   */
+  struct AttributeDefaults : public SimpleRefCount<AttributeDefaults>
+  {
+    /** The defaults, by Attribute index. */
+    std::vector<struct AttributeDefault> attributes;
+  };
 
   /** Type of hash values. */
   typedef uint32_t hash_t;
@@ -164,6 +201,16 @@ public:
    * \returns The TypeId instance whose index is \c i.
    */
   static TypeId GetRegistered (uint32_t i);
+  /**
+   * Get the generation of the TypeIds, which changes each time a
+   * TypeId gains a parent, an attribute or a trace source.  The
+   * caches of the attributes or trace sources of the TypeIds compare
+   * it to the generation they were built at, to know if they are
+   * out of date.
+   *
+   * \returns The generation.
+   */
+  static uint32_t GetGeneration (void);
 
   /**
    * Constructor.
@@ -255,6 +302,17 @@ public:
    * \returns The information associated to attribute whose index is \p i.
    */
   struct TypeId::AttributeInformation GetAttribute(uint32_t i) const;
+  /**
+   * Get the default values of the Attributes, to construct an object.
+   *
+   * This is a faster alternative to GetAttribute() for
+   * ObjectBase::ConstructSelf, which does not copy the names and help
+   * strings of the Attributes.
+   *
+   * \returns The default values of the Attributes of this TypeId,
+   *          without those of its parents.
+   */
+  Ptr<const AttributeDefaults> GetAttributeDefaults (void) const;
   /**
    * Get the Attribute name by index.
    *
@@ -653,6 +711,12 @@ TypeId::AddConstructor (void)
 {
   struct Maker {
     static ObjectBase * Create () {
+      // Only the Objects, released by Object::DoDelete, may be
+      // carved out of the ObjectArena.
+      if (std::is_base_of<Object, T>::value)
+        {
+          return ::new (ObjectArena::Allocate (sizeof (T))) T ();
+        }
       ObjectBase * base = new T ();
       return base;
     }
@@ -831,6 +831,18 @@ RandomVariableStreamAttributeTestCase::DoRun (void)
   //
   ok = p->SetAttributeFailSafe ("TestRandom", StringValue ("ns3::ConstantRandomVariable[Constant=1.0]"));
   NS_TEST_ASSERT_MSG_EQ (ok, true, "Could not SetAttributeFailSafe() a ConstantRandomVariable");
+
+  //
+  // The initial value is a string: each object gets its own random variable.
+  //
+  Ptr<AttributeObjectTest> q = CreateObject<AttributeObjectTest> ();
+  Ptr<AttributeObjectTest> r = CreateObject<AttributeObjectTest> ();
+  PointerValue qRandom, rRandom;
+  q->GetAttribute ("TestRandom", qRandom);
+  r->GetAttribute ("TestRandom", rRandom);
+  NS_TEST_ASSERT_MSG_NE (qRandom.Get<RandomVariableStream> (), 0, "No initial random variable");
+  NS_TEST_ASSERT_MSG_NE (qRandom.Get<RandomVariableStream> (), rRandom.Get<RandomVariableStream> (),
+                         "Initial random variable shared between objects");
 }
 
 // ===========================================================================
@@ -18,6 +18,9 @@
 
 #include "ns3/test.h"
 #include "ns3/callback.h"
+#include "ns3/traced-callback.h"
+#include "ns3/ptr.h"
+#include "ns3/simple-ref-count.h"
 #include <stdint.h>
 
 using namespace ns3;
@@ -557,6 +560,131 @@ NullifyCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (target1.IsNull (), true, "Nullified Callback reports not IsNull()");
 }
 
+// ===========================================================================
+// Test the callbacks which are stored inline, without a pimpl
+// ===========================================================================
+class InlineCallbackTestCase : public TestCase
+{
+public:
+  InlineCallbackTestCase ();
+  virtual ~InlineCallbackTestCase () {}
+
+  void Target1 (int a) { m_test1 += a; }
+
+private:
+  virtual void DoRun (void);
+  virtual void DoSetup (void);
+
+  int m_test1;
+};
+
+static int gInlineCallbackTest1;
+
+void InlineCallbackTarget1 (int a, int b) { gInlineCallbackTest1 += a * b; }
+void InlineCallbackTarget2 (int &a, int b) { a += b; gInlineCallbackTest1 = a; }
+
+class InlineCallbackTestObject : public SimpleRefCount<InlineCallbackTestObject>
+{
+public:
+  void Target1 (int a) { gInlineCallbackTest1 = a; }
+};
+
+InlineCallbackTestCase::InlineCallbackTestCase ()
+  : TestCase ("Check the Callbacks stored inline")
+{
+}
+
+void
+InlineCallbackTestCase::DoSetup (void)
+{
+  m_test1 = 0;
+  gInlineCallbackTest1 = 0;
+}
+
+void
+InlineCallbackTestCase::DoRun (void)
+{
+  //
+  // Copies of an inline Callback call the same target, and compare
+  // equal to it, and to the pimpl built by GetImpl.
+  //
+  Callback<void, int> target1 = MakeCallback (&InlineCallbackTestCase::Target1, this);
+  Callback<void, int> copy1 = target1;
+  target1 (1);
+  copy1 (2);
+  NS_TEST_ASSERT_MSG_EQ (m_test1, 3, "Callback did not fire");
+  NS_TEST_ASSERT_MSG_EQ (copy1.IsEqual (target1), true, "Copies of a Callback are not equal");
+  NS_TEST_ASSERT_MSG_EQ (target1.GetImpl ()->IsEqual (copy1.GetImpl ()), true, "Callback impls are not equal");
+  InlineCallbackTestCase other;
+  Callback<void, int> target2 = MakeCallback (&InlineCallbackTestCase::Target1, &other);
+  NS_TEST_ASSERT_MSG_EQ (target2.IsEqual (target1), false, "Callbacks to different objects are equal");
+  typedef CallbackImpl<void, int, empty, empty, empty, empty, empty, empty, empty, empty> Impl;
+  Callback<void, int> fromImpl (DynamicCast<Impl> (target1.GetImpl ()));
+  NS_TEST_ASSERT_MSG_EQ (fromImpl.IsEqual (target1), true, "Callback not equal to its pimpl");
+  NS_TEST_ASSERT_MSG_EQ (target1.IsEqual (fromImpl), true, "Callback not equal to its pimpl");
+  NS_TEST_ASSERT_MSG_EQ (target2.IsEqual (fromImpl), false, "Callbacks to different objects are equal");
+
+  //
+  // Inline Callbacks can be assigned through a CallbackBase, as done
+  // by CallbackValue and TracedCallback.
+  //
+  CallbackValue value (target1);
+  Callback<void, int> assigned;
+  NS_TEST_ASSERT_MSG_EQ (value.GetAccessor (assigned), true, "Could not get Callback from CallbackValue");
+  assigned (4);
+  NS_TEST_ASSERT_MSG_EQ (m_test1, 7, "Assigned Callback did not fire");
+  NS_TEST_ASSERT_MSG_EQ (value.SerializeToString (0), value.SerializeToString (0),
+                         "Serialized inline Callback is not stable");
+  NS_TEST_ASSERT_MSG_EQ (value.SerializeToString (0), CallbackValue (copy1).SerializeToString (0),
+                         "Copies of a Callback serialize differently");
+  NS_TEST_ASSERT_MSG_NE (value.SerializeToString (0), CallbackValue (target2).SerializeToString (0),
+                         "Callbacks to different objects serialize the same");
+  Callback<void, double> wrongType;
+  NS_TEST_ASSERT_MSG_EQ (wrongType.CheckType (target1), false, "Callbacks of different types are compatible");
+  NS_TEST_ASSERT_MSG_EQ (assigned.CheckType (target2), true, "Callbacks of the same type are not compatible");
+
+  TracedCallback<int> traced;
+  traced.ConnectWithoutContext (target1);
+  traced.ConnectWithoutContext (target2);
+  traced (5);
+  NS_TEST_ASSERT_MSG_EQ (m_test1, 12, "TracedCallback did not fire");
+  traced.DisconnectWithoutContext (copy1);
+  traced (6);
+  NS_TEST_ASSERT_MSG_EQ (m_test1, 12, "TracedCallback not disconnected");
+
+  //
+  // Callbacks to smart pointers are not stored inline, but behave the same.
+  //
+  Ptr<InlineCallbackTestObject> object = Create<InlineCallbackTestObject> ();
+  Callback<void, int> target3 = MakeCallback (&InlineCallbackTestObject::Target1, object);
+  Callback<void, int> copy3 = target3;
+  copy3 (8);
+  NS_TEST_ASSERT_MSG_EQ (gInlineCallbackTest1, 8, "Callback did not fire");
+  NS_TEST_ASSERT_MSG_EQ (copy3.IsEqual (target3), true, "Copies of a Callback are not equal");
+  NS_TEST_ASSERT_MSG_EQ (target3.IsEqual (target1), false, "Callbacks to different targets are equal");
+
+  //
+  // A bound scalar argument is stored inline; a bound non-const
+  // reference is shared by all the copies of the Callback.
+  //
+  gInlineCallbackTest1 = 0;
+  Callback<void, int> bound1 = MakeBoundCallback (&InlineCallbackTarget1, 3);
+  Callback<void, int> boundCopy1 = bound1;
+  boundCopy1 (5);
+  NS_TEST_ASSERT_MSG_EQ (gInlineCallbackTest1, 15, "Bound Callback did not fire");
+  NS_TEST_ASSERT_MSG_EQ (boundCopy1.IsEqual (bound1), true, "Copies of a bound Callback are not equal");
+  NS_TEST_ASSERT_MSG_EQ (boundCopy1.GetIdentity (), bound1.GetIdentity (),
+                         "Copies of a bound Callback have different identities");
+  Callback<void, int> bound2 = MakeBoundCallback (&InlineCallbackTarget1, 4);
+  NS_TEST_ASSERT_MSG_EQ (bound2.IsEqual (bound1), false, "Callbacks with different bound arguments are equal");
+
+  Callback<void, int> bound3 = MakeBoundCallback (&InlineCallbackTarget2, 10);
+  Callback<void, int> boundCopy3 = bound3;
+  bound3 (1);
+  boundCopy3 (2);
+  NS_TEST_ASSERT_MSG_EQ (gInlineCallbackTest1, 13, "Bound reference not shared by the Callback copies");
+}
+
 // ===========================================================================
 // Make sure that various MakeCallback template functions compile and execute.
 // Doesn't check an results of the execution.
@@ -704,6 +832,7 @@ CallbackTestSuite::CallbackTestSuite ()
   AddTestCase (new MakeCallbackTestCase, TestCase::QUICK);
   AddTestCase (new MakeBoundCallbackTestCase, TestCase::QUICK);
   AddTestCase (new NullifyCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new InlineCallbackTestCase, TestCase::QUICK);
   AddTestCase (new MakeCallbackTemplatesTestCase, TestCase::QUICK);
 }
 
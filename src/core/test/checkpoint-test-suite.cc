@@ -0,0 +1,158 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/checkpoint.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/double.h"
+#include "ns3/test.h"
+
+#include <vector>
+
+using namespace ns3;
+
+class CheckpointTestCase : public TestCase
+{
+public:
+  CheckpointTestCase ();
+  virtual void DoRun (void);
+  /**
+   * Build the scenario: a random variable and the named event.
+   * \returns The random variable.
+   */
+  Ptr<UniformRandomVariable> Build (void);
+  /** Record the time of the named event. */
+  void Tick (void);
+  /** Record the time of an event scheduled before Checkpoint::Restore. */
+  void Early (void);
+  /**
+   * Draw values from the random variable.
+   * \param [in] urv The random variable.
+   * \param [out] values The values drawn.
+   */
+  void Draw (Ptr<UniformRandomVariable> urv, std::vector<double> *values);
+
+  std::vector<Time> m_ticks;  //!< The times of the named events.
+  Time m_early;               //!< The time of the early event.
+};
+
+CheckpointTestCase::CheckpointTestCase ()
+  : TestCase ("Check that a restored simulation continues as the saved one")
+{
+}
+
+Ptr<UniformRandomVariable>
+CheckpointTestCase::Build (void)
+{
+  Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable> ();
+  urv->SetStream (7);
+  Checkpoint::Register ("urv", urv);
+  Checkpoint::RegisterEvent ("tick", MakeCallback (&CheckpointTestCase::Tick, this));
+  return urv;
+}
+
+void
+CheckpointTestCase::Tick (void)
+{
+  m_ticks.push_back (Simulator::Now ());
+}
+
+void
+CheckpointTestCase::Early (void)
+{
+  m_early = Simulator::Now ();
+}
+
+void
+CheckpointTestCase::Draw (Ptr<UniformRandomVariable> urv, std::vector<double> *values)
+{
+  for (int i = 0; i < 3; i++)
+    {
+      values->push_back (urv->GetValue ());
+    }
+}
+
+void
+CheckpointTestCase::DoRun (void)
+{
+  std::string filename = CreateTempDirFilename ("checkpoint.ckpt");
+
+  // The simulation which saves the checkpoint at 3s
+  RngSeedManager::SetSeed (3);
+  RngSeedManager::SetRun (5);
+  Ptr<UniformRandomVariable> urv = Build ();
+  urv->SetAttribute ("Max", DoubleValue (5));
+  std::vector<double> drawn;
+  std::vector<double> expected;
+  Simulator::Schedule (Seconds (1), &CheckpointTestCase::Draw, this, urv, &drawn);
+  Checkpoint::Schedule (Seconds (5), "tick");
+  Checkpoint::Schedule (Seconds (10), "tick");
+  EventId cancelled = Checkpoint::Schedule (Seconds (6), "tick");
+  Simulator::Cancel (cancelled);
+  EventId removed = Checkpoint::Schedule (Seconds (7), "tick");
+  Simulator::Remove (removed);
+  Simulator::Schedule (Seconds (3), &Checkpoint::Save, filename);
+  Simulator::Schedule (Seconds (3), &CheckpointTestCase::Draw, this, urv, &expected);
+  Simulator::Stop (Seconds (4));
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_ticks.size (), 0, "Named event before the stop");
+
+  // The simulation which restores it
+  RngSeedManager::SetSeed (1);
+  RngSeedManager::SetRun (1);
+  urv = Build ();
+  NS_TEST_ASSERT_MSG_EQ (urv->GetMax (), 1, "Wrong default value");
+  Simulator::Schedule (Seconds (1), &CheckpointTestCase::Early, this);
+  EventId late = Simulator::Schedule (Seconds (2), &CheckpointTestCase::Early, this);
+  Checkpoint::Restore (filename);
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (3), "Clock not restored");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::IsExpired (late), false, "Pending event expired");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::GetDelayLeft (late), Seconds (2), "Wrong delay of a pending event");
+  Simulator::Remove (late);
+  NS_TEST_ASSERT_MSG_EQ (Simulator::IsExpired (late), true, "Pending event not removed");
+  NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetSeed (), 3, "Seed not restored");
+  NS_TEST_ASSERT_MSG_EQ (RngSeedManager::GetRun (), 5, "Run not restored");
+  NS_TEST_ASSERT_MSG_EQ (urv->GetMax (), 5, "Attribute not restored");
+  std::vector<double> restored;
+  Simulator::ScheduleNow (&CheckpointTestCase::Draw, this, urv, &restored);
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_ASSERT_MSG_EQ (restored.size (), expected.size (), "Wrong number of values");
+  for (std::size_t i = 0; i < expected.size (); i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (restored[i], expected[i], "Random stream not restored");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_early, Seconds (4), "Pending event not delayed");
+  NS_TEST_ASSERT_MSG_EQ (m_ticks.size (), 2, "Wrong number of named events");
+  NS_TEST_ASSERT_MSG_EQ (m_ticks[0], Seconds (5), "Wrong time of the first named event");
+  NS_TEST_ASSERT_MSG_EQ (m_ticks[1], Seconds (10), "Wrong time of the second named event");
+}
+
+
+static class CheckpointTestSuite : public TestSuite
+{
+public:
+  CheckpointTestSuite ()
+    : TestSuite ("checkpoint", UNIT)
+  {
+    AddTestCase (new CheckpointTestCase (), TestCase::QUICK);
+  }
+} g_checkpointTestSuite;
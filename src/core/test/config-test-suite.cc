@@ -159,6 +159,24 @@ DerivedConfigTestObject::GetTypeId (void)
   return tid;
 }
 
+class LateConfigTestObject : public ConfigTestObject
+{
+public:
+  static TypeId GetTypeId (void);
+  LateConfigTestObject (void) {}
+  virtual ~LateConfigTestObject (void) {}
+  TracedValue<int16_t> m_late;  // traced through a source added by the test
+};
+
+TypeId
+LateConfigTestObject::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("LateConfigTestObject")
+    .SetParent<ConfigTestObject> ()
+    ;
+  return tid;
+}
+
 class BaseConfigObject : public Object
 {
 public:
@@ -669,6 +687,142 @@ ObjectVectorTraceConfigTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_path, "/NodeA/NodeB/NodesB/1/Source", "Trace 1 did not provide expected context");
 }
 
+// ===========================================================================
+// Test for the ability to connect several paths in one traversal.
+// ===========================================================================
+class ConnectBatchConfigTestCase : public TestCase
+{
+public:
+  ConnectBatchConfigTestCase ();
+  virtual ~ConnectBatchConfigTestCase () {}
+
+  void TraceOne (std::string path, int16_t old, int16_t newValue) { m_one.push_back (path); }
+  void TraceTwo (std::string path, int16_t old, int16_t newValue) { m_two.push_back (path); }
+
+private:
+  virtual void DoRun (void);
+
+  std::vector<std::string> m_one;
+  std::vector<std::string> m_two;
+};
+
+ConnectBatchConfigTestCase::ConnectBatchConfigTestCase ()
+  : TestCase ("Check ability to connect several paths at once")
+{
+}
+
+void
+ConnectBatchConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<ConfigTestObject> a = CreateObject<ConfigTestObject> ();
+  root->SetNodeA (a);
+  Ptr<ConfigTestObject> b = CreateObject<ConfigTestObject> ();
+  a->SetNodeB (b);
+  std::vector<Ptr<ConfigTestObject> > nodesA;
+  std::vector<Ptr<ConfigTestObject> > nodesB;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      nodesA.push_back (CreateObject<ConfigTestObject> ());
+      b->AddNodeA (nodesA.back ());
+      nodesB.push_back (CreateObject<ConfigTestObject> ());
+      b->AddNodeB (nodesB.back ());
+    }
+  Names::Add ("/Names/BatchNode", nodesA[0]);
+
+  Callback<void, std::string, int16_t, int16_t> one =
+    MakeCallback (&ConnectBatchConfigTestCase::TraceOne, this);
+  Callback<void, std::string, int16_t, int16_t> two =
+    MakeCallback (&ConnectBatchConfigTestCase::TraceTwo, this);
+  std::vector<std::pair<std::string, CallbackBase> > connections;
+  connections.push_back (std::make_pair ("/NodeA/NodeB/NodesB/1/Source", one));
+  connections.push_back (std::make_pair ("/NodeA/NodeB/NodesB/3/Source", one));
+  connections.push_back (std::make_pair ("/NodeA/NodeB/NodesB/[2-3]/Source", two));
+  connections.push_back (std::make_pair ("/NodeA/NodeB/NodesA/*/Source", two));
+  connections.push_back (std::make_pair ("/NodeA/NodeB/NodesA/9/Source", one));
+  connections.push_back (std::make_pair ("/NodeA/NodeB/NodesA/1/Missing", one));
+  connections.push_back (std::make_pair ("/Names/BatchNode/Source", one));
+  Config::ConnectBatch (connections);
+
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      nodesA[i]->SetAttribute ("Source", IntegerValue (i));
+    }
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      nodesB[i]->SetAttribute ("Source", IntegerValue (i));
+    }
+
+  NS_TEST_ASSERT_MSG_EQ (m_one.size (), 3, "Wrong number of traces to the first callback");
+  NS_TEST_ASSERT_MSG_EQ (m_one[0], "/Names/BatchNode/Source", "Wrong context");
+  NS_TEST_ASSERT_MSG_EQ (m_one[1], "/NodeA/NodeB/NodesB/1/Source", "Wrong context");
+  NS_TEST_ASSERT_MSG_EQ (m_one[2], "/NodeA/NodeB/NodesB/3/Source", "Wrong context");
+  NS_TEST_ASSERT_MSG_EQ (m_two.size (), 6, "Wrong number of traces to the second callback");
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      std::ostringstream oss;
+      oss << "/NodeA/NodeB/NodesA/" << i << "/Source";
+      NS_TEST_ASSERT_MSG_EQ (m_two[i], oss.str (), "Wrong context");
+    }
+  NS_TEST_ASSERT_MSG_EQ (m_two[4], "/NodeA/NodeB/NodesB/2/Source", "Wrong context");
+  NS_TEST_ASSERT_MSG_EQ (m_two[5], "/NodeA/NodeB/NodesB/3/Source", "Wrong context");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
+// ===========================================================================
+// Test that the paths are resolved with the trace sources added to a
+// TypeId after the paths through it were first resolved.
+// ===========================================================================
+class LateTraceSourceConfigTestCase : public TestCase
+{
+public:
+  LateTraceSourceConfigTestCase ();
+  virtual ~LateTraceSourceConfigTestCase () {}
+
+  void Trace (std::string path, int16_t old, int16_t newValue) { m_traces.push_back (path); }
+
+private:
+  virtual void DoRun (void);
+
+  std::vector<std::string> m_traces;
+};
+
+LateTraceSourceConfigTestCase::LateTraceSourceConfigTestCase ()
+  : TestCase ("Check that Config sees the trace sources added to a TypeId after its first use")
+{
+}
+
+void
+LateTraceSourceConfigTestCase::DoRun (void)
+{
+  Ptr<ConfigTestObject> root = CreateObject<ConfigTestObject> ();
+  Config::RegisterRootNamespaceObject (root);
+  Ptr<LateConfigTestObject> a = CreateObject<LateConfigTestObject> ();
+  root->SetNodeA (a);
+  Callback<void, std::string, int16_t, int16_t> cb =
+    MakeCallback (&LateTraceSourceConfigTestCase::Trace, this);
+
+  Config::Connect ("/NodeA/Late", cb);
+  a->m_late = 1;
+  NS_TEST_ASSERT_MSG_EQ (m_traces.size (), 0, "Connected to a missing trace source");
+
+  TypeId tid = LateConfigTestObject::GetTypeId ();
+  if (tid.LookupTraceSourceByName ("Late") == 0)
+    {
+      tid.AddTraceSource ("Late", "",
+                          MakeTraceSourceAccessor (&LateConfigTestObject::m_late),
+                          "ns3::TracedValueCallback::Int16");
+    }
+  Config::Connect ("/NodeA/Late", cb);
+  a->m_late = 2;
+  NS_TEST_ASSERT_MSG_EQ (m_traces.size (), 1, "Trace source added to the TypeId not found");
+  NS_TEST_ASSERT_MSG_EQ (m_traces[0], "/NodeA/Late", "Wrong context");
+
+  Config::UnregisterRootNamespaceObject (root);
+}
+
 // ===========================================================================
 // Test for the ability to search attributes of parent classes
 // when Resolver searches for attributes in a derived class object.
@@ -737,6 +891,8 @@ ConfigTestSuite::ConfigTestSuite ()
   AddTestCase (new UnderRootNamespaceConfigTestCase, TestCase::QUICK);
   AddTestCase (new ObjectVectorConfigTestCase, TestCase::QUICK);
   AddTestCase (new SearchAttributesOfParentObjectsTestCase, TestCase::QUICK);
+  AddTestCase (new ConnectBatchConfigTestCase, TestCase::QUICK);
+  AddTestCase (new LateTraceSourceConfigTestCase, TestCase::QUICK);
 }
 
 static ConfigTestSuite configTestSuite;
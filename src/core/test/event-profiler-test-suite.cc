@@ -0,0 +1,181 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/event-profiler.h"
+#include "ns3/default-simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/make-event.h"
+#include "ns3/boolean.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <sstream>
+
+using namespace ns3;
+
+/** A function to make events of. */
+static void
+EventProfilerFunction (void)
+{
+}
+
+class EventProfilerTestCase : public TestCase
+{
+public:
+  EventProfilerTestCase ();
+  virtual void DoRun (void);
+  void Handler (uint32_t value);
+};
+
+EventProfilerTestCase::EventProfilerTestCase ()
+  : TestCase ("Check the names, the sorting and the folded output of the profile")
+{
+}
+
+void
+EventProfilerTestCase::Handler (uint32_t value)
+{
+}
+
+void
+EventProfilerTestCase::DoRun (void)
+{
+  EventImpl *member = MakeEvent (&EventProfilerTestCase::Handler, this, 1);
+  EventImpl *function = MakeEvent (&EventProfilerFunction);
+  std::string memberName = EventProfiler::GetTypeName (typeid (*member));
+  std::string functionName = EventProfiler::GetTypeName (typeid (*function));
+  NS_TEST_ASSERT_MSG_EQ (memberName, "void (EventProfilerTestCase::*)(unsigned int)",
+                         "Wrong name for a member event");
+  NS_TEST_ASSERT_MSG_EQ (functionName, "void (*)()", "Wrong name for a function event");
+
+  EventProfiler profiler;
+  profiler.Record (typeid (*member), 1, 100);
+  profiler.Record (typeid (*member), 1, 300);
+  profiler.Record (typeid (*member), 2, 1000);
+  profiler.Record (typeid (*function), 2, 5000);
+  profiler.Record (typeid (*function), Simulator::NO_CONTEXT, 2000);
+  member->Unref ();
+  function->Unref ();
+
+  std::vector<EventProfiler::Entry> byType = profiler.GetByType ();
+  NS_TEST_ASSERT_MSG_EQ (byType.size (), 2, "Wrong number of event types");
+  NS_TEST_ASSERT_MSG_EQ (byType[0].name, functionName, "Wrong sort order");
+  NS_TEST_ASSERT_MSG_EQ (byType[0].count, 2, "Wrong count");
+  NS_TEST_ASSERT_MSG_EQ (byType[0].totalNs, 7000, "Wrong total");
+  NS_TEST_ASSERT_MSG_EQ (byType[0].maxNs, 5000, "Wrong max");
+  NS_TEST_ASSERT_MSG_EQ (byType[1].name, memberName, "Wrong sort order");
+  NS_TEST_ASSERT_MSG_EQ (byType[1].count, 3, "Wrong count");
+  NS_TEST_ASSERT_MSG_EQ (byType[1].totalNs, 1400, "Wrong total");
+  NS_TEST_ASSERT_MSG_EQ (byType[1].maxNs, 1000, "Wrong max");
+
+  std::vector<EventProfiler::Entry> byContext = profiler.GetByContext ();
+  NS_TEST_ASSERT_MSG_EQ (byContext.size (), 3, "Wrong number of contexts");
+  NS_TEST_ASSERT_MSG_EQ (byContext[0].name, "node 2", "Wrong sort order");
+  NS_TEST_ASSERT_MSG_EQ (byContext[0].totalNs, 6000, "Wrong total");
+  NS_TEST_ASSERT_MSG_EQ (byContext[1].name, "no context", "Wrong sort order");
+  NS_TEST_ASSERT_MSG_EQ (byContext[2].name, "node 1", "Wrong sort order");
+  NS_TEST_ASSERT_MSG_EQ (byContext[2].count, 2, "Wrong count");
+
+  std::ostringstream folded;
+  profiler.WriteFolded (folded);
+  std::ostringstream expected;
+  expected << "no context;" << functionName << " 2" << std::endl
+           << "node 1;" << memberName << " 0" << std::endl
+           << "node 2;" << functionName << " 5" << std::endl
+           << "node 2;" << memberName << " 1" << std::endl;
+  NS_TEST_ASSERT_MSG_EQ (folded.str (), expected.str (), "Wrong folded stacks");
+
+  profiler.Clear ();
+  NS_TEST_ASSERT_MSG_EQ (profiler.GetByType ().size (), 0, "Profile not cleared");
+}
+
+
+class EventProfilerSimulatorTestCase : public TestCase
+{
+public:
+  EventProfilerSimulatorTestCase ();
+  virtual void DoRun (void);
+  void Handler (uint32_t value);
+  uint32_t m_count;
+};
+
+EventProfilerSimulatorTestCase::EventProfilerSimulatorTestCase ()
+  : TestCase ("Check that DefaultSimulatorImpl profiles its events")
+{
+}
+
+void
+EventProfilerSimulatorTestCase::Handler (uint32_t value)
+{
+  m_count++;
+}
+
+void
+EventProfilerSimulatorTestCase::DoRun (void)
+{
+  std::string report = CreateTempDirFilename ("profile.txt");
+  std::string folded = CreateTempDirFilename ("profile.folded");
+
+  Simulator::Destroy ();
+  Ptr<DefaultSimulatorImpl> impl = CreateObject<DefaultSimulatorImpl> ();
+  impl->SetAttribute ("Profile", BooleanValue (true));
+  impl->SetAttribute ("ProfileReport", StringValue (report));
+  impl->SetAttribute ("ProfileFolded", StringValue (folded));
+  Simulator::SetImplementation (impl);
+
+  m_count = 0;
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Simulator::ScheduleWithContext (i % 2, MicroSeconds (i),
+                                      &EventProfilerSimulatorTestCase::Handler, this, i);
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+  NS_TEST_ASSERT_MSG_EQ (m_count, 10, "Events not run");
+
+  std::ifstream reportFile (report.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (reportFile.is_open (), true, "No profile report");
+  std::string line;
+  std::getline (reportFile, line);
+  NS_TEST_ASSERT_MSG_EQ (line.find ("Event profile: 10 events"), 0, "Wrong profile report");
+
+  std::ifstream foldedFile (folded.c_str ());
+  NS_TEST_ASSERT_MSG_EQ (foldedFile.is_open (), true, "No folded profile");
+  uint32_t lines = 0;
+  while (std::getline (foldedFile, line))
+    {
+      NS_TEST_ASSERT_MSG_EQ ((line.find ("node 0;void (EventProfilerSimulatorTestCase::*)(unsigned int) ") == 0
+                              || line.find ("node 1;void (EventProfilerSimulatorTestCase::*)(unsigned int) ") == 0),
+                             true, "Wrong folded stack " << line);
+      lines++;
+    }
+  NS_TEST_ASSERT_MSG_EQ (lines, 2, "Wrong number of folded stacks");
+}
+
+
+static class EventProfilerTestSuite : public TestSuite
+{
+public:
+  EventProfilerTestSuite ()
+    : TestSuite ("event-profiler", UNIT)
+  {
+    AddTestCase (new EventProfilerTestCase (), TestCase::QUICK);
+    AddTestCase (new EventProfilerSimulatorTestCase (), TestCase::QUICK);
+  }
+} g_eventProfilerTestSuite;
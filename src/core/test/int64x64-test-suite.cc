@@ -483,6 +483,15 @@ Int64x64ArithmeticTestCase::DoRun (void)
   // Check special values
   Check (51,  int64x64_t (0, 0x159fa87f8aeaad21ULL) * 10,
 	           int64x64_t (0, 0xd83c94fb6d2ac34aULL));
+
+  // Division with a numerator less than one, with an integer
+  // divisor, and in the general case:
+  const int64x64_t quarter = int64x64_t (0, 0x4000000000000000ULL);  // 0.25
+  Check (52,   frac  /   thre,    quarter );
+  Check (53, (-frac) /   thre,   -quarter );
+  Check (54,   thref /   two,     int64x64_t (1, 0xe000000000000000ULL) );  // 1.875
+  Check (55,   thref / (-frac),   int64x64_t (-5) );
+  Check (56,   int64x64_t (0, 1) / int64x64_t (0, 2),  int64x64_t (0, 0x8000000000000000ULL) );
   
 }
 
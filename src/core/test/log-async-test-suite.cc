@@ -0,0 +1,177 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// The LOG_LOGIC and LOG_FUNCTION statements of this file are compiled out.
+#define NS_LOG_STATIC_LEVEL ns3::LOG_LEVEL_INFO
+
+#include "ns3/log.h"
+#include "ns3/system-thread.h"
+#include "ns3/test.h"
+
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE ("LogAsyncTestSuite");
+
+class LogAsyncThreadsTestCase : public TestCase
+{
+public:
+  LogAsyncThreadsTestCase ();
+  virtual void DoRun (void);
+  static void Writer (uint32_t thread);
+  /** Number of writing threads. */
+  static const uint32_t THREADS = 4;
+  /** Number of lines written by each thread, enough to fill the buffers. */
+  static const uint32_t LINES = 20000;
+};
+
+LogAsyncThreadsTestCase::LogAsyncThreadsTestCase ()
+  : TestCase ("Check that the lines written by several threads are all written, in order")
+{
+}
+
+void
+LogAsyncThreadsTestCase::Writer (uint32_t thread)
+{
+  for (uint32_t i = 0; i < LINES; i++)
+    {
+      std::clog << "thread " << thread << " line " << i << std::endl;
+    }
+}
+
+void
+LogAsyncThreadsTestCase::DoRun (void)
+{
+  std::ostringstream oss;
+  std::streambuf *buf = std::clog.rdbuf (oss.rdbuf ());
+  LogSetAsync (true);
+  NS_TEST_ASSERT_MSG_EQ (LogIsAsync (), true, "Not asynchronous");
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t t = 0; t < THREADS; t++)
+    {
+      threads.push_back (Create<SystemThread> (MakeBoundCallback (&LogAsyncThreadsTestCase::Writer, t)));
+      threads.back ()->Start ();
+    }
+  for (uint32_t t = 0; t < THREADS; t++)
+    {
+      threads[t]->Join ();
+    }
+  LogFlush ();
+  std::string flushed = oss.str ();
+  LogSetAsync (false);
+  std::clog.rdbuf (buf);
+  NS_TEST_ASSERT_MSG_EQ (LogIsAsync (), false, "Still asynchronous");
+  NS_TEST_ASSERT_MSG_EQ (oss.str (), flushed, "Lines written after LogFlush");
+
+  std::vector<uint32_t> next (THREADS, 0);
+  std::istringstream iss (oss.str ());
+  std::string line;
+  while (std::getline (iss, line))
+    {
+      std::istringstream fields (line);
+      std::string threadWord, lineWord;
+      uint32_t thread = THREADS, i = 0;
+      fields >> threadWord >> thread >> lineWord >> i;
+      NS_TEST_ASSERT_MSG_EQ ((threadWord == "thread" && lineWord == "line" && thread < THREADS),
+                             true, "Corrupted line \"" << line << "\"");
+      NS_TEST_ASSERT_MSG_EQ (i, next[thread], "Wrong line order for thread " << thread);
+      next[thread]++;
+    }
+  for (uint32_t t = 0; t < THREADS; t++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (next[t], LINES, "Lines lost for thread " << t);
+    }
+}
+
+
+class LogAsyncMacrosTestCase : public TestCase
+{
+public:
+  LogAsyncMacrosTestCase ();
+  virtual void DoRun (void);
+};
+
+LogAsyncMacrosTestCase::LogAsyncMacrosTestCase ()
+  : TestCase ("Check the NS_LOG macros with asynchronous output")
+{
+}
+
+void
+LogAsyncMacrosTestCase::DoRun (void)
+{
+  std::ostringstream oss;
+  std::streambuf *buf = std::clog.rdbuf (oss.rdbuf ());
+  LogSetAsync (true);
+  LogComponentEnable ("LogAsyncTestSuite", (enum LogLevel)(LOG_LEVEL_INFO | LOG_PREFIX_FUNC));
+  NS_LOG_INFO ("info " << 1);
+  NS_LOG_LOGIC ("logic " << 2);
+  NS_LOG_UNCOND ("uncond " << 3);
+  LogFlush ();
+  std::string flushed = oss.str ();
+  LogComponentDisable ("LogAsyncTestSuite", LOG_LEVEL_ALL);
+  LogSetAsync (false);
+  std::clog.rdbuf (buf);
+  NS_TEST_ASSERT_MSG_EQ (flushed, "LogAsyncTestSuite:DoRun(): info 1\nuncond 3\n",
+                         "Wrong log output");
+}
+
+
+class LogStaticLevelTestCase : public TestCase
+{
+public:
+  LogStaticLevelTestCase ();
+  virtual void DoRun (void);
+};
+
+LogStaticLevelTestCase::LogStaticLevelTestCase ()
+  : TestCase ("Check that NS_LOG_STATIC_LEVEL removes the other log levels")
+{
+}
+
+void
+LogStaticLevelTestCase::DoRun (void)
+{
+  std::ostringstream oss;
+  std::streambuf *buf = std::clog.rdbuf (oss.rdbuf ());
+  LogComponentEnable ("LogAsyncTestSuite", (enum LogLevel)(LOG_LEVEL_ALL | LOG_PREFIX_FUNC));
+  NS_LOG_FUNCTION (this);
+  NS_LOG_INFO ("info " << 1);
+  NS_LOG_LOGIC ("logic " << 2);
+  LogComponentDisable ("LogAsyncTestSuite", (enum LogLevel)(LOG_LEVEL_ALL | LOG_PREFIX_FUNC));
+  std::clog.rdbuf (buf);
+#ifdef NS3_LOG_ENABLE
+  NS_TEST_ASSERT_MSG_EQ (oss.str (), "LogAsyncTestSuite:DoRun(): info 1\n", "Wrong log output");
+#endif
+}
+
+
+static class LogAsyncTestSuite : public TestSuite
+{
+public:
+  LogAsyncTestSuite ()
+    : TestSuite ("log-async", UNIT)
+  {
+    AddTestCase (new LogAsyncThreadsTestCase (), TestCase::QUICK);
+    AddTestCase (new LogAsyncMacrosTestCase (), TestCase::QUICK);
+    AddTestCase (new LogStaticLevelTestCase (), TestCase::QUICK);
+  }
+} g_logAsyncTestSuite;
@@ -929,6 +929,71 @@ AlternateFindTestCase::DoRun (void)
                          "Unexpectedly able to GetObject<TestObject> on an AlternateTestObject");
 }
 
+// ===========================================================================
+// Test the cache of the paths of Names::Find, when the names change.
+// ===========================================================================
+class FindCacheTestCase : public TestCase
+{
+public:
+  FindCacheTestCase ();
+  virtual ~FindCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+FindCacheTestCase::FindCacheTestCase ()
+  : TestCase ("Check that Names::Find does not return stale paths")
+{
+}
+
+FindCacheTestCase::~FindCacheTestCase ()
+{
+}
+
+void
+FindCacheTestCase::DoTeardown (void)
+{
+  Names::Clear ();
+}
+
+void
+FindCacheTestCase::DoRun (void)
+{
+  Ptr<TestObject> client = CreateObject<TestObject> ();
+  Names::Add ("Client", client);
+  Ptr<TestObject> device = CreateObject<TestObject> ();
+  Names::Add ("Client/eth0", device);
+
+  Ptr<TestObject> found;
+  found = Names::Find<TestObject> ("/Names/Client/eth0");
+  NS_TEST_ASSERT_MSG_EQ (found, device, "Could not find a previously named Object");
+  found = Names::Find<TestObject> ("Client/eth0");
+  NS_TEST_ASSERT_MSG_EQ (found, device, "Could not find a previously named Object again");
+
+  Names::Rename ("Client", "Server");
+  found = Names::Find<TestObject> ("/Names/Client/eth0");
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Found an Object under its parent's old name");
+  found = Names::Find<TestObject> ("/Names/Server/eth0");
+  NS_TEST_ASSERT_MSG_EQ (found, device, "Could not find an Object under its parent's new name");
+
+  Names::Rename ("Server/eth0", "eth1");
+  found = Names::Find<TestObject> ("Server/eth0");
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Found an Object under its old name");
+  found = Names::Find<TestObject> ("Server/eth1");
+  NS_TEST_ASSERT_MSG_EQ (found, device, "Could not find an Object under its new name");
+
+  Names::Clear ();
+  found = Names::Find<TestObject> ("Server/eth1");
+  NS_TEST_ASSERT_MSG_EQ (found, 0, "Found an Object after Names::Clear");
+  Ptr<TestObject> other = CreateObject<TestObject> ();
+  Names::Add ("Server", other);
+  Names::Add ("Server/eth1", client);
+  found = Names::Find<TestObject> ("Server/eth1");
+  NS_TEST_ASSERT_MSG_EQ (found, client, "Found the Object named before Names::Clear");
+}
+
 class NamesTestSuite : public TestSuite
 {
 public:
@@ -952,6 +1017,7 @@ NamesTestSuite::NamesTestSuite ()
   AddTestCase (new FullyQualifiedFindTestCase, TestCase::QUICK);
   AddTestCase (new RelativeFindTestCase, TestCase::QUICK);
   AddTestCase (new AlternateFindTestCase, TestCase::QUICK);
+  AddTestCase (new FindCacheTestCase, TestCase::QUICK);
 }
 
 static NamesTestSuite namesTestSuite;
@@ -22,6 +22,7 @@
 #include "ns3/object.h"
 #include "ns3/object-factory.h"
 #include "ns3/assert.h"
+#include <vector>
 
 namespace {
 
@@ -431,6 +432,159 @@ ObjectFactoryTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_NE (a->GetObject<DerivedA> (), 0, "Unexpectedly able to work around C++ type system");
 }
 
+// ===========================================================================
+// Test case to make sure that the cached GetObject lookups follow the
+// aggregation.
+// ===========================================================================
+class GetObjectCacheTestCase : public TestCase
+{
+public:
+  GetObjectCacheTestCase ();
+  virtual ~GetObjectCacheTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+GetObjectCacheTestCase::GetObjectCacheTestCase ()
+  : TestCase ("Check that GetObject finds the Objects aggregated after a lookup")
+{
+}
+
+GetObjectCacheTestCase::~GetObjectCacheTestCase ()
+{
+}
+
+void
+GetObjectCacheTestCase::DoRun (void)
+{
+  Ptr<BaseA> baseA = CreateObject<BaseA> ();
+  Ptr<DerivedB> derivedB = CreateObject<DerivedB> ();
+
+  //
+  // Look up the types before the aggregation, twice, so that the
+  // results are cached.
+  //
+  for (int i = 0; i < 2; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseA> (), baseA, "Cannot GetObject (through baseA) for BaseA Object");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), 0, "Unexpectedly found a BaseB through baseA");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseB> (), derivedB, "Cannot GetObject (through derivedB) for BaseB Object");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), 0, "Unexpectedly found a BaseA through derivedB");
+    }
+
+  baseA->AggregateObject (derivedB);
+
+  //
+  // Both sides of the aggregation must now find both Objects, by
+  // their own type and by their parent type.
+  //
+  for (int i = 0; i < 2; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<BaseB> (), derivedB, "Cannot GetObject (through baseA) for BaseB Object");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<DerivedB> (), derivedB, "Cannot GetObject (through baseA) for DerivedB Object");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<BaseA> (), baseA, "Cannot GetObject (through derivedB) for BaseA Object");
+      NS_TEST_ASSERT_MSG_EQ (derivedB->GetObject<DerivedA> (), 0, "Unexpectedly found a DerivedA through derivedB");
+      NS_TEST_ASSERT_MSG_EQ (baseA->GetObject<Object> (DerivedB::GetTypeId ()), derivedB,
+                             "Cannot GetObject (through baseA) for the DerivedB TypeId");
+    }
+}
+
+// ===========================================================================
+// Test case to make sure that the arena mode allocates the Objects
+// contiguously, and recycles them.
+// ===========================================================================
+class ObjectArenaTestCase : public TestCase
+{
+public:
+  ObjectArenaTestCase ();
+  virtual ~ObjectArenaTestCase ();
+
+private:
+  virtual void DoRun (void);
+};
+
+ObjectArenaTestCase::ObjectArenaTestCase ()
+  : TestCase ("Check the ObjectFactory arena mode")
+{
+}
+
+ObjectArenaTestCase::~ObjectArenaTestCase ()
+{
+}
+
+void
+ObjectArenaTestCase::DoRun (void)
+{
+  const uint32_t n = 100;
+  ObjectFactory factory;
+  factory.SetTypeId (DerivedA::GetTypeId ());
+
+  ObjectFactory::SetArenaEnabled (true);
+  NS_TEST_ASSERT_MSG_EQ (ObjectFactory::IsArenaEnabled (), true, "Arena mode not on");
+  ObjectArena::Stats before = ObjectArena::GetStats ();
+  std::vector<Ptr<DerivedA> > objects;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      objects.push_back (i % 2 ? factory.Create<DerivedA> () : CreateObject<DerivedA> ());
+    }
+  ObjectFactory::SetArenaEnabled (false);
+  NS_TEST_ASSERT_MSG_EQ (ObjectFactory::IsArenaEnabled (), false, "Arena mode still on");
+  ObjectArena::Stats after = ObjectArena::GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (after.allocations - before.allocations, n, "Wrong number of allocations");
+  NS_TEST_ASSERT_MSG_EQ (after.arena - before.arena + after.recycled - before.recycled, n,
+                         "Objects not allocated from the arena");
+
+  //
+  // Apart from a change of chunk, each Object follows the previous one.
+  //
+  const char *first = reinterpret_cast<const char *> (PeekPointer (objects[0]));
+  const char *second = reinterpret_cast<const char *> (PeekPointer (objects[1]));
+  std::ptrdiff_t stride = second - first;
+  NS_TEST_ASSERT_MSG_GT (stride, 0, "Objects not in increasing order");
+  NS_TEST_ASSERT_MSG_LT (static_cast<std::size_t> (stride), sizeof (DerivedA) + 32, "Objects not contiguous");
+  uint32_t contiguous = 0;
+  for (uint32_t i = 1; i < n; i++)
+    {
+      const char *previous = reinterpret_cast<const char *> (PeekPointer (objects[i - 1]));
+      const char *current = reinterpret_cast<const char *> (PeekPointer (objects[i]));
+      if (current - previous == stride)
+        {
+          contiguous++;
+        }
+    }
+  NS_TEST_ASSERT_MSG_GT_OR_EQ (contiguous, n - 2, "Objects not contiguous");
+
+  //
+  // Out of arena mode, the Objects come from the system allocator.
+  //
+  for (uint32_t i = 0; i < n; i++)
+    {
+      NS_TEST_ASSERT_MSG_EQ (ObjectArena::Contains (PeekPointer (objects[i])), true,
+                             "Object not in the arena");
+    }
+  before = ObjectArena::GetStats ();
+  Ptr<DerivedA> system = CreateObject<DerivedA> ();
+  after = ObjectArena::GetStats ();
+  NS_TEST_ASSERT_MSG_EQ (ObjectArena::Contains (PeekPointer (system)), false,
+                         "Object allocated from the arena out of arena mode");
+  NS_TEST_ASSERT_MSG_EQ (after.allocations - before.allocations, 0,
+                         "Object allocated from the arena out of arena mode");
+
+  //
+  // Deleted Objects are recycled in arena mode.
+  //
+  DerivedA *last = PeekPointer (objects.back ());
+  objects.pop_back ();
+  ObjectFactory::SetArenaEnabled (true);
+  before = ObjectArena::GetStats ();
+  Ptr<DerivedA> recycled = CreateObject<DerivedA> ();
+  after = ObjectArena::GetStats ();
+  ObjectFactory::SetArenaEnabled (false);
+  NS_TEST_ASSERT_MSG_EQ (PeekPointer (recycled), last, "Object not recycled");
+  NS_TEST_ASSERT_MSG_EQ (after.recycled - before.recycled, 1, "Object not recycled");
+}
+
 // ===========================================================================
 // The Test Suite that glues the Test Cases together.
 // ===========================================================================
@@ -446,6 +600,8 @@ ObjectTestSuite::ObjectTestSuite ()
   AddTestCase (new CreateObjectTestCase, TestCase::QUICK);
   AddTestCase (new AggregateObjectTestCase, TestCase::QUICK);
   AddTestCase (new ObjectFactoryTestCase, TestCase::QUICK);
+  AddTestCase (new GetObjectCacheTestCase, TestCase::QUICK);
+  AddTestCase (new ObjectArenaTestCase, TestCase::QUICK);
 }
 
 static ObjectTestSuite objectTestSuite;
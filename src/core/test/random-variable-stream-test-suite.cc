@@ -28,6 +28,8 @@
 #include <ctime>
 #include <fstream>
 #include <cmath>
+#include <sstream>
+#include <vector>
 
 #include "ns3/boolean.h"
 #include "ns3/double.h"
@@ -35,6 +37,7 @@
 #include "ns3/integer.h"
 #include "ns3/test.h"
 #include "ns3/log.h"
+#include "ns3/object-factory.h"
 #include "ns3/rng-seed-manager.h"
 #include "ns3/random-variable-stream.h"
 
@@ -2886,6 +2889,87 @@ RandomVariableStreamEmpiricalAntitheticTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ_TOL (valueMean, expectedMean, TOLERANCE, "Wrong mean value."); 
 }
 
+// ===========================================================================
+// Test case for the bulk GetValues of the random variable stream generators
+// ===========================================================================
+class RandomVariableStreamGetValuesTestCase : public TestCase
+{
+public:
+  RandomVariableStreamGetValuesTestCase ();
+  virtual ~RandomVariableStreamGetValuesTestCase ();
+
+private:
+  virtual void DoRun (void);
+  /**
+   * Check that GetValues returns the same values as GetValue.
+   * \param [in] name The name of the random variable stream type.
+   * \param [in] attributes The attributes, as name=value pairs.
+   */
+  void Check (std::string name, std::string attributes);
+};
+
+RandomVariableStreamGetValuesTestCase::RandomVariableStreamGetValuesTestCase ()
+  : TestCase ("GetValues of Random Variable Stream Generators")
+{
+}
+
+RandomVariableStreamGetValuesTestCase::~RandomVariableStreamGetValuesTestCase ()
+{
+}
+
+void
+RandomVariableStreamGetValuesTestCase::Check (std::string name, std::string attributes)
+{
+  ObjectFactory factory;
+  factory.SetTypeId (name);
+  std::istringstream iss (attributes);
+  std::string attribute;
+  while (iss >> attribute)
+    {
+      std::string::size_type eq = attribute.find ('=');
+      factory.Set (attribute.substr (0, eq), StringValue (attribute.substr (eq + 1)));
+    }
+  // Two streams with the same stream number give the same uniform variables.
+  factory.Set ("Stream", IntegerValue (7));
+  Ptr<RandomVariableStream> scalar = factory.Create<RandomVariableStream> ();
+  Ptr<RandomVariableStream> bulk = factory.Create<RandomVariableStream> ();
+
+  // Mix batches of various sizes with single values.
+  const std::size_t sizes[] = { 1, 2, 3, 0, 64, 127, 128, 129, 1000, 5 };
+  std::vector<double> values;
+  for (std::size_t k = 0; k < sizeof (sizes) / sizeof (sizes[0]); k++)
+    {
+      values.assign (sizes[k] + 1, 0.0);
+      bulk->GetValues (&values[0], sizes[k]);
+      for (std::size_t i = 0; i < sizes[k]; i++)
+        {
+          NS_TEST_ASSERT_MSG_EQ (values[i], scalar->GetValue (),
+                                 name << " " << attributes << ": batch " << k << " value " << i << " differs");
+        }
+      NS_TEST_ASSERT_MSG_EQ (bulk->GetValue (), scalar->GetValue (),
+                             name << " " << attributes << ": value after batch " << k << " differs");
+    }
+}
+
+void
+RandomVariableStreamGetValuesTestCase::DoRun (void)
+{
+  SetTestSuiteSeed ();
+
+  Check ("ns3::UniformRandomVariable", "Min=2 Max=5");
+  Check ("ns3::UniformRandomVariable", "Min=2 Max=5 Antithetic=true");
+  Check ("ns3::ConstantRandomVariable", "Constant=3");
+  Check ("ns3::ExponentialRandomVariable", "Mean=2");
+  Check ("ns3::ExponentialRandomVariable", "Mean=2 Bound=3 Antithetic=true");
+  Check ("ns3::ParetoRandomVariable", "Mean=2 Shape=3");
+  Check ("ns3::ParetoRandomVariable", "Mean=2 Shape=3 Bound=2.5 Antithetic=true");
+  Check ("ns3::WeibullRandomVariable", "Scale=2 Shape=3");
+  Check ("ns3::WeibullRandomVariable", "Scale=2 Shape=3 Bound=2 Antithetic=true");
+  Check ("ns3::NormalRandomVariable", "Mean=2 Variance=3");
+  Check ("ns3::NormalRandomVariable", "Mean=2 Variance=3 Bound=1 Antithetic=true");
+  Check ("ns3::LogNormalRandomVariable", "Mu=1 Sigma=2");
+}
+
 class RandomVariableStreamTestSuite : public TestSuite
 {
 public:
@@ -2930,6 +3014,7 @@ RandomVariableStreamTestSuite::RandomVariableStreamTestSuite ()
   AddTestCase (new RandomVariableStreamDeterministicTestCase, TestCase::QUICK);
   AddTestCase (new RandomVariableStreamEmpiricalTestCase, TestCase::QUICK);
   AddTestCase (new RandomVariableStreamEmpiricalAntitheticTestCase, TestCase::QUICK);
+  AddTestCase (new RandomVariableStreamGetValuesTestCase, TestCase::QUICK);
 }
 
 static RandomVariableStreamTestSuite randomVariableStreamTestSuite;
@@ -0,0 +1,120 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/replication-runner.h"
+#include "ns3/simulator.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/rng-seed-manager.h"
+#include "ns3/test.h"
+
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+using namespace ns3;
+
+class ReplicationRunnerTestCase : public TestCase
+{
+public:
+  ReplicationRunnerTestCase ();
+  virtual void DoRun (void);
+  /** The replication: run the simulation, and print its results. */
+  void Replication (void);
+  /** The event of the simulation: draw a value. */
+  void Draw (void);
+
+  Ptr<UniformRandomVariable> m_urv;  //!< The random variable of the setup.
+  double m_value;                    //!< The value drawn.
+};
+
+ReplicationRunnerTestCase::ReplicationRunnerTestCase ()
+  : TestCase ("Check that the replications use their own run, and that their output is collected")
+{
+}
+
+void
+ReplicationRunnerTestCase::Draw (void)
+{
+  m_value = m_urv->GetValue ();
+}
+
+void
+ReplicationRunnerTestCase::Replication (void)
+{
+  Simulator::Run ();
+  std::cout << RngSeedManager::GetRun () << " " << Simulator::Now ().GetSeconds ()
+            << " " << m_value << std::endl;
+}
+
+void
+ReplicationRunnerTestCase::DoRun (void)
+{
+  const uint32_t replications = 5;
+  uint64_t run = RngSeedManager::GetRun ();
+  RngSeedManager::SetRun (11);
+  m_urv = CreateObject<UniformRandomVariable> ();
+  m_urv->SetStream (3);
+  m_value = 0;
+  Simulator::Schedule (Seconds (2), &ReplicationRunnerTestCase::Draw, this);
+
+  std::string filename = CreateTempDirFilename ("replications.txt");
+  ReplicationRunner runner;
+  runner.SetReplications (replications);
+  runner.SetJobs (2);
+  runner.SetOutput (filename);
+  uint32_t failed = runner.Run (MakeCallback (&ReplicationRunnerTestCase::Replication, this));
+  NS_TEST_ASSERT_MSG_EQ (failed, 0, "Failed replications");
+  NS_TEST_ASSERT_MSG_EQ (Simulator::Now (), Seconds (0), "Simulation run by the setup process");
+  NS_TEST_ASSERT_MSG_EQ (m_value, 0, "Event run by the setup process");
+  Simulator::Destroy ();
+
+  std::ifstream is (filename.c_str ());
+  for (uint32_t i = 0; i < replications; i++)
+    {
+      uint64_t r = 0;
+      double now = 0;
+      double value = 0;
+      is >> r >> now >> value;
+      NS_TEST_ASSERT_MSG_EQ (r, 11 + i, "Wrong run number, or order");
+      NS_TEST_ASSERT_MSG_EQ (now, 2, "Simulation not run");
+      RngSeedManager::SetRun (r);
+      Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable> ();
+      urv->SetStream (3);
+      std::ostringstream expected;
+      expected << urv->GetValue ();
+      std::ostringstream actual;
+      actual << value;
+      NS_TEST_ASSERT_MSG_EQ (actual.str (), expected.str (), "Stream not restarted for run " << r);
+    }
+  std::string rest;
+  is >> rest;
+  NS_TEST_ASSERT_MSG_EQ (rest, "", "Extra output");
+  m_urv = 0;
+  RngSeedManager::SetRun (run);
+}
+
+
+static class ReplicationRunnerTestSuite : public TestSuite
+{
+public:
+  ReplicationRunnerTestSuite ()
+    : TestSuite ("replication-runner", UNIT)
+  {
+    AddTestCase (new ReplicationRunnerTestCase (), TestCase::QUICK);
+  }
+} g_replicationRunnerTestSuite;
@@ -23,6 +23,14 @@
 #include "ns3/heap-scheduler.h"
 #include "ns3/map-scheduler.h"
 #include "ns3/calendar-scheduler.h"
+#include "ns3/quad-heap-scheduler.h"
+#include "ns3/timing-wheel-scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/event-allocator.h"
+#include "ns3/config.h"
+#include "ns3/boolean.h"
+#include <algorithm>
+#include <vector>
 
 using namespace ns3;
 
@@ -168,6 +176,263 @@ SimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_destroy, true, "Event should have run");
 }
 
+class SimulatorOrderTestCase : public TestCase
+{
+public:
+  SimulatorOrderTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  void Event (uint32_t i);
+
+  std::vector<EventId> m_ids;
+  std::vector<bool> m_removed;
+  uint64_t m_last;
+  uint32_t m_count;
+  bool m_ordered;
+  bool m_removedRan;
+  ObjectFactory m_schedulerFactory;
+};
+
+SimulatorOrderTestCase::SimulatorOrderTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check that events run in time order after removals with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+void
+SimulatorOrderTestCase::Event (uint32_t i)
+{
+  uint64_t now = Simulator::Now ().GetTimeStep ();
+  if (now < m_last)
+    {
+      m_ordered = false;
+    }
+  if (m_removed[i])
+    {
+      m_removedRan = true;
+    }
+  m_last = now;
+  m_count++;
+}
+
+void
+SimulatorOrderTestCase::DoRun (void)
+{
+  const uint32_t n = 2000;
+  m_last = 0;
+  m_count = 0;
+  m_ordered = true;
+  m_removedRan = false;
+  m_ids.clear ();
+  m_removed.assign (n, false);
+
+  Simulator::SetScheduler (m_schedulerFactory);
+
+  // a simple deterministic LCG gives us a scrambled, repeatable
+  // set of timestamps, with plenty of duplicates.
+  uint32_t state = 12345;
+  for (uint32_t i = 0; i < n; i++)
+    {
+      state = state * 1103515245 + 12345;
+      Time at = NanoSeconds ((state >> 16) % 500);
+      m_ids.push_back (Simulator::Schedule (at, &SimulatorOrderTestCase::Event, this, i));
+    }
+  uint32_t removed = 0;
+  for (uint32_t i = 0; i < n; i += 3)
+    {
+      Simulator::Remove (m_ids[i]);
+      m_removed[i] = true;
+      removed++;
+    }
+  Simulator::Run ();
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_ordered, true, "Events did not run in time order");
+  NS_TEST_EXPECT_MSG_EQ (m_removedRan, false, "A removed event did run");
+  NS_TEST_EXPECT_MSG_EQ (m_count, n - removed, "Unexpected number of events run");
+}
+
+/**
+ * Drive a scheduler directly, with timestamps spread over many orders
+ * of magnitude, and check it against a sorted reference list.
+ */
+class SchedulerConsistencyTestCase : public TestCase
+{
+public:
+  SchedulerConsistencyTestCase (ObjectFactory schedulerFactory);
+  virtual void DoRun (void);
+  static bool EventLess (const Scheduler::Event &a, const Scheduler::Event &b);
+  /**
+   * Find the earliest event of a list.
+   * \param [in] events The non-empty list.
+   * \returns The earliest event.
+   */
+  static std::vector<Scheduler::Event>::iterator First (std::vector<Scheduler::Event> &events);
+
+  /** An event which does nothing. */
+  class NullEvent : public EventImpl
+  {
+  protected:
+    virtual void Notify (void)
+    {
+    }
+  };
+
+  ObjectFactory m_schedulerFactory;
+};
+
+SchedulerConsistencyTestCase::SchedulerConsistencyTestCase (ObjectFactory schedulerFactory)
+  : TestCase ("Check Insert, Remove and RemoveNext against a reference with " +
+              schedulerFactory.GetTypeId ().GetName ()),
+    m_schedulerFactory (schedulerFactory)
+{
+}
+
+bool
+SchedulerConsistencyTestCase::EventLess (const Scheduler::Event &a, const Scheduler::Event &b)
+{
+  return a.key < b.key;
+}
+
+std::vector<Scheduler::Event>::iterator
+SchedulerConsistencyTestCase::First (std::vector<Scheduler::Event> &events)
+{
+  std::vector<Scheduler::Event>::iterator first = events.begin ();
+  for (std::vector<Scheduler::Event>::iterator i = events.begin (); i != events.end (); ++i)
+    {
+      if (i->key < first->key)
+        {
+          first = i;
+        }
+    }
+  return first;
+}
+
+void
+SchedulerConsistencyTestCase::DoRun (void)
+{
+  Ptr<Scheduler> scheduler = m_schedulerFactory.Create<Scheduler> ();
+  std::vector<Scheduler::Event> reference;
+  std::vector<Ptr<EventImpl> > impls;
+  uint64_t now = 0;
+  uint32_t uid = 4;
+  uint32_t state = 54321;
+  bool ok = true;
+  for (uint32_t round = 0; round < 3000 && ok; round++)
+    {
+      state = state * 1103515245 + 12345;
+      uint32_t action = (state >> 16) % 8;
+      if (action < 4 || reference.empty ())
+        {
+          // insert, with a delay from 0 to about 2^40
+          state = state * 1103515245 + 12345;
+          uint32_t bits = (state >> 16) % 41;
+          state = state * 1103515245 + 12345;
+          uint64_t delay = ((uint64_t)(state >> 8) << 16) % ((uint64_t)1 << bits);
+          if (action == 0)
+            {
+              delay = 0;
+            }
+          Ptr<EventImpl> impl = Create<NullEvent> ();
+          impls.push_back (impl);
+          Scheduler::Event ev;
+          ev.impl = PeekPointer (impl);
+          ev.key.m_ts = now + delay;
+          ev.key.m_uid = uid++;
+          ev.key.m_context = 0;
+          scheduler->Insert (ev);
+          reference.push_back (ev);
+        }
+      else if (action < 6)
+        {
+          // remove an arbitrary event
+          state = state * 1103515245 + 12345;
+          uint32_t i = (state >> 16) % reference.size ();
+          scheduler->Remove (reference[i]);
+          reference.erase (reference.begin () + i);
+        }
+      else
+        {
+          std::vector<Scheduler::Event>::iterator first = First (reference);
+          Scheduler::Event peek = scheduler->PeekNext ();
+          Scheduler::Event next = scheduler->RemoveNext ();
+          ok = (peek.key.m_uid == first->key.m_uid && next.key.m_uid == first->key.m_uid);
+          now = first->key.m_ts;
+          reference.erase (first);
+        }
+      // Peek after every change, so that a stale cached next event
+      // would show up.
+      if (ok && !reference.empty ())
+        {
+          ok = (scheduler->PeekNext ().key.m_uid == First (reference)->key.m_uid);
+        }
+    }
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "RemoveNext did not return the earliest event");
+  std::sort (reference.begin (), reference.end (), &SchedulerConsistencyTestCase::EventLess);
+  for (uint32_t i = 0; i < reference.size () && ok; i++)
+    {
+      Scheduler::Event next = scheduler->RemoveNext ();
+      ok = (next.key.m_uid == reference[i].key.m_uid);
+    }
+  NS_TEST_EXPECT_MSG_EQ (ok, true, "Events drained out of order");
+  NS_TEST_EXPECT_MSG_EQ (scheduler->IsEmpty (), true, "Scheduler should be empty");
+}
+
+class SimulatorEventPoolTestCase : public TestCase
+{
+public:
+  SimulatorEventPoolTestCase ();
+  virtual void DoRun (void);
+  void Event (uint32_t i);
+
+  uint32_t m_count;
+};
+
+SimulatorEventPoolTestCase::SimulatorEventPoolTestCase ()
+  : TestCase ("Check that event objects are recycled by the EventAllocator")
+{
+}
+
+void
+SimulatorEventPoolTestCase::Event (uint32_t i)
+{
+  m_count++;
+  if (i > 0)
+    {
+      Simulator::Schedule (NanoSeconds (1), &SimulatorEventPoolTestCase::Event, this, i - 1);
+    }
+}
+
+void
+SimulatorEventPoolTestCase::DoRun (void)
+{
+  m_count = 0;
+  EventAllocator::ResetStats ();
+  Simulator::Schedule (NanoSeconds (1), &SimulatorEventPoolTestCase::Event, this, 999);
+  Simulator::Run ();
+  EventAllocator::Stats stats = Simulator::GetEventAllocatorStats ();
+  NS_TEST_EXPECT_MSG_EQ (m_count, 1000, "Unexpected number of events run");
+  NS_TEST_EXPECT_MSG_GT_OR_EQ (stats.allocations, 1000, "Events not allocated through the EventAllocator");
+  // a chain of events only ever needs a couple of live events, so
+  // almost all of them should come from the free list.
+  NS_TEST_EXPECT_MSG_GT (stats.hits, 990, "Events are not recycled");
+  NS_TEST_EXPECT_MSG_EQ (stats.hits + stats.misses, stats.allocations, "Inconsistent statistics");
+
+  // with the pool disabled, nothing is recycled.
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventPool", BooleanValue (false));
+  Simulator::Destroy ();
+  m_count = 0;
+  Simulator::Schedule (NanoSeconds (1), &SimulatorEventPoolTestCase::Event, this, 99);
+  EventAllocator::ResetStats ();
+  Simulator::Run ();
+  stats = Simulator::GetEventAllocatorStats ();
+  NS_TEST_EXPECT_MSG_EQ (m_count, 100, "Unexpected number of events run");
+  NS_TEST_EXPECT_MSG_EQ (stats.hits, 0, "Events recycled with the pool disabled");
+  NS_TEST_EXPECT_MSG_EQ (stats.pooled, 0, "Events pooled with the pool disabled");
+  Config::SetDefault ("ns3::DefaultSimulatorImpl::EventPool", BooleanValue (true));
+  Simulator::Destroy ();
+}
+
 class SimulatorTemplateTestCase : public TestCase
 {
 public:
@@ -469,11 +734,35 @@ public:
     factory.SetTypeId (ListScheduler::GetTypeId ());
 
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (MapScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (HeapScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
     factory.SetTypeId (CalendarScheduler::GetTypeId ());
     AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (QuadHeapScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    factory.SetTypeId (TimingWheelScheduler::GetTypeId ());
+    AddTestCase (new SimulatorEventsTestCase (factory), TestCase::QUICK);
+    AddTestCase (new SimulatorOrderTestCase (factory), TestCase::QUICK);
+    const char *schedulers[] = {
+      "ns3::ListScheduler",
+      "ns3::MapScheduler",
+      "ns3::HeapScheduler",
+      "ns3::CalendarScheduler",
+      "ns3::QuadHeapScheduler",
+      "ns3::TimingWheelScheduler"
+    };
+    for (uint32_t i = 0; i < sizeof (schedulers) / sizeof (schedulers[0]); i++)
+      {
+        factory.SetTypeId (schedulers[i]);
+        AddTestCase (new SchedulerConsistencyTestCase (factory), TestCase::QUICK);
+      }
+    AddTestCase (new SimulatorEventPoolTestCase (), TestCase::QUICK);
   }
 } g_simulatorTestSuite;
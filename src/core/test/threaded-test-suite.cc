@@ -29,7 +29,9 @@
 
 #include <ctime>
 #include <list>
+#include <string>
 #include <utility>
+#include <vector>
 
 using namespace ns3;
 
@@ -225,6 +227,118 @@ ThreadedSimulatorEventsTestCase::DoRun (void)
   NS_TEST_EXPECT_MSG_EQ (m_a, m_d, "Bad scheduling");
 }
 
+/**
+ * Check that events injected concurrently by many threads are all run,
+ * and that the events of each thread run in the order they were scheduled.
+ */
+class ThreadedSimulatorInjectionTestCase : public TestCase
+{
+public:
+  ThreadedSimulatorInjectionTestCase (const std::string &simulatorType, unsigned int threads);
+  void Received (unsigned int threadno, uint32_t seq);
+  void Check (void);
+  static void InjectingThread (std::pair<ThreadedSimulatorInjectionTestCase *, unsigned int> context);
+  static const uint32_t EVENTS = 5000;
+  unsigned int m_threads;
+  std::string m_simulatorType;
+  std::vector<uint32_t> m_next;
+  uint64_t m_received;
+  bool m_inOrder;
+
+private:
+  virtual void DoSetup (void);
+  virtual void DoRun (void);
+  virtual void DoTeardown (void);
+};
+
+ThreadedSimulatorInjectionTestCase::ThreadedSimulatorInjectionTestCase (const std::string &simulatorType, unsigned int threads)
+  : TestCase ("Check concurrent ScheduleWithContext from " +
+              std::to_string (threads) + " threads in " + simulatorType),
+    m_threads (threads),
+    m_simulatorType (simulatorType)
+{
+}
+
+void
+ThreadedSimulatorInjectionTestCase::InjectingThread (std::pair<ThreadedSimulatorInjectionTestCase *, unsigned int> context)
+{
+  ThreadedSimulatorInjectionTestCase *me = context.first;
+  unsigned int threadno = context.second;
+  for (uint32_t seq = 0; seq < EVENTS; ++seq)
+    {
+      Simulator::ScheduleWithContext (threadno, Seconds (0),
+                                      &ThreadedSimulatorInjectionTestCase::Received,
+                                      me, threadno, seq);
+    }
+}
+
+void
+ThreadedSimulatorInjectionTestCase::Received (unsigned int threadno, uint32_t seq)
+{
+  if (seq != m_next[threadno] || Simulator::GetContext () != threadno)
+    {
+      m_inOrder = false;
+    }
+  m_next[threadno] = seq + 1;
+  ++m_received;
+}
+
+void
+ThreadedSimulatorInjectionTestCase::Check (void)
+{
+  if (m_received == static_cast<uint64_t> (m_threads) * EVENTS)
+    {
+      Simulator::Stop ();
+    }
+  else
+    {
+      Simulator::Schedule (MilliSeconds (1), &ThreadedSimulatorInjectionTestCase::Check, this);
+    }
+}
+
+void
+ThreadedSimulatorInjectionTestCase::DoSetup (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue (m_simulatorType));
+  m_next.assign (m_threads, 0);
+  m_received = 0;
+  m_inOrder = true;
+}
+
+void
+ThreadedSimulatorInjectionTestCase::DoTeardown (void)
+{
+  Config::SetGlobal ("SimulatorImplementationType", StringValue ("ns3::DefaultSimulatorImpl"));
+}
+
+void
+ThreadedSimulatorInjectionTestCase::DoRun (void)
+{
+  std::list<Ptr<SystemThread> > threads;
+  for (unsigned int i = 0; i < m_threads; ++i)
+    {
+      threads.push_back (
+        Create<SystemThread> (MakeBoundCallback (
+            &ThreadedSimulatorInjectionTestCase::InjectingThread,
+                std::pair<ThreadedSimulatorInjectionTestCase *, unsigned int> (this, i) )) );
+    }
+  Simulator::Schedule (MilliSeconds (1), &ThreadedSimulatorInjectionTestCase::Check, this);
+  Simulator::Schedule (Seconds (10), &Simulator::Stop);
+  for (std::list<Ptr<SystemThread> >::iterator it = threads.begin (); it != threads.end (); ++it)
+    {
+      (*it)->Start ();
+    }
+  Simulator::Run ();
+  for (std::list<Ptr<SystemThread> >::iterator it = threads.begin (); it != threads.end (); ++it)
+    {
+      (*it)->Join ();
+    }
+  Simulator::Destroy ();
+
+  NS_TEST_EXPECT_MSG_EQ (m_received, static_cast<uint64_t> (m_threads) * EVENTS, "Lost events");
+  NS_TEST_EXPECT_MSG_EQ (m_inOrder, true, "Events of a thread ran out of order");
+}
+
 class ThreadedSimulatorTestSuite : public TestSuite
 {
 public:
@@ -241,7 +355,9 @@ public:
       "ns3::ListScheduler",
       "ns3::HeapScheduler",
       "ns3::MapScheduler",
-      "ns3::CalendarScheduler"
+      "ns3::CalendarScheduler",
+      "ns3::QuadHeapScheduler",
+      "ns3::TimingWheelScheduler"
     };
     unsigned int threadcounts[] = {
       0,
@@ -262,5 +378,8 @@ public:
               }
           }
       }
+#ifdef HAVE_RT
+    AddTestCase (new ThreadedSimulatorInjectionTestCase ("ns3::RealtimeSimulatorImpl", 8), TestCase::QUICK);
+#endif
   }
 } g_threadedSimulatorTestSuite;
@@ -108,6 +108,100 @@ BasicTracedCallbackTestCase::DoRun (void)
   NS_TEST_ASSERT_MSG_EQ (m_two, true, "Callback CbTwo not called");
 }
 
+class ChainTracedCallbackTestCase : public TestCase
+{
+public:
+  ChainTracedCallbackTestCase ();
+  virtual ~ChainTracedCallbackTestCase () {}
+
+private:
+  virtual void DoRun (void);
+
+  void CbOne (int a);
+  void CbTwo (int a);
+  void CbThree (int a);
+  void CbConnect (int a);
+
+  TracedCallback<int> m_trace;
+  std::string m_calls;
+};
+
+ChainTracedCallbackTestCase::ChainTracedCallbackTestCase ()
+  : TestCase ("Check the order of a chain of TracedCallback sinks")
+{
+}
+
+void
+ChainTracedCallbackTestCase::CbOne (int a)
+{
+  m_calls += "1";
+}
+
+void
+ChainTracedCallbackTestCase::CbTwo (int a)
+{
+  m_calls += "2";
+}
+
+void
+ChainTracedCallbackTestCase::CbThree (int a)
+{
+  m_calls += "3";
+}
+
+void
+ChainTracedCallbackTestCase::CbConnect (int a)
+{
+  m_calls += "c";
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbThree, this));
+}
+
+void
+ChainTracedCallbackTestCase::DoRun (void)
+{
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "New TracedCallback is not empty");
+  m_trace (0);
+
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbThree, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), false, "TracedCallback with sinks is empty");
+  m_calls = "";
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "123", "Sinks not called in order");
+
+  // Remove the first sink: the others keep their order.
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbOne, this));
+  m_calls = "";
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "23", "Sinks not called in order");
+
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbOne, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbThree, this));
+  m_calls = "";
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "21", "Sinks not called in order");
+
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbTwo, this));
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbOne, this));
+  NS_TEST_ASSERT_MSG_EQ (m_trace.IsEmpty (), true, "TracedCallback not empty");
+  m_calls = "";
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "", "Disconnected sinks called");
+
+  // A sink may connect another sink, which is called on the same trace.
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbOne, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbTwo, this));
+  m_trace.ConnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbConnect, this));
+  m_calls = "";
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "12c3", "Sink connected during a trace not called");
+  m_trace.DisconnectWithoutContext (MakeCallback (&ChainTracedCallbackTestCase::CbConnect, this));
+  m_calls = "";
+  m_trace (0);
+  NS_TEST_ASSERT_MSG_EQ (m_calls, "123", "Sinks not called in order");
+}
+
 class TracedCallbackTestSuite : public TestSuite
 {
 public:
@@ -118,6 +212,7 @@ TracedCallbackTestSuite::TracedCallbackTestSuite ()
   : TestSuite ("traced-callback", UNIT)
 {
   AddTestCase (new BasicTracedCallbackTestCase, TestCase::QUICK);
+  AddTestCase (new ChainTracedCallbackTestCase, TestCase::QUICK);
 }
 
 static TracedCallbackTestSuite tracedCallbackTestSuite;
@@ -325,6 +325,130 @@ DeprecatedAttributeTestCase::DoRun (void)
        << endl;
 }
 
+
+
+//----------------------------
+//
+// Attribute and TraceSource index test
+
+class IndexBase : public Object
+{
+public:
+  IndexBase () : m_base (0) { };
+  virtual ~IndexBase () { };
+
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("IndexBase")
+      .SetParent<Object> ()
+      .AddAttribute ("base",
+                     "the base Attribute",
+                     IntegerValue (1),
+                     MakeIntegerAccessor (&IndexBase::m_base),
+                     MakeIntegerChecker<int> ())
+      .AddTraceSource ("baseTrace",
+                       "the base TraceSource",
+                       MakeTraceSourceAccessor (&IndexBase::m_baseTrace),
+                       "ns3::TracedValueCallback::Double");
+    return tid;
+  }
+
+  int m_base;
+  TracedValue<double> m_baseTrace;
+};
+
+class IndexDerived : public IndexBase
+{
+public:
+  IndexDerived () : m_derived (0) { };
+  virtual ~IndexDerived () { };
+
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId ("IndexDerived")
+      .SetParent<IndexBase> ()
+      .AddAttribute ("derived",
+                     "the derived Attribute",
+                     IntegerValue (2),
+                     MakeIntegerAccessor (&IndexDerived::m_derived),
+                     MakeIntegerChecker<int> ())
+      .AddTraceSource ("derivedTrace",
+                       "the derived TraceSource",
+                       MakeTraceSourceAccessor (&IndexDerived::m_derivedTrace),
+                       "ns3::TracedValueCallback::Double");
+    return tid;
+  }
+
+  int m_derived;
+  TracedValue<double> m_derivedTrace;
+};
+
+
+class LookupIndexTestCase : public TestCase
+{
+public:
+  LookupIndexTestCase ();
+  virtual ~LookupIndexTestCase ();
+private:
+  virtual void DoRun (void);
+
+};
+
+LookupIndexTestCase::LookupIndexTestCase ()
+  : TestCase ("Check Attribute and TraceSource lookups through the parents")
+{
+}
+
+LookupIndexTestCase::~LookupIndexTestCase ()
+{
+}
+
+void
+LookupIndexTestCase::DoRun (void)
+{
+  TypeId tid = IndexDerived::GetTypeId ();
+
+  struct TypeId::AttributeInformation ainfo;
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("derived", &ainfo), true,
+                         "lookup own attribute");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "derived", "wrong own attribute");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("base", &ainfo), true,
+                         "lookup inherited attribute");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "base", "wrong inherited attribute");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("none", &ainfo), false,
+                         "lookup missing attribute");
+  NS_TEST_ASSERT_MSG_EQ (IndexBase::GetTypeId ().LookupAttributeByName ("derived", &ainfo),
+                         false, "lookup child attribute in parent");
+
+  struct TypeId::TraceSourceInformation tinfo;
+  NS_TEST_ASSERT_MSG_NE (tid.LookupTraceSourceByName ("derivedTrace", &tinfo), 0,
+                         "lookup own trace source");
+  NS_TEST_ASSERT_MSG_EQ (tinfo.name, "derivedTrace", "wrong own trace source");
+  NS_TEST_ASSERT_MSG_NE (tid.LookupTraceSourceByName ("baseTrace", &tinfo), 0,
+                         "lookup inherited trace source");
+  NS_TEST_ASSERT_MSG_EQ (tinfo.name, "baseTrace", "wrong inherited trace source");
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupTraceSourceByName ("none"), 0,
+                         "lookup missing trace source");
+
+  // Attributes registered after a lookup must be found.
+  TypeId base = IndexBase::GetTypeId ();
+  if (!base.LookupAttributeByName ("late", &ainfo))
+    {
+      base.AddAttribute ("late",
+                         "an Attribute added after the first lookup",
+                         IntegerValue (3),
+                         MakeIntegerAccessor (&IndexBase::m_base),
+                         MakeIntegerChecker<int> ());
+    }
+  NS_TEST_ASSERT_MSG_EQ (tid.LookupAttributeByName ("late", &ainfo), true,
+                         "lookup attribute added late");
+  NS_TEST_ASSERT_MSG_EQ (ainfo.name, "late", "wrong attribute added late");
+
+  Ptr<IndexDerived> object = CreateObject<IndexDerived> ();
+  NS_TEST_ASSERT_MSG_EQ (object->m_base, 3, "wrong initial value of late attribute");
+  NS_TEST_ASSERT_MSG_EQ (object->m_derived, 2, "wrong initial value of own attribute");
+}
+
   
 //----------------------------
 //
@@ -383,7 +507,29 @@ LookupTimeTestCase::DoRun (void)
   }
   stop = clock ();
   Report ("hash", stop - start);
-  
+
+  // Look up each attribute of each type, including the inherited ones.
+  uint32_t attributes = 0;
+  start = clock ();
+  for (uint32_t j = 0; j < REPETITIONS / 100; ++j)
+    {
+      for (uint32_t i = 0; i < nids; ++i)
+        {
+          TypeId tid = TypeId::GetRegistered (i);
+          struct TypeId::AttributeInformation info;
+          for (uint32_t k = 0; k < tid.GetAttributeN (); ++k)
+            {
+              tid.LookupAttributeByName (tid.GetAttribute (k).name, &info);
+              attributes++;
+            }
+        }
+    }
+  stop = clock ();
+  cout << suite << "Lookup time: by attribute name: "
+       << "ticks: " << stop - start
+       << "\tper: " << 1E6 * double(stop - start) / (attributes * double(CLOCKS_PER_SEC))
+       << " microsec/lookup"
+       << endl;
 }
 
 void
@@ -437,6 +583,7 @@ TypeIdTestSuite::TypeIdTestSuite ()
   AddTestCase (new UniqueTypeIdTestCase, QUICK);
   AddTestCase (new CollisionTestCase, QUICK);
   AddTestCase (new DeprecatedAttributeTestCase, QUICK);
+  AddTestCase (new LookupIndexTestCase, QUICK);
 }
 
 static TypeIdTestSuite g_TypeIdTestSuite;  
@@ -0,0 +1,886 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "multithreaded-simulator-impl.h"
+#include "ns3/simulator.h"
+#include "ns3/system-thread.h"
+#include "ns3/uinteger.h"
+#include "ns3/channel.h"
+#include "ns3/channel-list.h"
+#include "ns3/net-device.h"
+#include "ns3/node.h"
+#include "ns3/node-list.h"
+#include "ns3/assert.h"
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <thread>
+
+namespace ns3 {
+
+// Note:  Logging in this file is largely avoided due to the
+// number of calls that are made to these functions and the possibility
+// of causing recursions leading to stack overflow
+NS_LOG_COMPONENT_DEFINE ("MultithreadedSimulatorImpl");
+
+NS_OBJECT_ENSURE_REGISTERED (MultithreadedSimulatorImpl);
+
+/** Timestamp used for "no event" and "no limit". */
+static const uint64_t INFINITE_TS = std::numeric_limits<uint64_t>::max ();
+
+thread_local MultithreadedSimulatorImpl::Partition *MultithreadedSimulatorImpl::g_partition = 0;
+
+TypeId
+MultithreadedSimulatorImpl::GetTypeId (void)
+{
+  static TypeId tid = TypeId ("ns3::MultithreadedSimulatorImpl")
+    .SetParent<SimulatorImpl> ()
+    .SetGroupName ("Mpi")
+    .AddConstructor<MultithreadedSimulatorImpl> ()
+    .AddAttribute ("ThreadCount",
+                   "The maximum number of threads (and partitions) to use.  "
+                   "Zero means one thread per hardware thread.",
+                   UintegerValue (0),
+                   MakeUintegerAccessor (&MultithreadedSimulatorImpl::m_threads),
+                   MakeUintegerChecker<uint32_t> ())
+  ;
+  return tid;
+}
+
+MultithreadedSimulatorImpl::Barrier::Barrier ()
+  : m_n (1),
+    m_arrived (0),
+    m_generation (0)
+{
+}
+
+void
+MultithreadedSimulatorImpl::Barrier::SetCount (uint32_t n)
+{
+  m_n = n;
+  m_arrived.store (0);
+}
+
+void
+MultithreadedSimulatorImpl::Barrier::Wait (void)
+{
+  uint32_t generation = m_generation.load (std::memory_order_acquire);
+  if (m_arrived.fetch_add (1, std::memory_order_acq_rel) + 1 == m_n)
+    {
+      m_arrived.store (0, std::memory_order_relaxed);
+      m_generation.fetch_add (1, std::memory_order_acq_rel);
+      return;
+    }
+  while (m_generation.load (std::memory_order_acquire) == generation)
+    {
+      std::this_thread::yield ();
+    }
+}
+
+MultithreadedSimulatorImpl::MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+  m_threads = 0;
+  m_lookAhead = INFINITE_TS;
+  m_stopTs.store (INFINITE_TS);
+  m_running = false;
+  m_stopped = false;
+  m_partitionCount = 0;
+  m_finalTs = 0;
+  m_windows.store (0);
+  m_foreignSeq.store (0);
+  // uids are allocated from 4.
+  // uid 0 is "invalid" events
+  // uid 1 is "now" events
+  // uid 2 is "destroy" events
+  m_uid = 4;
+  m_currentUid = 0;
+  m_currentTs = 0;
+  m_currentContext = Simulator::NO_CONTEXT;
+}
+
+MultithreadedSimulatorImpl::~MultithreadedSimulatorImpl ()
+{
+  NS_LOG_FUNCTION (this);
+}
+
+void
+MultithreadedSimulatorImpl::DoDispose (void)
+{
+  NS_LOG_FUNCTION (this);
+  CollectEvents ();
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          next.impl->Unref ();
+        }
+    }
+  m_events = 0;
+  SimulatorImpl::DoDispose ();
+}
+
+void
+MultithreadedSimulatorImpl::Destroy ()
+{
+  NS_LOG_FUNCTION (this);
+  while (!m_destroyEvents.empty ())
+    {
+      Ptr<EventImpl> ev = m_destroyEvents.front ().PeekEventImpl ();
+      m_destroyEvents.pop_front ();
+      NS_LOG_LOGIC ("handle destroy " << ev);
+      if (!ev->IsCancelled ())
+        {
+          ev->Invoke ();
+        }
+    }
+}
+
+void
+MultithreadedSimulatorImpl::SetScheduler (ObjectFactory schedulerFactory)
+{
+  NS_LOG_FUNCTION (this << schedulerFactory);
+  NS_ABORT_MSG_IF (m_running, "Cannot change the scheduler while the simulation is running");
+  m_schedulerFactory = schedulerFactory;
+  Ptr<Scheduler> scheduler = schedulerFactory.Create<Scheduler> ();
+
+  if (m_events != 0)
+    {
+      while (!m_events->IsEmpty ())
+        {
+          Scheduler::Event next = m_events->RemoveNext ();
+          scheduler->Insert (next);
+        }
+    }
+  m_events = scheduler;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetSystemId (void) const
+{
+  return 0;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionIndex (uint32_t context) const
+{
+  if (context < m_nodePartition.size ())
+    {
+      return m_nodePartition[context];
+    }
+  return 0;
+}
+
+void
+MultithreadedSimulatorImpl::BuildPartitions (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ASSERT (m_partitions.empty ());
+
+  // Group the nodes which must run in the same partition, with a
+  // union-find over the node ids.
+  uint32_t nNodes = NodeList::GetNNodes ();
+  std::vector<uint32_t> parent (nNodes);
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      parent[i] = i;
+    }
+  struct Link
+  {
+    uint32_t a;
+    uint32_t b;
+    uint64_t delay;
+  };
+  std::vector<Link> links;
+
+  for (ChannelList::Iterator it = ChannelList::Begin (); it != ChannelList::End (); ++it)
+    {
+      Ptr<Channel> channel = *it;
+      std::vector<uint32_t> nodes;
+      bool pointToPoint = true;
+      for (uint32_t i = 0; i < channel->GetNDevices (); i++)
+        {
+          Ptr<NetDevice> device = channel->GetDevice (i);
+          if (device == 0 || device->GetNode () == 0)
+            {
+              continue;
+            }
+          pointToPoint = pointToPoint && device->IsPointToPoint ();
+          nodes.push_back (device->GetNode ()->GetId ());
+        }
+      TimeValue delay;
+      if (nodes.size () == 2 && pointToPoint &&
+          channel->GetAttributeFailSafe ("Delay", delay) &&
+          delay.Get ().IsStrictlyPositive ())
+        {
+          Link link;
+          link.a = nodes[0];
+          link.b = nodes[1];
+          link.delay = delay.Get ().GetTimeStep ();
+          links.push_back (link);
+          continue;
+        }
+      for (uint32_t i = 1; i < nodes.size (); i++)
+        {
+          uint32_t a = nodes[0];
+          uint32_t b = nodes[i];
+          while (parent[a] != a)
+            {
+              a = parent[a];
+            }
+          while (parent[b] != b)
+            {
+              b = parent[b];
+            }
+          parent[std::max (a, b)] = std::min (a, b);
+        }
+    }
+
+  // Collect the groups, and spread them over the partitions, largest
+  // first, each to the least loaded partition.
+  std::map<uint32_t, std::vector<uint32_t> > groups;
+  for (uint32_t i = 0; i < nNodes; i++)
+    {
+      uint32_t root = i;
+      while (parent[root] != root)
+        {
+          root = parent[root];
+        }
+      groups[root].push_back (i);
+    }
+  std::vector<std::pair<uint32_t, uint32_t> > order;
+  for (std::map<uint32_t, std::vector<uint32_t> >::const_iterator i = groups.begin ();
+       i != groups.end (); ++i)
+    {
+      // sort by decreasing size, then by increasing root id.
+      order.push_back (std::make_pair (nNodes - i->second.size (), i->first));
+    }
+  std::sort (order.begin (), order.end ());
+
+  uint32_t threads = m_threads;
+  if (threads == 0)
+    {
+      threads = std::max (1u, std::thread::hardware_concurrency ());
+    }
+  uint32_t n = std::max<uint32_t> (1, std::min<uint32_t> (threads, groups.size ()));
+  std::vector<uint32_t> load (n, 0);
+  m_nodePartition.assign (nNodes, 0);
+  for (uint32_t i = 0; i < order.size (); i++)
+    {
+      uint32_t target = std::min_element (load.begin (), load.end ()) - load.begin ();
+      const std::vector<uint32_t> &group = groups[order[i].second];
+      for (uint32_t j = 0; j < group.size (); j++)
+        {
+          m_nodePartition[group[j]] = target;
+        }
+      load[target] += group.size ();
+    }
+
+  m_lookAhead = INFINITE_TS;
+  for (uint32_t i = 0; i < links.size (); i++)
+    {
+      if (m_nodePartition[links[i].a] != m_nodePartition[links[i].b])
+        {
+          m_lookAhead = std::min (m_lookAhead, links[i].delay);
+        }
+    }
+  NS_LOG_INFO ("nodes " << nNodes << ", partitions " << n <<
+               ", lookahead " << (m_lookAhead == INFINITE_TS ? -1 : (int64_t)m_lookAhead));
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Partition *p = new Partition;
+      p->impl = this;
+      p->index = i;
+      p->events = m_schedulerFactory.Create<Scheduler> ();
+      p->inbox.store (0);
+      p->currentTs = m_currentTs;
+      p->currentUid = m_currentUid;
+      p->currentContext = m_currentContext;
+      // interleave the uids of the partitions, so that they
+      // stay unique when the partitions are merged back.
+      p->uid = m_uid + i;
+      p->seq = 0;
+      p->windowEnd = 0;
+      p->stopTs = INFINITE_TS;
+      p->stopUid = 0;
+      p->stopNow = false;
+      p->nextTs = INFINITE_TS;
+      p->publishedStopNow = false;
+      m_partitions.push_back (p);
+    }
+  m_partitionCount = n;
+
+  while (!m_events->IsEmpty ())
+    {
+      Scheduler::Event ev = m_events->RemoveNext ();
+      m_partitions[GetPartitionIndex (ev.key.m_context)]->events->Insert (ev);
+    }
+  m_barrier.SetCount (n);
+}
+
+void
+MultithreadedSimulatorImpl::CollectEvents (void)
+{
+  NS_LOG_FUNCTION (this);
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      Partition *p = m_partitions[i];
+      DrainInbox (p);
+      while (!p->events->IsEmpty ())
+        {
+          m_events->Insert (p->events->RemoveNext ());
+        }
+      m_uid = std::max (m_uid, p->uid);
+      delete p;
+    }
+  m_partitions.clear ();
+}
+
+void
+MultithreadedSimulatorImpl::PushInbox (Partition *target, InboxEvent *ie)
+{
+  InboxEvent *head = target->inbox.load (std::memory_order_relaxed);
+  do
+    {
+      ie->next = head;
+    }
+  while (!target->inbox.compare_exchange_weak (head, ie,
+                                               std::memory_order_release,
+                                               std::memory_order_relaxed));
+}
+
+bool
+MultithreadedSimulatorImpl::InboxEventLess (const InboxEvent *a, const InboxEvent *b)
+{
+  if (a->ts != b->ts)
+    {
+      return a->ts < b->ts;
+    }
+  if (a->source != b->source)
+    {
+      return a->source < b->source;
+    }
+  return a->seq < b->seq;
+}
+
+void
+MultithreadedSimulatorImpl::LowerStopTs (uint64_t ts)
+{
+  uint64_t current = m_stopTs.load (std::memory_order_relaxed);
+  while (ts < current
+         && !m_stopTs.compare_exchange_weak (current, ts, std::memory_order_relaxed))
+    {
+    }
+}
+
+void
+MultithreadedSimulatorImpl::DrainInbox (Partition *p)
+{
+  InboxEvent *list = p->inbox.exchange (0, std::memory_order_acquire);
+  if (list == 0)
+    {
+      return;
+    }
+  std::vector<InboxEvent *> batch;
+  for (InboxEvent *ie = list; ie != 0; ie = ie->next)
+    {
+      if (ie->relative)
+        {
+          ie->ts += p->currentTs;
+          ie->relative = false;
+        }
+      batch.push_back (ie);
+    }
+  // The order in which the events were pushed depends on the thread
+  // scheduling: sort them to keep the simulation deterministic.
+  std::sort (batch.begin (), batch.end (), &MultithreadedSimulatorImpl::InboxEventLess);
+  uint32_t stride = m_partitions.size ();
+  for (uint32_t i = 0; i < batch.size (); i++)
+    {
+      Scheduler::Event ev;
+      ev.impl = batch[i]->impl;
+      ev.key.m_ts = batch[i]->ts;
+      ev.key.m_context = batch[i]->context;
+      ev.key.m_uid = p->uid;
+      p->uid += stride;
+      p->events->Insert (ev);
+      delete batch[i];
+    }
+}
+
+void
+MultithreadedSimulatorImpl::RunPartition (Partition *partition)
+{
+  partition->impl->DoRunPartition (partition);
+}
+
+void
+MultithreadedSimulatorImpl::DoRunPartition (Partition *p)
+{
+  g_partition = p;
+  while (true)
+    {
+      // All the events sent to this partition during the previous
+      // window are in the inbox by now: publish our next event time.
+      DrainInbox (p);
+      p->nextTs = INFINITE_TS;
+      if (!p->events->IsEmpty ())
+        {
+          Scheduler::EventKey key = p->events->PeekNext ().key;
+          // An event at stopTs, scheduled after the stop request,
+          // does not run: it counts as an event after the stop time.
+          p->nextTs = (key.m_ts == p->stopTs && key.m_uid > p->stopUid) ? key.m_ts + 1 : key.m_ts;
+        }
+      p->publishedStopNow = p->stopNow;
+      // No event runs between the two barriers, so that every
+      // partition reads the same stop time.
+      uint64_t stopTs = m_stopTs.load (std::memory_order_relaxed);
+      m_barrier.Wait ();
+
+      // Every partition computes the same window from the published values.
+      uint64_t next = INFINITE_TS;
+      bool stopNow = false;
+      for (uint32_t i = 0; i < m_partitions.size (); i++)
+        {
+          const Partition *q = m_partitions[i];
+          next = std::min (next, q->nextTs);
+          stopNow = stopNow || q->publishedStopNow;
+        }
+      if (stopNow || next == INFINITE_TS || next > stopTs)
+        {
+          if (p->index == 0)
+            {
+              m_stopped = stopNow || (next != INFINITE_TS && next > stopTs);
+              uint64_t finalTs = 0;
+              for (uint32_t i = 0; i < m_partitions.size (); i++)
+                {
+                  finalTs = std::max (finalTs, m_partitions[i]->currentTs);
+                }
+              if (stopTs != INFINITE_TS)
+                {
+                  // The simulation ends at the stop time, even if a
+                  // partition ran past it before the stop request.
+                  finalTs = stopTs;
+                }
+              m_finalTs = finalTs;
+            }
+          break;
+        }
+      uint64_t end = INFINITE_TS;
+      if (m_lookAhead != INFINITE_TS && next < INFINITE_TS - m_lookAhead)
+        {
+          end = next + m_lookAhead;
+        }
+      if (stopTs != INFINITE_TS && end > stopTs)
+        {
+          end = stopTs + 1;
+        }
+      p->windowEnd = end;
+      if (p->index == 0)
+        {
+          m_windows.fetch_add (1, std::memory_order_relaxed);
+        }
+
+      while (!p->events->IsEmpty () && !p->stopNow)
+        {
+          Scheduler::Event ev = p->events->PeekNext ();
+          // The stop time may have been lowered by an event of this
+          // window, in this partition or in another one.
+          if (ev.key.m_ts >= end || ev.key.m_ts > m_stopTs.load (std::memory_order_relaxed)
+              || ev.key.m_ts > p->stopTs
+              || (ev.key.m_ts == p->stopTs && ev.key.m_uid > p->stopUid))
+            {
+              break;
+            }
+          p->events->RemoveNext ();
+          NS_ASSERT (ev.key.m_ts >= p->currentTs);
+          p->currentTs = ev.key.m_ts;
+          p->currentContext = ev.key.m_context;
+          p->currentUid = ev.key.m_uid;
+          ev.impl->Invoke ();
+          ev.impl->Unref ();
+        }
+      m_barrier.Wait ();
+    }
+  g_partition = 0;
+}
+
+void
+MultithreadedSimulatorImpl::Run (void)
+{
+  NS_LOG_FUNCTION (this);
+  NS_ABORT_MSG_IF (m_running, "Simulator::Run called recursively");
+
+  BuildPartitions ();
+  m_running = true;
+  m_stopped = false;
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 1; i < m_partitions.size (); i++)
+    {
+      Ptr<SystemThread> thread =
+        Create<SystemThread> (MakeBoundCallback (&MultithreadedSimulatorImpl::RunPartition,
+                                                 m_partitions[i]));
+      thread->Start ();
+      threads.push_back (thread);
+    }
+  DoRunPartition (m_partitions[0]);
+  for (uint32_t i = 0; i < threads.size (); i++)
+    {
+      threads[i]->Join ();
+    }
+  m_running = false;
+
+  // Bring the clock of the main thread to the end of the run.
+  m_currentTs = m_finalTs;
+  m_currentUid = 0;
+  for (uint32_t i = 0; i < m_partitions.size (); i++)
+    {
+      if (m_partitions[i]->currentTs == m_finalTs)
+        {
+          m_currentUid = std::max (m_currentUid, m_partitions[i]->currentUid);
+        }
+    }
+  m_currentContext = Simulator::NO_CONTEXT;
+  if (m_stopTs.load () <= m_currentTs)
+    {
+      m_stopTs.store (INFINITE_TS);
+    }
+  CollectEvents ();
+}
+
+void
+MultithreadedSimulatorImpl::Stop (void)
+{
+  NS_LOG_FUNCTION (this);
+  Partition *p = g_partition;
+  if (p != 0)
+    {
+      p->stopNow = true;
+      LowerStopTs (p->currentTs);
+    }
+  else
+    {
+      m_stopped = true;
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Stop (Time const &delay)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep ());
+  Partition *p = g_partition;
+  if (p != 0)
+    {
+      // Like a stop event scheduled by DefaultSimulatorImpl, the
+      // request takes a unique id.
+      uint64_t ts = p->currentTs + delay.GetTimeStep ();
+      if (ts < p->stopTs)
+        {
+          p->stopTs = ts;
+          p->stopUid = p->uid;
+        }
+      p->uid += m_partitions.size ();
+      LowerStopTs (ts);
+    }
+  else
+    {
+      NS_ASSERT_MSG (!m_running, "Simulator::Stop Thread-unsafe invocation!");
+      LowerStopTs (m_currentTs + delay.GetTimeStep ());
+    }
+}
+
+EventId
+MultithreadedSimulatorImpl::Schedule (Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << delay.GetTimeStep () << event);
+  NS_ASSERT (delay.IsPositive ());
+
+  Scheduler::Event ev;
+  ev.impl = event;
+  Partition *p = g_partition;
+  if (p != 0)
+    {
+      ev.key.m_ts = p->currentTs + delay.GetTimeStep ();
+      ev.key.m_context = p->currentContext;
+      ev.key.m_uid = p->uid;
+      p->uid += m_partitions.size ();
+      p->events->Insert (ev);
+    }
+  else
+    {
+      NS_ASSERT_MSG (!m_running, "Simulator::Schedule Thread-unsafe invocation!");
+      ev.key.m_ts = m_currentTs + delay.GetTimeStep ();
+      ev.key.m_context = m_currentContext;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_events->Insert (ev);
+    }
+  return EventId (event, ev.key.m_ts, ev.key.m_context, ev.key.m_uid);
+}
+
+void
+MultithreadedSimulatorImpl::ScheduleWithContext (uint32_t context, Time const &delay, EventImpl *event)
+{
+  NS_LOG_FUNCTION (this << context << delay.GetTimeStep () << event);
+
+  Partition *p = g_partition;
+  if (p == 0 && !m_running)
+    {
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = m_currentTs + delay.GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = m_uid;
+      m_uid++;
+      m_events->Insert (ev);
+      return;
+    }
+
+  Partition *target = m_partitions[GetPartitionIndex (context)];
+  if (target == p)
+    {
+      Scheduler::Event ev;
+      ev.impl = event;
+      ev.key.m_ts = p->currentTs + delay.GetTimeStep ();
+      ev.key.m_context = context;
+      ev.key.m_uid = p->uid;
+      p->uid += m_partitions.size ();
+      p->events->Insert (ev);
+      return;
+    }
+
+  InboxEvent *ie = new InboxEvent;
+  ie->context = context;
+  ie->impl = event;
+  if (p != 0)
+    {
+      ie->ts = p->currentTs + delay.GetTimeStep ();
+      ie->relative = false;
+      ie->source = p->index;
+      ie->seq = p->seq++;
+      NS_ABORT_MSG_IF (ie->ts < p->windowEnd,
+                       "Event sent to node " << context << " with a delay of " <<
+                       delay << ", lower than the lookahead " << TimeStep (m_lookAhead));
+    }
+  else
+    {
+      // Event from a thread which does not run a partition: its
+      // timestamp is relative to the clock of the target partition.
+      ie->ts = delay.GetTimeStep ();
+      ie->relative = true;
+      ie->source = std::numeric_limits<uint32_t>::max ();
+      ie->seq = m_foreignSeq.fetch_add (1, std::memory_order_relaxed);
+    }
+  // The event must not share packets with the objects of this thread.
+  event->Isolate ();
+  PushInbox (target, ie);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleNow (EventImpl *event)
+{
+  return Schedule (TimeStep (0), event);
+}
+
+EventId
+MultithreadedSimulatorImpl::ScheduleDestroy (EventImpl *event)
+{
+  EventId id (Ptr<EventImpl> (event, false), Now ().GetTimeStep (), 0xffffffff, 2);
+  CriticalSection cs (m_destroyEventsMutex);
+  m_destroyEvents.push_back (id);
+  return id;
+}
+
+Time
+MultithreadedSimulatorImpl::Now (void) const
+{
+  // Do not add function logging here, to avoid stack overflow
+  const Partition *p = g_partition;
+  if (p != 0)
+    {
+      return TimeStep (p->currentTs);
+    }
+  return TimeStep (m_currentTs);
+}
+
+Time
+MultithreadedSimulatorImpl::GetDelayLeft (const EventId &id) const
+{
+  if (IsExpired (id))
+    {
+      return TimeStep (0);
+    }
+  else
+    {
+      return TimeStep (id.GetTs ()) - Now ();
+    }
+}
+
+void
+MultithreadedSimulatorImpl::Remove (const EventId &id)
+{
+  if (id.GetUid () == 2)
+    {
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              m_destroyEvents.erase (i);
+              break;
+            }
+        }
+      return;
+    }
+  if (IsExpired (id))
+    {
+      return;
+    }
+  Scheduler::Event event;
+  event.impl = id.PeekEventImpl ();
+  event.key.m_ts = id.GetTs ();
+  event.key.m_context = id.GetContext ();
+  event.key.m_uid = id.GetUid ();
+  Partition *p = g_partition;
+  if (p != 0)
+    {
+      NS_ABORT_MSG_IF (GetPartitionIndex (id.GetContext ()) != p->index,
+                       "Cannot remove an event of node " << id.GetContext () <<
+                       " from another partition");
+      p->events->Remove (event);
+    }
+  else
+    {
+      NS_ASSERT_MSG (!m_running, "Simulator::Remove Thread-unsafe invocation!");
+      m_events->Remove (event);
+    }
+  event.impl->Cancel ();
+  // whenever we remove an event from the event list, we have to unref it.
+  event.impl->Unref ();
+}
+
+void
+MultithreadedSimulatorImpl::Cancel (const EventId &id)
+{
+  if (!IsExpired (id))
+    {
+      id.PeekEventImpl ()->Cancel ();
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsExpired (const EventId &id) const
+{
+  if (id.GetUid () == 2)
+    {
+      if (id.PeekEventImpl () == 0 ||
+          id.PeekEventImpl ()->IsCancelled ())
+        {
+          return true;
+        }
+      // destroy events.
+      CriticalSection cs (m_destroyEventsMutex);
+      for (DestroyEvents::const_iterator i = m_destroyEvents.begin (); i != m_destroyEvents.end (); i++)
+        {
+          if (*i == id)
+            {
+              return false;
+            }
+        }
+      return true;
+    }
+  uint64_t currentTs = m_currentTs;
+  uint32_t currentUid = m_currentUid;
+  const Partition *p = g_partition;
+  if (p != 0)
+    {
+      currentTs = p->currentTs;
+      currentUid = p->currentUid;
+    }
+  if (id.PeekEventImpl () == 0 ||
+      id.GetTs () < currentTs ||
+      (id.GetTs () == currentTs &&
+       id.GetUid () <= currentUid) ||
+      id.PeekEventImpl ()->IsCancelled ())
+    {
+      return true;
+    }
+  else
+    {
+      return false;
+    }
+}
+
+bool
+MultithreadedSimulatorImpl::IsFinished (void) const
+{
+  const Partition *p = g_partition;
+  if (p != 0)
+    {
+      return p->events->IsEmpty () || p->stopNow;
+    }
+  return m_events->IsEmpty () || m_stopped;
+}
+
+Time
+MultithreadedSimulatorImpl::GetMaximumSimulationTime (void) const
+{
+  return TimeStep (0x7fffffffffffffffLL);
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetContext (void) const
+{
+  const Partition *p = g_partition;
+  if (p != 0)
+    {
+      return p->currentContext;
+    }
+  return m_currentContext;
+}
+
+uint32_t
+MultithreadedSimulatorImpl::GetPartitionCount (void) const
+{
+  return m_partitionCount;
+}
+
+Time
+MultithreadedSimulatorImpl::GetLookAhead (void) const
+{
+  if (m_lookAhead == INFINITE_TS)
+    {
+      return GetMaximumSimulationTime ();
+    }
+  return TimeStep (m_lookAhead);
+}
+
+uint64_t
+MultithreadedSimulatorImpl::GetWindowCount (void) const
+{
+  return m_windows.load ();
+}
+
+} // namespace ns3
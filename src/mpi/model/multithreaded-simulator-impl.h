@@ -0,0 +1,313 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MULTITHREADED_SIMULATOR_IMPL_H
+#define MULTITHREADED_SIMULATOR_IMPL_H
+
+#include "ns3/simulator-impl.h"
+#include "ns3/scheduler.h"
+#include "ns3/event-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+#include "ns3/system-mutex.h"
+
+#include <stdint.h>
+#include <atomic>
+#include <list>
+#include <vector>
+
+namespace ns3 {
+
+/**
+ * \ingroup mpi
+ *
+ * \brief Shared-memory parallel simulator implementation.
+ *
+ * This simulator implementation partitions the nodes of the simulation
+ * across a number of worker threads in a single process, without MPI.
+ * Each partition has its own event list and its own clock, and runs
+ * the events of its nodes (the event context being the node id).
+ *
+ * Synchronization is conservative, in globally synchronized time
+ * windows.  At the start of each window the partitions agree, through
+ * a barrier, on the earliest pending event time \c T of the whole
+ * simulation; every partition then executes, in parallel, all its
+ * events with a timestamp lower than <tt>T + lookahead</tt>, and waits
+ * on the barrier again.
+ *
+ * The lookahead and the partitions are computed at the start of every
+ * call to Run, from the channels of the ChannelList:
+ *  - a channel with exactly two point-to-point devices and a strictly
+ *    positive "Delay" attribute (e.g., PointToPointChannel) may link
+ *    two different partitions;
+ *  - the nodes attached to any other channel (e.g., CsmaChannel, whose
+ *    carrier state is read synchronously by all its devices) are
+ *    always kept in the same partition;
+ *  - the connected groups of nodes are then spread over the threads,
+ *    and the lookahead is the smallest delay of the point-to-point
+ *    channels which link two partitions.
+ *
+ * Events sent to a node of another partition (Simulator::ScheduleWithContext)
+ * are pushed, without locking, into the inbox of the target partition.
+ * Their bound packets are first replaced by unshared copies (see
+ * EventImpl::Isolate), so that the two partitions never share packet
+ * data.  The inboxes are drained at the start of each window and their
+ * content is sorted by timestamp and sender, so that, for a given
+ * number of threads, the execution order does not depend on thread
+ * scheduling.  An event sent to another partition within the current
+ * window is a causality error and aborts the simulation.
+ *
+ * The order of the events of a partition with the same timestamp
+ * depends on the partitioning, hence on the number of threads: the
+ * runs are only reproducible for a fixed number of threads.  The
+ * packet uids are allocated by all the threads from a single counter,
+ * and are not reproducible.
+ *
+ * Events without a node context (Simulator::NO_CONTEXT) run in the
+ * first partition.
+ *
+ * Simulator::Stop, called from an event, stops the partition of this
+ * event at once (or at the requested time), and lowers the stop time
+ * which every partition checks before each of its events.  A stop
+ * requested with a delay of at least the lookahead is exact; with a
+ * shorter delay, the other partitions may already have run some events
+ * of the current window past the stop time.
+ *
+ * Model code which runs in different partitions must not share mutable
+ * state, other than through events sent across partitions, whose
+ * arguments must be packets, Objects, or values.
+ */
+class MultithreadedSimulatorImpl : public SimulatorImpl
+{
+public:
+  /**
+   *  Register this type.
+   *  \return The object TypeId.
+   */
+  static TypeId GetTypeId (void);
+
+  /** Constructor. */
+  MultithreadedSimulatorImpl ();
+  /** Destructor. */
+  ~MultithreadedSimulatorImpl ();
+
+  // Inherited
+  virtual void Destroy ();
+  virtual bool IsFinished (void) const;
+  virtual void Stop (void);
+  virtual void Stop (const Time &delay);
+  virtual EventId Schedule (const Time &delay, EventImpl *event);
+  virtual void ScheduleWithContext (uint32_t context, const Time &delay, EventImpl *event);
+  virtual EventId ScheduleNow (EventImpl *event);
+  virtual EventId ScheduleDestroy (EventImpl *event);
+  virtual void Remove (const EventId &id);
+  virtual void Cancel (const EventId &id);
+  virtual bool IsExpired (const EventId &id) const;
+  virtual void Run (void);
+  virtual Time Now (void) const;
+  virtual Time GetDelayLeft (const EventId &id) const;
+  virtual Time GetMaximumSimulationTime (void) const;
+  virtual void SetScheduler (ObjectFactory schedulerFactory);
+  virtual uint32_t GetSystemId (void) const;
+  virtual uint32_t GetContext (void) const;
+
+  /**
+   * \returns The number of partitions used by the last call to Run.
+   */
+  uint32_t GetPartitionCount (void) const;
+  /**
+   * \returns The lookahead used by the last call to Run.
+   */
+  Time GetLookAhead (void) const;
+  /**
+   * \returns The number of synchronization windows executed so far.
+   */
+  uint64_t GetWindowCount (void) const;
+
+private:
+  virtual void DoDispose (void);
+
+  /** An event sent to another partition. */
+  struct InboxEvent
+  {
+    uint64_t ts;          /**< Absolute timestamp, or delay if \c relative. */
+    uint32_t context;     /**< Event context. */
+    uint32_t source;      /**< Index of the sending partition. */
+    uint64_t seq;         /**< Sequence number of the sender. */
+    bool relative;        /**< \c ts is relative to the receiver clock. */
+    EventImpl *impl;      /**< The event implementation. */
+    InboxEvent *next;     /**< Next event in the inbox. */
+  };
+
+  /** The state of one partition. */
+  struct Partition
+  {
+    /** The owning simulator. */
+    MultithreadedSimulatorImpl *impl;
+    /** The partition index. */
+    uint32_t index;
+    /** The event list. */
+    Ptr<Scheduler> events;
+    /** Events sent by other threads, pushed lock-free. */
+    std::atomic<InboxEvent *> inbox;
+    /** Timestamp of the current event. */
+    uint64_t currentTs;
+    /** Unique id of the current event. */
+    uint32_t currentUid;
+    /** Execution context of the current event. */
+    uint32_t currentContext;
+    /** Next event unique id. */
+    uint32_t uid;
+    /** Sequence number of the events sent to other partitions. */
+    uint64_t seq;
+    /** End of the current window, exclusive. */
+    uint64_t windowEnd;
+    /** Stop time requested by an event of this partition. */
+    uint64_t stopTs;
+    /**
+     * Unique id of the stop request: the events of this partition at
+     * stopTs which were scheduled after the request do not run.
+     */
+    uint32_t stopUid;
+    /** Simulator::Stop was called by an event of this partition. */
+    bool stopNow;
+    /** Timestamp of the next event, published at the window barrier. */
+    uint64_t nextTs;
+    /** stopNow, published at the window barrier. */
+    bool publishedStopNow;
+  };
+
+  /** A simple reusable spinning barrier. */
+  class Barrier
+  {
+  public:
+    /** Constructor. */
+    Barrier ();
+    /**
+     * Set the number of threads to wait for.
+     * \param [in] n The number of threads.
+     */
+    void SetCount (uint32_t n);
+    /** Wait until all threads have reached the barrier. */
+    void Wait (void);
+  private:
+    uint32_t m_n;                        /**< Number of threads. */
+    std::atomic<uint32_t> m_arrived;     /**< Threads arrived so far. */
+    std::atomic<uint32_t> m_generation;  /**< Barrier generation. */
+  };
+
+  /**
+   * Thread entry point.
+   * \param [in] partition The partition to run.
+   */
+  static void RunPartition (Partition *partition);
+  /**
+   * Run the windows of a partition until the simulation stops.
+   * \param [in] p The partition.
+   */
+  void DoRunPartition (Partition *p);
+  /**
+   * Move the content of the inbox of a partition to its event list.
+   * \param [in] p The partition.
+   */
+  void DrainInbox (Partition *p);
+  /** Compute the partitions and the lookahead, and distribute the events. */
+  void BuildPartitions (void);
+  /** Delete the partitions, moving their events to the setup event list. */
+  void CollectEvents (void);
+  /**
+   * Get the partition which runs the events of a context.
+   * \param [in] context The event context.
+   * \returns The partition index.
+   */
+  uint32_t GetPartitionIndex (uint32_t context) const;
+  /**
+   * Push an event into the inbox of a partition.
+   * \param [in] target The partition.
+   * \param [in] ie The event.
+   */
+  static void PushInbox (Partition *target, InboxEvent *ie);
+  /**
+   * Compare two inbox events by timestamp, sender and sequence number.
+   * \param [in] a The first event.
+   * \param [in] b The second event.
+   * \returns \c true if \p a must run before \p b.
+   */
+  static bool InboxEventLess (const InboxEvent *a, const InboxEvent *b);
+  /**
+   * Lower the stop time of the simulation.
+   * \param [in] ts The requested stop time.
+   */
+  void LowerStopTs (uint64_t ts);
+
+  /** The partition run by the calling thread, if any. */
+  static thread_local Partition *g_partition;
+
+  /** Number of threads requested. */
+  uint32_t m_threads;
+  /** The scheduler factory. */
+  ObjectFactory m_schedulerFactory;
+  /** Events scheduled while the partitions are not built. */
+  Ptr<Scheduler> m_events;
+  /** The partitions. */
+  std::vector<Partition *> m_partitions;
+  /** Partition index of each node. */
+  std::vector<uint32_t> m_nodePartition;
+  /** The window barrier. */
+  Barrier m_barrier;
+  /** The lookahead, in time steps. */
+  uint64_t m_lookAhead;
+  /**
+   * Stop time: the events after it do not run.  Lowered by
+   * Simulator::Stop, from the main thread or from any partition.
+   */
+  std::atomic<uint64_t> m_stopTs;
+  /** Is the simulation running ? */
+  bool m_running;
+  /** Did the last Run end because of Simulator::Stop ? */
+  bool m_stopped;
+  /** Number of partitions used by the last Run. */
+  uint32_t m_partitionCount;
+  /** Simulation time reached at the end of Run. */
+  uint64_t m_finalTs;
+  /** Number of windows executed. */
+  std::atomic<uint64_t> m_windows;
+  /** Sequence number of events sent by non-simulation threads. */
+  std::atomic<uint64_t> m_foreignSeq;
+
+  /** Container type for the events to run at Simulator::Destroy() */
+  typedef std::list<EventId> DestroyEvents;
+  /** The container of events to run at Destroy. */
+  DestroyEvents m_destroyEvents;
+  /** Mutex to control access to the list of destroy events. */
+  mutable SystemMutex m_destroyEventsMutex;
+
+  /** Next event unique id, outside of Run. */
+  uint32_t m_uid;
+  /** Unique id of the current event, outside of Run. */
+  uint32_t m_currentUid;
+  /** Timestamp of the current event, outside of Run. */
+  uint64_t m_currentTs;
+  /** Execution context of the current event, outside of Run. */
+  uint32_t m_currentContext;
+};
+
+} // namespace ns3
+
+#endif /* MULTITHREADED_SIMULATOR_IMPL_H */
@@ -0,0 +1,408 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/test.h"
+#include "ns3/simulator.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/boolean.h"
+#include "ns3/node.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+
+#include <algorithm>
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup mpi
+ * \defgroup mpi-test mpi module tests
+ */
+
+/**
+ * \ingroup mpi-test
+ * \brief Check that the MultithreadedSimulatorImpl runs the same events
+ * as the DefaultSimulatorImpl.
+ *
+ * The topology is a ring of 8 nodes, linked by point-to-point channels
+ * with a 1ms delay (2ms for the last one), plus a group of 3 nodes on
+ * a shared channel, linked to the first node of the ring.  Tokens hop
+ * from node to node with ScheduleWithContext, and schedule some local
+ * events on each node; every node logs the events it runs.
+ */
+class MultithreadedSimulatorTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorTestCase ();
+private:
+  virtual void DoRun (void);
+
+  /** (timestamp, token) records of one node. */
+  typedef std::vector<std::pair<int64_t, uint32_t> > Log;
+
+  /**
+   * Create the nodes and channels.
+   */
+  void Build (void);
+  /**
+   * Run the token workload with a simulator implementation.
+   * \param [in] factory The simulator implementation factory.
+   * \param [in] stop The stop time, or zero.
+   * \returns The time at the end of the run.
+   */
+  Time RunWith (ObjectFactory factory, Time stop);
+  /**
+   * A token arrives on a node.
+   * \param [in] node The node id.
+   * \param [in] token The token id.
+   * \param [in] hops The number of hops left.
+   */
+  void Hop (uint32_t node, uint32_t token, uint32_t hops);
+  /**
+   * A local event on a node.
+   * \param [in] node The node id.
+   * \param [in] token The token id.
+   */
+  void Local (uint32_t node, uint32_t token);
+  /**
+   * \returns A copy of the logs with each node log sorted.
+   */
+  std::vector<Log> Sorted (void) const;
+
+  std::vector<Log> m_logs;       //!< Per node logs.
+  uint32_t m_partitions;         //!< Partitions of the last run.
+  Time m_lookAhead;              //!< Lookahead of the last run.
+  uint64_t m_windows;            //!< Windows of the last run.
+};
+
+MultithreadedSimulatorTestCase::MultithreadedSimulatorTestCase ()
+  : TestCase ("Check the multithreaded simulator against the default simulator")
+{
+}
+
+void
+MultithreadedSimulatorTestCase::Build (void)
+{
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < 11; i++)
+    {
+      nodes.push_back (CreateObject<Node> ());
+    }
+  // the ring, plus a link from node 0 to node 8.
+  for (uint32_t i = 0; i < 9; i++)
+    {
+      uint32_t a = (i < 8) ? i : 0;
+      uint32_t b = (i < 8) ? (i + 1) % 8 : 8;
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      channel->SetAttribute ("Delay", TimeValue (i == 7 ? MilliSeconds (2) : MilliSeconds (1)));
+      Ptr<SimpleNetDevice> da = CreateObject<SimpleNetDevice> ();
+      Ptr<SimpleNetDevice> db = CreateObject<SimpleNetDevice> ();
+      da->SetAttribute ("PointToPointMode", BooleanValue (true));
+      db->SetAttribute ("PointToPointMode", BooleanValue (true));
+      nodes[a]->AddDevice (da);
+      nodes[b]->AddDevice (db);
+      da->SetChannel (channel);
+      db->SetChannel (channel);
+    }
+  // a shared channel, which must not be split across partitions.
+  Ptr<SimpleChannel> shared = CreateObject<SimpleChannel> ();
+  shared->SetAttribute ("Delay", TimeValue (MicroSeconds (100)));
+  for (uint32_t i = 8; i < 11; i++)
+    {
+      Ptr<SimpleNetDevice> device = CreateObject<SimpleNetDevice> ();
+      nodes[i]->AddDevice (device);
+      device->SetChannel (shared);
+    }
+}
+
+void
+MultithreadedSimulatorTestCase::Hop (uint32_t node, uint32_t token, uint32_t hops)
+{
+  m_logs[node].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), token));
+  if (hops == 0)
+    {
+      return;
+    }
+  Simulator::Schedule (MicroSeconds (10 * (token % 3)),
+                       &MultithreadedSimulatorTestCase::Local, this, node, token);
+  uint32_t next;
+  Time delay;
+  if (node == 0 && hops % 2 == 0)
+    {
+      next = 8;
+      delay = MilliSeconds (1);
+    }
+  else if (node < 8)
+    {
+      next = (node + 1) % 8;
+      delay = (node == 7) ? MilliSeconds (2) : MilliSeconds (1);
+    }
+  else if (node < 10)
+    {
+      next = node + 1;
+      delay = MicroSeconds (100);
+    }
+  else
+    {
+      next = 0;
+      delay = MilliSeconds (1);
+    }
+  Simulator::ScheduleWithContext (next, delay, &MultithreadedSimulatorTestCase::Hop,
+                                  this, next, token, hops - 1);
+}
+
+void
+MultithreadedSimulatorTestCase::Local (uint32_t node, uint32_t token)
+{
+  m_logs[node].push_back (std::make_pair (Simulator::Now ().GetTimeStep (), token + 1000));
+}
+
+Time
+MultithreadedSimulatorTestCase::RunWith (ObjectFactory factory, Time stop)
+{
+  Simulator::Destroy ();
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+  m_logs.assign (11, Log ());
+  Build ();
+  for (uint32_t token = 0; token < 6; token++)
+    {
+      uint32_t node = (token * 3) % 11;
+      Simulator::ScheduleWithContext (node, MicroSeconds (7 * token),
+                                      &MultithreadedSimulatorTestCase::Hop,
+                                      this, node, token, 200);
+    }
+  if (!stop.IsZero ())
+    {
+      Simulator::Stop (stop);
+    }
+  Simulator::Run ();
+  Time end = Simulator::Now ();
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      m_partitions = impl->GetPartitionCount ();
+      m_lookAhead = impl->GetLookAhead ();
+      m_windows = impl->GetWindowCount ();
+    }
+  Simulator::Destroy ();
+  return end;
+}
+
+std::vector<MultithreadedSimulatorTestCase::Log>
+MultithreadedSimulatorTestCase::Sorted (void) const
+{
+  std::vector<Log> logs = m_logs;
+  for (uint32_t i = 0; i < logs.size (); i++)
+    {
+      std::sort (logs[i].begin (), logs[i].end ());
+    }
+  return logs;
+}
+
+void
+MultithreadedSimulatorTestCase::DoRun (void)
+{
+  ObjectFactory reference ("ns3::DefaultSimulatorImpl");
+  ObjectFactory threaded ("ns3::MultithreadedSimulatorImpl");
+  threaded.Set ("ThreadCount", UintegerValue (4));
+
+  // full run
+  Time referenceEnd = RunWith (reference, Seconds (0));
+  std::vector<Log> expected = Sorted ();
+  Time threadedEnd = RunWith (threaded, Seconds (0));
+  std::vector<Log> first = m_logs;
+
+  NS_TEST_ASSERT_MSG_EQ (m_partitions, 4, "Unexpected number of partitions");
+  NS_TEST_ASSERT_MSG_EQ (m_lookAhead, MilliSeconds (1), "Unexpected lookahead");
+  NS_TEST_EXPECT_MSG_GT (m_windows, 1, "No synchronization window");
+  NS_TEST_EXPECT_MSG_EQ (threadedEnd, referenceEnd, "Different end of simulation time");
+  for (uint32_t i = 0; i < m_logs.size (); i++)
+    {
+      for (uint32_t j = 1; j < m_logs[i].size (); j++)
+        {
+          NS_TEST_ASSERT_MSG_GT_OR_EQ (m_logs[i][j].first, m_logs[i][j - 1].first,
+                                       "Events out of order on node " << i);
+        }
+    }
+  bool same = (Sorted () == expected);
+  NS_TEST_EXPECT_MSG_EQ (same, true, "The threaded simulator did not run the same events");
+
+  // the execution order does not depend on thread scheduling
+  RunWith (threaded, Seconds (0));
+  same = (m_logs == first);
+  NS_TEST_EXPECT_MSG_EQ (same, true, "The threaded simulator is not deterministic");
+
+  // Simulator::Stop
+  Time stop = MilliSeconds (20) + NanoSeconds (500);
+  referenceEnd = RunWith (reference, stop);
+  expected = Sorted ();
+  threadedEnd = RunWith (threaded, stop);
+  NS_TEST_EXPECT_MSG_EQ (referenceEnd, stop, "Default simulator did not stop in time");
+  NS_TEST_EXPECT_MSG_EQ (threadedEnd, stop, "Threaded simulator did not stop in time");
+  same = (Sorted () == expected);
+  NS_TEST_EXPECT_MSG_EQ (same, true, "The threaded simulator did not stop at the same event");
+}
+
+/**
+ * \ingroup mpi-test
+ * \brief Check that Simulator::Stop, called from an event, stops
+ * every partition of the MultithreadedSimulatorImpl.
+ *
+ * Each of the 4 nodes runs a periodic 1ms event; the first event of
+ * the first node calls Simulator::Stop (1.0005s).  Without channels the
+ * lookahead is infinite, and the other partitions may run past the stop
+ * time before they see it; with a ring of channels, whose delay is not
+ * more than the stop delay, every partition stops at the same event as
+ * with the DefaultSimulatorImpl.
+ */
+class MultithreadedSimulatorStopTestCase : public TestCase
+{
+public:
+  MultithreadedSimulatorStopTestCase ();
+private:
+  virtual void DoRun (void);
+
+  /**
+   * Run the periodic events with a simulator implementation.
+   * \param [in] factory The simulator implementation factory.
+   * \param [in] linked Link the nodes with a ring of channels.
+   * \returns The time at the end of the run.
+   */
+  Time RunWith (ObjectFactory factory, bool linked);
+  /**
+   * The periodic event of a node.
+   * \param [in] node The node id.
+   */
+  void Periodic (uint32_t node);
+
+  std::vector<uint32_t> m_counts;  //!< Number of periodic events run, per node.
+};
+
+MultithreadedSimulatorStopTestCase::MultithreadedSimulatorStopTestCase ()
+  : TestCase ("Check Simulator::Stop called from an event of the multithreaded simulator")
+{
+}
+
+void
+MultithreadedSimulatorStopTestCase::Periodic (uint32_t node)
+{
+  if (m_counts[node]++ == 0 && node == 0)
+    {
+      Simulator::Stop (Seconds (1) + MicroSeconds (500));
+    }
+  if (Simulator::Now () < Seconds (100))
+    {
+      Simulator::Schedule (MilliSeconds (1), &MultithreadedSimulatorStopTestCase::Periodic,
+                           this, node);
+    }
+}
+
+Time
+MultithreadedSimulatorStopTestCase::RunWith (ObjectFactory factory, bool linked)
+{
+  Simulator::Destroy ();
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      nodes.push_back (CreateObject<Node> ());
+    }
+  for (uint32_t i = 0; linked && i < 4; i++)
+    {
+      Ptr<SimpleChannel> channel = CreateObject<SimpleChannel> ();
+      channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+      Ptr<SimpleNetDevice> da = CreateObject<SimpleNetDevice> ();
+      Ptr<SimpleNetDevice> db = CreateObject<SimpleNetDevice> ();
+      da->SetAttribute ("PointToPointMode", BooleanValue (true));
+      db->SetAttribute ("PointToPointMode", BooleanValue (true));
+      nodes[i]->AddDevice (da);
+      nodes[(i + 1) % 4]->AddDevice (db);
+      da->SetChannel (channel);
+      db->SetChannel (channel);
+    }
+  m_counts.assign (4, 0);
+  for (uint32_t i = 0; i < 4; i++)
+    {
+      Simulator::ScheduleWithContext (i, MilliSeconds (1) + MicroSeconds (10 * i),
+                                      &MultithreadedSimulatorStopTestCase::Periodic, this, i);
+    }
+  Simulator::Run ();
+  Time end = Simulator::Now ();
+  Simulator::Destroy ();
+  return end;
+}
+
+void
+MultithreadedSimulatorStopTestCase::DoRun (void)
+{
+  Time stop = Seconds (1) + MilliSeconds (1) + MicroSeconds (500);
+  ObjectFactory reference ("ns3::DefaultSimulatorImpl");
+  Time referenceEnd = RunWith (reference, false);
+  std::vector<uint32_t> expected = m_counts;
+  NS_TEST_ASSERT_MSG_EQ (referenceEnd, stop, "Default simulator did not stop in time");
+
+  for (uint32_t threads = 1; threads <= 4; threads += 3)
+    {
+      ObjectFactory threaded ("ns3::MultithreadedSimulatorImpl");
+      threaded.Set ("ThreadCount", UintegerValue (threads));
+
+      // infinite lookahead: the other partitions may overrun the stop time.
+      Time threadedEnd = RunWith (threaded, false);
+      NS_TEST_EXPECT_MSG_EQ (threadedEnd, stop,
+                             "Threaded simulator did not stop in time with " << threads << " threads");
+      NS_TEST_EXPECT_MSG_EQ (m_counts[0], expected[0],
+                             "Threaded simulator did not stop at the same event with " << threads << " threads");
+      for (uint32_t i = 1; i < 4; i++)
+        {
+          NS_TEST_EXPECT_MSG_GT_OR_EQ (m_counts[i], expected[i],
+                                       "Node " << i << " stopped early with " << threads << " threads");
+          NS_TEST_EXPECT_MSG_LT (m_counts[i], 100000,
+                                 "Node " << i << " did not stop with " << threads << " threads");
+        }
+
+      // finite lookahead: every partition stops at the same event.
+      threadedEnd = RunWith (threaded, true);
+      NS_TEST_EXPECT_MSG_EQ (threadedEnd, stop,
+                             "Linked threaded simulator did not stop in time with " << threads << " threads");
+      bool same = (m_counts == expected);
+      NS_TEST_EXPECT_MSG_EQ (same, true,
+                             "Linked threaded simulator did not stop at the same events with " << threads << " threads");
+    }
+}
+
+/**
+ * \ingroup mpi-test
+ * \brief The multithreaded simulator test suite.
+ */
+class MultithreadedSimulatorTestSuite : public TestSuite
+{
+public:
+  MultithreadedSimulatorTestSuite ()
+    : TestSuite ("multithreaded-simulator", UNIT)
+  {
+    AddTestCase (new MultithreadedSimulatorTestCase (), TestCase::QUICK);
+    AddTestCase (new MultithreadedSimulatorStopTestCase (), TestCase::QUICK);
+  }
+};
+
+/** Static variable for test initialization. */
+static MultithreadedSimulatorTestSuite g_multithreadedSimulatorTestSuite;
@@ -50,96 +50,43 @@ namespace ns3 {
 NS_LOG_COMPONENT_DEFINE ("Buffer");
 
 
-uint32_t Buffer::g_recommendedStart = 0;
-#ifdef BUFFER_FREE_LIST
-/* The following macros are pretty evil but they are needed to allow us to
- * keep track of 3 possible states for the g_freeList variable:
- *  - uninitialized means that no one has created a buffer yet
- *    so no one has created the associated free list (it is created
- *    on-demand when the first buffer is created)
- *  - initialized means that the free list exists and is valid
- *  - destroyed means that the static destructors of this compilation unit
- *    have run so, the free list has been cleared from its content
- * The key is that in destroyed state, we are careful not re-create it
- * which is a typical weakness of lazy evaluation schemes which use 
- * '0' as a special value to indicate both un-initialized and destroyed.
- * Note that it is important to use '0' as the marker for un-initialized state
- * because the variable holding this state information is initialized to zero
- * which the compiler assigns to zero-memory which is initialized to _zero_
- * before the constructors run so this ensures perfect handling of crazy 
- * constructor orderings.
+std::atomic<uint32_t> Buffer::g_recommendedStart (0);
+
+/**
+ * \ingroup packet
+ * The pool of the buffer data storage.
  */
-#define MAGIC_DESTROYED (~(long) 0)
-#define IS_UNINITIALIZED(x) (x == (Buffer::FreeList*)0)
-#define IS_DESTROYED(x) (x == (Buffer::FreeList*)MAGIC_DESTROYED)
-#define IS_INITIALIZED(x) (!IS_UNINITIALIZED (x) && !IS_DESTROYED (x))
-#define DESTROYED ((Buffer::FreeList*)MAGIC_DESTROYED)
-#define UNINITIALIZED ((Buffer::FreeList*)0)
-uint32_t Buffer::g_maxSize = 0;
-Buffer::FreeList *Buffer::g_freeList = 0;
-struct Buffer::LocalStaticDestructor Buffer::g_localStaticDestructor;
-
-Buffer::LocalStaticDestructor::~LocalStaticDestructor(void)
+static PacketDataPool g_dataPool;
+
+PacketDataPool &
+Buffer::GetDataPool (void)
 {
-  NS_LOG_FUNCTION (this);
-  if (IS_INITIALIZED (g_freeList))
-    {
-      for (Buffer::FreeList::iterator i = g_freeList->begin ();
-           i != g_freeList->end (); i++)
-        {
-          Buffer::Deallocate (*i);
-        }
-      delete g_freeList;
-      g_freeList = DESTROYED;
-    }
+  return g_dataPool;
 }
 
+#ifdef BUFFER_FREE_LIST
 void
 Buffer::Recycle (struct Buffer::Data *data)
 {
   NS_LOG_FUNCTION (data);
   NS_ASSERT (data->m_count == 0);
-  NS_ASSERT (!IS_UNINITIALIZED (g_freeList));
-  g_maxSize = std::max (g_maxSize, data->m_size);
-  /* feed into free list */
-  if (data->m_size < g_maxSize ||
-      IS_DESTROYED (g_freeList) ||
-      g_freeList->size () > 1000)
-    {
-      Buffer::Deallocate (data);
-    }
-  else
-    {
-      NS_ASSERT (IS_INITIALIZED (g_freeList));
-      g_freeList->push_back (data);
-    }
+  g_dataPool.Deallocate (data, data->m_size - 1 + sizeof (struct Buffer::Data));
 }
 
 Buffer::Data *
 Buffer::Create (uint32_t dataSize)
 {
   NS_LOG_FUNCTION (dataSize);
-  /* try to find a buffer correctly sized. */
-  if (IS_UNINITIALIZED (g_freeList))
-    {
-      g_freeList = new Buffer::FreeList ();
-    }
-  else if (IS_INITIALIZED (g_freeList))
+  if (dataSize == 0)
     {
-      while (!g_freeList->empty ()) 
-        {
-          struct Buffer::Data *data = g_freeList->back ();
-          g_freeList->pop_back ();
-          if (data->m_size >= dataSize) 
-            {
-              data->m_count = 1;
-              return data;
-            }
-          Buffer::Deallocate (data);
-        }
+      dataSize = 1;
     }
-  struct Buffer::Data *data = Buffer::Allocate (dataSize);
-  NS_ASSERT (data->m_count == 1);
+  uint32_t capacity;
+  void *b = g_dataPool.Allocate (dataSize - 1 + sizeof (struct Buffer::Data), &capacity);
+  struct Buffer::Data *data = static_cast<struct Buffer::Data *> (b);
+  // Use the whole block, rounded up by the pool.
+  data->m_size = capacity + 1 - sizeof (struct Buffer::Data);
+  data->m_count = 1;
   return data;
 }
 #else /* BUFFER_FREE_LIST */
@@ -198,6 +145,8 @@ Buffer::Buffer (uint32_t dataSize)
 }
 
 Buffer::Buffer (uint32_t dataSize, bool initialize)
+  : m_chain (0),
+    m_chainSize (0)
 {
   NS_LOG_FUNCTION (this << dataSize << initialize);
   if (initialize == true)
@@ -244,14 +193,17 @@ void
 Buffer::Initialize (uint32_t zeroSize)
 {
   NS_LOG_FUNCTION (this << zeroSize);
-  m_data = Buffer::Create (0);
-  m_start = std::min (m_data->m_size, g_recommendedStart);
+  uint32_t recommendedStart = g_recommendedStart.load (std::memory_order_relaxed);
+  m_data = Buffer::Create (recommendedStart);
+  m_start = std::min (m_data->m_size, recommendedStart);
   m_maxZeroAreaStart = m_start;
   m_zeroAreaStart = m_start;
   m_zeroAreaEnd = m_zeroAreaStart + zeroSize;
   m_end = m_zeroAreaEnd;
   m_data->m_dirtyStart = m_start;
   m_data->m_dirtyEnd = m_end;
+  m_chain = 0;
+  m_chainSize = 0;
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -259,6 +211,16 @@ Buffer &
 Buffer::operator = (Buffer const&o)
 {
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != o.m_chain)
+    {
+      if (o.m_chain != 0)
+        {
+          o.m_chain->m_count++;
+        }
+      ReleaseChain ();
+      m_chain = o.m_chain;
+    }
+  m_chainSize = o.m_chainSize;
   if (m_data != o.m_data) 
     {
       // not assignment to self.
@@ -270,7 +232,7 @@ Buffer::operator = (Buffer const&o)
       m_data = o.m_data;
       m_data->m_count++;
     }
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+  UpdateRecommendedStart ();
   m_maxZeroAreaStart = o.m_maxZeroAreaStart;
   m_zeroAreaStart = o.m_zeroAreaStart;
   m_zeroAreaEnd = o.m_zeroAreaEnd;
@@ -284,7 +246,8 @@ Buffer::~Buffer ()
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
-  g_recommendedStart = std::max (g_recommendedStart, m_maxZeroAreaStart);
+  UpdateRecommendedStart ();
+  ReleaseChain ();
   m_data->m_count--;
   if (m_data->m_count == 0) 
     {
@@ -292,6 +255,138 @@ Buffer::~Buffer ()
     }
 }
 
+void
+Buffer::ReleaseChain (void)
+{
+  if (m_chain != 0)
+    {
+      m_chain->m_count--;
+      if (m_chain->m_count == 0)
+        {
+          delete m_chain;
+        }
+      m_chain = 0;
+      m_chainSize = 0;
+    }
+}
+
+void
+Buffer::MakeChainWritable (void)
+{
+  NS_LOG_FUNCTION (this);
+  if (m_chain == 0)
+    {
+      m_chain = new Chain ();
+      m_chain->m_count = 1;
+    }
+  else if (m_chain->m_count > 1)
+    {
+      // The segments are shared by copying the Buffers, not their bytes.
+      Chain *chain = new Chain ();
+      chain->m_count = 1;
+      chain->m_segments = m_chain->m_segments;
+      m_chain->m_count--;
+      m_chain = chain;
+    }
+}
+
+Buffer
+Buffer::GetHead (void) const
+{
+  NS_LOG_FUNCTION (this);
+  Buffer head = *this;
+  head.ReleaseChain ();
+  return head;
+}
+
+void
+Buffer::Flatten (uint32_t start) const
+{
+  NS_LOG_FUNCTION (this << start);
+  NS_ASSERT (m_chain != 0);
+  uint32_t nSegments = m_chain->m_segments.size () + 1;
+
+  // Keep the longest run of virtual zero bytes of the segments, merged
+  // across the segments which hold only zero bytes, as the zero area of
+  // the flattened buffer: the payload of reassembled packets stays
+  // virtual.
+  uint32_t zeroStart = 0;
+  uint32_t zeroSize = 0;
+  uint32_t runStart = 0;
+  uint32_t offset = 0;
+  for (uint32_t k = 0; k < nSegments; k++)
+    {
+      const Buffer &segment = (k == 0) ? *this : m_chain->m_segments[k - 1];
+      if (segment.m_zeroAreaStart != segment.m_start)
+        {
+          offset += segment.m_zeroAreaStart - segment.m_start;
+          runStart = offset;
+        }
+      offset += segment.m_zeroAreaEnd - segment.m_zeroAreaStart;
+      if (offset - runStart > zeroSize)
+        {
+          zeroStart = runStart;
+          zeroSize = offset - runStart;
+        }
+      if (segment.m_end != segment.m_zeroAreaEnd)
+        {
+          offset += segment.m_end - segment.m_zeroAreaEnd;
+          runStart = offset;
+        }
+    }
+
+  // Allocated as a full copy, with the room left by the pool for the
+  // headers, up to the recommended start.
+  uint32_t recommendedStart = g_recommendedStart.load (std::memory_order_relaxed);
+  uint32_t size = GetSize ();
+  uint32_t realSize = size - zeroSize;
+  Buffer tmp (0, false);
+  tmp.m_data = Buffer::Create (std::max (recommendedStart, start + realSize));
+  tmp.m_start = std::max (start, std::min (recommendedStart, tmp.m_data->m_size - realSize));
+  tmp.m_maxZeroAreaStart = tmp.m_start;
+  tmp.m_zeroAreaStart = tmp.m_start + zeroStart;
+  tmp.m_zeroAreaEnd = tmp.m_zeroAreaStart + zeroSize;
+  tmp.m_end = tmp.m_start + size;
+  tmp.m_data->m_dirtyStart = tmp.m_start;
+  tmp.m_data->m_dirtyEnd = tmp.m_end;
+
+  uint8_t *to = tmp.m_data->m_data + tmp.m_start;
+  offset = 0;
+  for (uint32_t k = 0; k < nSegments; k++)
+    {
+      const Buffer &segment = (k == 0) ? *this : m_chain->m_segments[k - 1];
+      uint32_t dataStart = segment.m_zeroAreaStart - segment.m_start;
+      uint32_t zeroes = segment.m_zeroAreaEnd - segment.m_zeroAreaStart;
+      uint32_t dataEnd = segment.m_end - segment.m_zeroAreaEnd;
+      memcpy (to, segment.m_data->m_data + segment.m_start, dataStart);
+      to += dataStart;
+      offset += dataStart;
+      if (offset < zeroStart || offset >= zeroStart + zeroSize)
+        {
+          memset (to, 0, zeroes);
+          to += zeroes;
+        }
+      offset += zeroes;
+      memcpy (to, segment.m_data->m_data + segment.m_zeroAreaStart, dataEnd);
+      to += dataEnd;
+      offset += dataEnd;
+    }
+  NS_ASSERT (to == tmp.m_data->m_data + tmp.m_start + realSize);
+  *const_cast<Buffer *> (this) = tmp;
+  NS_ASSERT (CheckInternalState ());
+}
+
+void
+Buffer::UpdateRecommendedStart (void) const
+{
+  // A heuristic only: the buffers destroyed at the same time by two
+  // threads may lose one of the updates.
+  if (m_maxZeroAreaStart > g_recommendedStart.load (std::memory_order_relaxed))
+    {
+      g_recommendedStart.store (m_maxZeroAreaStart, std::memory_order_relaxed);
+    }
+}
+
 uint32_t
 Buffer::GetInternalSize (void) const
 {
@@ -310,6 +405,11 @@ Buffer::AddAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0)
+    {
+      // Copy the bytes once, leaving room for the new ones.
+      Flatten (start);
+    }
   bool isDirty = m_data->m_count > 1 && m_start > m_data->m_dirtyStart;
   if (m_start >= start && !isDirty)
     {
@@ -355,6 +455,10 @@ Buffer::AddAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0)
+    {
+      Flatten (0);
+    }
   bool isDirty = m_data->m_count > 1 && m_end < m_data->m_dirtyEnd;
   if (GetInternalEnd () + end <= m_data->m_size && !isDirty)
     {
@@ -400,7 +504,24 @@ void
 Buffer::AddAtEnd (const Buffer &o)
 {
   NS_LOG_FUNCTION (this << &o);
-  if (m_data->m_count == 1 &&
+  if (o.GetSize () == 0)
+    {
+      return;
+    }
+  if (GetSize () == 0)
+    {
+      *this = o;
+      return;
+    }
+  if (&o == this)
+    {
+      Buffer copy = o;
+      AddAtEnd (copy);
+      return;
+    }
+  if (m_chain == 0 &&
+      o.m_chain == 0 &&
+      m_data->m_count == 1 &&
       m_end == m_zeroAreaEnd &&
       m_end == m_data->m_dirtyEnd &&
       o.m_start == o.m_zeroAreaStart &&
@@ -425,15 +546,41 @@ Buffer::AddAtEnd (const Buffer &o)
       NS_ASSERT (CheckInternalState ());
       return;
     }
+  if (m_chain == 0 &&
+      o.m_chain == 0 &&
+      o.m_data != m_data &&
+      o.m_zeroAreaStart == o.m_zeroAreaEnd &&
+      !(m_data->m_count > 1 && m_end < m_data->m_dirtyEnd) &&
+      GetInternalEnd () + o.GetSize () <= m_data->m_size)
+    {
+      /**
+       * The bytes of o fit in the room at the end of our BufferData:
+       * copying them there now is cheaper than flattening the chain
+       * later.
+       */
+      uint32_t size = o.GetSize ();
+      AddAtEnd (size);
+      Buffer::Iterator dst = End ();
+      dst.Prev (size);
+      dst.Write (o.Begin (), o.End ());
+      NS_ASSERT (CheckInternalState ());
+      return;
+    }
 
-  Buffer dst = CreateFullCopy ();
-  Buffer src = o.CreateFullCopy ();
-
-  dst.AddAtEnd (src.GetSize ());
-  Buffer::Iterator destStart = dst.End ();
-  destStart.Prev (src.GetSize ());
-  destStart.Write (src.Begin (), src.End ());
-  *this = dst;
+  // Append the head and the segments of o to the chain: they share
+  // the BufferData of o, no byte is copied.
+  MakeChainWritable ();
+  if (o.m_end != o.m_start)
+    {
+      m_chain->m_segments.push_back (o.GetHead ());
+    }
+  if (o.m_chain != 0)
+    {
+      m_chain->m_segments.insert (m_chain->m_segments.end (),
+                                  o.m_chain->m_segments.begin (),
+                                  o.m_chain->m_segments.end ());
+    }
+  m_chainSize += o.GetSize ();
   NS_ASSERT (CheckInternalState ());
 }
 
@@ -442,6 +589,15 @@ Buffer::RemoveAtStart (uint32_t start)
 {
   NS_LOG_FUNCTION (this << start);
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0 && start > m_end - m_start)
+    {
+      if (start < GetSize ())
+        {
+          *this = CreateFragment (start, GetSize () - start);
+          return;
+        }
+      ReleaseChain ();
+    }
   uint32_t newStart = m_start + start;
   if (newStart <= m_zeroAreaStart)
     {
@@ -487,6 +643,15 @@ Buffer::RemoveAtEnd (uint32_t end)
 {
   NS_LOG_FUNCTION (this << end);
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0)
+    {
+      if (end < GetSize ())
+        {
+          *this = CreateFragment (0, GetSize () - end);
+          return;
+        }
+      ReleaseChain ();
+    }
   uint32_t newEnd = m_end - std::min (end, m_end - m_start);
   if (newEnd > m_zeroAreaEnd)
     {
@@ -523,6 +688,32 @@ Buffer::CreateFragment (uint32_t start, uint32_t length) const
 {
   NS_LOG_FUNCTION (this << start << length);
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0)
+    {
+      // Assemble the fragment from the fragments of the segments
+      // which it overlaps.
+      uint32_t end = start + length;
+      Buffer tmp = GetHead ();
+      uint32_t offset = tmp.GetSize ();
+      if (offset >= end)
+        {
+          return tmp.CreateFragment (start, length);
+        }
+      tmp.RemoveAtStart (start);
+      for (std::vector<Buffer>::const_iterator i = m_chain->m_segments.begin ();
+           i != m_chain->m_segments.end () && offset < end; ++i)
+        {
+          uint32_t size = i->GetSize ();
+          if (offset + size > start)
+            {
+              uint32_t from = std::max (start, offset) - offset;
+              uint32_t to = std::min (end, offset + size) - offset;
+              tmp.AddAtEnd (i->CreateFragment (from, to - from));
+            }
+          offset += size;
+        }
+      return tmp;
+    }
   Buffer tmp = *this;
   tmp.RemoveAtStart (start);
   tmp.RemoveAtEnd (GetSize () - (start + length));
@@ -535,18 +726,24 @@ Buffer::CreateFullCopy (void) const
 {
   NS_LOG_FUNCTION (this);
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0)
+    {
+      // The flattened buffer may still have a zero area.
+      Buffer tmp = *this;
+      tmp.Flatten (0);
+      return tmp.CreateFullCopy ();
+    }
   if (m_zeroAreaEnd - m_zeroAreaStart != 0) 
     {
-      Buffer tmp;
-      tmp.AddAtStart (m_zeroAreaEnd - m_zeroAreaStart);
-      tmp.Begin ().WriteU8 (0, m_zeroAreaEnd - m_zeroAreaStart);
+      // Allocate the whole copy at once.
+      uint32_t zeroSize = m_zeroAreaEnd - m_zeroAreaStart;
       uint32_t dataStart = m_zeroAreaStart - m_start;
-      tmp.AddAtStart (dataStart);
-      tmp.Begin ().Write (m_data->m_data+m_start, dataStart);
       uint32_t dataEnd = m_end - m_zeroAreaEnd;
-      tmp.AddAtEnd (dataEnd);
-      Buffer::Iterator i = tmp.End ();
-      i.Prev (dataEnd);
+      Buffer tmp;
+      tmp.AddAtStart (dataStart + zeroSize + dataEnd);
+      Buffer::Iterator i = tmp.Begin ();
+      i.Write (m_data->m_data+m_start, dataStart);
+      i.WriteU8 (0, zeroSize);
       i.Write (m_data->m_data+m_zeroAreaStart,dataEnd);
       NS_ASSERT (tmp.CheckInternalState ());
       return tmp;
@@ -559,6 +756,10 @@ uint32_t
 Buffer::GetSerializedSize (void) const
 {
   NS_LOG_FUNCTION (this);
+  if (m_chain != 0)
+    {
+      Flatten (0);
+    }
   uint32_t dataStart = (m_zeroAreaStart - m_start + 3) & (~0x3);
   uint32_t dataEnd = (m_end - m_zeroAreaEnd + 3) & (~0x3);
 
@@ -579,6 +780,10 @@ uint32_t
 Buffer::Serialize (uint8_t* buffer, uint32_t maxSize) const
 {
   NS_LOG_FUNCTION (this << &buffer << maxSize);
+  if (m_chain != 0)
+    {
+      Flatten (0);
+    }
   uint32_t* p = reinterpret_cast<uint32_t *> (buffer);
   uint32_t size = 0;
 
@@ -715,6 +920,7 @@ void
 Buffer::CopyData (std::ostream *os, uint32_t size) const
 {
   NS_LOG_FUNCTION (this << &os << size);
+  uint32_t left = size - std::min (size, m_end - m_start);
   if (size > 0)
     {
       uint32_t tmpsize = std::min (m_zeroAreaStart-m_start, size);
@@ -738,6 +944,16 @@ Buffer::CopyData (std::ostream *os, uint32_t size) const
             }
         }
     }
+  if (m_chain != 0)
+    {
+      for (std::vector<Buffer>::const_iterator i = m_chain->m_segments.begin ();
+           i != m_chain->m_segments.end () && left > 0; ++i)
+        {
+          uint32_t toWrite = std::min (left, i->GetSize ());
+          i->CopyData (os, toWrite);
+          left -= toWrite;
+        }
+    }
 }
 
 uint32_t 
@@ -767,10 +983,21 @@ Buffer::CopyData (uint8_t *buffer, uint32_t size) const
             {
               tmpsize = std::min (m_end - m_zeroAreaEnd, size);
               memcpy (buffer, (const char*)(m_data->m_data + m_zeroAreaStart), tmpsize);
+              buffer += tmpsize;
               size -= tmpsize;
             }
         }
     }
+  if (m_chain != 0)
+    {
+      for (std::vector<Buffer>::const_iterator i = m_chain->m_segments.begin ();
+           i != m_chain->m_segments.end () && size > 0; ++i)
+        {
+          uint32_t copied = i->CopyData (buffer, size);
+          buffer += copied;
+          size -= copied;
+        }
+    }
   return originalSize - size;
 }
 
@@ -843,25 +1070,36 @@ Buffer::Iterator::Write (Iterator start, Iterator end)
   uint32_t size = end.m_current - start.m_current;
   NS_ASSERT_MSG (CheckNoZero (m_current, m_current + size),
                  GetWriteErrorMessage ());
+  // The written bytes are all before, or all after, our zero area.
+  uint8_t *to;
+  if (m_current <= m_zeroStart)
+    {
+      to = &m_data[m_current];
+    }
+  else
+    {
+      to = &m_data[m_current - (m_zeroEnd - m_zeroStart)];
+    }
   if (start.m_current <= start.m_zeroStart)
     {
       uint32_t toCopy = std::min (size, start.m_zeroStart - start.m_current);
-      memcpy (&m_data[m_current], &start.m_data[start.m_current], toCopy);
+      memcpy (to, &start.m_data[start.m_current], toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   if (start.m_current <= start.m_zeroEnd)
     {
       uint32_t toCopy = std::min (size, start.m_zeroEnd - start.m_current);
-      memset (&m_data[m_current], 0, toCopy);
+      memset (to, 0, toCopy);
       start.m_current += toCopy;
       m_current += toCopy;
+      to += toCopy;
       size -= toCopy;
     }
   uint32_t toCopy = std::min (size, start.m_dataEnd - start.m_current);
   uint8_t *from = &start.m_data[start.m_current - (start.m_zeroEnd-start.m_zeroStart)];
-  uint8_t *to = &m_data[m_current];
   memcpy (to, from, toCopy);
   m_current += toCopy;
 }
@@ -23,7 +23,9 @@
 #include <stdint.h>
 #include <vector>
 #include <ostream>
+#include <atomic>
 #include "ns3/assert.h"
+#include "packet-data-pool.h"
 
 #define BUFFER_FREE_LIST 1
 
@@ -38,9 +40,9 @@ namespace ns3 {
  * automatically adjusted to hold any data prepended
  * or appended by the user. Its implementation is optimized
  * to ensure that the number of buffer resizes is minimized,
- * by creating new Buffers of the maximum size ever used.
- * The correct maximum size is learned at runtime during use by 
- * recording the maximum size of each packet.
+ * by reserving room in new Buffers for the largest headers ever
+ * added.  The correct size is learned at runtime during use by
+ * recording the maximum size of the headers of each packet.
  *
  * \internal
  * The implementation of the Buffer class uses a COW (Copy On Write)
@@ -88,6 +90,20 @@ namespace ns3 {
  * \endverbatim
  *
  * A simple state invariant is that m_start <= m_zeroStart <= m_zeroEnd <= m_end
+ *
+ * Appending a Buffer to another one does not copy its bytes: the
+ * appended Buffer is kept as a list of segments, the "chain", after
+ * the bytes described above, which are the "head" of the Buffer.
+ * Each segment is a Buffer without a chain of its own, which shares
+ * the BufferData of the Buffer it was taken from, so that
+ * fragmenting and reassembling a Buffer copy no payload byte.  The
+ * chain is reference-counted and shared by the copies of a Buffer:
+ * it is never modified while shared.  The Iterator only walks
+ * contiguous bytes, so that a chained Buffer is flattened into a
+ * single new BufferData, once, when an Iterator is created on it
+ * or when bytes are added to it.  The longest run of zero bytes of
+ * the chain stays the zero area of the flattened Buffer, so that
+ * reassembled zero-filled payloads are not written either.
  */
 class Buffer 
 {
@@ -641,6 +657,17 @@ private:
    */
   Buffer (uint32_t dataSize, bool initialize);
   ~Buffer ();
+
+  /**
+   * \brief Get the pool of the buffer data storage.
+   *
+   * The pool recycles the data storage of the buffers of each
+   * thread; it can be used to set the size of its free lists, and
+   * to read its statistics.
+   *
+   * \returns the pool of the buffer data storage.
+   */
+  static PacketDataPool & GetDataPool (void);
 private:
   /**
    * This data structure is variable-sized through its last member whose size
@@ -696,6 +723,26 @@ private:
    * \brief Transform a "Virtual byte buffer" into a "Real byte buffer"
    */
   void TransformIntoRealBuffer (void) const;
+  /**
+   * \brief Copy the head and the chain of segments of the buffer
+   * into a single new BufferData.
+   * \param start the number of bytes to reserve before the data
+   */
+  void Flatten (uint32_t start) const;
+  /**
+   * \brief Get the head of the buffer, without its chain of segments.
+   * \returns the head of the buffer.
+   */
+  Buffer GetHead (void) const;
+  /**
+   * \brief Drop the reference of the buffer to its chain of segments.
+   */
+  void ReleaseChain (void);
+  /**
+   * \brief Make sure that the buffer has a chain of segments,
+   * which it does not share with other buffers.
+   */
+  void MakeChainWritable (void);
   /**
    * \brief Checks the internal buffer structures consistency
    *
@@ -748,6 +795,12 @@ private:
    */
   static void Deallocate (struct Buffer::Data *data);
 
+  /**
+   * The segments appended after the head of a Buffer, shared by the
+   * copies of the Buffer.
+   */
+  struct Chain;
+
   struct Data *m_data; //!< the buffer data storage
 
   /**
@@ -766,7 +819,7 @@ private:
    * writing data. i.e., m_start should be initialized to this 
    * value.
    */
-  static uint32_t g_recommendedStart;
+  static std::atomic<uint32_t> g_recommendedStart;
 
   /**
    * offset to the start of the virtual zero area from the start
@@ -788,19 +841,32 @@ private:
    * instance from the start of m_data->m_data
    */
   uint32_t m_end;
+  /**
+   * the segments appended after the head, or zero if none.
+   */
+  struct Chain *m_chain;
+  /**
+   * the number of bytes of the segments of m_chain.
+   */
+  uint32_t m_chainSize;
 
-#ifdef BUFFER_FREE_LIST
-  /// Container for buffer data
-  typedef std::vector<struct Buffer::Data*> FreeList;
-  /// Local static destructor structure
-  struct LocalStaticDestructor 
-  {
-    ~LocalStaticDestructor ();
-  };
-  static uint32_t g_maxSize; //!< Max observed data size
-  static FreeList *g_freeList; //!< Buffer data container
-  static struct LocalStaticDestructor g_localStaticDestructor; //!< Local static destructor
-#endif
+  /**
+   * \brief Raise g_recommendedStart to m_maxZeroAreaStart.
+   */
+  void UpdateRecommendedStart (void) const;
+};
+
+struct Buffer::Chain
+{
+  /**
+   * The reference count of the chain.  Each buffer which
+   * references the chain holds a count.
+   */
+  uint32_t m_count;
+  /**
+   * The segments, in order.  None of them has a chain.
+   */
+  std::vector<Buffer> m_segments;
 };
 
 } // namespace ns3
@@ -1052,28 +1118,42 @@ Buffer::Buffer (Buffer const&o)
     m_zeroAreaStart (o.m_zeroAreaStart),
     m_zeroAreaEnd (o.m_zeroAreaEnd),
     m_start (o.m_start),
-    m_end (o.m_end)
+    m_end (o.m_end),
+    m_chain (o.m_chain),
+    m_chainSize (o.m_chainSize)
 {
   m_data->m_count++;
+  if (m_chain != 0)
+    {
+      m_chain->m_count++;
+    }
   NS_ASSERT (CheckInternalState ());
 }
 
 uint32_t 
 Buffer::GetSize (void) const
 {
-  return m_end - m_start;
+  return m_end - m_start + m_chainSize;
 }
 
 Buffer::Iterator 
 Buffer::Begin (void) const
 {
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0)
+    {
+      Flatten (0);
+    }
   return Buffer::Iterator (this);
 }
 Buffer::Iterator 
 Buffer::End (void) const
 {
   NS_ASSERT (CheckInternalState ());
+  if (m_chain != 0)
+    {
+      Flatten (0);
+    }
   return Buffer::Iterator (this, false);
 }
 
@@ -19,11 +19,9 @@
  */
 #include "byte-tag-list.h"
 #include "ns3/log.h"
-#include <vector>
 #include <cstring>
 
 #define USE_FREE_LIST 1
-#define FREE_LIST_SIZE 1000
 #define OFFSET_MAX (2147483647)
 
 namespace ns3 {
@@ -44,32 +42,17 @@ struct ByteTagListData {
   uint8_t data[4]; //!< data
 };
 
-#ifdef USE_FREE_LIST
 /**
  * \ingroup packet
- *
- * \brief Container class for struct ByteTagListData
- *
- * Internal use only.
+ * The pool of the byte tag storage.
  */
-static class ByteTagListDataFreeList : public std::vector<struct ByteTagListData *>
-{
-public:
-  ~ByteTagListDataFreeList ();
-} g_freeList; //!< Container for struct ByteTagListData
-static uint32_t g_maxSize = 0; //!< maximum data size (used for allocation)
+static PacketDataPool g_dataPool;
 
-ByteTagListDataFreeList::~ByteTagListDataFreeList ()
+PacketDataPool &
+ByteTagList::GetDataPool (void)
 {
-  NS_LOG_FUNCTION (this);
-  for (ByteTagListDataFreeList::iterator i = begin ();
-       i != end (); i++)
-    {
-      uint8_t *buffer = (uint8_t *)(*i);
-      delete [] buffer;
-    }
+  return g_dataPool;
 }
-#endif /* USE_FREE_LIST */
 
 ByteTagList::Iterator::Item::Item (TagBuffer buf_)
   : buf (buf_)
@@ -193,19 +176,7 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
   NS_LOG_FUNCTION (this << tid << bufferSize << start << end);
   uint32_t spaceNeeded = m_used + bufferSize + 4 + 4 + 4 + 4;
   NS_ASSERT (m_used <= spaceNeeded);
-  if (m_data == 0)
-    {
-      m_data = Allocate (spaceNeeded);
-      m_used = 0;
-    } 
-  else if (m_data->size < spaceNeeded ||
-           (m_data->count != 1 && m_data->dirty != m_used))
-    {
-      struct ByteTagListData *newData = Allocate (spaceNeeded);
-      std::memcpy (&newData->data, &m_data->data, m_used);
-      Deallocate (m_data);
-      m_data = newData;
-    }
+  Reserve (spaceNeeded);
   TagBuffer tag = TagBuffer (&m_data->data[m_used], 
                              &m_data->data[spaceNeeded]);
   tag.WriteU32 (tid.GetUid ());
@@ -225,10 +196,35 @@ ByteTagList::Add (TypeId tid, uint32_t bufferSize, int32_t start, int32_t end)
   return tag;
 }
 
+void
+ByteTagList::Reserve (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  if (m_data == 0)
+    {
+      m_data = Allocate (size);
+      m_used = 0;
+    } 
+  else if (m_data->size < size ||
+           (m_data->count != 1 && m_data->dirty != m_used))
+    {
+      struct ByteTagListData *newData = Allocate (size);
+      std::memcpy (&newData->data, &m_data->data, m_used);
+      Deallocate (m_data);
+      m_data = newData;
+    }
+}
+
 void 
 ByteTagList::Add (const ByteTagList &o)
 {
   NS_LOG_FUNCTION (this << &o);
+  if (o.m_used == 0)
+    {
+      return;
+    }
+  // Make room for all the tags of o at once.
+  Reserve (m_used + o.m_used);
   ByteTagList::Iterator i = o.BeginAll ();
   while (i.HasNext ())
     {
@@ -282,6 +278,7 @@ ByteTagList::AddAtEnd (int32_t appendOffset)
       return;
     }
   ByteTagList list;
+  list.Reserve (m_used);
   ByteTagList::Iterator i = BeginAll ();
   while (i.HasNext ())
     {
@@ -315,6 +312,7 @@ ByteTagList::AddAtStart (int32_t prependOffset)
     }
   m_minStart = INT32_MAX;
   ByteTagList list;
+  list.Reserve (m_used);
   ByteTagList::Iterator i = BeginAll ();
   while (i.HasNext ())
     {
@@ -344,24 +342,12 @@ struct ByteTagListData *
 ByteTagList::Allocate (uint32_t size)
 {
   NS_LOG_FUNCTION (this << size);
-  while (!g_freeList.empty ())
-    {
-      struct ByteTagListData *data = g_freeList.back ();
-      g_freeList.pop_back ();
-      NS_ASSERT (data != 0);
-      if (data->size >= size)
-        {
-          data->count = 1;
-          data->dirty = 0;
-          return data;
-        }
-      uint8_t *buffer = (uint8_t *)data;
-      delete [] buffer;
-    }
-  uint8_t *buffer = new uint8_t [std::max (size, g_maxSize) + sizeof (struct ByteTagListData) - 4];
-  struct ByteTagListData *data = (struct ByteTagListData *)buffer;
+  uint32_t capacity;
+  void *buffer = g_dataPool.Allocate (size + sizeof (struct ByteTagListData) - 4, &capacity);
+  struct ByteTagListData *data = static_cast<struct ByteTagListData *> (buffer);
   data->count = 1;
-  data->size = size;
+  // Use the whole block, rounded up by the pool.
+  data->size = capacity + 4 - sizeof (struct ByteTagListData);
   data->dirty = 0;
   return data;
 }
@@ -374,20 +360,10 @@ ByteTagList::Deallocate (struct ByteTagListData *data)
     {
       return;
     }
-  g_maxSize = std::max (g_maxSize, data->size);
   data->count--;
   if (data->count == 0)
     {
-      if (g_freeList.size () > FREE_LIST_SIZE ||
-          data->size < g_maxSize)
-        {
-          uint8_t *buffer = (uint8_t *)data;
-          delete [] buffer;
-        }
-      else
-        {
-          g_freeList.push_back (data);
-        }
+      g_dataPool.Deallocate (data, data->size + sizeof (struct ByteTagListData) - 4);
     }
 }
 
@@ -24,6 +24,7 @@
 #include <stdint.h>
 #include "ns3/type-id.h"
 #include "tag-buffer.h"
+#include "packet-data-pool.h"
 
 namespace ns3 {
 
@@ -225,6 +226,12 @@ private:
    */
   void AddAtStart (int32_t prependOffset);
 
+  /**
+   * \brief Get the pool which recycles the tag storage.
+   * \returns the pool of the byte tag storage.
+   */
+  static PacketDataPool & GetDataPool (void);
+
 private:
   /**
    * \brief Returns an iterator pointing to the very first tag in this list.
@@ -233,6 +240,13 @@ private:
    */
   ByteTagList::Iterator BeginAll (void) const;
 
+  /**
+   * \brief Make sure that the tags can be written in place, up to
+   * \p size bytes, copying them to a larger ByteTagListData if needed.
+   * \param size the number of bytes of tags to hold
+   */
+  void Reserve (uint32_t size);
+
   /**
    * \brief Allocate the memory for the ByteTagListData
    * \param size the memory to allocate
@@ -20,7 +20,7 @@
 
 /**
 \file   packet-tag-list.cc
-\brief  Implements a linked list of Packet tags, including copy-on-write semantics.
+\brief  Implements a copy-on-write array of Packet tags.
 */
 
 #include "packet-tag-list.h"
@@ -28,261 +28,219 @@
 #include "tag.h"
 #include "ns3/fatal-error.h"
 #include "ns3/log.h"
-#include <cstring>
+#include <algorithm>
+#include <cstddef>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("PacketTagList");
 
-bool
-PacketTagList::COWTraverse (Tag & tag, PacketTagList::COWWriter Writer)
-{
-  TypeId tid = tag.GetInstanceTypeId ();
-  NS_LOG_FUNCTION (this << tid);
-  NS_LOG_INFO     ("looking for " << tid);
+namespace {
 
-  // trivial case when list is empty
-  if (m_next == 0)
-    {
-      return false;
-    }
-
-  bool found = false;
+/**
+ * \ingroup packet
+ * The number of tags the array of a list is first allocated for:
+ * the packets of wifi, LTE or flow-monitor carry a few tags.
+ */
+const uint32_t INITIAL_TAGS = 4;
 
-  struct TagData ** prevNext = &m_next; // previous node's next pointer
-  struct TagData  * cur      =  m_next; // cursor to current node
-  struct TagData  * it = 0;             // utility
+/**
+ * \ingroup packet
+ * The pool of the packet tag storage.
+ */
+PacketDataPool g_dataPool;
 
-  // Search from the head of the list until we find tid or a merge
-  while (cur != 0)
-    {
-      if (cur->count > 1)
-        {
-          // found merge
-          NS_LOG_INFO ("found initial merge before tid");
-          break;
-        }
-      else if (cur->tid == tid)
-        {
-          NS_LOG_INFO ("found tid before initial merge, calling writer");
-          found = (this->*Writer)(tag, true, cur, prevNext);
-          break;
-        }
-      else
-        {
-          // no merge or tid found yet, move on
-          prevNext = &cur->next;
-          cur      =  cur->next;
-        }
-    }  // while !found && !cow
+} // unnamed namespace
 
-  // did we find it or run out of tags?
-  if (cur == 0 || found)
-    {
-      NS_LOG_INFO ("returning after header with found: " << found);
-      return found;
-    }
+PacketDataPool &
+PacketTagList::GetDataPool (void)
+{
+  return g_dataPool;
+}
 
-  // From here on out, we have to copy the list
-  // until we find tid, then link past it
+struct PacketTagList::Data *
+PacketTagList::Allocate (uint32_t size)
+{
+  NS_LOG_FUNCTION (size);
+  uint32_t capacity;
+  void *buffer = g_dataPool.Allocate (offsetof (struct Data, m_tags)
+                                      + size * sizeof (struct TagData),
+                                      &capacity);
+  struct Data *data = static_cast<struct Data *> (buffer);
+  data->m_count = 1;
+  // Use the whole block, rounded up by the pool.
+  data->m_size = (capacity - offsetof (struct Data, m_tags)) / sizeof (struct TagData);
+  data->m_dirty = 0;
+  data->m_capacity = capacity;
+  return data;
+}
 
-  // Before we do all that work, let's make sure tid really exists
-  for (it = cur; it != 0; it = it->next)
-    {
-      if (it->tid == tid)
-        {
-          break;
-        }
-    }
-  if (it == 0)
+void
+PacketTagList::Deallocate (struct Data *data)
+{
+  NS_LOG_FUNCTION (data);
+  data->m_count--;
+  if (data->m_count == 0)
     {
-      // got to end of list without finding tid
-      NS_LOG_INFO ("tid not found after first merge");
-      return found;
+      g_dataPool.Deallocate (data, data->m_capacity);
     }
+}
 
-  // At this point cur is a merge, but untested for tid
-  NS_ASSERT (cur != 0);
-  NS_ASSERT (cur->count > 1);
-
-  /*
-     Walk the remainder of the list, copying, until we find tid
-     As we put a copy of the cur node onto our list,
-     we move the merge point down the list.
-
-     Starting position                  End position
-       T1 is a merge                     T1.count decremented
-                                         T2 is a merge
-                                         T1' is a copy of T1
-
-          other                             other
-               \                                 \
-      Prev  ->  T1  ->  T2  -> ...                T1  ->  T2  -> ...
-           /   /                                         /|
-      pNext cur                         Prev  ->  T1' --/ |
-                                                     /    |
-                                                pNext   cur
-
-     When we reach tid, we link past it, decrement count, and we're done.
-  */
-
-  // Should normally check for null cur pointer,
-  // but since we know tid exists, we'll skip this test
-  while ( /* cur && */ cur->tid != tid)
+void
+PacketTagList::Unshare (uint32_t size)
+{
+  NS_LOG_FUNCTION (this << size);
+  NS_ASSERT (size >= m_used);
+  struct Data *data = Allocate (size);
+  if (m_data != 0)
     {
-      NS_ASSERT (cur != 0);
-      NS_ASSERT (cur->count > 1);
-      cur->count--;                       // unmerge cur
-      struct TagData * copy = new struct TagData ();
-      copy->tid = cur->tid;
-      copy->count = 1;
-      memcpy (copy->data, cur->data, TagData::MAX_SIZE);
-      copy->next = cur->next;             // merge into tail
-      copy->next->count++;                // mark new merge
-      *prevNext = copy;                   // point prior list at copy
-      prevNext = &copy->next;             // advance
-      cur      =  copy->next;
+      std::copy (m_data->m_tags, m_data->m_tags + m_used, data->m_tags);
+      Deallocate (m_data);
     }
-  // Sanity check:
-  NS_ASSERT (cur != 0);                 // cur should be non-zero
-  NS_ASSERT (cur->tid == tid);          // cur->tid should be tid
-  NS_ASSERT (cur->count > 1);           // cur should be a merge
-
-  // link around tid, removing it from our list
-  found = (this->*Writer)(tag, false, cur, prevNext);
-  return found;
-
+  data->m_dirty = m_used;
+  m_data = data;
 }
 
-bool
-PacketTagList::Remove (Tag & tag)
+void
+PacketTagList::Detach (void)
 {
-  return COWTraverse (tag, &PacketTagList::RemoveWriter);
+  NS_LOG_FUNCTION (this);
+  if (m_data != 0 && m_data->m_count != 1)
+    {
+      Unshare (m_used);
+    }
 }
 
-// COWWriter implementing Remove
-bool
-PacketTagList::RemoveWriter (Tag & tag, bool preMerge,
-                             struct PacketTagList::TagData  * cur,
-                             struct PacketTagList::TagData ** prevNext)
+uint32_t
+PacketTagList::Find (TypeId tid) const
 {
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  tag.Deserialize (TagBuffer (cur->data,
-                              cur->data + TagData::MAX_SIZE));
-  *prevNext = cur->next;            // link around cur
-
-  if (preMerge)
+  if ((m_mask & GetMask (tid)) == 0)
     {
-      // found tid before first merge, so delete cur
-      delete cur;
+      return m_used;
     }
-  else
+  // From the last tag added, which is the first one removed.
+  for (uint32_t i = m_used; i-- > 0; )
     {
-      // cur is always a merge at this point
-      // unmerge cur, since we linked around it already
-      cur->count--;
-      if (cur->next != 0)
+      if (m_data->m_tags[i].tid == tid)
         {
-          // there's a next, so make it a merge
-          cur->next->count++;
+          return i;
         }
     }
-  return found;
+  return m_used;
 }
 
-bool
-PacketTagList::Replace (Tag & tag)
+void 
+PacketTagList::Add (const Tag &tag) const
 {
-  bool found = COWTraverse (tag, &PacketTagList::ReplaceWriter);
-  if (!found)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  // ensure this id was not yet added
+  NS_ASSERT_MSG (Find (tid) == m_used, "Error: cannot add the same kind of tag twice.");
+  NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
+
+  PacketTagList *self = const_cast<PacketTagList *> (this);
+  if (m_data == 0)
     {
-      Add (tag);
+      self->m_data = Allocate (INITIAL_TAGS);
+    }
+  else if (m_data->m_size == m_used
+           || (m_data->m_count != 1 && m_data->m_dirty != m_used))
+    {
+      // Full, or another list has written after our tags.
+      self->Unshare (m_used + 1);
     }
-  return found;
+  struct TagData *cur = &m_data->m_tags[m_used];
+  cur->tid = tid;
+  tag.Serialize (TagBuffer (cur->data, cur->data + tag.GetSerializedSize ()));
+  self->m_used++;
+  self->m_mask |= GetMask (tid);
+  m_data->m_dirty = m_used;
 }
 
-// COWWriter implementing Replace
 bool
-PacketTagList::ReplaceWriter (Tag & tag, bool preMerge,
-                              struct PacketTagList::TagData  * cur,
-                              struct PacketTagList::TagData ** prevNext)
+PacketTagList::Remove (Tag & tag)
 {
-  NS_LOG_FUNCTION_NOARGS ();
-
-  // found tid
-  bool found = true;
-  if (preMerge)
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_used)
     {
-      // found tid before first merge, so just rewrite
-      tag.Serialize (TagBuffer (cur->data,
-                                cur->data + tag.GetSerializedSize ()));
+      return false;
     }
-  else
+  struct TagData *cur = &m_data->m_tags[i];
+  tag.Deserialize (TagBuffer (cur->data, cur->data + TagData::MAX_SIZE));
+  if (i != m_used - 1)
     {
-      // cur is always a merge at this point
-      // need to copy, replace, and link past cur
-      cur->count--;                     // unmerge cur
-      struct TagData * copy = new struct TagData ();
-      copy->tid = tag.GetInstanceTypeId ();
-      copy->count = 1;
-      tag.Serialize (TagBuffer (copy->data,
-                                copy->data + tag.GetSerializedSize ()));
-      copy->next = cur->next;           // merge into tail
-      if (copy->next != 0)
+      // Move the later tags down, on a copy if the array is shared.
+      if (m_data->m_count != 1)
         {
-          copy->next->count++;          // mark new merge
+          Unshare (m_used);
         }
-      *prevNext = copy;                 // point prior list at copy
+      std::copy (m_data->m_tags + i + 1, m_data->m_tags + m_used, m_data->m_tags + i);
+    }
+  // The last tag is removed by shortening the list, which does not
+  // disturb the other lists sharing the array.
+  m_used--;
+  if (m_data->m_count == 1)
+    {
+      m_data->m_dirty = m_used;
+    }
+  m_mask = 0;
+  for (uint32_t j = 0; j < m_used; j++)
+    {
+      m_mask |= GetMask (m_data->m_tags[j].tid);
     }
-  return found;
+  return true;
 }
 
-void 
-PacketTagList::Add (const Tag &tag) const
+bool
+PacketTagList::Replace (Tag & tag)
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
-  // ensure this id was not yet added
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  TypeId tid = tag.GetInstanceTypeId ();
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_used)
     {
-      NS_ASSERT_MSG (cur->tid != tag.GetInstanceTypeId (), "Error: cannot add the same kind of tag twice.");
+      Add (tag);
+      return false;
     }
-  struct TagData * head = new struct TagData ();
-  head->count = 1;
-  head->next = 0;
-  head->tid = tag.GetInstanceTypeId ();
-  head->next = m_next;
   NS_ASSERT (tag.GetSerializedSize () <= TagData::MAX_SIZE);
-  tag.Serialize (TagBuffer (head->data, head->data + tag.GetSerializedSize ()));
-
-  const_cast<PacketTagList *> (this)->m_next = head;
+  if (m_data->m_count != 1)
+    {
+      Unshare (m_used);
+    }
+  struct TagData *cur = &m_data->m_tags[i];
+  tag.Serialize (TagBuffer (cur->data, cur->data + tag.GetSerializedSize ()));
+  return true;
 }
 
 bool
 PacketTagList::Peek (Tag &tag) const
 {
-  NS_LOG_FUNCTION (this << tag.GetInstanceTypeId ());
   TypeId tid = tag.GetInstanceTypeId ();
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next) 
+  NS_LOG_FUNCTION (this << tid);
+  uint32_t i = Find (tid);
+  if (i == m_used)
     {
-      if (cur->tid == tid) 
-        {
-          /* found tag */
-          tag.Deserialize (TagBuffer (cur->data, cur->data + TagData::MAX_SIZE));
-          return true;
-        }
+      /* no tag found */
+      return false;
     }
-  /* no tag found */
-  return false;
+  const struct TagData *cur = &m_data->m_tags[i];
+  tag.Deserialize (TagBuffer (const_cast<uint8_t *> (cur->data),
+                              const_cast<uint8_t *> (cur->data) + TagData::MAX_SIZE));
+  return true;
 }
 
 const struct PacketTagList::TagData *
-PacketTagList::Head (void) const
+PacketTagList::Begin (void) const
 {
-  return m_next;
+  return m_data == 0 ? 0 : m_data->m_tags;
 }
 
-} /* namespace ns3 */
+const struct PacketTagList::TagData *
+PacketTagList::End (void) const
+{
+  return m_data == 0 ? 0 : m_data->m_tags + m_used;
+}
 
+} /* namespace ns3 */
@@ -22,12 +22,13 @@
 
 /**
 \file   packet-tag-list.h
-\brief  Defines a linked list of Packet tags, including copy-on-write semantics.
+\brief  Defines a copy-on-write array of Packet tags.
 */
 
 #include <stdint.h>
 #include <ostream>
 #include "ns3/type-id.h"
+#include "packet-data-pool.h"
 
 namespace ns3 {
 
@@ -43,82 +44,36 @@ class Tag;
  *
  * \internal
  *
- * The implementation of this class is a bit tricky.  Refer to this
- * diagram in the discussion that follows.
+ *   - Tags are stored in serialized form, in a single array of TagData
+ *     structures allocated from a PacketDataPool.  The first
+ *     allocation has room for a few tags, which is all most packets
+ *     ever carry, and the array grows when it is full.  The tags are
+ *     kept in the order they were added.
  *
- * \dot
- *    digraph {
- *        rankdir = "LR";
- *        clusterrank = local;
- *        node [ shape = record, fontname="FreeSans", fontsize="10" ];
- *        oth  [ label="<l> Other branch | <n> next | <c> ..." ];
- *        PTL1 [ label="<l> PacketTagList A | <n> m_next" , shape=Mrecord];
- *        PTL2 [ label="<l> PacketTagList B | <n> m_next" , shape=Mrecord];
- *        oth:n  -> T7:l ;
- *        PTL2:n -> T6:l ;
- *        PTL1:n -> T5:l ;
- *        T1   [ label="<l> T1  | <n> next | <c> count = 1" ];
- *        T2   [ label="<l> T2  | <n> next | <c> count = 1" ];
- *        T3   [ label="<l> T3  | <n> next | <c> count = 2" ];
- *        T4   [ label="<l> T4  | <n> next | <c> count = 1" ];
- *        T5   [ label="<l> T5  | <n> next | <c> count = 2" ];
- *        T6   [ label="<l> T6  | <n> next | <c> count = 1" ];
- *        T7   [ label="<l> T7  | <n> next | <c> count = 1" ];
- *        NULL [ label="0", shape = ellipse ];
- *        subgraph cluster_list {
- *          penwidth = 0;
- *          T6:n -> T5:l ;
- *          T5:n -> T4:l ;
- *          T4:n -> T3:l ;
- *          T7:n -> T3:l ;
- *          T3:n -> T2:l ;
- *          T2:n -> T1:l ;
- *          T1:n -> NULL ;
- *        };
- *      }
- * \enddot
+ *   - The array is shared by the copies of a PacketTagList and,
+ *     thus, reference-counted.  Each PacketTagList holds the number
+ *     of tags of the array which belong to it, while the array
+ *     records the number of tags written by any of the lists which
+ *     share it (the "dirty" tags, as in the ByteTagList).
  *
- *   - Tags are stored in serialized form in a tree of TagData
- *     structures. (<tt>T1-T7</tt> in the diagram)
- *
- *   - Each TagData points (\c next pointers in the diagram)
- *     toward the root of the tree, which is a null pointer.
- *
- *   - \c count is the number of incoming pointers to this
- *     TagData.  Branch points, where branches merge or join, have
- *     <tt>count \> 1</tt> (\c T3, \c T5); successive links along
- *     a branch have <tt>count = 1</tt> (\c T1, \c T2, \c T4, \c T6, \c T7).
- *
- *   - Each PacketTagList points to a specific TagData,
- *     which is the most recent Tag added to the packet. (<tt>T5-T7</tt>)
- *
- *   - Conceptually, therefore, each Packet has a PacketTagList which
- *     points to a singly-linked list of TagData.
+ *   - Each PacketTagList also holds a mask of the hashes of the
+ *     TypeId's of its tags, so that looking for a tag which is not
+ *     in the list does not look at the array at all.
  *
  * \par <b> Copy-on-write </b> is implemented as follows:
  *
- *   - #Add prepends the new tag to the list (growing that branch of the tree,
- *     as \c T6). This is a constant time operation, and does not affect
- *     any other #PacketTagList's, hence this is a \c const function.
- *
  *   - Copy constructor (PacketTagList(const PacketTagList & o))
  *     and assignment (#operator=(const PacketTagList & o))
- *     simply join the tree at the same place as the original
- *     PacketTagList \c o, incrementing the \c count.
- *     For assignment, the old branch is deleted, up to
- *     the first branch point, which has its \c count decremented.
- *     (PacketTagList \c B started as a copy of PacketTagList \c A,
- *     before \c T6 was added to \c B).
+ *     simply share the array of \c o, incrementing its count.
+ *
+ *   - #Add writes the new tag after the tags of the list, in place,
+ *     if no other list sharing the array has written there, and
+ *     copies the array otherwise, or when it is full.  This does not
+ *     affect any other PacketTagList, hence this is a \c const function.
  *
- *   - #Remove and #Replace are a little tricky, depending on where the
- *     target tag is found relative to the first branch point:
- *     - \e Target before <em> the first branch point: </em> \n
- *       The target is just dealt with in place (linked around and deleted,
- *       in the case of #Remove; rewritten in the case of #Replace).
- *     - \e Target at or after <em> the first branch point: </em> \n
- *       The portion of the list between the first branch and the target is
- *       shared. This portion is copied before the #Remove or #Replace is
- *       performed.
+ *   - #Remove of the last tag added only shortens the list.  Other
+ *     #Remove and #Replace operations are done in place if the array
+ *     is not shared, and on a copy of the array otherwise.
  *
  * \par <b> Memory Management: </b>
  * \n
@@ -130,9 +85,7 @@ class PacketTagList
 {
 public:
   /**
-   * Tree node for sharing serialized tags.
-   *
-   * See PacketTagList for a discussion of the data structure.
+   * A serialized tag, as stored in the array of a PacketTagList.
    *
    * See TagData::TagData_e for a discussion of the size limit on
    * tag serialization.
@@ -146,15 +99,9 @@ public:
      * in this constant.
      *
      * \internal
-     * Ideally, TagData would be 32 bytes in size, so they require
-     * no padding on 64-bit architectures.  (The architecture
-     * affects the size because of the \c #next pointer.)
-     * This would leave 18 bytes for \c #data.  However,
-     * ns3:Ipv6PacketInfoTag needs 19 bytes!  The current
-     * implementation allows 20 bytes, which gives TagData
-     * a size of 30 bytes on 32-byte machines (which gets
-     * padded with 2 bytes), and 34 bytes on 64-bit machines, which
-     * gets padded to 40 bytes.
+     * ns3:Ipv6PacketInfoTag needs 19 bytes.  The current
+     * implementation allows 21 bytes, which, with the TypeId,
+     * gives TagData a size of 24 bytes on all architectures.
      */
     enum TagData_e
     {
@@ -162,9 +109,7 @@ public:
   };
 
     uint8_t data[MAX_SIZE];   /**< Serialization buffer */
-    struct TagData * next;   /**< Pointer to next in list */
     TypeId tid;               /**< Type of the tag serialized into #data */
-    uint32_t count;           /**< Number of incoming links */
   };  /* struct TagData */
 
   /**
@@ -176,8 +121,8 @@ public:
    *
    * \param [in] o The PacketTagList to copy.
    *
-   * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * This makes a light-weight copy, sharing the
+   * \ref TagData array of \pname{o}.
    */
   inline PacketTagList (PacketTagList const &o);
   /**
@@ -187,18 +132,18 @@ public:
    * \returns the copied object
    *
    * This makes a light-weight copy by #RemoveAll, then
-   * pointing to the same \ref TagData as \pname{o}.
+   * sharing the \ref TagData array of \pname{o}.
    */
   inline PacketTagList &operator = (PacketTagList const &o);
   /**
    * Destructor
    *
-   * #RemoveAll's the tags up to the first merge.
+   * #RemoveAll's the tags.
    */
   inline ~PacketTagList ();
 
   /**
-   * Add a tag to the head of this branch.
+   * Add a tag at the end of the list.
    *
    * \param [in] tag The tag to add
    */
@@ -230,67 +175,87 @@ public:
    */
   bool Peek (Tag &tag) const;
   /**
-   * Remove all tags from this list (up to the first merge).
+   * Remove all tags from this list.
    */
   inline void RemoveAll (void);
   /**
-   * \returns pointer to head of tag list
+   * Give this list its own copy of the tag array it shares with
+   * other lists, e.g. before it is handed over to another thread.
+   */
+  void Detach (void);
+  /**
+   * \returns pointer to the first tag of the list, the oldest one
+   */
+  const struct PacketTagList::TagData *Begin (void) const;
+  /**
+   * \returns pointer past the last tag of the list
+   */
+  const struct PacketTagList::TagData *End (void) const;
+
+  /**
+   * \brief Get the pool which recycles the tag arrays.
+   * \returns the pool of the packet tag storage.
    */
-  const struct PacketTagList::TagData *Head (void) const;
+  static PacketDataPool & GetDataPool (void);
 
 private:
   /**
-   * Typedef of method function pointer for copy-on-write operations
+   * The array of tags, shared by the copies of a PacketTagList.
+   */
+  struct Data
+  {
+    /** Number of PacketTagList's which reference this array. */
+    uint32_t m_count;
+    /** Number of tags which m_tags can hold. */
+    uint32_t m_size;
+    /** Number of tags written by any of the lists which share the array. */
+    uint32_t m_dirty;
+    /** Size of this structure, in bytes, as allocated by the pool. */
+    uint32_t m_capacity;
+    /** The tags, in the order they were added. */
+    struct TagData m_tags[1];
+  };
+
+  /**
+   * Get the bit of the mask of the tags of a type.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True if operation successful, false otherwise
+   * \param [in] tid The type of the tag.
+   * \returns The bit of the hash of \pname{tid}.
    */
-  typedef bool (PacketTagList::*COWWriter)
-    (Tag       & tag, bool         preMerge,
-    struct TagData * cur, struct TagData ** prevNext);
+  static inline uint32_t GetMask (TypeId tid);
   /**
-   * Traverse the list implementing copy-on-write, using \pname{Writer}.
+   * Find a tag of the list.
    *
-   * \param [in] tag The tag type to operate on.
-   * \param [in] Writer The copy-on-write function to use.
-   * \returns True if \pname{tag} found, false otherwise.
+   * \param [in] tid The type of the tag.
+   * \returns The index of the tag in the array, or #m_used if
+   *          the list has no tag of type \pname{tid}.
    */
-  bool COWTraverse   (Tag & tag, PacketTagList::COWWriter Writer);
+  uint32_t Find (TypeId tid) const;
   /**
-   * Copy-on-write implementing Remove.
+   * Copy the tags of the list to a new array, which the list
+   * then references alone.
    *
-   * \param [in] tag The target tag type to remove.
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *             false otherwise.
-   * \param [in] cur Pointer to the tag.
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag will definitely be removed.
+   * \param [in] size The number of tags the new array must hold.
    */
-  bool RemoveWriter  (Tag       & tag, bool         preMerge,
-                      struct TagData * cur, struct TagData ** prevNext);
+  void Unshare (uint32_t size);
   /**
-   * Copy-on-write implementing Replace
+   * Allocate an array of tags.
    *
-   * \param [in] tag The target tag type to replace
-   * \param [in] preMerge True if \pname{tag} was found before the first merge,
-   *          false otherwise.
-   * \param [in] cur Pointer to the tag
-   * \param [in] prevNext Pointer to the struct TagData.next pointer
-   *          pointing to \pname{cur}.
-   * \returns True, since tag value will definitely be replaced.
+   * \param [in] size The number of tags to hold.
+   * \returns The array, with a count of one.
    */
-  bool ReplaceWriter (Tag & tag, bool preMerge, struct TagData * cur, struct TagData ** prevNext);
-
+  static struct Data *Allocate (uint32_t size);
   /**
-   * Pointer to first \ref TagData on the list
+   * Release a reference to an array of tags, and free it
+   * when this was the last one.
+   *
+   * \param [in] data The array.
    */
-  struct TagData *m_next;
+  static void Deallocate (struct Data *data);
+
+  struct Data *m_data;  //!< The array of tags, or 0 if there are none.
+  uint32_t m_used;      //!< Number of tags of #m_data in this list.
+  uint32_t m_mask;      //!< Union of GetMask() of the tags of this list.
 };
 
 } // namespace ns3
@@ -302,16 +267,20 @@ private:
 namespace ns3 {
 
 PacketTagList::PacketTagList ()
-  : m_next ()
+  : m_data (0),
+    m_used (0),
+    m_mask (0)
 {
 }
 
 PacketTagList::PacketTagList (PacketTagList const &o)
-  : m_next (o.m_next)
+  : m_data (o.m_data),
+    m_used (o.m_used),
+    m_mask (o.m_mask)
 {
-  if (m_next != 0)
+  if (m_data != 0)
     {
-      m_next->count++;
+      m_data->m_count++;
     }
 }
 
@@ -319,16 +288,18 @@ PacketTagList &
 PacketTagList::operator = (PacketTagList const &o)
 {
   // self assignment
-  if (m_next == o.m_next) 
+  if (this == &o) 
     {
       return *this;
     }
-  RemoveAll ();
-  m_next = o.m_next;
-  if (m_next != 0) 
+  if (o.m_data != 0)
     {
-      m_next->count++;
+      o.m_data->m_count++;
     }
+  RemoveAll ();
+  m_data = o.m_data;
+  m_used = o.m_used;
+  m_mask = o.m_mask;
   return *this;
 }
 
@@ -340,25 +311,19 @@ PacketTagList::~PacketTagList ()
 void
 PacketTagList::RemoveAll (void)
 {
-  struct TagData *prev = 0;
-  for (struct TagData *cur = m_next; cur != 0; cur = cur->next)
-    {
-      cur->count--;
-      if (cur->count > 0) 
-        {
-          break;
-        }
-      if (prev != 0) 
-        {
-	  delete prev;
-        }
-      prev = cur;
-    }
-  if (prev != 0) 
+  if (m_data != 0)
     {
-      delete prev;
+      Deallocate (m_data);
+      m_data = 0;
     }
-  m_next = 0;
+  m_used = 0;
+  m_mask = 0;
+}
+
+uint32_t
+PacketTagList::GetMask (TypeId tid)
+{
+  return 1U << (tid.GetUid () & 31);
 }
 
 } // namespace ns3
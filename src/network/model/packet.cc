@@ -21,14 +21,23 @@
 #include "ns3/assert.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/unused.h"
 #include <string>
 #include <cstdarg>
+#include <vector>
 
 namespace ns3 {
 
 NS_LOG_COMPONENT_DEFINE ("Packet");
 
-uint32_t Packet::m_globalUid = 0;
+std::atomic<uint32_t> Packet::m_globalUid (0);
+std::atomic<bool> Packet::m_virtualPayload (false);
+
+/**
+ * \ingroup packet
+ * The pool of the packet objects.
+ */
+static PacketDataPool g_objectPool;
 
 TypeId 
 ByteTagIterator::Item::GetTypeId (void) const
@@ -81,22 +90,23 @@ ByteTagIterator::ByteTagIterator (ByteTagList::Iterator i)
 }
 
 
-PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *head)
-  : m_current (head)
+PacketTagIterator::PacketTagIterator (const struct PacketTagList::TagData *begin,
+                                      const struct PacketTagList::TagData *end)
+  : m_begin (begin),
+    m_current (end)
 {
 }
 bool
 PacketTagIterator::HasNext (void) const
 {
-  return m_current != 0;
+  return m_current != m_begin;
 }
 PacketTagIterator::Item
 PacketTagIterator::Next (void)
 {
   NS_ASSERT (HasNext ());
-  const struct PacketTagList::TagData *prev = m_current;
-  m_current = m_current->next;
-  return PacketTagIterator::Item (prev);
+  m_current--;
+  return PacketTagIterator::Item (m_current);
 }
 
 PacketTagIterator::Item::Item (const struct PacketTagList::TagData *data)
@@ -127,6 +137,26 @@ Packet::Copy (void) const
   return Ptr<Packet> (new Packet (*this), false);
 }
 
+Ptr<Packet>
+Packet::CreateUnsharedCopy (void) const
+{
+  NS_LOG_FUNCTION (this);
+  // The buffer, the metadata and the Nix-vector go through their
+  // serialized form, as when a packet is sent to another MPI rank.
+  uint32_t size = GetSerializedSize ();
+  std::vector<uint32_t> data ((size + 3) / 4);
+  uint8_t *buffer = reinterpret_cast<uint8_t *> (&data[0]);
+  uint32_t serialized = Serialize (buffer, size);
+  NS_ASSERT (serialized);
+  NS_UNUSED (serialized);
+  Ptr<Packet> copy = Create<Packet> (buffer, size, true);
+  // Tags are not serialized.
+  copy->m_byteTagList.Add (m_byteTagList);
+  copy->m_packetTagList = m_packetTagList;
+  copy->m_packetTagList.Detach ();
+  return copy;
+}
+
 Packet::Packet ()
   : m_buffer (),
     m_byteTagList (),
@@ -137,10 +167,9 @@ Packet::Packet ()
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, 0),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid.fetch_add (1, std::memory_order_relaxed), 0),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 
 Packet::Packet (const Packet &o)
@@ -179,10 +208,9 @@ Packet::Packet (uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid.fetch_add (1, std::memory_order_relaxed), size),
     m_nixVector (0)
 {
-  m_globalUid++;
 }
 Packet::Packet (uint8_t const *buffer, uint32_t size, bool magic)
   : m_buffer (0, false),
@@ -205,15 +233,27 @@ Packet::Packet (uint8_t const*buffer, uint32_t size)
      * zero.  The lower 32 bits are for the 
      * global UID
      */
-    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid, size),
+    m_metadata (static_cast<uint64_t> (Simulator::GetSystemId ()) << 32 | m_globalUid.fetch_add (1, std::memory_order_relaxed), size),
     m_nixVector (0)
 {
-  m_globalUid++;
   m_buffer.AddAtStart (size);
   Buffer::Iterator i = m_buffer.Begin ();
   i.Write (buffer, size);
 }
 
+void *
+Packet::operator new (size_t size)
+{
+  uint32_t capacity;
+  return g_objectPool.Allocate (size, &capacity);
+}
+
+void
+Packet::operator delete (void *p, size_t size)
+{
+  g_objectPool.Deallocate (p, g_objectPool.GetCapacity (size));
+}
+
 Packet::Packet (const Buffer &buffer,  const ByteTagList &byteTagList, 
                 const PacketTagList &packetTagList, const PacketMetadata &metadata)
   : m_buffer (buffer),
@@ -545,6 +585,44 @@ Packet::EnableChecking (void)
   PacketMetadata::EnableChecking ();
 }
 
+void
+Packet::EnableVirtualPayload (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_virtualPayload.store (true, std::memory_order_relaxed);
+}
+
+void
+Packet::DisableVirtualPayload (void)
+{
+  NS_LOG_FUNCTION_NOARGS ();
+  m_virtualPayload.store (false, std::memory_order_relaxed);
+}
+
+bool
+Packet::IsVirtualPayloadEnabled (void)
+{
+  return m_virtualPayload.load (std::memory_order_relaxed);
+}
+
+Ptr<Packet>
+Packet::CreatePayload (uint8_t const *buffer, uint32_t size)
+{
+  NS_LOG_FUNCTION (static_cast<const void *> (buffer) << size);
+  if (m_virtualPayload.load (std::memory_order_relaxed))
+    {
+      // Only the size of the data is kept, as by Packet (size).
+      return Create<Packet> (size);
+    }
+  return Create<Packet> (buffer, size);
+}
+
+PacketDataPool &
+Packet::GetObjectPool (void)
+{
+  return g_objectPool;
+}
+
 uint32_t Packet::GetSerializedSize (void) const
 {
   uint32_t size = 0;
@@ -881,7 +959,7 @@ Packet::PrintPacketTags (std::ostream &os) const
 PacketTagIterator 
 Packet::GetPacketTagIterator (void) const
 {
-  return PacketTagIterator (m_packetTagList.Head ());
+  return PacketTagIterator (m_packetTagList.Begin (), m_packetTagList.End ());
 }
 
 std::ostream& operator<< (std::ostream& os, const Packet &packet)
@@ -890,4 +968,22 @@ std::ostream& operator<< (std::ostream& os, const Packet &packet)
   return os;
 }
 
+void
+IsolateEventArgument (Ptr<Packet> &packet)
+{
+  if (packet != 0)
+    {
+      packet = packet->CreateUnsharedCopy ();
+    }
+}
+
+void
+IsolateEventArgument (Ptr<const Packet> &packet)
+{
+  if (packet != 0)
+    {
+      packet = packet->CreateUnsharedCopy ();
+    }
+}
+
 } // namespace ns3
@@ -21,6 +21,7 @@
 #define PACKET_H
 
 #include <stdint.h>
+#include <atomic>
 #include "buffer.h"
 #include "header.h"
 #include "trailer.h"
@@ -28,6 +29,7 @@
 #include "tag.h"
 #include "byte-tag-list.h"
 #include "packet-tag-list.h"
+#include "packet-data-pool.h"
 #include "nix-vector.h"
 #include "ns3/mac48-address.h"
 #include "ns3/callback.h"
@@ -169,9 +171,14 @@ private:
   friend class Packet;
   /**
    * Constructor
-   * \param head head of the items
+   * \param begin first of the items
+   * \param end past the last of the items
+   *
+   * The items are iterated from the last one, the tag added last.
    */
-  PacketTagIterator (const struct PacketTagList::TagData *head);
+  PacketTagIterator (const struct PacketTagList::TagData *begin,
+                     const struct PacketTagList::TagData *end);
+  const struct PacketTagList::TagData *m_begin;    //!< first of the tags in a packet
   const struct PacketTagList::TagData *m_current;  //!< actual position over the set of tags in a packet
 };
 
@@ -280,6 +287,25 @@ public:
    * \param size the size of the input buffer.
    */
   Packet (uint8_t const*buffer, uint32_t size);
+  /**
+   * \brief Allocate a packet from the pool of the packet objects.
+   *
+   * Create<Packet> and Packet::Copy allocate the packets from the
+   * free list of the calling thread, and the SimpleRefCount deleter
+   * returns them to the free list of the thread which releases the
+   * last reference.
+   *
+   * \param size the size of the object.
+   * \returns the memory of the packet.
+   */
+  static void * operator new (size_t size);
+  /**
+   * \brief Return a packet to the pool of the packet objects.
+   *
+   * \param p the memory of the packet.
+   * \param size the size of the object.
+   */
+  static void operator delete (void *p, size_t size);
   /**
    * \brief Create a new packet which contains a fragment of the original
    * packet.
@@ -423,6 +449,17 @@ public:
    * same datasets internally.
    */
   Ptr<Packet> Copy (void) const;
+  /**
+   * \brief Performs a deep copy of the packet.
+   *
+   * \returns a copy of the packet which shares no data with it.
+   *
+   * Unlike the COW copy of Copy, the returned packet can be handed
+   * over to another thread while this packet is still in use.  It
+   * keeps the uid, the metadata, the tags and the Nix-vector of this
+   * packet.
+   */
+  Ptr<Packet> CreateUnsharedCopy (void) const;
 
   /**
    * \brief Returns the packet's Uid.
@@ -501,6 +538,63 @@ public:
    * errors will be detected and will abort the program.
    */
   static void EnableChecking (void);
+  /**
+   * \brief Enable the virtual payload of the packets.
+   *
+   * Most simulations never read the application payload of their
+   * packets, only its size.  Once this method is invoked, the packets
+   * created by CreatePayload keep only the size of their data: their
+   * payload is virtual, as the zero-filled payload of
+   * Packet (uint32_t), and reads as zeroes.  No memory is allocated for
+   * this payload, even when the packet is fragmented and reassembled,
+   * read with CopyData or written to a pcap file: only
+   * Buffer::PeekData allocates it.
+   *
+   * The packets created with Packet (uint8_t const *, uint32_t), e.g.
+   * from received frames or serialized headers, always copy their data.
+   * Invoke this method only if no model reads the content of the
+   * payloads created by the traffic generators.
+   */
+  static void EnableVirtualPayload (void);
+  /**
+   * \brief Disable the virtual payload of the packets.
+   *
+   * The packets created from a data buffer copy the data again.
+   *
+   * \sa EnableVirtualPayload
+   */
+  static void DisableVirtualPayload (void);
+  /**
+   * \returns true if the virtual payload of the packets is enabled.
+   *
+   * \sa EnableVirtualPayload
+   */
+  static bool IsVirtualPayloadEnabled (void);
+  /**
+   * \brief Create a packet holding application payload data.
+   *
+   * Traffic generators create their payloads with this method rather
+   * than with Packet (uint8_t const *, uint32_t), so that the data
+   * is dropped when the virtual payload is enabled: the packet then
+   * has a zero-filled payload of the same size.  Otherwise the data
+   * is copied.
+   *
+   * \param buffer the payload data.
+   * \param size the size of the payload data.
+   * \returns the new packet.
+   *
+   * \sa EnableVirtualPayload
+   */
+  static Ptr<Packet> CreatePayload (uint8_t const *buffer, uint32_t size);
+  /**
+   * \brief Get the pool which recycles the packet objects.
+   *
+   * Set its MaxFree limit to zero to allocate each packet from the
+   * system allocator.
+   *
+   * \returns the pool of the packet objects.
+   */
+  static PacketDataPool & GetObjectPool (void);
 
   /**
    * \brief Returns number of bytes required for packet
@@ -727,7 +821,8 @@ private:
   /* Please see comments above about nix-vector */
   Ptr<NixVector> m_nixVector; //!< the packet's Nix vector
 
-  static uint32_t m_globalUid; //!< Global counter of packets Uid
+  static std::atomic<uint32_t> m_globalUid; //!< Global counter of packets Uid
+  static std::atomic<bool> m_virtualPayload; //!< Whether CreatePayload drops the payload data
 };
 
 /**
@@ -739,6 +834,20 @@ private:
  */
 std::ostream& operator<< (std::ostream& os, const Packet &packet);
 
+/**
+ * \ingroup packet
+ * Replace a packet bound to an event by an unshared copy, before the
+ * event is handed over to another thread (see EventImpl::Isolate).
+ *
+ * \param [in,out] packet The packet.
+ */
+void IsolateEventArgument (Ptr<Packet> &packet);
+/**
+ * \ingroup packet
+ * \copydoc IsolateEventArgument(Ptr<Packet>&)
+ */
+void IsolateEventArgument (Ptr<const Packet> &packet);
+
 /**
  * \ingroup network
  * \defgroup packetperf Packet Performance
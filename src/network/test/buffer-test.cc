@@ -359,6 +359,57 @@ BufferTest::DoRun (void)
   val2 <<= 8;
   val2 |= i.ReadU8 ();
   NS_TEST_ASSERT_MSG_EQ (val1, val2, "Bad ReadNtohU16()");
+
+  // Append real bytes after a zero area.
+  buffer = Buffer (3);
+  other = Buffer ();
+  other.AddAtStart (2);
+  i = other.Begin ();
+  i.WriteU8 (0x7);
+  i.WriteU8 (0x8);
+  buffer.AddAtEnd (other);
+  ENSURE_WRITTEN_BYTES (buffer, 5, 0x00, 0x00, 0x00, 0x7, 0x8);
+
+  // Fragment, concatenate and slice the chained buffers.
+  buffer = Buffer (3);
+  buffer.AddAtStart (2);
+  i = buffer.Begin ();
+  i.WriteU8 (0x1);
+  i.WriteU8 (0x2);
+  buffer.AddAtEnd (2);
+  i = buffer.End ();
+  i.Prev (2);
+  i.WriteU8 (0x3);
+  i.WriteU8 (0x4);
+  Buffer chain = buffer.CreateFragment (0, 3);
+  chain.AddAtEnd (buffer.CreateFragment (5, 2));
+  chain.AddAtEnd (buffer.CreateFragment (1, 3));
+  NS_TEST_ASSERT_MSG_EQ (chain.GetSize (), 8, "Bad chained buffer size");
+  uint8_t copied[8];
+  NS_TEST_ASSERT_MSG_EQ (chain.CopyData (copied, 8), 8, "Bad CopyData of a chained buffer");
+  NS_TEST_ASSERT_MSG_EQ (copied[3], 0x3, "Bad CopyData of a chained buffer");
+  NS_TEST_ASSERT_MSG_EQ (copied[7], 0x0, "Bad CopyData of a chained buffer");
+  Buffer chainFragment = chain.CreateFragment (2, 5);
+  ENSURE_WRITTEN_BYTES (chainFragment, 5, 0x00, 0x3, 0x4, 0x2, 0x00);
+  Buffer chainCopy = chain;
+  chainCopy.AddAtEnd (chainFragment);
+  chainCopy.RemoveAtStart (4);
+  chainCopy.RemoveAtEnd (2);
+  NS_TEST_ASSERT_MSG_EQ (chainCopy.GetSize (), 7, "Bad sliced chained buffer size");
+  ENSURE_WRITTEN_BYTES (chainCopy, 7, 0x4, 0x2, 0x00, 0x00, 0x00, 0x3, 0x4);
+  ENSURE_WRITTEN_BYTES (chain, 8, 0x1, 0x2, 0x00, 0x3, 0x4, 0x2, 0x00, 0x00);
+  ENSURE_WRITTEN_BYTES (buffer, 7, 0x1, 0x2, 0x00, 0x00, 0x00, 0x3, 0x4);
+  chain = buffer.CreateFragment (0, 2);
+  chain.AddAtEnd (buffer.CreateFragment (2, 5));
+  chain.AddAtStart (1);
+  chain.Begin ().WriteU8 (0x5);
+  chain.AddAtEnd (1);
+  i = chain.End ();
+  i.Prev ();
+  i.WriteU8 (0x6);
+  NS_TEST_ASSERT_MSG_EQ (chain.GetSize (), 9, "Bad flattened buffer size");
+  ENSURE_WRITTEN_BYTES (chain, 9, 0x5, 0x1, 0x2, 0x00, 0x00, 0x00, 0x3, 0x4, 0x6);
+  ENSURE_WRITTEN_BYTES (buffer, 7, 0x1, 0x2, 0x00, 0x00, 0x00, 0x3, 0x4);
 }
 //-----------------------------------------------------------------------------
 class BufferTestSuite : public TestSuite
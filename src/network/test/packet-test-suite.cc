@@ -19,6 +19,7 @@
  */
 #include "ns3/packet.h"
 #include "ns3/packet-tag-list.h"
+#include "ns3/make-event.h"
 #include "ns3/test.h"
 #include "ns3/unused.h"
 #include <limits>     // std:numeric_limits
@@ -27,6 +28,9 @@
 #include <iostream>
 #include <iomanip>
 #include <ctime>
+#include <thread>
+#include <sstream>
+#include <cstring>
 
 using namespace ns3;
 
@@ -847,6 +851,353 @@ PacketTagListTest::DoRun (void)
     
 }
 
+//-----------------------------------------------------------------------------
+/**
+ * Test the per-thread pools of the packet data.
+ */
+class PacketDataPoolTest : public TestCase
+{
+public:
+  PacketDataPoolTest ();
+private:
+  void DoRun (void);
+  /**
+   * Create, copy and destroy packets, as a thread of the test.
+   * \param [in] n The number of packets.
+   * \param [out] ok Set to \c false if a packet is corrupted.
+   * \param [out] stats The statistics of the Buffer pool of the thread.
+   */
+  static void CreatePackets (uint32_t n, bool *ok, PacketDataPool::Stats *stats);
+};
+
+PacketDataPoolTest::PacketDataPoolTest ()
+  : TestCase ("Check the per-thread pools of the packet data")
+{
+}
+
+void
+PacketDataPoolTest::CreatePackets (uint32_t n, bool *ok, PacketDataPool::Stats *stats)
+{
+  Buffer::GetDataPool ().ResetStats ();
+  for (uint32_t i = 0; i < n; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddHeader (ATestHeader<10> ());
+      p->AddByteTag (ATestTag<5> ());
+      Ptr<Packet> q = p->Copy ();
+      q->AddHeader (ATestHeader<20> ());
+      ATestHeader<20> h20;
+      ATestHeader<10> h10;
+      q->RemoveHeader (h20);
+      q->RemoveHeader (h10);
+      if (p->GetSize () != 1010 || q->GetSize () != 1000
+          || h10.m_error || h20.m_error)
+        {
+          *ok = false;
+        }
+    }
+  *stats = Buffer::GetDataPool ().GetStats ();
+}
+
+void
+PacketDataPoolTest::DoRun (void)
+{
+  PacketDataPool &buffers = Buffer::GetDataPool ();
+  PacketDataPool &metadata = PacketMetadata::GetDataPool ();
+  PacketDataPool &tags = ByteTagList::GetDataPool ();
+
+  // Once warm, the pools serve all the packets of the thread.
+  {
+    Ptr<Packet> p = Create<Packet> (100);
+    p->AddHeader (ATestHeader<10> ());
+    p->AddByteTag (ATestTag<5> ());
+  }
+  buffers.ResetStats ();
+  metadata.ResetStats ();
+  tags.ResetStats ();
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (100);
+      p->AddHeader (ATestHeader<10> ());
+      p->AddByteTag (ATestTag<5> ());
+    }
+  NS_TEST_EXPECT_MSG_EQ (buffers.GetStats ().misses, 0, "Buffer data not recycled");
+  NS_TEST_EXPECT_MSG_EQ (buffers.GetStats ().hits, buffers.GetStats ().allocations,
+                         "Buffer data not recycled");
+  NS_TEST_EXPECT_MSG_EQ (metadata.GetStats ().misses, 0, "Metadata not recycled");
+  NS_TEST_EXPECT_MSG_EQ (tags.GetStats ().misses, 0, "Byte tags not recycled");
+  NS_TEST_EXPECT_MSG_EQ ((buffers.GetStats ().peak >= buffers.GetStats ().pooled), true,
+                         "Peak below the current number of free blocks");
+
+  // The packet objects are recycled as well, including the copies.
+  PacketDataPool &packets = Packet::GetObjectPool ();
+  {
+    Ptr<Packet> p = Create<Packet> (100);
+    Ptr<Packet> copy = p->Copy ();
+  }
+  packets.ResetStats ();
+  for (uint32_t i = 0; i < 10; i++)
+    {
+      Ptr<Packet> p = Create<Packet> (100);
+      Ptr<Packet> copy = p->Copy ();
+    }
+  NS_TEST_EXPECT_MSG_EQ (packets.GetStats ().allocations, 20, "Packets not allocated from the pool");
+  NS_TEST_EXPECT_MSG_EQ (packets.GetStats ().misses, 0, "Packets not recycled");
+  NS_TEST_EXPECT_MSG_EQ (packets.GetStats ().deallocations, 20, "Packets not returned to the pool");
+
+  // Without free blocks, the packets are served by the system allocator.
+  uint32_t maxFree = buffers.GetMaxFree ();
+  buffers.SetMaxFree (0);
+  NS_TEST_EXPECT_MSG_EQ (buffers.GetStats ().pooled, 0, "Free blocks not released");
+  buffers.ResetStats ();
+  {
+    Ptr<Packet> p = Create<Packet> (100);
+  }
+  NS_TEST_EXPECT_MSG_EQ (buffers.GetStats ().misses, 1, "Buffer data recycled");
+  NS_TEST_EXPECT_MSG_EQ (buffers.GetStats ().released, 1, "Buffer data recycled");
+  buffers.SetMaxFree (maxFree);
+
+  // Each thread has its own free lists.  The types used by the
+  // threads are registered beforehand.
+  ATestHeader<20>::GetTypeId ();
+  const uint32_t nThreads = 4;
+  bool ok[nThreads];
+  PacketDataPool::Stats stats[nThreads];
+  std::vector<std::thread> threads;
+  for (uint32_t i = 0; i < nThreads; i++)
+    {
+      ok[i] = true;
+      threads.push_back (std::thread (&PacketDataPoolTest::CreatePackets,
+                                      1000, &ok[i], &stats[i]));
+    }
+  for (uint32_t i = 0; i < nThreads; i++)
+    {
+      threads[i].join ();
+      NS_TEST_EXPECT_MSG_EQ (ok[i], true, "Packet corrupted in thread " << i);
+      NS_TEST_EXPECT_MSG_EQ ((stats[i].hits > stats[i].misses), true,
+                             "Buffer data not recycled in thread " << i);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Test the virtual payload of the packets.
+ */
+class PacketVirtualPayloadTest : public TestCase
+{
+public:
+  PacketVirtualPayloadTest ();
+private:
+  void DoRun (void);
+};
+
+PacketVirtualPayloadTest::PacketVirtualPayloadTest ()
+  : TestCase ("Check the virtual payload of the packets")
+{
+}
+
+void
+PacketVirtualPayloadTest::DoRun (void)
+{
+  uint8_t data[3000];
+  memset (data, 0xaa, sizeof (data));
+  uint32_t virtualSize = Create<Packet> (3000)->GetSerializedSize ();
+
+  Packet::EnableVirtualPayload ();
+  NS_TEST_EXPECT_MSG_EQ (Packet::IsVirtualPayloadEnabled (), true, "Virtual payload not enabled");
+  Ptr<Packet> p = Packet::CreatePayload (data, sizeof (data));
+  NS_TEST_EXPECT_MSG_EQ (p->GetSize (), 3000, "Bad size of the virtual payload");
+  NS_TEST_EXPECT_MSG_EQ (p->GetSerializedSize (), virtualSize, "Payload not virtual");
+  uint8_t copy[3000];
+  p->CopyData (copy, sizeof (copy));
+  NS_TEST_EXPECT_MSG_EQ ((copy[0] == 0 && copy[2999] == 0), true, "Virtual payload not zero");
+  std::ostringstream os;
+  p->CopyData (&os, p->GetSize ());
+  NS_TEST_EXPECT_MSG_EQ (os.str (), std::string (3000, '\0'), "Virtual payload not zero");
+
+  // The packets created from a data buffer still copy it.
+  Ptr<Packet> copied = Create<Packet> (data, sizeof (data));
+  copied->CopyData (copy, sizeof (copy));
+  NS_TEST_EXPECT_MSG_EQ ((copy[0] == 0xaa && copy[2999] == 0xaa), true, "Data not copied");
+
+  // The payload stays virtual through fragmentation and reassembly.
+  p->AddHeader (ATestHeader<10> ());
+  Ptr<Packet> reassembled = p->CreateFragment (0, 1000);
+  reassembled->AddAtEnd (p->CreateFragment (1000, 1000));
+  reassembled->AddAtEnd (p->CreateFragment (2000, 1010));
+  ATestHeader<10> h10;
+  reassembled->RemoveHeader (h10);
+  NS_TEST_EXPECT_MSG_EQ (h10.m_error, false, "Header corrupted");
+  NS_TEST_EXPECT_MSG_EQ (reassembled->GetSize (), 3000, "Bad size of the reassembled packet");
+  NS_TEST_EXPECT_MSG_EQ (reassembled->GetSerializedSize (), virtualSize,
+                         "Payload of the reassembled packet not virtual");
+
+  Packet::DisableVirtualPayload ();
+  p = Packet::CreatePayload (data, sizeof (data));
+  p->CopyData (copy, sizeof (copy));
+  NS_TEST_EXPECT_MSG_EQ ((copy[0] == 0xaa && copy[2999] == 0xaa), true, "Payload not copied");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Test the storage of the packet tags.
+ */
+class PacketTagStorageTest : public TestCase
+{
+public:
+  PacketTagStorageTest ();
+private:
+  void DoRun (void);
+};
+
+PacketTagStorageTest::PacketTagStorageTest ()
+  : TestCase ("Check the storage of the packet tags")
+{
+}
+
+void
+PacketTagStorageTest::DoRun (void)
+{
+  PacketDataPool &pool = PacketTagList::GetDataPool ();
+  ATestTag<1> t1 (1);
+  ATestTag<2> t2 (2);
+  ATestTag<3> t3 (3);
+  ATestTag<4> t4 (4);
+  ATestTag<5> t5 (5);
+
+  // A few tags share a single allocation.
+  pool.ResetStats ();
+  Ptr<Packet> p = Create<Packet> (100);
+  p->AddPacketTag (t1);
+  p->AddPacketTag (t2);
+  p->AddPacketTag (t3);
+  NS_TEST_EXPECT_MSG_EQ (pool.GetStats ().allocations, 1, "One allocation per tag");
+
+  // A copy shares the tags, until they are changed.
+  Ptr<Packet> copy = p->Copy ();
+  copy->AddPacketTag (t4);
+  NS_TEST_EXPECT_MSG_EQ (pool.GetStats ().allocations, 1, "Tags copied by an addition");
+  ATestTag<3> r3;
+  NS_TEST_EXPECT_MSG_EQ (p->RemovePacketTag (r3), true, "Tag 3 not found");
+  NS_TEST_EXPECT_MSG_EQ (r3.GetData (), 3, "Bad value of tag 3");
+  NS_TEST_EXPECT_MSG_EQ (pool.GetStats ().allocations, 1, "Tags copied by a removal");
+  ATestTag<2> r2 (20);
+  copy->ReplacePacketTag (r2);
+  NS_TEST_EXPECT_MSG_EQ (pool.GetStats ().allocations, 2, "Shared tags overwritten");
+  p->AddPacketTag (t5);
+  NS_TEST_EXPECT_MSG_EQ (pool.GetStats ().allocations, 2, "Tags copied by an addition");
+
+  ATestTag<1> x1;
+  ATestTag<2> x2;
+  ATestTag<3> x3;
+  ATestTag<4> x4;
+  ATestTag<5> x5;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (x2), true, "Tag 2 not found");
+  NS_TEST_EXPECT_MSG_EQ (x2.GetData (), 2, "Tag 2 replaced in the original");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (x3), false, "Tag 3 not removed from the original");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (x4), false, "Tag 4 added to the original");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (x5), true, "Tag 5 not found");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (x2), true, "Tag 2 not found");
+  NS_TEST_EXPECT_MSG_EQ (x2.GetData (), 20, "Tag 2 not replaced in the copy");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (x3), true, "Tag 3 removed from the copy");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (x5), false, "Tag 5 added to the copy");
+  NS_TEST_EXPECT_MSG_EQ (copy->RemovePacketTag (x1), true, "Tag 1 not found");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (x1), false, "Tag 1 not removed");
+  NS_TEST_EXPECT_MSG_EQ (copy->PeekPacketTag (x2), true, "Tag 2 lost by a removal");
+  NS_TEST_EXPECT_MSG_EQ (x2.m_error, false, "Tag 2 corrupted by a removal");
+
+  // The tags are iterated from the last one added.
+  std::ostringstream oss;
+  PacketTagIterator i = copy->GetPacketTagIterator ();
+  while (i.HasNext ())
+    {
+      oss << i.Next ().GetTypeId ().GetName () << " ";
+    }
+  NS_TEST_EXPECT_MSG_EQ (oss.str (), "anon::ATestTag<4> anon::ATestTag<3> anon::ATestTag<2> ",
+                         "Bad order of the tags");
+
+  // The array grows past its first allocation.
+  ATestTag<6> t6 (6);
+  ATestTag<7> t7 (7);
+  ATestTag<8> t8 (8);
+  p->AddPacketTag (t6);
+  p->AddPacketTag (t7);
+  p->AddPacketTag (t8);
+  ATestTag<8> x8;
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (x8), true, "Tag 8 not found");
+  NS_TEST_EXPECT_MSG_EQ (x8.GetData (), 8, "Bad value of tag 8");
+  NS_TEST_EXPECT_MSG_EQ (p->PeekPacketTag (x1), true, "Tag 1 lost by growth");
+  NS_TEST_EXPECT_MSG_EQ (x1.m_error, false, "Tag 1 corrupted by growth");
+}
+
+//-----------------------------------------------------------------------------
+/**
+ * Test the copies of the packets bound to an event handed over to
+ * another thread.
+ */
+class PacketIsolateTest : public TestCase
+{
+public:
+  PacketIsolateTest ();
+private:
+  void DoRun (void);
+  /**
+   * The event handler.
+   * \param [in] p The packet bound to the event.
+   */
+  void Receive (Ptr<Packet> p);
+
+  Ptr<Packet> m_received; //!< The packet received by the handler.
+};
+
+PacketIsolateTest::PacketIsolateTest ()
+  : TestCase ("Check the copies of the packets bound to an isolated event")
+{
+}
+
+void
+PacketIsolateTest::Receive (Ptr<Packet> p)
+{
+  m_received = p;
+}
+
+void
+PacketIsolateTest::DoRun (void)
+{
+  uint8_t data[100];
+  for (uint32_t i = 0; i < sizeof (data); i++)
+    {
+      data[i] = i;
+    }
+  Ptr<Packet> p = Create<Packet> (data, sizeof (data));
+  p->AddHeader (ATestHeader<10> ());
+  p->AddPacketTag (ATestTag<1> (1));
+  p->AddByteTag (ATestTag<2> (2));
+
+  EventImpl *event = MakeEvent (&PacketIsolateTest::Receive, this, p);
+  event->Isolate ();
+  event->Invoke ();
+  event->Unref ();
+
+  NS_TEST_ASSERT_MSG_NE (m_received, 0, "Event not invoked");
+  NS_TEST_EXPECT_MSG_NE (m_received, p, "Packet not copied");
+  NS_TEST_EXPECT_MSG_EQ (m_received->GetUid (), p->GetUid (), "Uid not kept");
+  NS_TEST_EXPECT_MSG_EQ (m_received->GetSize (), p->GetSize (), "Size not kept");
+  ATestHeader<10> h10;
+  m_received->RemoveHeader (h10);
+  NS_TEST_EXPECT_MSG_EQ (h10.m_error, false, "Header corrupted");
+  uint8_t copy[100];
+  m_received->CopyData (copy, sizeof (copy));
+  NS_TEST_EXPECT_MSG_EQ (memcmp (copy, data, sizeof (data)), 0, "Payload corrupted");
+  ATestTag<1> t1;
+  NS_TEST_EXPECT_MSG_EQ (m_received->PeekPacketTag (t1), true, "Packet tag lost");
+  NS_TEST_EXPECT_MSG_EQ (t1.GetData (), 1, "Packet tag corrupted");
+  ATestTag<2> t2;
+  NS_TEST_EXPECT_MSG_EQ (m_received->FindFirstMatchingByteTag (t2), true, "Byte tag lost");
+  NS_TEST_EXPECT_MSG_EQ (t2.GetData (), 2, "Byte tag corrupted");
+  m_received = 0;
+}
+
 //-----------------------------------------------------------------------------
 class PacketTestSuite : public TestSuite
 {
@@ -859,6 +1210,10 @@ PacketTestSuite::PacketTestSuite ()
 {
   AddTestCase (new PacketTest, TestCase::QUICK);
   AddTestCase (new PacketTagListTest, TestCase::QUICK);
+  AddTestCase (new PacketDataPoolTest, TestCase::QUICK);
+  AddTestCase (new PacketVirtualPayloadTest, TestCase::QUICK);
+  AddTestCase (new PacketTagStorageTest, TestCase::QUICK);
+  AddTestCase (new PacketIsolateTest, TestCase::QUICK);
 }
 
 static PacketTestSuite g_packetTestSuite;
@@ -23,6 +23,13 @@
 #include "ns3/simulator.h"
 #include "ns3/point-to-point-net-device.h"
 #include "ns3/point-to-point-channel.h"
+#include "ns3/multithreaded-simulator-impl.h"
+#include "ns3/object-factory.h"
+#include "ns3/uinteger.h"
+#include "ns3/data-rate.h"
+
+#include <algorithm>
+#include <vector>
 
 using namespace ns3;
 
@@ -100,6 +107,245 @@ PointToPointTest::DoRun (void)
   Simulator::Destroy ();
 }
 
+/**
+ * \brief Test the PointToPoint model with the MultithreadedSimulatorImpl
+ *
+ * A ring of nodes, linked by PointToPointChannels, forwards packets
+ * hop by hop around the ring in both directions.  Each forwarded packet
+ * is built from a fragment of the received one, so that they share
+ * their data.  The nodes log the packets they receive, and check their
+ * content; the logs must be the same with the DefaultSimulatorImpl and
+ * with the MultithreadedSimulatorImpl, where each link joins two
+ * partitions.
+ */
+class PointToPointMultithreadedTest : public TestCase
+{
+public:
+  /**
+   * \brief Create the test
+   */
+  PointToPointMultithreadedTest ();
+
+  /**
+   * \brief Run the test
+   */
+  virtual void DoRun (void);
+
+private:
+  /** A received packet. */
+  struct Record
+  {
+    int64_t ts;        //!< Reception time.
+    uint32_t origin;   //!< Node which sent the packet first.
+    uint32_t hops;     //!< Number of hops left.
+    uint32_t size;     //!< Packet size.
+    bool ok;           //!< The content of the packet is the expected one.
+    /**
+     * \param [in] o The other record.
+     * \returns true if this record sorts before \p o.
+     */
+    bool operator < (const Record &o) const;
+    /**
+     * \param [in] o The other record.
+     * \returns true if this record is the same as \p o.
+     */
+    bool operator == (const Record &o) const;
+  };
+  /** The records of one node. */
+  typedef std::vector<Record> Log;
+
+  /**
+   * \brief Build and run the ring with a simulator implementation
+   *
+   * \param factory The simulator implementation factory
+   */
+  void RunWith (ObjectFactory factory);
+  /**
+   * \brief Send a new packet from a node
+   *
+   * \param device NetDevice to send to
+   * \param origin The node id
+   * \param size The packet size
+   */
+  void Send (Ptr<NetDevice> device, uint32_t origin, uint32_t size);
+  /**
+   * \brief Log a received packet, and forward it on the other device
+   * of the node
+   *
+   * \param device The receiving NetDevice
+   * \param packet The packet
+   * \param protocol The protocol number
+   * \param from The sender address
+   * \returns true
+   */
+  bool Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                uint16_t protocol, const Address &from);
+
+  std::vector<Log> m_logs;   //!< Per node logs.
+  uint32_t m_partitions;     //!< Partitions of the last run.
+};
+
+/** Number of nodes of the ring. */
+static const uint32_t RING_NODES = 6;
+/** Number of packets sent by each node. */
+static const uint32_t RING_PACKETS = 10;
+/** Number of hops of each packet. */
+static const uint8_t RING_HOPS = 8;
+
+bool
+PointToPointMultithreadedTest::Record::operator < (const Record &o) const
+{
+  if (ts != o.ts)
+    {
+      return ts < o.ts;
+    }
+  if (origin != o.origin)
+    {
+      return origin < o.origin;
+    }
+  if (hops != o.hops)
+    {
+      return hops < o.hops;
+    }
+  return size < o.size;
+}
+
+bool
+PointToPointMultithreadedTest::Record::operator == (const Record &o) const
+{
+  return ts == o.ts && origin == o.origin && hops == o.hops
+         && size == o.size && ok == o.ok;
+}
+
+PointToPointMultithreadedTest::PointToPointMultithreadedTest ()
+  : TestCase ("PointToPoint with the multithreaded simulator")
+{
+}
+
+void
+PointToPointMultithreadedTest::Send (Ptr<NetDevice> device, uint32_t origin, uint32_t size)
+{
+  std::vector<uint8_t> data (size);
+  data[0] = origin;
+  data[1] = RING_HOPS;
+  for (uint32_t i = 2; i < size; i++)
+    {
+      data[i] = (i + origin) & 0xff;
+    }
+  device->Send (Create<Packet> (&data[0], size), device->GetBroadcast (), 0x800);
+}
+
+bool
+PointToPointMultithreadedTest::Receive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+                                        uint16_t protocol, const Address &from)
+{
+  uint32_t size = packet->GetSize ();
+  std::vector<uint8_t> data (size);
+  packet->CopyData (&data[0], size);
+  Record record;
+  record.ts = Simulator::Now ().GetTimeStep ();
+  record.origin = data[0];
+  record.hops = data[1];
+  record.size = size;
+  record.ok = true;
+  for (uint32_t i = 2; i < size; i++)
+    {
+      record.ok = record.ok && data[i] == ((i + data[0]) & 0xff);
+    }
+  Ptr<Node> node = device->GetNode ();
+  m_logs[node->GetId ()].push_back (record);
+
+  if (record.hops > 1)
+    {
+      uint8_t header[2] = { data[0], static_cast<uint8_t> (data[1] - 1) };
+      Ptr<Packet> next = Create<Packet> (header, 2);
+      next->AddAtEnd (packet->CreateFragment (2, size - 2));
+      Ptr<NetDevice> out = node->GetDevice (node->GetDevice (0) == device ? 1 : 0);
+      out->Send (next, out->GetBroadcast (), protocol);
+    }
+  return true;
+}
+
+void
+PointToPointMultithreadedTest::RunWith (ObjectFactory factory)
+{
+  Simulator::Destroy ();
+  Simulator::SetImplementation (factory.Create<SimulatorImpl> ());
+  m_logs.assign (RING_NODES, Log ());
+
+  std::vector<Ptr<Node> > nodes;
+  for (uint32_t i = 0; i < RING_NODES; i++)
+    {
+      nodes.push_back (CreateObject<Node> ());
+    }
+  for (uint32_t i = 0; i < RING_NODES; i++)
+    {
+      Ptr<PointToPointChannel> channel = CreateObject<PointToPointChannel> ();
+      channel->SetAttribute ("Delay", TimeValue (MilliSeconds (1)));
+      Ptr<Node> ends[2] = { nodes[i], nodes[(i + 1) % RING_NODES] };
+      for (uint32_t j = 0; j < 2; j++)
+        {
+          Ptr<PointToPointNetDevice> device = CreateObject<PointToPointNetDevice> ();
+          device->Attach (channel);
+          device->SetAddress (Mac48Address::Allocate ());
+          device->SetDataRate (DataRate ("10Mbps"));
+          device->SetQueue (CreateObject<DropTailQueue> ());
+          ends[j]->AddDevice (device);
+          device->SetReceiveCallback (MakeCallback (&PointToPointMultithreadedTest::Receive, this));
+          Ptr<NetDeviceQueueInterface> iface = CreateObject<NetDeviceQueueInterface> ();
+          device->AggregateObject (iface);
+          iface->CreateTxQueues ();
+        }
+    }
+  for (uint32_t i = 0; i < RING_NODES; i++)
+    {
+      for (uint32_t j = 0; j < RING_PACKETS; j++)
+        {
+          Simulator::ScheduleWithContext (i, MicroSeconds (300 * j + 10 * i),
+                                          &PointToPointMultithreadedTest::Send, this,
+                                          nodes[i]->GetDevice (j % 2), i, 100 + 50 * j);
+        }
+    }
+  Simulator::Run ();
+  m_partitions = 1;
+  Ptr<MultithreadedSimulatorImpl> impl =
+    DynamicCast<MultithreadedSimulatorImpl> (Simulator::GetImplementation ());
+  if (impl != 0)
+    {
+      m_partitions = impl->GetPartitionCount ();
+    }
+  Simulator::Destroy ();
+}
+
+void
+PointToPointMultithreadedTest::DoRun (void)
+{
+  RunWith (ObjectFactory ("ns3::DefaultSimulatorImpl"));
+  std::vector<Log> expected = m_logs;
+  uint32_t received = 0;
+  for (uint32_t i = 0; i < expected.size (); i++)
+    {
+      std::sort (expected[i].begin (), expected[i].end ());
+      received += expected[i].size ();
+    }
+  NS_TEST_ASSERT_MSG_EQ (received, RING_NODES * RING_PACKETS * RING_HOPS, "Packets were lost");
+
+  ObjectFactory factory ("ns3::MultithreadedSimulatorImpl");
+  factory.Set ("ThreadCount", UintegerValue (3));
+  RunWith (factory);
+  NS_TEST_ASSERT_MSG_EQ (m_partitions, 3, "Unexpected number of partitions");
+  for (uint32_t i = 0; i < m_logs.size (); i++)
+    {
+      std::sort (m_logs[i].begin (), m_logs[i].end ());
+      for (uint32_t j = 0; j < m_logs[i].size (); j++)
+        {
+          NS_TEST_EXPECT_MSG_EQ (m_logs[i][j].ok, true, "Corrupted packet on node " << i);
+        }
+      bool same = (m_logs[i] == expected[i]);
+      NS_TEST_EXPECT_MSG_EQ (same, true, "Different packets on node " << i);
+    }
+}
+
 /**
  * \brief TestSuite for PointToPoint module
  */
@@ -116,6 +362,7 @@ PointToPointTestSuite::PointToPointTestSuite ()
   : TestSuite ("devices-point-to-point", UNIT)
 {
   AddTestCase (new PointToPointTest, TestCase::QUICK);
+  AddTestCase (new PointToPointMultithreadedTest, TestCase::QUICK);
 }
 
 static PointToPointTestSuite g_pointToPointTestSuite; //!< The testsuite
@@ -0,0 +1,222 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+#include <utility>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+
+bool g_debug = false;
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+#define DEB(x) if (g_debug) { LOGME (x) ; }
+
+// Output field width
+int g_fwidth = 6;
+
+/**
+ * Several threads inject events into the simulator with
+ * Simulator::ScheduleWithContext, while the main thread runs them.
+ */
+class Bench
+{
+public:
+  Bench (const uint32_t threads, const uint32_t events)
+  : m_threads (threads),
+    m_events (events),
+    m_received (0)
+  { };
+
+  void RunBench (void);
+private:
+  static void Inject (std::pair<Bench *, uint32_t> context);
+  void Received (void);
+  void Poll (void);
+
+  uint32_t m_threads;
+  uint32_t m_events;
+  uint64_t m_received;
+  std::vector<int64_t> m_injectMs;
+};
+
+void
+Bench::Inject (std::pair<Bench *, uint32_t> context)
+{
+  Bench *me = context.first;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < me->m_events; ++i)
+    {
+      Simulator::ScheduleWithContext (context.second, NanoSeconds (1),
+                                      &Bench::Received, me);
+    }
+  me->m_injectMs[context.second] = time.End ();
+}
+
+void
+Bench::Received (void)
+{
+  ++m_received;
+}
+
+void
+Bench::Poll (void)
+{
+  if (m_received == static_cast<uint64_t> (m_threads) * m_events)
+    {
+      Simulator::Stop ();
+      return;
+    }
+  Simulator::Schedule (MicroSeconds (10), &Bench::Poll, this);
+}
+
+void
+Bench::RunBench (void)
+{
+  SystemWallClockMs time;
+  uint64_t total = static_cast<uint64_t> (m_threads) * m_events;
+
+  m_received = 0;
+  m_injectMs.assign (m_threads, 0);
+
+  // Create the simulator implementation in the main thread.
+  Simulator::Schedule (MicroSeconds (10), &Bench::Poll, this);
+
+  std::vector<Ptr<SystemThread> > threads;
+  for (uint32_t i = 0; i < m_threads; ++i)
+    {
+      threads.push_back (Create<SystemThread>
+                         (MakeBoundCallback (&Bench::Inject, std::make_pair (this, i))));
+    }
+
+  DEB ("running");
+  time.Start ();
+  for (uint32_t i = 0; i < m_threads; ++i)
+    {
+      threads[i]->Start ();
+    }
+  Simulator::Run ();
+  for (uint32_t i = 0; i < m_threads; ++i)
+    {
+      threads[i]->Join ();
+    }
+  double simu = time.End ();
+  simu /= 1000;
+  Simulator::Destroy ();
+
+  double inject = 0;
+  for (uint32_t i = 0; i < m_threads; ++i)
+    {
+      inject = std::max (inject, m_injectMs[i] / 1000.0);
+    }
+  DEB ("injection took " << inject << "s, run took " << simu << "s");
+  // The wall clock counts milliseconds: on short runs the times can
+  // be zero, so clamp them to one tick to keep the rates finite.
+  inject = std::max (inject, 0.001);
+  simu = std::max (simu, 0.001);
+
+  LOG (std::setw (g_fwidth) << inject <<
+       std::setw (g_fwidth) << (total / inject) <<
+       std::setw (g_fwidth) << (inject * m_threads / total) <<
+       std::setw (g_fwidth) << simu <<
+       std::setw (g_fwidth) << (m_received / simu));
+}
+
+
+int main (int argc, char *argv[])
+{
+  bool realtime = false;
+  uint32_t threads =      4;
+  uint32_t events  = 100000;
+  uint32_t runs    =      1;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the injection of events from several threads.\n"
+             "\n"
+             "Each thread schedules --events events with\n"
+             "Simulator::ScheduleWithContext, as fast as it can, while\n"
+             "the main thread runs the simulation until all of them\n"
+             "have been executed.");
+  cmd.AddValue ("threads",  "number of injecting threads (default 4)", threads);
+  cmd.AddValue ("events",   "events injected per thread (default 1E5)", events);
+  cmd.AddValue ("realtime", "use the RealtimeSimulatorImpl", realtime);
+  cmd.AddValue ("debug",    "enable debugging output",     g_debug);
+  cmd.AddValue ("runs",     "number of runs (default 1)",  runs);
+  cmd.AddValue ("prec",     "printed output precision",    g_fwidth);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+
+  if (realtime)
+    {
+      GlobalValue::Bind ("SimulatorImplementationType",
+                         StringValue ("ns3::RealtimeSimulatorImpl"));
+    }
+
+  LOGME (std::setprecision (g_fwidth - 6));
+  DEB ("debugging is ON");
+
+  LOGME ("simulator: " << (realtime ? "ns3::RealtimeSimulatorImpl" : "ns3::DefaultSimulatorImpl"));
+  LOGME ("threads: " << threads);
+  LOGME ("events per thread: " << events);
+  LOGME ("runs: " << runs);
+
+  // table header
+  LOG ("");
+  LOG (std::left << std::setw (g_fwidth) << "Run #" <<
+       std::left << std::setw (3 * g_fwidth) << "Injection:" <<
+       std::left << std::setw (2 * g_fwidth) << "End to end:");
+  LOG (std::left << std::setw (g_fwidth) << "" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (ev/s)" <<
+       std::left << std::setw (g_fwidth) << "Per (s/ev)" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (ev/s)");
+  LOG (std::setfill ('-') <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::setfill (' ')
+       );
+
+  Bench bench (threads, events);
+
+  // prime
+  DEB ("priming");
+  std::cout << std::left << std::setw (g_fwidth) << "(prime)";
+  bench.RunBench ();
+
+  for (uint32_t i = 0; i < runs; i++)
+    {
+      std::cout << std::setw (g_fwidth) << i;
+      bench.RunBench ();
+    }
+  LOG ("");
+  return 0;
+}
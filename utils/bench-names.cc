@@ -0,0 +1,276 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+
+bool g_debug = false;
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+#define DEB(x) if (g_debug) { LOGME (x) ; }
+
+// Output field width
+int g_fwidth = 6;
+
+/**
+ * The names looked up, drawn once among the named objects, in the
+ * forms the Config resolver and the helpers use.
+ */
+struct Targets
+{
+  std::vector<std::string> nodes;       //!< Names of nodes, at the root.
+  std::vector<std::string> devices;     //!< Names of devices, under their node.
+  std::vector<std::string> full;        //!< Fully qualified paths of devices.
+  std::vector<std::string> relative;    //!< Relative paths of devices.
+  std::vector<std::string> missing;     //!< Relative paths of no object.
+  std::vector<Ptr<Object> > contexts;   //!< The nodes.
+  std::vector<Ptr<Object> > objects;    //!< The devices.
+};
+
+/** Accumulates the results, so that the lookups are not optimized out. */
+uintptr_t g_sink = 0;
+
+/**
+ * A benchmark: look up each of the targets, in turn, \c total times.
+ */
+typedef void (*Operation)(const Targets &targets, uint32_t i);
+
+/** Names::Find with a fully qualified path. */
+void
+FindFull (const Targets &targets, uint32_t i)
+{
+  g_sink += (uintptr_t) PeekPointer (Names::Find<Object> (targets.full[i]));
+}
+/** Names::Find with a relative path. */
+void
+FindRelative (const Targets &targets, uint32_t i)
+{
+  g_sink += (uintptr_t) PeekPointer (Names::Find<Object> (targets.relative[i]));
+}
+/** Names::Find with a path and a name. */
+void
+FindPathName (const Targets &targets, uint32_t i)
+{
+  g_sink += (uintptr_t) PeekPointer (Names::Find<Object> (targets.nodes[i], targets.devices[i]));
+}
+/** Names::Find with a context and a name, as the Config resolver. */
+void
+FindContextName (const Targets &targets, uint32_t i)
+{
+  g_sink += (uintptr_t) PeekPointer (Names::Find<Object> (targets.contexts[i], targets.devices[i]));
+}
+/** Names::Find of a path which is not named. */
+void
+FindMissing (const Targets &targets, uint32_t i)
+{
+  g_sink += (uintptr_t) PeekPointer (Names::Find<Object> (targets.missing[i]));
+}
+/** Names::FindName. */
+void
+FindName (const Targets &targets, uint32_t i)
+{
+  g_sink += Names::FindName (targets.objects[i]).size ();
+}
+/** Names::FindPath. */
+void
+FindPath (const Targets &targets, uint32_t i)
+{
+  g_sink += Names::FindPath (targets.objects[i]).size ();
+}
+
+/**
+ * Print one line of the table.
+ * \param [in] name The benchmark name.
+ * \param [in] elapsed The elapsed time, in s.
+ * \param [in] total The number of operations.
+ */
+void
+Report (std::string name, double elapsed, uint32_t total)
+{
+  LOG (std::left << std::setw (30) << name <<
+       std::setw (g_fwidth) << elapsed <<
+       std::setw (g_fwidth) << (total / elapsed) <<
+       std::setw (g_fwidth) << (elapsed / total * 1e9));
+}
+
+/**
+ * Run one benchmark.
+ * \param [in] name The benchmark name.
+ * \param [in] operation The operation to benchmark.
+ * \param [in] targets The names looked up.
+ * \param [in] total The number of lookups.
+ */
+void
+RunBench (std::string name, Operation operation, const Targets &targets, uint32_t total)
+{
+  uint32_t n = targets.full.size ();
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t j = 0; j < total; j++)
+    {
+      (*operation)(targets, j % n);
+    }
+  double elapsed = time.End ();
+  elapsed /= 1000;
+  DEB ("sink: " << g_sink);
+  Report (name, elapsed, total);
+}
+
+/**
+ * \param [in] i The index of a node.
+ * \returns The name of the node.
+ */
+std::string
+NodeName (uint32_t i)
+{
+  std::ostringstream oss;
+  oss << "node-" << i;
+  return oss.str ();
+}
+
+/**
+ * \param [in] j The index of a device on its node.
+ * \returns The name of the device.
+ */
+std::string
+DeviceName (uint32_t j)
+{
+  std::ostringstream oss;
+  oss << "dev-" << j;
+  return oss.str ();
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t total =  1000000;
+  uint32_t nodes =   100000;
+  uint32_t devices =      9;
+  uint32_t count =   100000;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the Names service.\n"
+             "\n"
+             "--nodes objects are named at the root of the name space, as\n"
+             "the nodes of a large topology, each with --devices named\n"
+             "objects under it: one million names by default.  Each\n"
+             "benchmark then looks up --total names, in turn among --count\n"
+             "random devices.");
+  cmd.AddValue ("total",   "number of lookups of each kind (default 1E6)", total);
+  cmd.AddValue ("nodes",   "number of objects named at the root (default 1E5)", nodes);
+  cmd.AddValue ("devices", "number of objects named under each node (default 9)", devices);
+  cmd.AddValue ("count",   "number of random lookup targets (default 1E5)", count);
+  cmd.AddValue ("debug",   "enable debugging output", g_debug);
+  cmd.AddValue ("prec",    "printed output precision", g_fwidth);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+
+  LOGME (std::setprecision (g_fwidth - 6));
+  DEB ("debugging is ON");
+
+  LOGME ("names: " << nodes * (devices + 1));
+  LOGME ("lookups: " << total);
+  LOGME ("targets: " << count);
+
+  std::vector<Ptr<Object> > nodeObjects;
+  std::vector<std::vector<Ptr<Object> > > deviceObjects (nodes);
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      nodeObjects.push_back (CreateObject<Object> ());
+      for (uint32_t j = 0; j < devices; j++)
+        {
+          deviceObjects[i].push_back (CreateObject<Object> ());
+        }
+    }
+  std::vector<std::string> deviceNames;
+  for (uint32_t j = 0; j < devices; j++)
+    {
+      deviceNames.push_back (DeviceName (j));
+    }
+
+  // table header
+  LOG ("");
+  LOG (std::left << std::setw (30) << "Operation" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (/s)" <<
+       std::left << std::setw (g_fwidth) << "Per (ns)");
+  LOG (std::setfill ('-') <<
+       std::right << std::setw (30) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::setfill (' ')
+       );
+
+  // The nodes at the root, and the devices by path and name, as the
+  // topology readers and the helpers do.
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      std::string node = NodeName (i);
+      Names::Add (node, nodeObjects[i]);
+      for (uint32_t j = 0; j < devices; j++)
+        {
+          Names::Add (node, deviceNames[j], deviceObjects[i][j]);
+        }
+    }
+  double elapsed = time.End ();
+  Report ("Names::Add", elapsed / 1000, nodes * (devices + 1));
+
+  Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable> ();
+  Targets targets;
+  for (uint32_t k = 0; k < count; k++)
+    {
+      uint32_t i = urv->GetInteger (0, nodes - 1);
+      uint32_t j = urv->GetInteger (0, devices - 1);
+      std::string node = NodeName (i);
+      targets.nodes.push_back (node);
+      targets.devices.push_back (deviceNames[j]);
+      targets.full.push_back ("/Names/" + node + "/" + deviceNames[j]);
+      targets.relative.push_back (node + "/" + deviceNames[j]);
+      targets.missing.push_back (node + "/" + DeviceName (devices + j));
+      targets.contexts.push_back (nodeObjects[i]);
+      targets.objects.push_back (deviceObjects[i][j]);
+    }
+
+  RunBench ("Find (full path)", &FindFull, targets, total);
+  RunBench ("Find (relative path)", &FindRelative, targets, total);
+  RunBench ("Find (path, name)", &FindPathName, targets, total);
+  RunBench ("Find (context, name)", &FindContextName, targets, total);
+  RunBench ("Find (missing name)", &FindMissing, targets, total);
+  RunBench ("FindName", &FindName, targets, total);
+  RunBench ("FindPath", &FindPath, targets, total);
+
+  time.Start ();
+  Names::Clear ();
+  elapsed = time.End ();
+  Report ("Names::Clear", elapsed / 1000, nodes * (devices + 1));
+  LOG ("");
+  return 0;
+}
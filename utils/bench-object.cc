@@ -0,0 +1,219 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+
+bool g_debug = false;
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+#define DEB(x) if (g_debug) { LOGME (x) ; }
+
+// Output field width
+int g_fwidth = 6;
+
+/**
+ * An Object type to aggregate, as the protocols and models
+ * aggregated to a Node.
+ *
+ * \tparam N The index of the type.
+ */
+template <int N>
+class Aggregate : public Object
+{
+public:
+  /**
+   * Register this type.
+   * \return The object TypeId.
+   */
+  static TypeId GetTypeId (void)
+  {
+    static TypeId tid = TypeId (GetName ().c_str ())
+      .SetParent<Object> ()
+      .SetGroupName ("Core")
+      .AddConstructor<Aggregate<N> > ()
+    ;
+    return tid;
+  }
+private:
+  /** \returns The name of this type. */
+  static std::string GetName (void)
+  {
+    std::ostringstream oss;
+    oss << "ns3::BenchObjectAggregate" << N;
+    return oss.str ();
+  }
+};
+
+/** The number of aggregated types. */
+const int TYPES = 8;
+
+/** Accumulates the results, so that the lookups are not optimized out. */
+uintptr_t g_sink = 0;
+
+/**
+ * Look up one of the aggregated types.
+ * \param [in] object The object to look the type up from.
+ * \param [in] i The index of the type.
+ */
+void
+Lookup (Ptr<Object> object, int i)
+{
+  switch (i)
+    {
+    case 0: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<0> > ()); break;
+    case 1: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<1> > ()); break;
+    case 2: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<2> > ()); break;
+    case 3: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<3> > ()); break;
+    case 4: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<4> > ()); break;
+    case 5: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<5> > ()); break;
+    case 6: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<6> > ()); break;
+    case 7: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<7> > ()); break;
+    default: g_sink += (uintptr_t) PeekPointer (object->GetObject<Aggregate<TYPES> > ()); break;
+    }
+}
+
+/**
+ * Create an aggregate of objects of the first \p count types.
+ * \param [in] count The number of objects.
+ * \return The first object of the aggregate.
+ */
+Ptr<Object>
+MakeAggregate (int count)
+{
+  Ptr<Object> object = CreateObject<Aggregate<0> > ();
+  if (count > 1) object->AggregateObject (CreateObject<Aggregate<1> > ());
+  if (count > 2) object->AggregateObject (CreateObject<Aggregate<2> > ());
+  if (count > 3) object->AggregateObject (CreateObject<Aggregate<3> > ());
+  if (count > 4) object->AggregateObject (CreateObject<Aggregate<4> > ());
+  if (count > 5) object->AggregateObject (CreateObject<Aggregate<5> > ());
+  if (count > 6) object->AggregateObject (CreateObject<Aggregate<6> > ());
+  if (count > 7) object->AggregateObject (CreateObject<Aggregate<7> > ());
+  return object;
+}
+
+/**
+ * Run one benchmark: \p total lookups on \p objects aggregates.
+ * \param [in] name The benchmark name.
+ * \param [in] objects The aggregates, looked up in turn.
+ * \param [in] types The types to look up, in turn.
+ * \param [in] total The number of lookups.
+ */
+void
+RunBench (std::string name, const std::vector<Ptr<Object> > &objects,
+          const std::vector<int> &types, uint32_t total)
+{
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t j = 0; j < total; j++)
+    {
+      Lookup (objects[j % objects.size ()], types[j % types.size ()]);
+    }
+  double elapsed = time.End ();
+  elapsed /= 1000;
+  DEB ("sink: " << g_sink);
+
+  LOG (std::left << std::setw (30) << name <<
+       std::setw (g_fwidth) << elapsed <<
+       std::setw (g_fwidth) << (total / elapsed) <<
+       std::setw (g_fwidth) << (elapsed / total * 1e9));
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t total = 10000000;
+  uint32_t nodes =      100;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark Object::GetObject.\n"
+             "\n"
+             "Aggregates of Objects of up to eight types are created, as\n"
+             "the Nodes of a simulation, and each benchmark looks up --total\n"
+             "types in them, in turn.");
+  cmd.AddValue ("total", "number of lookups of each kind (default 1E7)", total);
+  cmd.AddValue ("nodes", "number of aggregates (default 100)", nodes);
+  cmd.AddValue ("debug", "enable debugging output", g_debug);
+  cmd.AddValue ("prec",  "printed output precision", g_fwidth);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+
+  LOGME (std::setprecision (g_fwidth - 6));
+  DEB ("debugging is ON");
+
+  LOGME ("lookups: " << total);
+  LOGME ("aggregates: " << nodes);
+
+  std::vector<Ptr<Object> > single;
+  std::vector<Ptr<Object> > full;
+  for (uint32_t i = 0; i < nodes; i++)
+    {
+      single.push_back (MakeAggregate (1));
+      full.push_back (MakeAggregate (TYPES));
+    }
+
+  std::vector<int> first (1, 0);
+  std::vector<int> last (1, TYPES - 1);
+  std::vector<int> all;
+  for (int i = 0; i < TYPES; i++)
+    {
+      all.push_back (i);
+    }
+  std::vector<int> missing (1, TYPES);
+  // A type often looked up, and the others now and then
+  std::vector<int> skewed;
+  for (int i = 0; i < TYPES; i++)
+    {
+      skewed.push_back (TYPES - 1);
+      skewed.push_back (i);
+    }
+
+  // table header
+  LOG ("");
+  LOG (std::left << std::setw (30) << "Lookup" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (/s)" <<
+       std::left << std::setw (g_fwidth) << "Per (ns)");
+  LOG (std::setfill ('-') <<
+       std::right << std::setw (30) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::setfill (' ')
+       );
+
+  RunBench ("1 object, own type", single, first, total);
+  RunBench ("1 object, missing type", single, missing, total);
+  RunBench ("8 objects, first type", full, first, total);
+  RunBench ("8 objects, last type", full, last, total);
+  RunBench ("8 objects, all types", full, all, total);
+  RunBench ("8 objects, skewed types", full, skewed, total);
+  RunBench ("8 objects, missing type", full, missing, total);
+  LOG ("");
+  return 0;
+}
@@ -21,12 +21,21 @@
 #include "ns3/system-wall-clock-ms.h"
 #include "ns3/packet.h"
 #include "ns3/packet-metadata.h"
+#include "ns3/packet-data-pool.h"
+#ifdef NS3_BENCH_POINT_TO_POINT
+#include "ns3/node-container.h"
+#include "ns3/net-device-container.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#endif
 #include <iostream>
 #include <sstream>
 #include <string>
 #include <stdlib.h> // for exit ()
 #include <limits>
 #include <algorithm>
+#include <vector>
 
 using namespace ns3;
 
@@ -284,6 +293,122 @@ benchFragment (uint32_t n)
   }
 }
 
+/** Payload bytes of the reassembly and segmentation benchmarks. */
+static uint8_t g_payload[65000];
+
+static void
+benchReassembly (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  const uint32_t mtu = 1500;
+  const uint32_t fragmentSize = mtu - ipv4.GetSerializedSize ();
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // A 64 kB datagram, fragmented as by Ipv4L3Protocol::DoFragmentation.
+      Ptr<Packet> p = Packet::CreatePayload (g_payload, 64000);
+      p->AddHeader (udp);
+      std::vector<Ptr<Packet> > fragments;
+      for (uint32_t offset = 0; offset < p->GetSize (); offset += fragmentSize)
+        {
+          uint32_t size = std::min (fragmentSize, p->GetSize () - offset);
+          Ptr<Packet> fragment = p->CreateFragment (offset, size);
+          fragment->AddHeader (ipv4);
+          fragments.push_back (fragment);
+        }
+
+      // Reassembled as by Ipv4L3Protocol::Fragments::GetPacket.
+      Ptr<Packet> reassembled;
+      for (std::vector<Ptr<Packet> >::iterator j = fragments.begin (); j != fragments.end (); ++j)
+        {
+          (*j)->RemoveHeader (ipv4);
+          if (reassembled == 0)
+            {
+              reassembled = (*j)->Copy ();
+            }
+          else
+            {
+              reassembled->AddAtEnd (*j);
+            }
+        }
+      reassembled->RemoveHeader (udp);
+    }
+}
+
+static void
+benchSegmentation (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<20> tcp;
+  const uint32_t segmentSize = 536;
+  const uint32_t writeSize = 1000;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // The application writes, as queued by TcpTxBuffer::Add.
+      std::vector<Ptr<Packet> > writes;
+      uint32_t total = 0;
+      for (uint32_t j = 0; j < 16; j++)
+        {
+          writes.push_back (Packet::CreatePayload (g_payload, writeSize));
+          total += writeSize;
+        }
+
+      // The segments, spanning the writes, as TcpTxBuffer::CopyFromSequence.
+      for (uint32_t offset = 0; offset < total; offset += segmentSize)
+        {
+          uint32_t size = std::min (segmentSize, total - offset);
+          uint32_t index = offset / writeSize;
+          uint32_t start = offset % writeSize;
+          Ptr<Packet> segment = writes[index]->CreateFragment (start, std::min (size, writeSize - start));
+          while (segment->GetSize () < size)
+            {
+              index++;
+              uint32_t left = size - segment->GetSize ();
+              segment->AddAtEnd (writes[index]->CreateFragment (0, std::min (left, writeSize)));
+            }
+          segment->AddHeader (tcp);
+          segment->AddHeader (ipv4);
+        }
+    }
+}
+
+static void
+benchPacketTags (uint32_t n)
+{
+  BenchHeader<25> ipv4;
+  BenchHeader<8> udp;
+  // Sizes of FlowIdTag, EpsBearerTag, AmpduTag and SnrTag.
+  BenchTag<4> flowId;
+  BenchTag<1> bearer;
+  BenchTag<2> ampdu;
+  BenchTag<8> snr;
+  BenchTag<3> absent;
+
+  for (uint32_t i = 0; i < n; i++)
+    {
+      // The sender tags the packet at each layer.
+      Ptr<Packet> p = Create<Packet> (1000);
+      p->AddPacketTag (flowId);
+      p->AddHeader (udp);
+      p->AddHeader (ipv4);
+      p->AddPacketTag (bearer);
+      p->AddPacketTag (ampdu);
+      // The receiver gets a copy, and looks up the tags at each layer.
+      Ptr<Packet> o = p->Copy ();
+      o->AddPacketTag (snr);
+      o->PeekPacketTag (absent);
+      o->RemovePacketTag (snr);
+      o->RemovePacketTag (ampdu);
+      o->PeekPacketTag (bearer);
+      o->RemoveHeader (ipv4);
+      o->RemoveHeader (udp);
+      o->PeekPacketTag (absent);
+      o->RemovePacketTag (flowId);
+    }
+}
+
 static void
 benchByteTags (uint32_t n)
 {
@@ -302,6 +427,71 @@ benchByteTags (uint32_t n)
     }
 }
 
+#ifdef NS3_BENCH_POINT_TO_POINT
+/** Number of packets received at the end of the chain. */
+static uint32_t g_chainReceived;
+
+static bool
+chainForward (Ptr<NetDevice> next, Ptr<NetDevice> device, Ptr<const Packet> packet,
+              uint16_t protocol, const Address &from)
+{
+  // As a router, forward a copy of the received packet.
+  next->Send (packet->Copy (), next->GetBroadcast (), protocol);
+  return true;
+}
+
+static bool
+chainReceive (Ptr<NetDevice> device, Ptr<const Packet> packet,
+              uint16_t protocol, const Address &from)
+{
+  g_chainReceived++;
+  return true;
+}
+
+static void
+chainSend (Ptr<NetDevice> device, uint32_t left)
+{
+  device->Send (Create<Packet> (1000), device->GetBroadcast (), 0x0800);
+  if (left > 1)
+    {
+      // Slower than the links, so that the queues stay short.
+      Simulator::Schedule (MicroSeconds (10), &chainSend, device, left - 1);
+    }
+}
+
+static void
+benchPointToPointChain (uint32_t n)
+{
+  const uint32_t nNodes = 8;
+  NodeContainer nodes;
+  nodes.Create (nNodes);
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("1Gbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("1us"));
+  std::vector<NetDeviceContainer> links;
+  for (uint32_t i = 1; i < nNodes; i++)
+    {
+      links.push_back (p2p.Install (nodes.Get (i - 1), nodes.Get (i)));
+    }
+  for (uint32_t i = 1; i < links.size (); i++)
+    {
+      links[i - 1].Get (1)->SetReceiveCallback (MakeBoundCallback (&chainForward, links[i].Get (0)));
+    }
+  links.back ().Get (1)->SetReceiveCallback (MakeCallback (&chainReceive));
+
+  g_chainReceived = 0;
+  Simulator::ScheduleNow (&chainSend, links.front ().Get (0), n);
+  Simulator::Run ();
+  Simulator::Destroy ();
+  if (g_chainReceived != n)
+    {
+      std::cerr << "Error-- " << g_chainReceived << " of " << n
+                << " packets received at the end of the chain" << std::endl;
+      exit (1);
+    }
+}
+#endif /* NS3_BENCH_POINT_TO_POINT */
+
 static uint64_t
 runBenchOneIteration (void (*bench) (uint32_t), uint32_t n)
 {
@@ -331,17 +521,31 @@ runBench (void (*bench) (uint32_t), uint32_t n, uint32_t minIterations, char con
             << std::endl;
 }
 
+static void
+printPoolStats (char const *name, const PacketDataPool &pool)
+{
+  PacketDataPool::Stats stats = pool.GetStats ();
+  std::cout << name << " pool: "
+            << stats.allocations << " allocations, "
+            << stats.hits << " hits, "
+            << stats.misses << " misses, "
+            << stats.peak << " peak free blocks"
+            << std::endl;
+}
+
 int main (int argc, char *argv[])
 {
   uint32_t n = 0;
   uint32_t minIterations = 1;
   bool enablePrinting = false;
+  bool virtualPayload = false;
 
   CommandLine cmd;
   cmd.Usage ("Benchmark Packet class");
   cmd.AddValue ("n", "number of iterations", n);
   cmd.AddValue ("min-iterations", "number of subiterations to minimize iteration time over", minIterations);
   cmd.AddValue ("enable-printing", "enable packet printing", enablePrinting);
+  cmd.AddValue ("virtual-payload", "keep only the size of the payload data", virtualPayload);
   cmd.Parse (argc, argv);
 
   if (n == 0)
@@ -350,6 +554,10 @@ int main (int argc, char *argv[])
         "by command-line argument --n=(number of packets)" << std::endl;
       exit (1);
     }
+  if (virtualPayload)
+    {
+      Packet::EnableVirtualPayload ();
+    }
   std::cout << "Running bench-packets with n=" << n << std::endl;
   std::cout << "All tests begin by adding UDP and IPv4 headers." << std::endl;
 
@@ -358,7 +566,23 @@ int main (int argc, char *argv[])
   runBench (&benchC, n, minIterations, "Remove by func call");
   runBench (&benchD, n, minIterations, "Intermixed add/remove headers and tags");
   runBench (&benchFragment, n, minIterations, "Fragmentation and concatenation");
+  runBench (&benchReassembly, n, minIterations, "Fragmentation and reassembly of 64 kB");
+  runBench (&benchSegmentation, n, minIterations, "Segmentation of 16 kB in 536 B");
+  runBench (&benchPacketTags, n, minIterations, "Several packet tags on the packet path");
   runBench (&benchByteTags, n, minIterations, "Benchmark byte tags");
+#ifdef NS3_BENCH_POINT_TO_POINT
+  runBench (&benchPointToPointChain, n, minIterations, "Point-to-point chain of 8 nodes");
+  uint32_t maxFree = Packet::GetObjectPool ().GetMaxFree ();
+  Packet::GetObjectPool ().SetMaxFree (0);
+  runBench (&benchPointToPointChain, n, minIterations, "Point-to-point chain, packets not recycled");
+  Packet::GetObjectPool ().SetMaxFree (maxFree);
+#endif
+
+  printPoolStats ("Buffer", Buffer::GetDataPool ());
+  printPoolStats ("PacketMetadata", PacketMetadata::GetDataPool ());
+  printPoolStats ("ByteTagList", ByteTagList::GetDataPool ());
+  printPoolStats ("PacketTagList", PacketTagList::GetDataPool ());
+  printPoolStats ("Packet", Packet::GetObjectPool ());
 
   return 0;
 }
@@ -0,0 +1,135 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <sys/resource.h>
+#include <iomanip>
+#include <iostream>
+
+#include "ns3/core-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-helper.h"
+#include "ns3/csma-helper.h"
+
+using namespace ns3;
+
+
+bool g_debug = false;
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+#define DEB(x) if (g_debug) { LOGME (x) ; }
+
+/**
+ * Get the peak resident set size of the process.
+ * \returns The peak resident set size, in kB.
+ */
+long
+GetPeakRss (void)
+{
+  struct rusage usage;
+  getrusage (RUSAGE_SELF, &usage);
+  return usage.ru_maxrss;
+}
+
+/**
+ * Build the scenario: a chain of nodes linked by point-to-point links,
+ * with the nodes also grouped in CSMA LANs.
+ * \param [in] nodes The number of nodes.
+ * \param [in] lan The number of nodes per CSMA LAN.
+ * \returns The number of devices.
+ */
+uint32_t
+Build (uint32_t nodes, uint32_t lan)
+{
+  NodeContainer all;
+  all.Create (nodes);
+
+  PointToPointHelper p2p;
+  p2p.SetDeviceAttribute ("DataRate", StringValue ("10Mbps"));
+  p2p.SetChannelAttribute ("Delay", StringValue ("2ms"));
+  uint32_t devices = 0;
+  for (uint32_t i = 1; i < nodes; i++)
+    {
+      devices += p2p.Install (all.Get (i - 1), all.Get (i)).GetN ();
+    }
+
+  CsmaHelper csma;
+  csma.SetChannelAttribute ("DataRate", StringValue ("100Mbps"));
+  for (uint32_t i = 0; i + lan <= nodes; i += lan)
+    {
+      NodeContainer members;
+      for (uint32_t j = i; j < i + lan; j++)
+        {
+          members.Add (all.Get (j));
+        }
+      devices += csma.Install (members).GetN ();
+    }
+  return devices;
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t nodes = 100000;
+  uint32_t lan   =      8;
+  bool arena = false;
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the construction of a large scenario.\n"
+             "\n"
+             "Creates --nodes nodes, links them in a chain with point-to-point\n"
+             "links, and groups them in CSMA LANs of --lan nodes, then reports\n"
+             "the setup time and the peak resident set size.  With --arena,\n"
+             "the Objects are allocated in ObjectFactory arena mode.\n"
+             "Run once with and once without --arena to compare.");
+  cmd.AddValue ("nodes", "number of nodes (default 1E5)", nodes);
+  cmd.AddValue ("lan",   "number of nodes per CSMA LAN (default 8)", lan);
+  cmd.AddValue ("arena", "allocate the Objects in arena mode", arena);
+  cmd.AddValue ("debug", "enable debugging output", g_debug);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  DEB ("debugging is ON");
+
+  LOGME ("nodes: " << nodes);
+  LOGME ("nodes per LAN: " << lan);
+  LOGME ("arena mode: " << (arena ? "on" : "off"));
+
+  long rssBefore = GetPeakRss ();
+  SystemWallClockMs time;
+  time.Start ();
+  ObjectFactory::SetArenaEnabled (arena);
+  uint32_t devices = Build (nodes, lan);
+  ObjectFactory::SetArenaEnabled (false);
+  double elapsed = time.End ();
+  elapsed /= 1000;
+  long rssAfter = GetPeakRss ();
+
+  ObjectArena::Stats stats = ObjectArena::GetStats ();
+  LOGME ("devices: " << devices);
+  LOGME ("setup time (s): " << elapsed);
+  LOGME ("peak RSS (MB): " << std::fixed << std::setprecision (1) <<
+         rssAfter / 1024.0 << " (" << (rssAfter - rssBefore) / 1024.0 <<
+         " for the scenario)");
+  LOGME ("objects allocated in arena mode: " << stats.allocations <<
+         ", carved out of " << stats.chunks << " chunks of " <<
+         ObjectArena::CHUNK_SIZE / 1024 << " kB");
+
+  Simulator::Destroy ();
+  return 0;
+}
@@ -0,0 +1,271 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+
+bool g_debug = false;
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+#define DEB(x) if (g_debug) { LOGME (x) ; }
+
+// Output field width
+int g_fwidth = 6;
+
+/**
+ * Operands of the benchmarks, drawn once so that the compiler
+ * can not fold the operations.
+ */
+struct Operands
+{
+  std::vector<double> seconds;       //!< Durations, in s.
+  std::vector<int64_t> counts;       //!< Integers, as packet sizes in bits.
+  std::vector<Time> times;           //!< Durations.
+  std::vector<int64x64_t> values;    //!< High precision values.
+};
+
+/** Accumulates the results, so that the operations are not optimized out. */
+double g_sink = 0;
+
+/**
+ * A benchmark: apply an operation to each of the operands, in turn,
+ * \c total times.
+ */
+typedef void (*Operation)(const Operands &ops, uint32_t i);
+
+/** Time::Seconds from a double. */
+void
+FromSeconds (const Operands &ops, uint32_t i)
+{
+  g_sink += Seconds (ops.seconds[i]).GetTimeStep ();
+}
+/** Time::MicroSeconds from a double. */
+void
+FromMicroSeconds (const Operands &ops, uint32_t i)
+{
+  g_sink += MicroSeconds (ops.seconds[i] * 1e6).GetTimeStep ();
+}
+/** Time::NanoSeconds from an integer. */
+void
+FromNanoSeconds (const Operands &ops, uint32_t i)
+{
+  g_sink += NanoSeconds (ops.counts[i]).GetTimeStep ();
+}
+/** Time::GetSeconds. */
+void
+ToSeconds (const Operands &ops, uint32_t i)
+{
+  g_sink += ops.times[i].GetSeconds ();
+}
+/** Time::GetMicroSeconds. */
+void
+ToMicroSeconds (const Operands &ops, uint32_t i)
+{
+  g_sink += ops.times[i].GetMicroSeconds ();
+}
+/** Time::To (Time::US), as a high precision value. */
+void
+ToMicroSecondsHighPrecision (const Operands &ops, uint32_t i)
+{
+  g_sink += ops.times[i].To (Time::US).GetHigh ();
+}
+/** Time addition. */
+void
+Add (const Operands &ops, uint32_t i)
+{
+  g_sink += (ops.times[i] + ops.times[i + 1]).GetTimeStep ();
+}
+/** Time multiplied by an integer. */
+void
+MulInteger (const Operands &ops, uint32_t i)
+{
+  g_sink += (ops.times[i] * ops.counts[i]).GetTimeStep ();
+}
+/** Time divided by an integer. */
+void
+DivInteger (const Operands &ops, uint32_t i)
+{
+  g_sink += (ops.times[i] / ops.counts[i]).GetTimeStep ();
+}
+/** Time divided by a Time. */
+void
+DivTime (const Operands &ops, uint32_t i)
+{
+  g_sink += ops.times[i] / ops.times[i + 1];
+}
+/** High precision multiplication. */
+void
+Mul (const Operands &ops, uint32_t i)
+{
+  g_sink += (ops.values[i] * ops.values[i + 1]).GetHigh ();
+}
+/** High precision division. */
+void
+Div (const Operands &ops, uint32_t i)
+{
+  g_sink += (ops.values[i] / ops.values[i + 1]).GetHigh ();
+}
+/** High precision division by an integer. */
+void
+DivByInteger (const Operands &ops, uint32_t i)
+{
+  g_sink += (ops.values[i] / int64x64_t (ops.counts[i])).GetLow ();
+}
+/** Propagation delay: distance / speed. */
+void
+PropagationDelay (const Operands &ops, uint32_t i)
+{
+  // As ConstantSpeedPropagationDelayModel, with the distance in m.
+  g_sink += Seconds (ops.seconds[i] * 1e5 / 299792458.0).GetTimeStep ();
+}
+/** Transmission time of a packet: size / rate. */
+void
+TransmissionTime (const Operands &ops, uint32_t i)
+{
+  // As DataRate::CalculateBitsTxTime, at 54 Mb/s.
+  g_sink += Seconds (static_cast<double> (ops.counts[i]) / 54e6).GetTimeStep ();
+}
+
+/**
+ * Run one benchmark.
+ * \param [in] name The benchmark name.
+ * \param [in] operation The operation to benchmark.
+ * \param [in] ops The operands.
+ * \param [in] total The number of operations.
+ */
+void
+RunBench (std::string name, Operation operation, const Operands &ops, uint32_t total)
+{
+  uint32_t n = ops.seconds.size () - 1;
+  SystemWallClockMs time;
+  time.Start ();
+  for (uint32_t j = 0; j < total; j++)
+    {
+      (*operation)(ops, j % n);
+    }
+  double elapsed = time.End ();
+  elapsed /= 1000;
+  DEB ("sink: " << g_sink);
+
+  LOG (std::left << std::setw (30) << name <<
+       std::setw (g_fwidth) << elapsed <<
+       std::setw (g_fwidth) << (total / elapsed) <<
+       std::setw (g_fwidth) << (elapsed / total * 1e9));
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t total = 10000000;
+  uint32_t count =     1000;
+  std::string resolution = "NS";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the Time conversions and arithmetic.\n"
+             "\n"
+             "Each operation is applied --total times to --count random\n"
+             "operands, in turn.  The Time resolution can be changed with\n"
+             "--resolution, which sets the conversion factors.\n"
+             "\n"
+             "The operations are run after Simulator::Run, as during a\n"
+             "simulation: before it, each new Time is recorded so that it\n"
+             "can be converted if the resolution changes.");
+  cmd.AddValue ("total",      "number of operations of each kind (default 1E7)", total);
+  cmd.AddValue ("count",      "number of random operands (default 1000)", count);
+  cmd.AddValue ("resolution", "the Time resolution: S, MS, US, NS, PS or FS", resolution);
+  cmd.AddValue ("debug",      "enable debugging output", g_debug);
+  cmd.AddValue ("prec",       "printed output precision", g_fwidth);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+
+  const char *units[] = { "Y", "D", "H", "MIN", "S", "MS", "US", "NS", "PS", "FS" };
+  for (int unit = Time::Y; unit < Time::LAST; unit++)
+    {
+      if (resolution == units[unit])
+        {
+          Time::SetResolution (static_cast<enum Time::Unit> (unit));
+        }
+    }
+  // Stop recording the new Times.
+  Simulator::Run ();
+
+  LOGME (std::setprecision (g_fwidth - 6));
+  DEB ("debugging is ON");
+
+  LOGME ("operations: " << total);
+  LOGME ("operands: " << count);
+  LOGME ("resolution: " << resolution);
+  LOGME ("int64x64_t implementation: " <<
+         (int64x64_t::implementation == int64x64_t::int128_impl ? "int128" :
+          int64x64_t::implementation == int64x64_t::cairo_impl ? "cairo" :
+          "long double"));
+
+  // One more operand than count, for the binary operations.
+  Ptr<UniformRandomVariable> urv = CreateObject<UniformRandomVariable> ();
+  Operands ops;
+  for (uint32_t i = 0; i <= count; i++)
+    {
+      double seconds = urv->GetValue (1e-6, 1.0);
+      ops.seconds.push_back (seconds);
+      ops.counts.push_back (urv->GetInteger (1, 12000));
+      ops.times.push_back (Seconds (seconds));
+      ops.values.push_back (int64x64_t (urv->GetValue (0.001, 1000.0)));
+    }
+
+  // table header
+  LOG ("");
+  LOG (std::left << std::setw (30) << "Operation" <<
+       std::left << std::setw (g_fwidth) << "Time (s)" <<
+       std::left << std::setw (g_fwidth) << "Rate (/s)" <<
+       std::left << std::setw (g_fwidth) << "Per (ns)");
+  LOG (std::setfill ('-') <<
+       std::right << std::setw (30) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::right << std::setw (g_fwidth) << " " <<
+       std::setfill (' ')
+       );
+
+  RunBench ("Seconds (double)", &FromSeconds, ops, total);
+  RunBench ("MicroSeconds (double)", &FromMicroSeconds, ops, total);
+  RunBench ("NanoSeconds (int64_t)", &FromNanoSeconds, ops, total);
+  RunBench ("Time::GetSeconds", &ToSeconds, ops, total);
+  RunBench ("Time::GetMicroSeconds", &ToMicroSeconds, ops, total);
+  RunBench ("Time::To (US)", &ToMicroSecondsHighPrecision, ops, total);
+  RunBench ("Time + Time", &Add, ops, total);
+  RunBench ("Time * int64_t", &MulInteger, ops, total);
+  RunBench ("Time / int64_t", &DivInteger, ops, total);
+  RunBench ("Time / Time", &DivTime, ops, total);
+  RunBench ("int64x64_t * int64x64_t", &Mul, ops, total);
+  RunBench ("int64x64_t / int64x64_t", &Div, ops, total);
+  RunBench ("int64x64_t / integer", &DivByInteger, ops, total);
+  RunBench ("propagation delay", &PropagationDelay, ops, total);
+  RunBench ("transmission time", &TransmissionTime, ops, total);
+  LOG ("");
+  Simulator::Destroy ();
+  return 0;
+}
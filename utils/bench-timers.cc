@@ -0,0 +1,225 @@
+/* -*- Mode:C++; c-file-style:"gnu"; indent-tabs-mode:nil; -*- */
+/*
+ * Copyright (c) 2016
+ *
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "ns3/core-module.h"
+
+using namespace ns3;
+
+
+bool g_debug = false;
+
+std::string g_me;
+#define LOG(x)   std::cout << x << std::endl
+#define LOGME(x) LOG (g_me << x)
+#define DEB(x) if (g_debug) { LOGME (x) ; }
+
+// Output field width
+int g_fwidth = 6;
+
+/**
+ * A TCP-like retransmission timer workload.
+ *
+ * Each flow receives acknowledgements at exponentially distributed
+ * intervals.  Every acknowledgement cancels the retransmission timeout
+ * of the flow and schedules a new one, as TcpSocketBase does with its
+ * retransmission event, so that nearly all the timeouts are cancelled
+ * long before they expire.
+ */
+class Bench
+{
+public:
+  Bench (const uint32_t flows, const uint32_t total, const Time rto)
+  : m_flows (flows),
+    m_total (total),
+    m_rto (rto)
+  { };
+
+  void SetRandomStream (Ptr<RandomVariableStream> stream)
+  {
+    m_rand = stream;
+  }
+
+  void RunBench (void);
+private:
+  void Ack (uint32_t flow);
+  void Timeout (uint32_t flow);
+
+  Ptr<RandomVariableStream> m_rand;
+  uint32_t m_flows;
+  uint32_t m_total;
+  Time m_rto;
+  uint32_t m_acks;
+  uint32_t m_timeouts;
+  std::vector<EventId> m_rtoEvents;
+};
+
+void
+Bench::RunBench (void)
+{
+  SystemWallClockMs time;
+  double init, simu;
+
+  m_acks = 0;
+  m_timeouts = 0;
+  m_rtoEvents.assign (m_flows, EventId ());
+
+  time.Start ();
+  for (uint32_t flow = 0; flow < m_flows; ++flow)
+    {
+      Simulator::Schedule (NanoSeconds (m_rand->GetValue ()), &Bench::Ack, this, flow);
+      m_rtoEvents[flow] = Simulator::Schedule (m_rto, &Bench::Timeout, this, flow);
+    }
+  init = time.End ();
+  init /= 1000;
+
+  time.Start ();
+  Simulator::Run ();
+  simu = time.End ();
+  simu /= 1000;
+  DEB ("run took " << simu << "s, simulated " << Simulator::Now ().GetSeconds () << "s");
+  Simulator::Destroy ();
+
+  LOG (std::setw (g_fwidth) << init <<
+       std::setw (g_fwidth) << simu <<
+       std::setw (g_fwidth) << (m_acks / simu) <<
+       std::setw (g_fwidth) << (simu / m_acks) <<
+       std::setw (g_fwidth) << m_timeouts);
+}
+
+void
+Bench::Ack (uint32_t flow)
+{
+  if (m_acks >= m_total)
+    {
+      // Stop the flows: cancel their timers so that the simulation ends.
+      Simulator::Cancel (m_rtoEvents[flow]);
+      return;
+    }
+  ++m_acks;
+  Simulator::Cancel (m_rtoEvents[flow]);
+  m_rtoEvents[flow] = Simulator::Schedule (m_rto, &Bench::Timeout, this, flow);
+  Simulator::Schedule (NanoSeconds (m_rand->GetValue ()), &Bench::Ack, this, flow);
+}
+
+void
+Bench::Timeout (uint32_t flow)
+{
+  ++m_timeouts;
+}
+
+
+int main (int argc, char *argv[])
+{
+  uint32_t flows =   10000;
+  uint32_t total = 2000000;
+  uint32_t runs  =       1;
+  double ack     =       1;
+  double rto     =     200;
+  std::string scheduler = "";
+
+  CommandLine cmd;
+  cmd.Usage ("Benchmark the schedulers on a timer cancellation workload.\n"
+             "\n"
+             "Each of --flows flows receives acknowledgements at exponentially\n"
+             "distributed intervals, with mean --ack ms.  On each of them, the\n"
+             "retransmission timeout of the flow, --rto ms ahead, is cancelled\n"
+             "and scheduled again.  The run ends after --total acknowledgements.\n"
+             "\n"
+             "Without --scheduler, each scheduler is benchmarked in turn.\n"
+             "The ListScheduler is skipped, as it is far too slow with\n"
+             "the default number of flows.");
+  cmd.AddValue ("flows",     "number of flows (default 1E4)", flows);
+  cmd.AddValue ("total",     "total number of acknowledgements (default 2E6)", total);
+  cmd.AddValue ("ack",       "mean interval between acknowledgements of a flow, in ms (default 1)", ack);
+  cmd.AddValue ("rto",       "retransmission timeout, in ms (default 200)", rto);
+  cmd.AddValue ("scheduler", "the scheduler TypeId to benchmark", scheduler);
+  cmd.AddValue ("debug",     "enable debugging output", g_debug);
+  cmd.AddValue ("runs",      "number of runs (default 1)", runs);
+  cmd.AddValue ("prec",      "printed output precision", g_fwidth);
+  cmd.Parse (argc, argv);
+  g_me = cmd.GetName () + ": ";
+  g_fwidth += 6;  // 5 extra chars in '2.000002e+07 ': . e+0 _
+
+  std::vector<std::string> schedulers;
+  if (scheduler.empty ())
+    {
+      schedulers.push_back ("ns3::MapScheduler");
+      schedulers.push_back ("ns3::HeapScheduler");
+      schedulers.push_back ("ns3::CalendarScheduler");
+      schedulers.push_back ("ns3::QuadHeapScheduler");
+      schedulers.push_back ("ns3::TimingWheelScheduler");
+    }
+  else
+    {
+      schedulers.push_back (scheduler);
+    }
+
+  LOGME (std::setprecision (g_fwidth - 6));
+  DEB ("debugging is ON");
+
+  LOGME ("flows: " << flows);
+  LOGME ("acknowledgements: " << total);
+  LOGME ("mean ack interval: " << ack << " ms");
+  LOGME ("rto: " << rto << " ms");
+  LOGME ("runs: " << runs);
+
+  Ptr<ExponentialRandomVariable> erv = CreateObject<ExponentialRandomVariable> ();
+  erv->SetAttribute ("Mean", DoubleValue (ack * 1000000));
+  Bench bench (flows, total, MilliSeconds (rto));
+  bench.SetRandomStream (erv);
+
+  for (std::vector<std::string>::const_iterator it = schedulers.begin ();
+       it != schedulers.end (); ++it)
+    {
+      ObjectFactory factory (*it);
+
+      LOG ("");
+      LOGME ("scheduler: " << factory.GetTypeId ().GetName ());
+
+      // table header
+      LOG ("");
+      LOG (std::left << std::setw (g_fwidth) << "Run #" <<
+           std::left << std::setw (g_fwidth) << "Init (s)" <<
+           std::left << std::setw (g_fwidth) << "Time (s)" <<
+           std::left << std::setw (g_fwidth) << "Acks (/s)" <<
+           std::left << std::setw (g_fwidth) << "Per (s/ack)" <<
+           std::left << std::setw (g_fwidth) << "Timeouts");
+      LOG (std::setfill ('-') <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::right << std::setw (g_fwidth) << " " <<
+           std::setfill (' ')
+           );
+
+      for (uint32_t i = 0; i < runs; i++)
+        {
+          Simulator::SetScheduler (factory);
+          std::cout << std::left << std::setw (g_fwidth) << i;
+          bench.RunBench ();
+        }
+    }
+  LOG ("");
+  return 0;
+}